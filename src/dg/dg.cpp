@@ -1,8 +1,13 @@
 #include<limits>
 #include<fstream>
+#include<atomic>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/tensor.h>
 
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/work_stream.h>
+
 #include <deal.II/base/qprojector.h>
 
 #include <deal.II/grid/grid_generator.h>
@@ -19,6 +24,7 @@
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_tools.h>
 
 //#include <deal.II/fe/mapping_q1.h> // Might need mapping_q
 #include <deal.II/fe/mapping_q.h> // Might need mapping_q
@@ -48,9 +54,12 @@
 
 unsigned int n_vmult;
 unsigned int dRdW_form;
+unsigned int dRdW_reuse;
 unsigned int dRdW_mult;
 unsigned int dRdX_mult;
 unsigned int d2R_mult;
+unsigned int preconditioner_setup;
+unsigned int preconditioner_reuse;
 
 
 namespace PHiLiP {
@@ -97,12 +106,34 @@ DGBase<dim,real>::DGBase(
     , high_order_grid(grid_degree_input, triangulation)
     , mpi_communicator(MPI_COMM_WORLD)
     , pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(mpi_communicator)==0)
+    , active_local_time_stepping_level(-1)
+    , residual_is_current(false)
+    , residual_l2norm(0.0)
+    , residual_l2norm_is_current(false)
+    , dRdW_is_current(false)
 {
 
     dof_handler.initialize(*triangulation, fe_collection);
 
     set_all_cells_fe_degree(degree);
 
+    metric_cache_reported_MB = 0.0;
+    assembling_derivatives_with_threads = false;
+    n_volume_tapes_recorded = 0;
+    n_volume_tapes_replayed = 0;
+    n_volume_tape_branch_mismatches = 0;
+    volume_tapes_recording_time = 0.0;
+    volume_tapes_replaying_time = 0.0;
+
+    if (all_parameters->use_sum_factorization) {
+        tensor_product_operators.resize(max_degree+1);
+        for (unsigned int i_fe = 0; i_fe < fe_collection.size(); ++i_fe) {
+            const unsigned int poly_degree = fe_collection[i_fe].tensor_degree();
+            tensor_product_operators[poly_degree] = std::make_shared<TensorProductOperators<dim>>(
+                fe_collection[i_fe], oned_quadrature_collection[i_fe], face_quadrature_collection[i_fe]);
+        }
+    }
+
 }
 
 template <int dim, typename real>
@@ -230,6 +261,9 @@ DGBaseState<dim,nstate,real>::DGBaseState(
     pde_physics_rad = Physics::PhysicsFactory<dim,nstate,RadType> ::create_Physics(parameters_input);
     pde_physics_fad_fad = Physics::PhysicsFactory<dim,nstate,FadFadType> ::create_Physics(parameters_input);
     pde_physics_rad_fad = Physics::PhysicsFactory<dim,nstate,RadFadType> ::create_Physics(parameters_input);
+    if (parameters_input->reuse_jacobian_tapes) {
+        pde_physics_rad_primal = Physics::PhysicsFactory<dim,nstate,RadPrimalType> ::create_Physics(parameters_input);
+    }
 
     reset_numerical_fluxes();
 }
@@ -259,13 +293,16 @@ void DGBaseState<dim,nstate,real>::set_physics(
     std::shared_ptr< Physics::PhysicsBase<dim, nstate, FadType    > > pde_physics_fad_input,
     std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadType    > > pde_physics_rad_input,
     std::shared_ptr< Physics::PhysicsBase<dim, nstate, FadFadType > > pde_physics_fad_fad_input,
-    std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadFadType > > pde_physics_rad_fad_input)
+    std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadFadType > > pde_physics_rad_fad_input,
+    std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadPrimalType > > pde_physics_rad_primal_input)
 {
+    this->invalidate_residual();
     pde_physics_double = pde_physics_double_input;
     pde_physics_fad = pde_physics_fad_input;
     pde_physics_rad = pde_physics_rad_input;
     pde_physics_fad_fad = pde_physics_fad_fad_input;
     pde_physics_rad_fad = pde_physics_rad_fad_input;
+    pde_physics_rad_primal = pde_physics_rad_primal_input;
 
     reset_numerical_fluxes();
 }
@@ -279,11 +316,15 @@ real DGBaseState<dim,nstate,real>::evaluate_CFL (
     )
 {
     const unsigned int n_pts = soln_at_q.size();
-    std::vector< real > convective_eigenvalues(n_pts);
-    for (unsigned int isol = 0; isol < n_pts; ++isol) {
-        convective_eigenvalues[isol] = pde_physics_double->max_convective_eigenvalue (soln_at_q[isol]);
-        //viscosities[isol] = pde_physics_double->compute_diffusion_coefficient (soln_at_q[isol]);
+    std::array< std::vector<real>, nstate > soln_batch;
+    for (int istate = 0; istate < nstate; ++istate) {
+        soln_batch[istate].resize(n_pts);
+        for (unsigned int isol = 0; isol < n_pts; ++isol) {
+            soln_batch[istate][isol] = soln_at_q[isol][istate];
+        }
     }
+    std::vector< real > convective_eigenvalues;
+    pde_physics_double->max_convective_eigenvalue_batch (soln_batch, convective_eigenvalues);
     const real max_eig = *(std::max_element(convective_eigenvalues.begin(), convective_eigenvalues.end()));
 
     const real cfl_convective = cell_diameter / max_eig;
@@ -319,6 +360,43 @@ void DGBase<dim,real>::time_scale_solution_update ( dealii::LinearAlgebra::distr
     }
 }
 
+template <int dim, typename real>
+void DGBase<dim,real>::set_local_time_stepping_levels (const std::vector<unsigned int> &owned_cell_levels)
+{
+    dealii::LinearAlgebra::distributed::Vector<double> dof_levels;
+    dof_levels.reinit(solution);
+
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned()) continue;
+        dofs_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices (dofs_indices);
+        for (const auto dof_index : dofs_indices) {
+            dof_levels[dof_index] = owned_cell_levels[cell->active_cell_index()];
+        }
+    }
+    dof_levels.update_ghost_values();
+
+    local_time_stepping_levels.assign(triangulation->n_active_cells(), 0);
+    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned() && !cell->is_ghost()) continue;
+        dofs_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices (dofs_indices);
+        local_time_stepping_levels[cell->active_cell_index()] = static_cast<unsigned int>(dof_levels[dofs_indices[0]]);
+    }
+}
+
+template <int dim, typename real>
+real DGBase<dim,real>::get_global_min_max_dt_cell () const
+{
+    real min_dt = std::numeric_limits<real>::max();
+    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned()) continue;
+        min_dt = std::min(min_dt, static_cast<real>(max_dt_cell[cell->active_cell_index()]));
+    }
+    return dealii::Utilities::MPI::min(min_dt, mpi_communicator);
+}
+
 
 template <int dim, typename real>
 void DGBase<dim,real>::set_all_cells_fe_degree ( const unsigned int degree )
@@ -445,22 +523,34 @@ void DGBase<dim,real>::assemble_cell_residual (
 
     const dealii::types::global_dof_index current_cell_index = current_cell->active_cell_index();
 
-    assemble_volume_term_explicit (
-    current_cell_index,
-    fe_values_volume, current_dofs_indices, current_cell_rhs, fe_values_lagrange);
-    current_cell_rhs*=0.0;
-    //if ( compute_dRdW || compute_dRdX || compute_d2R ) {
-        assemble_volume_term_derivatives (
-            current_cell_index,
-            fe_values_volume, current_fe_ref, volume_quadrature_collection[i_quad],
-            current_metric_dofs_indices, current_dofs_indices,
-            current_cell_rhs, fe_values_lagrange,
-            compute_dRdW, compute_dRdX, compute_d2R);
-    //} else {
-    //    assemble_volume_term_explicit (
-    //    current_cell_index,
-    //    fe_values_volume, current_dofs_indices, current_cell_rhs, fe_values_lagrange);
-    //}
+    // The sum-factorized kernels only evaluate the residual.
+    // Derivatives are still obtained through automatic differentiation of the dense operators.
+    const bool use_sum_factorization = all_parameters->use_sum_factorization && !compute_dRdW && !compute_dRdX && !compute_d2R;
+
+    // With local time stepping, only the volume and face terms of the active level are evaluated.
+    const bool use_local_time_stepping = (active_local_time_stepping_level >= 0);
+    const auto get_level = [&] (const dealii::types::global_dof_index cell_index) {
+        return use_local_time_stepping ? local_time_stepping_levels[cell_index] : 0u;
+    };
+    const auto is_active_level = [&] (const unsigned int level) {
+        return !use_local_time_stepping || static_cast<int>(level) == active_local_time_stepping_level;
+    };
+    const unsigned int current_level = get_level(current_cell_index);
+
+    if (is_active_level(current_level)) {
+        assemble_volume_term_explicit (
+        current_cell_index,
+        fe_values_volume, current_dofs_indices, current_cell_rhs, fe_values_lagrange);
+        if (!use_sum_factorization) {
+            current_cell_rhs*=0.0;
+            assemble_volume_term_derivatives (
+                current_cell_index,
+                fe_values_volume, current_fe_ref, volume_quadrature_collection[i_quad],
+                current_metric_dofs_indices, current_dofs_indices,
+                current_cell_rhs, fe_values_lagrange,
+                compute_dRdW, compute_dRdX, compute_d2R);
+        }
+    }
 
 
                     //// Add local contribution from current cell to global vector
@@ -479,6 +569,8 @@ void DGBase<dim,real>::assemble_cell_residual (
         // CASE 1: FACE AT BOUNDARY
         if (current_face->at_boundary() && !current_cell->has_periodic_neighbor(iface) ) {
 
+            if (!is_active_level(current_level)) continue;
+
             fe_values_collection_face_int.reinit(current_cell, iface, i_quad, i_mapp, i_fele);
 
             const dealii::FEFaceValues<dim,dim> &fe_values_face_int = fe_values_collection_face_int.get_present_fe_values();
@@ -486,7 +578,7 @@ void DGBase<dim,real>::assemble_cell_residual (
             const real penalty = evaluate_penalty_scaling (current_cell, iface, fe_collection);
 
             const unsigned int boundary_id = current_face->boundary_id();
-            //if (compute_dRdW || compute_dRdX || compute_d2R) {
+            if (!use_sum_factorization) {
                 const dealii::Quadrature<dim-1> face_quadrature = face_quadrature_collection[i_quad];
                 assemble_boundary_term_derivatives (
                     current_cell_index,
@@ -495,11 +587,11 @@ void DGBase<dim,real>::assemble_cell_residual (
                     current_metric_dofs_indices, current_dofs_indices, current_cell_rhs,
                     compute_dRdW, compute_dRdX, compute_d2R);
 
-            //} else {
-            //    assemble_boundary_term_explicit (
-            //        current_cell_index,
-            //        boundary_id, fe_values_face_int, penalty, current_dofs_indices, current_cell_rhs);
-            //}
+            } else {
+                assemble_boundary_term_explicit (
+                    current_cell_index,
+                    boundary_id, fe_values_face_int, penalty, current_dofs_indices, current_cell_rhs);
+            }
 
         //CASE 2: PERIODIC BOUNDARY CONDITIONS
         //note that periodicity is not adapted for hp adaptivity yet. this needs to be figured out in the future
@@ -514,6 +606,8 @@ void DGBase<dim,real>::assemble_cell_residual (
 
                 Assert (current_cell->periodic_neighbor(iface).state() == dealii::IteratorState::valid, dealii::ExcInternalError());
 
+                if (!is_active_level(std::min(current_level, get_level(neighbor_cell->active_cell_index())))) continue;
+
                 const unsigned int n_dofs_neigh_cell = fe_collection[neighbor_cell->active_fe_index()].n_dofs_per_cell();
                 dealii::Vector<real> neighbor_cell_rhs (n_dofs_neigh_cell); // Defaults to 0.0 initialization
 
@@ -536,7 +630,7 @@ void DGBase<dim,real>::assemble_cell_residual (
                 const real penalty = 0.5 * (penalty1 + penalty2);
 
                 const dealii::types::global_dof_index neighbor_cell_index = neighbor_cell->active_cell_index();
-                //if ( compute_dRdW || compute_dRdX || compute_d2R ) {
+                if (!use_sum_factorization) {
                     const auto metric_neighbor_cell = current_metric_cell->periodic_neighbor(iface);
                     metric_neighbor_cell->get_dof_indices(neighbor_metric_dofs_indices);
                     const dealii::Quadrature<dim-1> &used_face_quadrature = face_quadrature_collection[i_quad_n]; // or i_quad
@@ -571,15 +665,15 @@ void DGBase<dim,real>::assemble_cell_residual (
                         current_dofs_indices, neighbor_dofs_indices,
                         current_cell_rhs, neighbor_cell_rhs,
                         compute_dRdW, compute_dRdX, compute_d2R);
-                //} else {
-                //    assemble_face_term_explicit (
-                //        current_cell_index,
-                //        neighbor_cell_index,
-                //        fe_values_face_int, fe_values_face_ext,
-                //        penalty,
-                //        current_dofs_indices, neighbor_dofs_indices,
-                //        current_cell_rhs, neighbor_cell_rhs);
-                //}
+                } else {
+                    assemble_face_term_explicit (
+                        current_cell_index,
+                        neighbor_cell_index,
+                        fe_values_face_int, fe_values_face_ext,
+                        penalty,
+                        current_dofs_indices, neighbor_dofs_indices,
+                        current_cell_rhs, neighbor_cell_rhs);
+                }
 
                 // Add local contribution from neighbor cell to global vector
                 for (unsigned int i=0; i<n_dofs_neigh_cell; ++i) {
@@ -607,6 +701,8 @@ void DGBase<dim,real>::assemble_cell_residual (
             const auto neighbor_cell = current_cell->neighbor(iface);
             const unsigned int neighbor_iface = current_cell->neighbor_face_no(iface);
 
+            if (!is_active_level(std::min(current_level, get_level(neighbor_cell->active_cell_index())))) continue;
+
             // Find corresponding subface
             unsigned int neighbor_i_subface = 0;
             unsigned int n_subface = dealii::GeometryInfo<dim>::n_subfaces(neighbor_cell->subface_case(neighbor_iface));
@@ -638,7 +734,7 @@ void DGBase<dim,real>::assemble_cell_residual (
             const real penalty = 0.5 * (penalty1 + penalty2);
 
             const dealii::types::global_dof_index neighbor_cell_index = neighbor_cell->active_cell_index();
-            //if ( compute_dRdW || compute_dRdX || compute_d2R ) {
+            if (!use_sum_factorization) {
                 const auto metric_neighbor_cell = current_metric_cell->neighbor(iface);
                 metric_neighbor_cell->get_dof_indices(neighbor_metric_dofs_indices);
 
@@ -676,15 +772,15 @@ void DGBase<dim,real>::assemble_cell_residual (
                     current_dofs_indices, neighbor_dofs_indices,
                     current_cell_rhs, neighbor_cell_rhs,
                     compute_dRdW, compute_dRdX, compute_d2R);
-            //} else {
-            //    assemble_face_term_explicit (
-            //        current_cell_index,
-            //        neighbor_cell_index,
-            //        fe_values_face_int, fe_values_face_ext,
-            //        penalty,
-            //        current_dofs_indices, neighbor_dofs_indices,
-            //        current_cell_rhs, neighbor_cell_rhs);
-            //}
+            } else {
+                assemble_face_term_explicit (
+                    current_cell_index,
+                    neighbor_cell_index,
+                    fe_values_face_int, fe_values_face_ext,
+                    penalty,
+                    current_dofs_indices, neighbor_dofs_indices,
+                    current_cell_rhs, neighbor_cell_rhs);
+            }
             // Add local contribution from neighbor cell to global vector
             for (unsigned int i=0; i<n_dofs_neigh_cell; ++i) {
                 rhs[neighbor_dofs_indices[i]] += neighbor_cell_rhs[i];
@@ -699,6 +795,8 @@ void DGBase<dim,real>::assemble_cell_residual (
             // e.g. The 4th face of the current cell might correspond to the 3rd face of the neighbor
             const unsigned int neighbor_iface = current_cell->neighbor_of_neighbor(iface);
 
+            if (!is_active_level(std::min(current_level, get_level(neighbor_cell->active_cell_index())))) continue;
+
             // Get information about neighbor cell
             const unsigned int n_dofs_neigh_cell = fe_collection[neighbor_cell->active_fe_index()].n_dofs_per_cell();
 
@@ -721,7 +819,7 @@ void DGBase<dim,real>::assemble_cell_residual (
             const real penalty = 0.5 * (penalty1 + penalty2);
 
             const dealii::types::global_dof_index neighbor_cell_index = neighbor_cell->active_cell_index();
-            //if ( compute_dRdW || compute_dRdX || compute_d2R ) {
+            if (!use_sum_factorization) {
                 const auto metric_neighbor_cell = current_metric_cell->neighbor_or_periodic_neighbor(iface);
                 metric_neighbor_cell->get_dof_indices(neighbor_metric_dofs_indices);
                 const dealii::Quadrature<dim-1> &used_face_quadrature = face_quadrature_collection[i_quad_n]; // or i_quad
@@ -755,15 +853,15 @@ void DGBase<dim,real>::assemble_cell_residual (
                     current_dofs_indices, neighbor_dofs_indices,
                     current_cell_rhs, neighbor_cell_rhs,
                     compute_dRdW, compute_dRdX, compute_d2R);
-            //} else {
-            //    assemble_face_term_explicit (
-            //        current_cell_index,
-            //        neighbor_cell_index,
-            //        fe_values_face_int, fe_values_face_ext,
-            //        penalty,
-            //        current_dofs_indices, neighbor_dofs_indices,
-            //        current_cell_rhs, neighbor_cell_rhs);
-            //}
+            } else {
+                assemble_face_term_explicit (
+                    current_cell_index,
+                    neighbor_cell_index,
+                    fe_values_face_int, fe_values_face_ext,
+                    penalty,
+                    current_dofs_indices, neighbor_dofs_indices,
+                    current_cell_rhs, neighbor_cell_rhs);
+            }
 
             // Add local contribution from neighbor cell to global vector
             for (unsigned int i=0; i<n_dofs_neigh_cell; ++i) {
@@ -906,6 +1004,89 @@ void DGBase<dim,real>::update_artificial_dissipation_discontinuity_sensor()
 }
 
 
+/// FEValues owned by each thread of the thread-parallel residual assembly.
+template <int dim>
+struct AssemblyScratchData
+{
+    /// Constructor.
+    AssemblyScratchData(
+        const dealii::hp::MappingCollection<dim> &mapping_collection,
+        const dealii::hp::FECollection<dim>      &fe_collection,
+        const dealii::hp::FECollection<dim>      &fe_collection_lagrange,
+        const dealii::hp::QCollection<dim>       &volume_quadrature_collection,
+        const dealii::hp::QCollection<dim-1>     &face_quadrature_collection,
+        const dealii::UpdateFlags volume_update_flags,
+        const dealii::UpdateFlags face_update_flags,
+        const dealii::UpdateFlags neighbor_face_update_flags)
+        : fe_values_volume (mapping_collection, fe_collection, volume_quadrature_collection, volume_update_flags)
+        , fe_values_face_int (mapping_collection, fe_collection, face_quadrature_collection, face_update_flags)
+        , fe_values_face_ext (mapping_collection, fe_collection, face_quadrature_collection, neighbor_face_update_flags)
+        , fe_values_subface (mapping_collection, fe_collection, face_quadrature_collection, face_update_flags)
+        , fe_values_volume_lagrange (mapping_collection, fe_collection_lagrange, volume_quadrature_collection, volume_update_flags)
+    { }
+
+    /// Copy constructor used by dealii::WorkStream to create the scratch data of each thread.
+    /** The FEValues are constructed anew since they hold internal mapping data that can't be shared.
+     */
+    AssemblyScratchData(const AssemblyScratchData<dim> &other)
+        : AssemblyScratchData(
+            other.fe_values_volume.get_mapping_collection(),
+            other.fe_values_volume.get_fe_collection(),
+            other.fe_values_volume_lagrange.get_fe_collection(),
+            other.fe_values_volume.get_quadrature_collection(),
+            other.fe_values_face_int.get_quadrature_collection(),
+            other.fe_values_volume.get_update_flags(),
+            other.fe_values_face_int.get_update_flags(),
+            other.fe_values_face_ext.get_update_flags())
+    { }
+
+    dealii::hp::FEValues<dim,dim>        fe_values_volume; ///< FEValues of volume.
+    dealii::hp::FEFaceValues<dim,dim>    fe_values_face_int; ///< FEValues of interior face.
+    dealii::hp::FEFaceValues<dim,dim>    fe_values_face_ext; ///< FEValues of exterior face.
+    dealii::hp::FESubfaceValues<dim,dim> fe_values_subface; ///< FEValues of subface.
+    dealii::hp::FEValues<dim,dim>        fe_values_volume_lagrange; ///< FEValues of the Lagrange basis used by the strong form.
+};
+
+/// Rows of the derivative matrices computed by a thread for one cell.
+/** The residual itself is not copied since cells of the same color write to different degrees of freedom.
+ */
+template <int dim, typename real>
+struct AssemblyCopyData
+{
+    std::vector<typename DGBase<dim,real>::MatrixRow> matrix_rows; ///< Rows added to the matrices by the copier.
+};
+
+template <int dim, typename real>
+void DGBase<dim,real>::color_cells_for_assembly ()
+{
+    // A cell writes into its own residual and into the residual of its face neighbors.
+    // Two cells can therefore be assembled concurrently if those sets do not intersect.
+    const auto get_conflict_indices = [&] (const typename dealii::DoFHandler<dim>::active_cell_iterator &cell)
+    {
+        std::vector<dealii::types::global_dof_index> conflict_indices;
+        if (!cell->is_locally_owned()) return conflict_indices;
+
+        conflict_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices(conflict_indices);
+
+        std::vector<dealii::types::global_dof_index> neighbor_dofs_indices;
+        for (unsigned int iface=0; iface < dealii::GeometryInfo<dim>::faces_per_cell; ++iface) {
+            if (cell->at_boundary(iface) && !cell->has_periodic_neighbor(iface)) continue;
+            const auto neighbor_cell = cell->neighbor_or_periodic_neighbor(iface);
+            // The finer neighbors are responsible for the face.
+            if (neighbor_cell->has_children()) continue;
+            neighbor_dofs_indices.resize(neighbor_cell->get_fe().n_dofs_per_cell());
+            neighbor_cell->get_dof_indices(neighbor_dofs_indices);
+            conflict_indices.insert(conflict_indices.end(), neighbor_dofs_indices.begin(), neighbor_dofs_indices.end());
+        }
+        return conflict_indices;
+    };
+
+    assembly_cell_colors = dealii::GraphColoring::make_graph_coloring(
+        dof_handler.begin_active(), dof_handler.end(),
+        std::function<std::vector<dealii::types::global_dof_index>(const typename dealii::DoFHandler<dim>::active_cell_iterator &)>(get_conflict_indices));
+}
+
 template <int dim, typename real>
 void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R, const double CFL_mass)
 {
@@ -915,6 +1096,26 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
         &&  !(compute_dRdX && compute_d2R)
             , dealii::ExcMessage("Can only do one at a time compute_dRdW or compute_dRdX or compute_d2R"));
 
+    // The right_hand_side is always assembled along with its derivatives.
+    // Therefore, only a lone residual assembly can be skipped.
+    const bool compute_residual_only = !compute_dRdW && !compute_dRdX && !compute_d2R;
+    if (compute_residual_only && residual_is_current && active_local_time_stepping_level < 0) {
+        auto diff_sol = solution;
+        diff_sol -= solution_residual;
+        const double l2_norm_sol = diff_sol.l2_norm();
+
+        if (l2_norm_sol == 0.0) {
+
+            auto diff_node = high_order_grid.volume_nodes;
+            diff_node -= volume_nodes_residual;
+            const double l2_norm_node = diff_node.l2_norm();
+
+            if (l2_norm_node == 0.0) {
+                return;
+            }
+        }
+    }
+
     //pcout << "Assembling DG residual...";
     if (compute_dRdW) {
         pcout << " with dRdW...";
@@ -923,7 +1124,7 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
         diff_sol -= solution_dRdW;
         const double l2_norm_sol = diff_sol.l2_norm();
 
-        if (l2_norm_sol == 0.0) {
+        if (dRdW_is_current && l2_norm_sol == 0.0) {
 
             auto diff_node = high_order_grid.volume_nodes;
             diff_node -= volume_nodes_dRdW;
@@ -942,8 +1143,13 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
         }
         solution_dRdW = solution;
         volume_nodes_dRdW = high_order_grid.volume_nodes;
+        dRdW_is_current = true;
 
-        system_matrix = 0;
+        if (all_parameters->use_block_sparse_system_matrix) {
+            block_system_matrix = 0;
+        } else {
+            system_matrix = 0;
+        }
     }
     if (compute_dRdX) {
         pcout << " with dRdX...";
@@ -1012,6 +1218,19 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
     }
     right_hand_side = 0;
 
+    if (all_parameters->use_metric_cache) {
+        bool grid_changed = true;
+        if (metric_cache.is_initialized() && volume_nodes_metric_cache.size() == high_order_grid.volume_nodes.size()) {
+            auto diff_node = high_order_grid.volume_nodes;
+            diff_node -= volume_nodes_metric_cache;
+            grid_changed = (diff_node.l2_norm() != 0.0);
+        }
+        if (grid_changed) {
+            metric_cache.reinit(triangulation->n_active_cells());
+            volume_nodes_metric_cache = high_order_grid.volume_nodes;
+        }
+    }
+
     //pcout << std::endl;
 
     //const dealii::MappingManifold<dim,dim> mapping;
@@ -1031,39 +1250,101 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
 
     solution.update_ghost_values();
 
+    // The derivatives are differentiated with tapeless Sacado types by each thread,
+    // and their rows are added to the Trilinos matrices by one thread at a time.
+    const bool use_threads = (dealii::MultithreadInfo::n_threads() > 1);
+
     int assembly_error = 0;
     try {
 
         update_artificial_dissipation_discontinuity_sensor();
 
-        auto metric_cell = high_order_grid.dof_handler_grid.begin_active();
-        for (auto soln_cell = dof_handler.begin_active(); soln_cell != dof_handler.end(); ++soln_cell, ++metric_cell) {
-        //for (auto cell = triangulation->begin_active(); cell != triangulation->end(); ++cell) {
-            if (!soln_cell->is_locally_owned()) continue;
-
-            //const int tria_level = cell->level();
-            //const int tria_index = cell->index();
-            //dealii::DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
-            //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid.dof_handler_grid);
-
-            //dealii::TriaActiveIterator< dealii::DoFCellAccessor<dim,dim,false> >
-
-            //DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
-            //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid.dof_handler_grid);
-
-
-            // Add right-hand side contributions this cell can compute
-            assemble_cell_residual (
-                soln_cell,
-                metric_cell,
-                compute_dRdW, compute_dRdX, compute_d2R,
-                fe_values_collection_volume,
-                fe_values_collection_face_int,
-                fe_values_collection_face_ext,
-                fe_values_collection_subface,
-                fe_values_collection_volume_lagrange,
-                right_hand_side);
-        } // end of cell loop
+        if (use_threads) {
+            if (assembly_cell_colors.empty()) color_cells_for_assembly();
+
+            std::atomic<int> thread_assembly_error(0);
+            const AssemblyScratchData<dim> sample_scratch_data(
+                mapping_collection, fe_collection, fe_collection_lagrange,
+                volume_quadrature_collection, face_quadrature_collection,
+                this->volume_update_flags, this->face_update_flags, this->neighbor_face_update_flags);
+
+            using CellIterator = typename std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>::const_iterator;
+
+            // Cells of the same color do not share degrees of freedom. The worker can therefore
+            // add its contributions directly into the right-hand side.
+            const auto worker = [&] (
+                const CellIterator &cell_iterator,
+                AssemblyScratchData<dim> &scratch_data,
+                AssemblyCopyData<dim,real> &copy_data)
+            {
+                const typename dealii::DoFHandler<dim>::active_cell_iterator &soln_cell = *cell_iterator;
+                copy_data.matrix_rows.clear();
+                if (!soln_cell->is_locally_owned()) return;
+                const typename dealii::DoFHandler<dim>::active_cell_iterator metric_cell (
+                    triangulation.get(), soln_cell->level(), soln_cell->index(), &high_order_grid.dof_handler_grid);
+
+                std::vector<MatrixRow> &matrix_rows = thread_matrix_rows.get();
+                matrix_rows.clear();
+                try {
+                    assemble_cell_residual (
+                        soln_cell,
+                        metric_cell,
+                        compute_dRdW, compute_dRdX, compute_d2R,
+                        scratch_data.fe_values_volume,
+                        scratch_data.fe_values_face_int,
+                        scratch_data.fe_values_face_ext,
+                        scratch_data.fe_values_subface,
+                        scratch_data.fe_values_volume_lagrange,
+                        right_hand_side);
+                } catch(...) {
+                    thread_assembly_error = 1;
+                }
+                copy_data.matrix_rows.swap(matrix_rows);
+            };
+            // Contrary to the worker, the copier of WorkStream::run() is called by one thread at a time,
+            // in the order of the cells of the color.
+            const auto copier = [&] (const AssemblyCopyData<dim,real> &copy_data) {
+                add_matrix_rows(copy_data.matrix_rows);
+            };
+
+            assembling_derivatives_with_threads = (compute_dRdW || compute_dRdX || compute_d2R);
+            for (const auto &color : assembly_cell_colors) {
+                dealii::WorkStream::run(color.cbegin(), color.cend(), worker, copier, sample_scratch_data, AssemblyCopyData<dim,real>());
+            }
+            assembling_derivatives_with_threads = false;
+
+            assembly_error = thread_assembly_error;
+        } else {
+
+            auto metric_cell = high_order_grid.dof_handler_grid.begin_active();
+            for (auto soln_cell = dof_handler.begin_active(); soln_cell != dof_handler.end(); ++soln_cell, ++metric_cell) {
+            //for (auto cell = triangulation->begin_active(); cell != triangulation->end(); ++cell) {
+                if (!soln_cell->is_locally_owned()) continue;
+
+                //const int tria_level = cell->level();
+                //const int tria_index = cell->index();
+                //dealii::DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
+                //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid.dof_handler_grid);
+
+                //dealii::TriaActiveIterator< dealii::DoFCellAccessor<dim,dim,false> >
+
+                //DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
+                //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid.dof_handler_grid);
+
+
+                // Add right-hand side contributions this cell can compute
+                assemble_cell_residual (
+                    soln_cell,
+                    metric_cell,
+                    compute_dRdW, compute_dRdX, compute_d2R,
+                    fe_values_collection_volume,
+                    fe_values_collection_face_int,
+                    fe_values_collection_face_ext,
+                    fe_values_collection_subface,
+                    fe_values_collection_volume_lagrange,
+                    right_hand_side);
+            } // end of cell loop
+        }
     } catch(...) {
         assembly_error = 1;
     }
@@ -1078,7 +1359,12 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
             std::cout << " Filling up Jacobian with mass matrix. " << std::endl;
             const bool do_inverse_mass_matrix = false;
             evaluate_mass_matrices (do_inverse_mass_matrix);
-            system_matrix.copy_from(global_mass_matrix);
+            if (all_parameters->use_block_sparse_system_matrix) {
+                block_system_matrix = 0;
+                block_system_matrix.add(1.0, global_mass_matrix);
+            } else {
+                system_matrix.copy_from(global_mass_matrix);
+            }
         }
         //if (compute_dRdX) {
         //    dRdXv.trilinos_matrix().
@@ -1091,22 +1377,46 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
     }
 
     right_hand_side.compress(dealii::VectorOperation::add);
+
+    if (all_parameters->use_metric_cache) {
+        // The cache is filled by the first assembly evaluating the metric terms with doubles.
+        const double metric_cache_MB = dealii::Utilities::MPI::sum(metric_cache.memory_consumption() / (1024.0*1024.0), mpi_communicator);
+        if (metric_cache_MB != metric_cache_reported_MB) {
+            pcout << "Metric cache of " << triangulation->n_global_active_cells() << " cells using "
+                  << metric_cache_MB << " MB." << std::endl;
+            metric_cache_reported_MB = metric_cache_MB;
+        }
+    }
+
+    // Partial residuals of local time stepping and invalid assemblies are not reused.
+    residual_l2norm_is_current = false;
+    residual_is_current = (mpi_assembly_error == 0 && active_local_time_stepping_level < 0);
+    if (residual_is_current) {
+        solution_residual = solution;
+        volume_nodes_residual = high_order_grid.volume_nodes;
+    }
+
     if ( compute_dRdW ) {
-        system_matrix.compress(dealii::VectorOperation::add);
+        if (all_parameters->use_block_sparse_system_matrix) {
+            block_system_matrix.compress();
+        } else {
+            system_matrix.compress(dealii::VectorOperation::add);
+        }
+
+        if (all_parameters->reuse_jacobian_tapes) {
+            pcout << "Volume tapes recorded: " << dealii::Utilities::MPI::sum(n_volume_tapes_recorded, mpi_communicator)
+                  << " in " << dealii::Utilities::MPI::max(volume_tapes_recording_time, mpi_communicator) << "s, "
+                  << "replayed: " << dealii::Utilities::MPI::sum(n_volume_tapes_replayed, mpi_communicator)
+                  << " in " << dealii::Utilities::MPI::max(volume_tapes_replaying_time, mpi_communicator) << "s, "
+                  << "re-recorded after a branch mismatch: " << dealii::Utilities::MPI::sum(n_volume_tape_branch_mismatches, mpi_communicator) << "."
+                  << std::endl;
+        }
 
         if (CFL_mass != 0.0) {
             time_scaled_mass_matrices(CFL_mass);
             add_time_scaled_mass_matrices();
         }
 
-        Epetra_CrsMatrix *input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-        Epetra_CrsMatrix *output_matrix;
-        epetra_rowmatrixtransposer_dRdW = std::make_unique<Epetra_RowMatrixTransposer> ( input_matrix );
-        const bool make_data_contiguous = true;
-        epetra_rowmatrixtransposer_dRdW->CreateTranspose( make_data_contiguous, output_matrix);
-        system_matrix_transpose.reinit(*output_matrix);
-        delete(output_matrix);
-
 
         //double condition_estimate;
         //dRdW_preconditioner_builder.ConstructPreconditioner(condition_estimate);
@@ -1170,9 +1480,24 @@ double DGBase<dim,real>::get_residual_linfnorm () const
 }
 
 
+template <int dim, typename real>
+void DGBase<dim,real>::invalidate_residual ()
+{
+    residual_is_current = false;
+    residual_l2norm_is_current = false;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::invalidate_dRdW ()
+{
+    dRdW_is_current = false;
+}
+
 template <int dim, typename real>
 double DGBase<dim,real>::get_residual_l2norm () const
 {
+    if (residual_l2norm_is_current) return residual_l2norm;
+
     //return get_residual_linfnorm ();
     //return right_hand_side.l2_norm();
     //return right_hand_side.l2_norm() / right_hand_side.size();
@@ -1223,7 +1548,9 @@ double DGBase<dim,real>::get_residual_l2norm () const
     }
     const double mpi_residual_l2_norm = dealii::Utilities::MPI::sum(residual_l2_norm, mpi_communicator);
     const double mpi_domain_volume    = dealii::Utilities::MPI::sum(domain_volume, mpi_communicator);
-    return std::sqrt(mpi_residual_l2_norm) / mpi_domain_volume;
+    residual_l2norm = std::sqrt(mpi_residual_l2_norm) / mpi_domain_volume;
+    residual_l2norm_is_current = true;
+    return residual_l2norm;
 }
 template <int dim, typename real>
 unsigned int DGBase<dim,real>::n_dofs () const
@@ -1341,6 +1668,10 @@ void DGBase<dim,real>::allocate_system ()
 
     dof_handler.distribute_dofs(fe_collection);
     dealii::DoFRenumbering::Cuthill_McKee(dof_handler,true);
+    assembly_cell_colors.clear();
+    metric_cache.clear();
+    invalidate_residual();
+    volume_nodes_metric_cache.reinit(0);
 
     //dealii::MappingFEField<dim,dim,dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<dim>> mapping = high_order_grid.get_MappingFEField();
     //dealii::MappingFEField<dim,dim,dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<dim>> mapping = *(high_order_grid.mapping_fe_field);
@@ -1378,22 +1709,48 @@ void DGBase<dim,real>::allocate_system ()
     dual.reinit(locally_owned_dofs, ghost_dofs, mpi_communicator);
 
     // System matrix allocation
-    dealii::DynamicSparsityPattern dsp(locally_relevant_dofs);
-    dealii::DoFTools::make_flux_sparsity_pattern(dof_handler, dsp);
-    dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_relevant_dofs);
-
-    sparsity_pattern.copy_from(dsp);
+    block_diagonal_system_matrix = all_parameters->ode_solver_param.jacobian_free_newton_krylov;
+    if (all_parameters->use_block_sparse_system_matrix) {
+        std::vector<typename dealii::DoFHandler<dim>::cell_iterator> cells;
+        std::vector<std::vector<unsigned int>> block_pattern;
+        make_block_sparsity_pattern(block_diagonal_system_matrix, cells, block_pattern);
+
+        std::vector<std::vector<dealii::types::global_dof_index>> cell_dofs(cells.size());
+        std::vector<unsigned int> cell_owners(cells.size());
+        for (unsigned int icell = 0; icell < cells.size(); ++icell) {
+            cell_dofs[icell].resize(cells[icell]->get_fe().n_dofs_per_cell());
+            cells[icell]->get_dof_indices(cell_dofs[icell]);
+            cell_owners[icell] = cells[icell]->subdomain_id();
+        }
+        block_system_matrix.reinit(locally_owned_dofs, locally_relevant_dofs, cell_dofs, cell_owners, block_pattern, mpi_communicator);
+        system_matrix.clear();
+    } else {
+        dealii::DynamicSparsityPattern dsp(locally_relevant_dofs);
+        if (block_diagonal_system_matrix) {
+            // Only the coupling within each cell is stored.
+            std::vector<dealii::types::global_dof_index> dofs_indices;
+            for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+
+                if (!cell->is_locally_owned()) continue;
+
+                const unsigned int n_dofs_cell = fe_collection[cell->active_fe_index()].n_dofs_per_cell();
+                dofs_indices.resize(n_dofs_cell);
+                cell->get_dof_indices (dofs_indices);
+                for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
+                    for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
+                        dsp.add(dofs_indices[itest], dofs_indices[itrial]);
+                    }
+                }
+            }
+        } else {
+            dealii::DoFTools::make_flux_sparsity_pattern(dof_handler, dsp);
+        }
+        dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_relevant_dofs);
 
-    system_matrix.reinit(locally_owned_dofs, sparsity_pattern, mpi_communicator);
+        sparsity_pattern.copy_from(dsp);
 
-    // system_matrix_transpose.reinit(system_matrix);
-    // Epetra_CrsMatrix *input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-    // Epetra_CrsMatrix *output_matrix;
-    // epetra_rowmatrixtransposer_dRdW = std::make_unique<Epetra_RowMatrixTransposer> ( input_matrix );
-    // const bool make_data_contiguous = true;
-    // epetra_rowmatrixtransposer_dRdW->CreateTranspose( make_data_contiguous, output_matrix);
-    // system_matrix_transpose.reinit(*output_matrix);
-    // delete(output_matrix);
+        system_matrix.reinit(locally_owned_dofs, sparsity_pattern, mpi_communicator);
+    }
 
     // {
     //     dRdW_preconditioner_builder.SetUserMatrix(const_cast<Epetra_CrsMatrix *>(&system_matrix.trilinos_matrix()));
@@ -1425,7 +1782,6 @@ void DGBase<dim,real>::allocate_system ()
     // Make sure that derivatives are cleared when reallocating DG objects.
     // The call to assemble the derivatives will reallocate those derivatives
     // if they are ever needed.
-    system_matrix_transpose.clear();
     dRdXv.clear();
     d2RdWdX.clear();
     d2RdWdW.clear();
@@ -1435,6 +1791,7 @@ void DGBase<dim,real>::allocate_system ()
     solution_dRdW *= 0.0;
     volume_nodes_dRdW.reinit(high_order_grid.volume_nodes);
     volume_nodes_dRdW *= 0.0;
+    dRdW_is_current = false;
 
     solution_dRdX.reinit(solution);
     solution_dRdX *= 0.0;
@@ -1449,6 +1806,125 @@ void DGBase<dim,real>::allocate_system ()
     dual_d2R *= 0.0;
 }
 
+template <int dim, typename real>
+void DGBase<dim,real>::make_block_sparsity_pattern (
+    const bool block_diagonal,
+    std::vector<typename dealii::DoFHandler<dim>::cell_iterator> &cells,
+    std::vector<std::vector<unsigned int>> &block_pattern) const
+{
+    // The cells are numbered with the locally owned cells first, followed by the ghost cells.
+    cells.clear();
+    block_pattern.clear();
+    std::vector<int> cell_numbering(triangulation->n_active_cells(), -1);
+    const auto number_cell = [&](const typename dealii::DoFHandler<dim>::cell_iterator &cell) {
+        int &icell = cell_numbering[cell->active_cell_index()];
+        if (icell < 0) {
+            icell = cells.size();
+            cells.push_back(cell);
+            block_pattern.emplace_back();
+        }
+        return static_cast<unsigned int>(icell);
+    };
+    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+        if (cell->is_locally_owned()) number_cell(cell);
+    }
+    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned()) continue;
+        const unsigned int icell = number_cell(cell);
+        block_pattern[icell].push_back(icell);
+
+        std::vector<typename dealii::DoFHandler<dim>::cell_iterator> neighbors;
+        for (unsigned int iface=0; iface < dealii::GeometryInfo<dim>::faces_per_cell; ++iface) {
+            if (cell->has_periodic_neighbor(iface)) {
+                neighbors.push_back(cell->periodic_neighbor(iface));
+            } else if (cell->at_boundary(iface)) {
+                continue;
+            } else if (dim > 1 && cell->face(iface)->has_children()) {
+                for (unsigned int isubface=0; isubface < cell->face(iface)->n_children(); ++isubface) {
+                    neighbors.push_back(cell->neighbor_child_on_subface(iface, isubface));
+                }
+            } else {
+                auto neighbor = cell->neighbor(iface);
+                // In 1D, the face does not have children when the neighbour is refined.
+                while (neighbor->has_children()) neighbor = neighbor->child(1-iface);
+                neighbors.push_back(neighbor);
+            }
+        }
+        for (const auto &neighbor : neighbors) {
+            const unsigned int ineighbor = number_cell(neighbor);
+            if (!block_diagonal) block_pattern[icell].push_back(ineighbor);
+            // This processor assembles the faces shared with ghost cells of higher subdomain id,
+            // see current_cell_should_do_the_work().
+            if (neighbor->is_ghost() && cell->subdomain_id() < neighbor->subdomain_id()) {
+                block_pattern[ineighbor].push_back(ineighbor);
+                if (!block_diagonal) block_pattern[ineighbor].push_back(icell);
+            }
+        }
+    }
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::setup_p_multigrid (PMultigridPreconditioner &p_multigrid) const
+{
+    p_multigrid.clear();
+
+    const bool block_diagonal = false;
+    std::vector<typename dealii::DoFHandler<dim>::cell_iterator> cells;
+    std::vector<std::vector<unsigned int>> block_pattern;
+    make_block_sparsity_pattern(block_diagonal, cells, block_pattern);
+    const unsigned int n_cells = cells.size();
+
+    // Finest level.
+    std::vector<std::vector<dealii::types::global_dof_index>> cell_dofs(n_cells);
+    std::vector<unsigned int> cell_owners(n_cells);
+    std::vector<unsigned int> cell_fe_index(n_cells);
+    unsigned int max_fe_index = 0;
+    for (unsigned int icell = 0; icell < n_cells; ++icell) {
+        cell_dofs[icell].resize(cells[icell]->get_fe().n_dofs_per_cell());
+        cells[icell]->get_dof_indices(cell_dofs[icell]);
+        cell_owners[icell] = cells[icell]->subdomain_id();
+        cell_fe_index[icell] = cells[icell]->active_fe_index();
+        max_fe_index = std::max(max_fe_index, cell_fe_index[icell]);
+    }
+    max_fe_index = dealii::Utilities::MPI::max(max_fe_index, mpi_communicator);
+    p_multigrid.add_level(locally_owned_dofs, locally_relevant_dofs, cell_dofs, cell_owners, block_pattern, {}, {}, mpi_communicator);
+
+    // Interpolation from each finite element to the next one of the fe_collection.
+    std::vector<dealii::FullMatrix<double>> prolongation_matrices(max_fe_index);
+    for (unsigned int i_fe = 0; i_fe < max_fe_index; ++i_fe) {
+        prolongation_matrices[i_fe].reinit(fe_collection[i_fe+1].n_dofs_per_cell(), fe_collection[i_fe].n_dofs_per_cell());
+        dealii::FETools::get_interpolation_matrix(fe_collection[i_fe], fe_collection[i_fe+1], prolongation_matrices[i_fe]);
+    }
+
+    std::vector<unsigned int> cell_prolongation(n_cells);
+    for (unsigned int level_fe_index = max_fe_index; level_fe_index-- > 0;) {
+        dealii::DoFHandler<dim> level_dof_handler(*triangulation);
+        for (const auto &cell : level_dof_handler.active_cell_iterators()) {
+            if (!cell->is_locally_owned()) continue;
+            const typename dealii::DoFHandler<dim>::active_cell_iterator fine_cell (
+                triangulation.get(), cell->level(), cell->index(), &dof_handler);
+            cell->set_active_fe_index(std::min<unsigned int>(fine_cell->active_fe_index(), level_fe_index));
+        }
+        level_dof_handler.distribute_dofs(fe_collection);
+
+        dealii::IndexSet level_locally_relevant_dofs;
+        dealii::DoFTools::extract_locally_relevant_dofs(level_dof_handler, level_locally_relevant_dofs);
+
+        for (unsigned int icell = 0; icell < n_cells; ++icell) {
+            const typename dealii::DoFHandler<dim>::active_cell_iterator level_cell (
+                triangulation.get(), cells[icell]->level(), cells[icell]->index(), &level_dof_handler);
+            const unsigned int fe_index = level_cell->active_fe_index();
+            cell_prolongation[icell] = (fe_index == cell_fe_index[icell]) ? dealii::numbers::invalid_unsigned_int : fe_index;
+            cell_fe_index[icell] = fe_index;
+            cell_dofs[icell].resize(fe_collection[fe_index].n_dofs_per_cell());
+            level_cell->get_dof_indices(cell_dofs[icell]);
+        }
+        p_multigrid.add_level(level_dof_handler.locally_owned_dofs(), level_locally_relevant_dofs,
+                              cell_dofs, cell_owners, block_pattern,
+                              prolongation_matrices, cell_prolongation, mpi_communicator);
+    }
+}
+
 template <int dim, typename real>
 void DGBase<dim,real>::allocate_second_derivatives ()
 {
@@ -1488,36 +1964,38 @@ void DGBase<dim,real>::allocate_dRdX ()
 template <int dim, typename real>
 void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 {
-    // Mass matrix sparsity pattern
-    //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
-    //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
-    //dealii::DynamicSparsityPattern dsp(dof_handler.n_locally_owned_dofs(), dof_handler.n_locally_owned_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
-    dealii::DynamicSparsityPattern dsp(dof_handler.n_dofs());
     std::vector<dealii::types::global_dof_index> dofs_indices;
-    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
-
-        if (!cell->is_locally_owned()) continue;
-
-        const unsigned int fe_index_curr_cell = cell->active_fe_index();
-
-        // Current reference element related to this physical cell
-        const dealii::FESystem<dim,dim> &current_fe_ref = fe_collection[fe_index_curr_cell];
-        const unsigned int n_dofs_cell = current_fe_ref.n_dofs_per_cell();
-
-        dofs_indices.resize(n_dofs_cell);
-        cell->get_dof_indices (dofs_indices);
-        for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
-            for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
-                dsp.add(dofs_indices[itest], dofs_indices[itrial]);
-            }
-        }
-    }
-    dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_owned_dofs);
-    mass_sparsity_pattern.copy_from(dsp);
     if (do_inverse_mass_matrix == true) {
-        global_inverse_mass_matrix.reinit(locally_owned_dofs, mass_sparsity_pattern);
+        inverse_mass_operator.clear();
     } else {
+        // Mass matrix sparsity pattern
+        //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
+        //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
+        //dealii::DynamicSparsityPattern dsp(dof_handler.n_locally_owned_dofs(), dof_handler.n_locally_owned_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
+        dealii::DynamicSparsityPattern dsp(dof_handler.n_dofs());
+        for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+
+            if (!cell->is_locally_owned()) continue;
+
+            const unsigned int fe_index_curr_cell = cell->active_fe_index();
+
+            // Current reference element related to this physical cell
+            const dealii::FESystem<dim,dim> &current_fe_ref = fe_collection[fe_index_curr_cell];
+            const unsigned int n_dofs_cell = current_fe_ref.n_dofs_per_cell();
+
+            dofs_indices.resize(n_dofs_cell);
+            cell->get_dof_indices (dofs_indices);
+            for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
+                for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
+                    dsp.add(dofs_indices[itest], dofs_indices[itrial]);
+                }
+            }
+        }
+        dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_owned_dofs);
+        mass_sparsity_pattern.copy_from(dsp);
         global_mass_matrix.reinit(locally_owned_dofs, mass_sparsity_pattern);
+        cell_mass_matrices.clear();
+        cell_mass_matrices.resize(triangulation->n_active_cells());
     }
 
     //dealii::TrilinosWrappers::SparseMatrix
@@ -1526,11 +2004,7 @@ void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
     //            dof_handler.get_fe_collection().max_dofs_per_cell());
     //pcout << "Before compress" << std::endl;
     //matrix_with_correct_size.compress(dealii::VectorOperation::unknown);
-    //if (do_inverse_mass_matrix == true) {
-    //    global_inverse_mass_matrix.reinit(matrix_with_correct_size);
-    //} else {
-    //    global_mass_matrix.reinit(matrix_with_correct_size);
-    //}
+    //global_mass_matrix.reinit(matrix_with_correct_size);
     //pcout << "AFter reinit" << std::endl;
 
     //const dealii::MappingManifold<dim,dim> mapping;
@@ -1542,6 +2016,10 @@ void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 
     dealii::hp::MappingCollection<dim> mapping_collection(mapping);
 
+    // Inverse of the reference mass matrix shared by the cells with a constant metric Jacobian determinant.
+    std::vector<unsigned int> reference_inverse_mass_block(fe_collection.size(), dealii::numbers::invalid_unsigned_int);
+    std::vector<unsigned int> local_dofs_indices;
+
     dealii::hp::FEValues<dim,dim> fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, this->volume_update_flags); ///< FEValues of volume.
     for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
 
@@ -1583,19 +2061,62 @@ void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 
         dofs_indices.resize(n_dofs_cell);
         cell->get_dof_indices (dofs_indices);
-        if (do_inverse_mass_matrix == true) {
-            dealii::FullMatrix<real> local_inverse_mass_matrix(n_dofs_cell);
-            local_inverse_mass_matrix.invert(local_mass_matrix);
-            global_inverse_mass_matrix.set (dofs_indices, local_inverse_mass_matrix);
-        } else {
+        if (do_inverse_mass_matrix == false) {
             global_mass_matrix.set (dofs_indices, local_mass_matrix);
+            cell_mass_matrices[cell->active_cell_index()] = local_mass_matrix;
+            continue;
+        }
+
+        // The mass matrix is the same for every state, such that only the block of the first state is inverted.
+        const unsigned int n_shape_fns = n_dofs_cell / nstate;
+        dealii::FullMatrix<double> scalar_mass_matrix(n_shape_fns);
+        local_dofs_indices.resize(n_dofs_cell);
+        for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
+            const std::pair<unsigned int, unsigned int> test_index = current_fe_ref.system_to_component_index(itest);
+            local_dofs_indices[test_index.first*n_shape_fns + test_index.second] = locally_owned_dofs.index_within_set(dofs_indices[itest]);
+            if (test_index.first != 0) continue;
+            for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
+                const std::pair<unsigned int, unsigned int> trial_index = current_fe_ref.system_to_component_index(itrial);
+                if (trial_index.first != 0) continue;
+                scalar_mass_matrix(test_index.second, trial_index.second) = local_mass_matrix[itest][itrial];
+            }
+        }
+
+        // A constant metric Jacobian determinant only scales the reference mass matrix.
+        const dealii::Quadrature<dim> &quadrature = volume_quadrature_collection[quad_index];
+        const double determinant = fe_values_volume.JxW(0) / quadrature.weight(0);
+        bool constant_determinant = true;
+        for (unsigned int iquad=1; iquad<n_quad_pts; ++iquad) {
+            if (std::abs(fe_values_volume.JxW(iquad) / quadrature.weight(iquad) - determinant) > 1e-12 * std::abs(determinant)) {
+                constant_determinant = false;
+                break;
+            }
         }
+
+        const bool check_diagonal = all_parameters->use_collocated_nodes;
+        dealii::FullMatrix<double> scalar_inverse_mass_matrix(n_shape_fns);
+        if (!constant_determinant) {
+            scalar_inverse_mass_matrix.invert(scalar_mass_matrix);
+            const unsigned int block = inverse_mass_operator.add_block(scalar_inverse_mass_matrix, check_diagonal);
+            inverse_mass_operator.add_cell(local_dofs_indices, block, 1.0);
+            continue;
+        }
+        unsigned int &reference_block = reference_inverse_mass_block[fe_index_curr_cell];
+        if (reference_block == dealii::numbers::invalid_unsigned_int) {
+            scalar_mass_matrix *= 1.0 / determinant;
+            scalar_inverse_mass_matrix.invert(scalar_mass_matrix);
+            reference_block = inverse_mass_operator.add_block(scalar_inverse_mass_matrix, check_diagonal);
+        }
+        inverse_mass_operator.add_cell(local_dofs_indices, reference_block, 1.0 / determinant);
     }
 
-    if (do_inverse_mass_matrix == true) {
-        global_inverse_mass_matrix.compress(dealii::VectorOperation::insert);
-    } else {
+    if (do_inverse_mass_matrix == false) {
         global_mass_matrix.compress(dealii::VectorOperation::insert);
+    } else {
+        const double inverse_mass_MB = dealii::Utilities::MPI::sum(inverse_mass_operator.memory_consumption() / (1024.0*1024.0), mpi_communicator);
+        pcout << "Inverse mass matrix stored as "
+              << dealii::Utilities::MPI::sum(inverse_mass_operator.n_blocks(), mpi_communicator) << " cell blocks using "
+              << inverse_mass_MB << " MB." << std::endl;
     }
 
     return;
@@ -1603,50 +2124,126 @@ void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 template<int dim, typename real>
 void DGBase<dim,real>::add_mass_matrices(const real scale)
 {
-    system_matrix.add(scale, global_mass_matrix);
+    if (all_parameters->use_block_sparse_system_matrix) {
+        block_system_matrix.add(scale, global_mass_matrix);
+    } else {
+        system_matrix.add(scale, global_mass_matrix);
+    }
 }
 template<int dim, typename real>
 void DGBase<dim,real>::add_time_scaled_mass_matrices()
 {
-    system_matrix.add(1.0, time_scaled_global_mass_matrix);
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    std::vector<real> row_values;
+    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+
+        if (!cell->is_locally_owned()) continue;
+
+        const unsigned int n_dofs_cell = cell->get_fe().n_dofs_per_cell();
+        dofs_indices.resize(n_dofs_cell);
+        cell->get_dof_indices (dofs_indices);
+
+        const dealii::types::global_dof_index cell_index = cell->active_cell_index();
+        const dealii::FullMatrix<real> &local_mass_matrix = cell_mass_matrices[cell_index];
+        const real scaling = cell_mass_time_scaling[cell_index];
+
+        row_values.resize(n_dofs_cell);
+        for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
+            for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
+                row_values[itrial] = scaling * local_mass_matrix[itest][itrial];
+            }
+            add_to_system_matrix(dofs_indices[itest], dofs_indices, row_values);
+        }
+    }
+    if (all_parameters->use_block_sparse_system_matrix) {
+        block_system_matrix.compress();
+    } else {
+        system_matrix.compress(dealii::VectorOperation::add);
+    }
+}
+template<int dim, typename real>
+void DGBase<dim,real>::add_to_system_matrix (
+    const dealii::types::global_dof_index row,
+    const std::vector<dealii::types::global_dof_index> &col_indices,
+    const std::vector<real> &values)
+{
+    if (assembling_derivatives_with_threads) {
+        thread_matrix_rows.get().push_back({nullptr, row, col_indices, values});
+        return;
+    }
+    if (all_parameters->use_block_sparse_system_matrix) {
+        block_system_matrix.add(row, col_indices, values);
+    } else {
+        system_matrix.add(row, col_indices, values);
+    }
+}
+template<int dim, typename real>
+void DGBase<dim,real>::add_to_matrix (
+    dealii::TrilinosWrappers::SparseMatrix &matrix,
+    const dealii::types::global_dof_index row,
+    const std::vector<dealii::types::global_dof_index> &col_indices,
+    const std::vector<real> &values)
+{
+    if (assembling_derivatives_with_threads) {
+        thread_matrix_rows.get().push_back({&matrix, row, col_indices, values});
+        return;
+    }
+    matrix.add(row, col_indices, values);
+}
+template<int dim, typename real>
+void DGBase<dim,real>::add_matrix_rows (const std::vector<MatrixRow> &matrix_rows)
+{
+    for (const MatrixRow &matrix_row : matrix_rows) {
+        if (matrix_row.matrix) {
+            matrix_row.matrix->add(matrix_row.row, matrix_row.col_indices, matrix_row.values);
+        } else if (all_parameters->use_block_sparse_system_matrix) {
+            block_system_matrix.add(matrix_row.row, matrix_row.col_indices, matrix_row.values);
+        } else {
+            system_matrix.add(matrix_row.row, matrix_row.col_indices, matrix_row.values);
+        }
+    }
 }
 template<int dim, typename real>
 void DGBase<dim,real>::time_scaled_mass_matrices(const real dt_scale)
 {
-    time_scaled_global_mass_matrix.reinit(system_matrix);
-    time_scaled_global_mass_matrix = 0.0;
-    std::vector<dealii::types::global_dof_index> dofs_indices;
+    cell_mass_time_scaling.resize(triangulation->n_active_cells());
     for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
 
         if (!cell->is_locally_owned()) continue;
 
-        const unsigned int fe_index_curr_cell = cell->active_fe_index();
+        const dealii::types::global_dof_index cell_index = cell->active_cell_index();
+        const double max_dt = max_dt_cell[cell_index];
+        cell_mass_time_scaling[cell_index] = 1.0 / (dt_scale * max_dt);
+        AssertIsFinite(cell_mass_time_scaling[cell_index]);
+    }
+}
 
-        // Current reference element related to this physical cell
-        const dealii::FESystem<dim,dim> &current_fe_ref = fe_collection[fe_index_curr_cell];
-        const unsigned int n_dofs_cell = current_fe_ref.n_dofs_per_cell();
+template<int dim, typename real>
+void DGBase<dim,real>::time_scaled_mass_matrix_vmult (
+    dealii::LinearAlgebra::distributed::Vector<double> &dst,
+    const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+{
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
 
+        if (!cell->is_locally_owned()) continue;
+
+        const unsigned int n_dofs_cell = cell->get_fe().n_dofs_per_cell();
         dofs_indices.resize(n_dofs_cell);
         cell->get_dof_indices (dofs_indices);
 
-        const double max_dt = max_dt_cell[cell->active_cell_index()];
+        const dealii::types::global_dof_index cell_index = cell->active_cell_index();
+        const dealii::FullMatrix<real> &local_mass_matrix = cell_mass_matrices[cell_index];
+        const real scaling = cell_mass_time_scaling[cell_index];
 
         for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
-            const unsigned int istate_test = current_fe_ref.system_to_component_index(itest).first;
-            for (unsigned int itrial=itest; itrial<n_dofs_cell; ++itrial) {
-                const unsigned int istate_trial = current_fe_ref.system_to_component_index(itrial).first;
-
-                if(istate_test==istate_trial) {
-                    const double value = global_mass_matrix.el(dofs_indices[itest],dofs_indices[itrial]);
-                    const double new_val = value / (dt_scale * max_dt);
-                    AssertIsFinite(new_val);
-                    time_scaled_global_mass_matrix.set(dofs_indices[itest],dofs_indices[itrial],new_val);
-                    time_scaled_global_mass_matrix.set(dofs_indices[itrial],dofs_indices[itest],new_val);
-                }
+            double value = 0.0;
+            for (unsigned int itrial=0; itrial<n_dofs_cell; ++itrial) {
+                value += local_mass_matrix[itest][itrial] * src[dofs_indices[itrial]];
             }
+            dst[dofs_indices[itest]] = scaling * value;
         }
     }
-    time_scaled_global_mass_matrix.compress(dealii::VectorOperation::insert);
 }
 
 template<int dim, typename real>
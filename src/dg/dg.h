@@ -5,6 +5,7 @@
 #include <deal.II/base/parameter_handler.h>
 
 #include <deal.II/base/qprojector.h>
+#include <deal.II/base/thread_local_storage.h>
 
 #include <deal.II/grid/tria.h>
 
@@ -20,12 +21,12 @@
 #include <deal.II/hp/mapping_collection.h>
 #include <deal.II/hp/fe_values.h>
 
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/trilinos_vector.h>
 
-#include <Epetra_RowMatrixTransposer.h>
 #include <AztecOO.h>
 
 #include "ADTypes.hpp"
@@ -36,6 +37,11 @@
 #include "physics/physics.h"
 #include "numerical_flux/numerical_flux.h"
 #include "parameters/all_parameters.h"
+#include "linear_solver/block_sparse_matrix.h"
+#include "linear_solver/p_multigrid_preconditioner.h"
+#include "sum_factorization.hpp"
+#include "metric_cache.hpp"
+#include "inverse_mass_operator.hpp"
 
 // Template specialization of MappingFEField
 //extern template class dealii::MappingFEField<PHILIP_DIM,PHILIP_DIM,dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<PHILIP_DIM> >;
@@ -138,6 +144,25 @@ public:
     /** Must be done after setting the mesh and before assembling the system. */
     virtual void allocate_system ();
 
+    /// Cells and cell-to-cell couplings of a block sparse matrix on this mesh.
+    /** The locally owned cells of the dof_handler come first, followed by the ghost cells they neighbour.
+     *  @p block_pattern lists the cells coupled to each cell through its faces, including itself,
+     *  or only itself if @p block_diagonal is true. Ghost cells only couple with the locally owned cells
+     *  whose shared faces are assembled by this processor.
+     */
+    void make_block_sparsity_pattern (
+        const bool block_diagonal,
+        std::vector<typename dealii::DoFHandler<dim>::cell_iterator> &cells,
+        std::vector<std::vector<unsigned int>> &block_pattern) const;
+
+    /// Adds the polynomial levels of the current discretization to @p p_multigrid.
+    /** The finest level is the current dof_handler. Each coarser level lowers the finite element
+     *  of the cells of highest degree by one, down to the first finite element of the fe_collection.
+     *  The coarse levels are numbered by temporary DoFHandlers sharing the cell numbering of
+     *  make_block_sparsity_pattern(), and the prolongations interpolate between consecutive finite elements.
+     */
+    void setup_p_multigrid (PMultigridPreconditioner &p_multigrid) const;
+
 private:
     /// Allocates the second derivatives.
     /** Is called when assembling the residual's second derivatives, and is currently empty
@@ -159,13 +184,45 @@ public:
      */
     void time_scale_solution_update ( dealii::LinearAlgebra::distributed::Vector<double> &solution_update, const real CFL ) const;
 
-    /// Evaluate the time_scaled_global_mass_matrix such that the maximum time step
+    /// Level of the cells and faces evaluated by assemble_residual(), or -1 to evaluate all of them.
+    /** Used by local time stepping, where a face belongs to the finest level of its two cells.
+     *  The right_hand_side then only contains the contributions of the given level.
+     */
+    int active_local_time_stepping_level;
+
+    /// Time level of each active cell, indexed by active_cell_index.
+    /** Also valid on the ghost cells. See set_local_time_stepping_levels().
+     */
+    std::vector<unsigned int> local_time_stepping_levels;
+
+    /// Sets the local_time_stepping_levels from the levels of the locally owned cells.
+    /** The levels are communicated to the ghost cells through a vector with the solution's ghost layout.
+     */
+    void set_local_time_stepping_levels (const std::vector<unsigned int> &owned_cell_levels);
+
+    /// Returns the smallest max_dt_cell over all the locally owned cells of all processes.
+    /** Multiplied by a CFL number, it gives a stable global time step for the explicit ODE solver.
+     *  The max_dt_cell are updated by assemble_residual().
+     */
+    real get_global_min_max_dt_cell () const;
+
+    /// Evaluates the time scaling of each cell mass matrix such that the maximum time step
     /// cell-wise is taken into account.
+    /** Only stores \f$ 1/(\text{scale} \Delta t_{max,cell}) \f$ for each cell. The scaled mass matrices are
+     *  applied from the cell_mass_matrices by add_time_scaled_mass_matrices() and time_scaled_mass_matrix_vmult().
+     */
     void time_scaled_mass_matrices(const real scale);
 
+    /// Applies the time scaled mass matrices evaluated by time_scaled_mass_matrices() to @p src.
+    void time_scaled_mass_matrix_vmult (
+        dealii::LinearAlgebra::distributed::Vector<double> &dst,
+        const dealii::LinearAlgebra::distributed::Vector<double> &src) const;
+
     /// Allocates and evaluates the mass matrices for the entire grid
     /** Although straightforward, this has not been tested yet.
      *  Will be required for accurate time-stepping or nonlinear problems
+     *
+     *  The inverse is not assembled into a global matrix, but stored in the inverse_mass_operator.
      */
     void evaluate_mass_matrices (bool do_inverse_mass_matrix = false);
 
@@ -183,10 +240,55 @@ public:
 
     /// Add time scaled mass matrices to the system.
     /** For pseudotime-stepping where the scaling depends on wavespeed and cell-size.
+     *  The scaled cell_mass_matrices are added directly into the diagonal blocks of the system matrix.
      */
     void add_time_scaled_mass_matrices();
 
-    double get_residual_l2norm () const; ///< Returns the L2-norm of the right_hand_side vector
+    /// Adds a row of dRdW to the system_matrix, or to the block_system_matrix if it is used.
+    /** The columns @p col_indices must all belong to the same cell.
+     *  During a thread-parallel assembly of the derivatives, the row is stored and added later by add_matrix_rows().
+     */
+    void add_to_system_matrix (
+        const dealii::types::global_dof_index row,
+        const std::vector<dealii::types::global_dof_index> &col_indices,
+        const std::vector<real> &values);
+
+    /// Adds a row of derivatives to @p matrix, such as dRdXv or the d2R matrices.
+    /** During a thread-parallel assembly of the derivatives, the row is stored and added later by add_matrix_rows().
+     */
+    void add_to_matrix (
+        dealii::TrilinosWrappers::SparseMatrix &matrix,
+        const dealii::types::global_dof_index row,
+        const std::vector<dealii::types::global_dof_index> &col_indices,
+        const std::vector<real> &values);
+
+    /// Row of a derivative matrix computed by a thread, but not yet added to its matrix.
+    struct MatrixRow
+    {
+        /// Matrix the row is added to, or nullptr for the system_matrix or block_system_matrix.
+        dealii::TrilinosWrappers::SparseMatrix *matrix;
+        dealii::types::global_dof_index row; ///< Global row index.
+        std::vector<dealii::types::global_dof_index> col_indices; ///< Global column indices.
+        std::vector<real> values; ///< Values added to the columns.
+    };
+
+    /// Adds the rows stored by a thread of the thread-parallel assembly to their matrices.
+    /** The Trilinos matrices are not thread-safe, so this is only called by one thread at a time.
+     */
+    void add_matrix_rows (const std::vector<MatrixRow> &matrix_rows);
+
+    /// Returns the L2-norm of the right_hand_side vector
+    /** The norm is only evaluated once after each assembly of the right_hand_side.
+     */
+    double get_residual_l2norm () const;
+    /// Forces the next assemble_residual() to recompute the right_hand_side.
+    /** Must be called when the right_hand_side is modified outside of assemble_residual().
+     */
+    void invalidate_residual ();
+    /// Forces the next assemble_residual() with compute_dRdW to recompute the system_matrix.
+    /** Must be called when the system_matrix is modified outside of assemble_residual().
+     */
+    void invalidate_dRdW ();
     double get_residual_linfnorm () const; ///< Returns the Linf-norm of the right_hand_side vector
 
     unsigned int n_dofs() const; ///< Number of degrees of freedom
@@ -207,26 +309,38 @@ public:
     /** Not sure we need to store it.  */
     dealii::SparsityPattern mass_sparsity_pattern;
 
-    /// Global mass matrix divided by the time scales.
-    /** Should be block diagonal where each block contains the scaled mass matrix of each cell.  */
-    dealii::TrilinosWrappers::SparseMatrix time_scaled_global_mass_matrix;
+    /// Mass matrix of each locally owned cell, indexed by active_cell_index.
+    /** Evaluated along with the global_mass_matrix, and used to apply the time scaled mass matrices.  */
+    std::vector<dealii::FullMatrix<real>> cell_mass_matrices;
+
+    /// Inverse of the time scale of each cell mass matrix, indexed by active_cell_index.
+    /** Evaluated by time_scaled_mass_matrices().  */
+    std::vector<real> cell_mass_time_scaling;
 
     /// Global mass matrix
     /** Should be block diagonal where each block contains the mass matrix of each cell.  */
     dealii::TrilinosWrappers::SparseMatrix global_mass_matrix;
-    /// Global inverser mass matrix
-    /** Should be block diagonal where each block contains the inverse mass matrix of each cell.  */
-    dealii::TrilinosWrappers::SparseMatrix global_inverse_mass_matrix;
+    /// Inverse mass matrix applied cell by cell.
+    /** Evaluated by evaluate_mass_matrices() when the inverse is requested.
+     *  Its blocks are shared by the cells with a constant metric Jacobian determinant.
+     */
+    CellInverseMassOperator inverse_mass_operator;
     /// System matrix corresponding to the derivative of the right_hand_side with
     /// respect to the solution
     dealii::TrilinosWrappers::SparseMatrix system_matrix;
 
-    /// System matrix corresponding to the derivative of the right_hand_side with
-    /// respect to the solution TRANSPOSED.
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
+    /// Flag to only allocate and assemble the diagonal blocks of the system_matrix.
+    /** Set by allocate_system() when the ODE solver uses the Jacobian-free Newton-Krylov mode,
+     *  where the system_matrix is only used as a block-Jacobi preconditioner.
+     *  The blocks coupling neighbouring cells are then skipped during the assembly.
+     */
+    bool block_diagonal_system_matrix;
 
-    /// Epetra_RowMatrixTransposer used to transpose the system_matrix.
-    std::unique_ptr<Epetra_RowMatrixTransposer> epetra_rowmatrixtransposer_dRdW;
+    /// System matrix stored as dense cell-to-cell blocks.
+    /** Used instead of the system_matrix when AllParameters::use_block_sparse_system_matrix is true.
+     *  The adjoint applies its transpose through BlockSparseMatrix::Tvmult().
+     */
+    BlockSparseMatrix block_system_matrix;
 
     //AztecOO dRdW_preconditioner_builder;
 
@@ -287,12 +401,28 @@ public:
      */
     dealii::LinearAlgebra::distributed::Vector<double> solution;
 private:
+    /// Modal coefficients of the solution used to compute the right_hand_side last
+    /// Will be used to avoid recomputing the residual.
+    dealii::LinearAlgebra::distributed::Vector<double> solution_residual;
+    /// Modal coefficients of the grid nodes used to compute the right_hand_side last
+    /// Will be used to avoid recomputing the residual.
+    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_residual;
+    /// Whether solution_residual and volume_nodes_residual describe the current right_hand_side.
+    bool residual_is_current;
+
+    /// Last value returned by get_residual_l2norm().
+    mutable double residual_l2norm;
+    /// Whether residual_l2norm corresponds to the current right_hand_side.
+    mutable bool residual_l2norm_is_current;
+
     /// Modal coefficients of the solution used to compute dRdW last
     /// Will be used to avoid recomputing dRdW.
     dealii::LinearAlgebra::distributed::Vector<double> solution_dRdW;
     /// Modal coefficients of the grid nodes used to compute dRdW last
     /// Will be used to avoid recomputing dRdW.
     dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_dRdW;
+    /// Whether the system_matrix still holds the dRdW evaluated at solution_dRdW and volume_nodes_dRdW.
+    bool dRdW_is_current;
 
     /// Modal coefficients of the solution used to compute dRdX last
     /// Will be used to avoid recomputing dRdX.
@@ -310,7 +440,33 @@ private:
     /// Dual variables to compute d2R last
     /// Will be used to avoid recomputing d2R.
     dealii::LinearAlgebra::distributed::Vector<double> dual_d2R;
+    /// Modal coefficients of the grid nodes used to fill the metric_cache
+    /// Will be used to invalidate the metric_cache.
+    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_metric_cache;
+    /// Memory of the metric_cache summed over the processors when it was last reported, in MB.
+    double metric_cache_reported_MB;
 public:
+    /// Metric terms stored across residual evaluations.
+    /** Only filled if use_metric_cache is set. Its memory usage, given by MetricCache::memory_consumption(),
+     *  is reported by assemble_residual() whenever it changes.
+     */
+    MetricCache<dim> metric_cache;
+
+    /// Number of cell volume terms whose dRdW block was obtained by recording a CoDiPack tape.
+    /** Only counted if reuse_jacobian_tapes is set.
+     */
+    unsigned int n_volume_tapes_recorded;
+    /// Number of cell volume terms whose dRdW block was obtained by re-evaluating a recorded tape.
+    unsigned int n_volume_tapes_replayed;
+    /// Number of replayed volume tapes discarded because the cell took different branches than the recorded one.
+    /** These cells are also counted in n_volume_tapes_recorded, since their tape is recorded again.
+     */
+    unsigned int n_volume_tape_branch_mismatches;
+    /// Accumulated wall time in seconds spent recording and evaluating the volume tapes.
+    double volume_tapes_recording_time;
+    /// Accumulated wall time in seconds spent re-evaluating the recorded volume tapes.
+    double volume_tapes_replaying_time;
+
 
     /// Time it takes for the maximum wavespeed to cross the cell domain.
     /** Uses evaluate_CFL() which would be defined in the subclasses.
@@ -448,6 +604,26 @@ public:
         dealii::hp::FEValues<dim,dim>        &fe_values_collection_volume_lagrange,
         dealii::LinearAlgebra::distributed::Vector<double> &rhs);
 
+private:
+    /// Groups of cells that can be assembled concurrently.
+    /** Cells of the same color do not write into the residual of the same degrees of freedom.
+     *  Computed on the first thread-parallel assembly and cleared by allocate_system().
+     */
+    std::vector<std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>> assembly_cell_colors;
+
+    /// Colors the active cells such that assemble_residual() can assemble each color with multiple threads.
+    void color_cells_for_assembly ();
+
+    /// Rows of the derivative matrices computed by each thread for its current cell.
+    dealii::Threads::ThreadLocalStorage<std::vector<MatrixRow>> thread_matrix_rows;
+protected:
+    /// Whether assemble_residual() currently assembles derivatives with multiple threads.
+    /** The CoDiPack tapes are global for a given AD type and can't be recorded by multiple threads.
+     *  The derived classes must then differentiate with tapeless Sacado types instead.
+     */
+    bool assembling_derivatives_with_threads;
+public:
+
     /// Finite Element Collection for p-finite-element to represent the solution
     /** This is a collection of FESystems */
     const dealii::hp::FECollection<dim>    fe_collection;
@@ -467,6 +643,11 @@ public:
     /// 1D quadrature to generate Lagrange polynomials for the sake of flux interpolation.
     dealii::hp::QCollection<1>       oned_quadrature_collection;
 
+    /// Tensor-product operators used by the sum-factorized explicit residual.
+    /** Indexed by the polynomial degree. Only built when use_sum_factorization is set.
+     */
+    std::vector<std::shared_ptr<TensorProductOperators<dim>>> tensor_product_operators;
+
 protected:
     /// Lagrange basis used in strong form
     /** This is a collection of scalar Lagrange bases */
@@ -570,10 +751,11 @@ protected:
         | dealii::update_inverse_jacobians;
     /// Update flags needed at face points.
     const dealii::UpdateFlags face_update_flags = dealii::update_values | dealii::update_gradients | dealii::update_quadrature_points | dealii::update_JxW_values | dealii::update_normal_vectors
-        | dealii::update_jacobians;
+        | dealii::update_jacobians | dealii::update_inverse_jacobians;
     /// Update flags needed at neighbor' face points.
     /** NOTE: With hp-adaptation, might need to query neighbor's quadrature points depending on the order of the cells. */
-    const dealii::UpdateFlags neighbor_face_update_flags = dealii::update_values | dealii::update_gradients | dealii::update_quadrature_points | dealii::update_JxW_values;
+    const dealii::UpdateFlags neighbor_face_update_flags = dealii::update_values | dealii::update_gradients | dealii::update_quadrature_points | dealii::update_JxW_values
+        | dealii::update_inverse_jacobians;
 
 
 
@@ -671,15 +853,22 @@ public:
     /// Dissipative numerical flux with RadFadDtype
     std::unique_ptr < NumericalFlux::NumericalFluxDissipative<dim, nstate, RadFadType > > diss_num_flux_rad_fad;
 
+    /// Contains the physics of the PDE with RadPrimalType
+    /** Only used to record the volume terms whose tapes are reused when reuse_jacobian_tapes is set.
+     */
+    std::shared_ptr < Physics::PhysicsBase<dim, nstate, RadPrimalType > > pde_physics_rad_primal;
+
     /** Change the physics object.
      *  Must provide all the AD types to ensure that the derivatives are consistent.
+     *  If the RadPrimalType physics is not provided, the volume tapes are not reused.
      */
     void set_physics(
         std::shared_ptr< Physics::PhysicsBase<dim, nstate, real       > > pde_physics_double_input,
         std::shared_ptr< Physics::PhysicsBase<dim, nstate, FadType    > > pde_physics_fad_input,
         std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadType    > > pde_physics_rad_input,
         std::shared_ptr< Physics::PhysicsBase<dim, nstate, FadFadType > > pde_physics_fad_fad_input,
-        std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadFadType > > pde_physics_rad_fad_input);
+        std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadFadType > > pde_physics_rad_fad_input,
+        std::shared_ptr< Physics::PhysicsBase<dim, nstate, RadPrimalType > > pde_physics_rad_primal_input = nullptr);
 
 protected:
     /// Evaluate the time it takes for the maximum wavespeed to cross the cell domain.
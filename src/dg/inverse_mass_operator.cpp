@@ -0,0 +1,145 @@
+#include <cmath>
+
+#include <deal.II/base/exceptions.h>
+
+#include "inverse_mass_operator.hpp"
+
+namespace PHiLiP {
+
+CellInverseMassOperator::CellInverseMassOperator ()
+{
+    clear();
+}
+
+void CellInverseMassOperator::clear ()
+{
+    // Swap with empty vectors to release the memory.
+    std::vector<unsigned int>().swap(dof_indices);
+    std::vector<unsigned int>(1, 0).swap(cell_dof_start);
+    std::vector<unsigned int>().swap(cell_block);
+    std::vector<double>().swap(cell_scaling);
+    std::vector<double>().swap(block_values);
+    std::vector<unsigned int>().swap(block_start);
+    std::vector<unsigned int>().swap(block_size);
+    std::vector<bool>().swap(block_is_diagonal);
+}
+
+unsigned int CellInverseMassOperator::add_block (const dealii::FullMatrix<double> &scalar_inverse_mass_matrix, const bool check_diagonal)
+{
+    const unsigned int n = scalar_inverse_mass_matrix.m();
+    AssertDimension(n, scalar_inverse_mass_matrix.n());
+
+    bool is_diagonal = check_diagonal;
+    if (check_diagonal) {
+        const double tolerance = 1e-12 * scalar_inverse_mass_matrix.linfty_norm();
+        for (unsigned int i = 0; i < n && is_diagonal; ++i) {
+            for (unsigned int j = 0; j < n; ++j) {
+                if (i != j && std::abs(scalar_inverse_mass_matrix(i,j)) > tolerance) {
+                    is_diagonal = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    block_start.push_back(block_values.size());
+    block_size.push_back(n);
+    block_is_diagonal.push_back(is_diagonal);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (is_diagonal) {
+            block_values.push_back(scalar_inverse_mass_matrix(i,i));
+            continue;
+        }
+        for (unsigned int j = 0; j < n; ++j) {
+            block_values.push_back(scalar_inverse_mass_matrix(i,j));
+        }
+    }
+    return block_start.size() - 1;
+}
+
+void CellInverseMassOperator::add_cell (const std::vector<unsigned int> &local_dof_indices, const unsigned int block_index, const double scaling)
+{
+    AssertIndexRange(block_index, n_blocks());
+    Assert(local_dof_indices.size() % block_size[block_index] == 0,
+           dealii::ExcMessage("The cell degrees of freedom must be a multiple of the block size."));
+
+    dof_indices.insert(dof_indices.end(), local_dof_indices.begin(), local_dof_indices.end());
+    cell_dof_start.push_back(dof_indices.size());
+    cell_block.push_back(block_index);
+    cell_scaling.push_back(scaling);
+}
+
+void CellInverseMassOperator::vmult (VectorType &dst, const VectorType &src) const
+{
+    for (unsigned int icell = 0; icell < n_cells(); ++icell) {
+        const unsigned int iblock = cell_block[icell];
+        const unsigned int n = block_size[iblock];
+        const double scaling = cell_scaling[icell];
+        const double *values = &block_values[block_start[iblock]];
+
+        for (unsigned int first = cell_dof_start[icell]; first < cell_dof_start[icell+1]; first += n) {
+            const unsigned int *dofs = &dof_indices[first];
+            if (block_is_diagonal[iblock]) {
+                for (unsigned int i = 0; i < n; ++i) {
+                    dst.local_element(dofs[i]) = scaling * values[i] * src.local_element(dofs[i]);
+                }
+                continue;
+            }
+
+            local_src.resize(n);
+            local_dst.resize(n);
+            for (unsigned int i = 0; i < n; ++i) {
+                local_src[i] = src.local_element(dofs[i]);
+            }
+            for (unsigned int i = 0; i < n; ++i) {
+                double sum = 0.0;
+                for (unsigned int j = 0; j < n; ++j) {
+                    sum += values[i*n+j] * local_src[j];
+                }
+                local_dst[i] = scaling * sum;
+            }
+            for (unsigned int i = 0; i < n; ++i) {
+                dst.local_element(dofs[i]) = local_dst[i];
+            }
+        }
+    }
+}
+
+void CellInverseMassOperator::get_diagonal (VectorType &diagonal) const
+{
+    for (unsigned int icell = 0; icell < n_cells(); ++icell) {
+        const unsigned int iblock = cell_block[icell];
+        const unsigned int n = block_size[iblock];
+        const double *values = &block_values[block_start[iblock]];
+        for (unsigned int first = cell_dof_start[icell]; first < cell_dof_start[icell+1]; first += n) {
+            for (unsigned int i = 0; i < n; ++i) {
+                const double value = block_is_diagonal[iblock] ? values[i] : values[i*n+i];
+                diagonal.local_element(dof_indices[first+i]) = cell_scaling[icell] * value;
+            }
+        }
+    }
+}
+
+unsigned int CellInverseMassOperator::n_cells () const
+{
+    return cell_block.size();
+}
+
+unsigned int CellInverseMassOperator::n_blocks () const
+{
+    return block_start.size();
+}
+
+std::size_t CellInverseMassOperator::memory_consumption () const
+{
+    return dof_indices.capacity() * sizeof(unsigned int)
+           + cell_dof_start.capacity() * sizeof(unsigned int)
+           + cell_block.capacity() * sizeof(unsigned int)
+           + cell_scaling.capacity() * sizeof(double)
+           + block_values.capacity() * sizeof(double)
+           + block_start.capacity() * sizeof(unsigned int)
+           + block_size.capacity() * sizeof(unsigned int)
+           + block_is_diagonal.capacity() / 8;
+}
+
+} // PHiLiP namespace
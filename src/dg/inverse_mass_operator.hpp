@@ -0,0 +1,87 @@
+#ifndef __INVERSE_MASS_OPERATOR_H__
+#define __INVERSE_MASS_OPERATOR_H__
+
+#include <vector>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+namespace PHiLiP {
+
+/// Block diagonal inverse of the DG mass matrix applied cell by cell.
+/** The DG mass matrix couples neither the cells nor the states, such that its inverse is made of one
+ *  small block per cell, which is the same for every state. Only that scalar block is stored.
+ *
+ *  On cells with a constant metric Jacobian determinant, the mass matrix is the reference mass matrix
+ *  scaled by the determinant. Those cells share the inverse of the reference block of their finite
+ *  element and only store their scaling. The blocks found to be diagonal, as for collocated nodes,
+ *  are stored and applied as diagonals.
+ *
+ *  The operator only acts on locally owned entries and therefore does not communicate.
+ */
+class CellInverseMassOperator
+{
+public:
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>; ///< Vector type the operator acts on.
+
+    /// Constructor.
+    CellInverseMassOperator ();
+
+    /// Removes all the cells and blocks.
+    void clear ();
+
+    /// Adds a block given the inverse of a scalar mass matrix.
+    /** The block is stored as a diagonal if @p check_diagonal is set and its off-diagonal entries vanish.
+     *  @return Index of the block to be used by add_cell().
+     */
+    unsigned int add_block (const dealii::FullMatrix<double> &scalar_inverse_mass_matrix, const bool check_diagonal);
+
+    /// Adds a locally owned cell whose inverse mass matrix is @p scaling times the block @p block_index.
+    /** @p local_dof_indices are the indices of the cell degrees of freedom into the locally owned entries,
+     *  ordered by state and then by scalar shape function.
+     */
+    void add_cell (const std::vector<unsigned int> &local_dof_indices, const unsigned int block_index, const double scaling);
+
+    /// Applies the inverse mass matrix. @p dst and @p src may be the same vector.
+    void vmult (VectorType &dst, const VectorType &src) const;
+
+    /// Fills the locally owned entries of @p diagonal with the diagonal of the inverse mass matrix.
+    void get_diagonal (VectorType &diagonal) const;
+
+    /// Number of cells added.
+    unsigned int n_cells () const;
+
+    /// Number of distinct blocks stored.
+    unsigned int n_blocks () const;
+
+    /// Memory used by the operator in bytes.
+    std::size_t memory_consumption () const;
+
+private:
+    /// Indices of the cell degrees of freedom into the locally owned entries. See add_cell().
+    std::vector<unsigned int> dof_indices;
+    /// Offset of each cell into dof_indices. Has n_cells()+1 entries.
+    std::vector<unsigned int> cell_dof_start;
+    /// Block used by each cell.
+    std::vector<unsigned int> cell_block;
+    /// Scaling of the block used by each cell.
+    std::vector<double> cell_scaling;
+
+    /// Values of the blocks, stored row-wise, or as diagonals.
+    std::vector<double> block_values;
+    /// Offset of each block into block_values.
+    std::vector<unsigned int> block_start;
+    /// Number of scalar shape functions of each block.
+    std::vector<unsigned int> block_size;
+    /// Whether each block is stored as a diagonal.
+    std::vector<bool> block_is_diagonal;
+
+    /// Entries of one state of a cell gathered before being overwritten, such that the operator can be applied in place.
+    mutable std::vector<double> local_src;
+    /// Result for one state of a cell before being scattered.
+    mutable std::vector<double> local_dst;
+};
+
+} // PHiLiP namespace
+
+#endif
@@ -0,0 +1,107 @@
+#include "metric_cache.hpp"
+
+namespace PHiLiP {
+
+template <int dim>
+void MetricCache<dim>::reinit (const unsigned int n_active_cells)
+{
+    clear();
+    volume_terms.resize(n_active_cells);
+    face_terms.resize(n_active_cells);
+}
+
+template <int dim>
+void MetricCache<dim>::clear ()
+{
+    // Swap with empty vectors to release the memory.
+    std::vector<MetricTerms>().swap(volume_terms);
+    std::vector<std::array<MetricTerms, dealii::GeometryInfo<dim>::faces_per_cell>>().swap(face_terms);
+}
+
+template <int dim>
+bool MetricCache<dim>::is_initialized () const
+{
+    return !volume_terms.empty();
+}
+
+template <int dim>
+bool MetricCache<dim>::get_terms (
+    const MetricTerms &terms,
+    std::vector<double> &jacobian_determinant,
+    std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse)
+{
+    const unsigned int n_quad_pts = jacobian_determinant.size();
+    if (terms.jacobian_determinant.size() != n_quad_pts) return false;
+    jacobian_determinant = terms.jacobian_determinant;
+    jacobian_transpose_inverse = terms.jacobian_transpose_inverse;
+    return true;
+}
+
+template <int dim>
+bool MetricCache<dim>::get_volume_terms (
+    const unsigned int cell_index,
+    std::vector<double> &jacobian_determinant,
+    std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse) const
+{
+    if (cell_index >= volume_terms.size()) return false;
+    return get_terms(volume_terms[cell_index], jacobian_determinant, jacobian_transpose_inverse);
+}
+
+template <int dim>
+void MetricCache<dim>::store_volume_terms (
+    const unsigned int cell_index,
+    const std::vector<double> &jacobian_determinant,
+    const std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse)
+{
+    if (cell_index >= volume_terms.size()) return;
+    volume_terms[cell_index].jacobian_determinant = jacobian_determinant;
+    volume_terms[cell_index].jacobian_transpose_inverse = jacobian_transpose_inverse;
+}
+
+template <int dim>
+bool MetricCache<dim>::get_face_terms (
+    const unsigned int cell_index,
+    const unsigned int face_number,
+    std::vector<double> &jacobian_determinant,
+    std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse) const
+{
+    if (cell_index >= face_terms.size()) return false;
+    return get_terms(face_terms[cell_index][face_number], jacobian_determinant, jacobian_transpose_inverse);
+}
+
+template <int dim>
+void MetricCache<dim>::store_face_terms (
+    const unsigned int cell_index,
+    const unsigned int face_number,
+    const std::vector<double> &jacobian_determinant,
+    const std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse)
+{
+    if (cell_index >= face_terms.size()) return;
+    face_terms[cell_index][face_number].jacobian_determinant = jacobian_determinant;
+    face_terms[cell_index][face_number].jacobian_transpose_inverse = jacobian_transpose_inverse;
+}
+
+template <int dim>
+std::size_t MetricCache<dim>::memory_consumption () const
+{
+    const auto terms_memory = [](const MetricTerms &terms) {
+        return terms.jacobian_determinant.capacity() * sizeof(double)
+               + terms.jacobian_transpose_inverse.capacity() * sizeof(dealii::Tensor<2,dim,double>);
+    };
+    std::size_t memory = sizeof(*this)
+                         + volume_terms.capacity() * sizeof(MetricTerms)
+                         + face_terms.capacity() * sizeof(typename decltype(face_terms)::value_type);
+    for (const auto &terms : volume_terms) {
+        memory += terms_memory(terms);
+    }
+    for (const auto &cell_face_terms : face_terms) {
+        for (const auto &terms : cell_face_terms) {
+            memory += terms_memory(terms);
+        }
+    }
+    return memory;
+}
+
+template class MetricCache <PHILIP_DIM>;
+
+} // PHiLiP namespace
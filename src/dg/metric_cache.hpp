@@ -0,0 +1,97 @@
+#ifndef __METRIC_CACHE_H__
+#define __METRIC_CACHE_H__
+
+#include <array>
+#include <vector>
+
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/geometry_info.h>
+
+namespace PHiLiP {
+
+/// Per-cell storage of the metric terms evaluated at the volume and face quadrature points.
+/** The metric Jacobian determinants and the transpose of the inverse metric Jacobians only depend
+ *  on the high-order grid. When the grid is fixed, as in pseudo-time steady solves or explicit time
+ *  marching, they are evaluated on the first residual assembly and reused afterwards.
+ *
+ *  The cache only stores the terms computed with doubles. The automatic differentiation passes
+ *  record the metric terms on their tapes and therefore always recompute them.
+ *
+ *  On the faces, only the same two terms are stored. The normals and surface Jacobian determinants are
+ *  derived from them at each quadrature point, and the physical quadrature points are interpolated
+ *  from the grid nodes on every assembly. Subfaces of hanging nodes are not cached.
+ *
+ *  Entries are indexed by the active cell index. All the entries are allocated by reinit() such that
+ *  different cells can be filled concurrently.
+ */
+template <int dim>
+class MetricCache
+{
+public:
+    /// Metric terms at the quadrature points of a cell or of one of its faces.
+    struct MetricTerms
+    {
+        /// Determinant of the metric Jacobian.
+        std::vector<double> jacobian_determinant;
+        /// Transpose of the inverse metric Jacobian.
+        std::vector<dealii::Tensor<2,dim,double>> jacobian_transpose_inverse;
+    };
+
+    /// Allocates empty entries for @p n_active_cells cells.
+    void reinit (const unsigned int n_active_cells);
+
+    /// Removes all the entries. The cache is disabled until the next reinit().
+    void clear ();
+
+    /// Whether the cache has been allocated.
+    bool is_initialized () const;
+
+    /// Retrieve the volume metric terms of a cell.
+    /** @return false if they have not been stored, or if they were stored for a different number of quadrature points.
+     */
+    bool get_volume_terms (
+        const unsigned int cell_index,
+        std::vector<double> &jacobian_determinant,
+        std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse) const;
+
+    /// Store the volume metric terms of a cell.
+    void store_volume_terms (
+        const unsigned int cell_index,
+        const std::vector<double> &jacobian_determinant,
+        const std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse);
+
+    /// Retrieve the metric terms of a cell evaluated on one of its (whole) faces.
+    /** @return false if they have not been stored, or if they were stored for a different number of quadrature points.
+     */
+    bool get_face_terms (
+        const unsigned int cell_index,
+        const unsigned int face_number,
+        std::vector<double> &jacobian_determinant,
+        std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse) const;
+
+    /// Store the metric terms of a cell evaluated on one of its (whole) faces.
+    void store_face_terms (
+        const unsigned int cell_index,
+        const unsigned int face_number,
+        const std::vector<double> &jacobian_determinant,
+        const std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse);
+
+    /// Memory used by the cache in bytes.
+    std::size_t memory_consumption () const;
+
+private:
+    /// Volume metric terms of each cell.
+    std::vector<MetricTerms> volume_terms;
+    /// Face metric terms of each cell.
+    std::vector<std::array<MetricTerms, dealii::GeometryInfo<dim>::faces_per_cell>> face_terms;
+
+    /// Copy the entry into the output if it has the expected number of quadrature points.
+    static bool get_terms (
+        const MetricTerms &terms,
+        std::vector<double> &jacobian_determinant,
+        std::vector<dealii::Tensor<2,dim,double>> &jacobian_transpose_inverse);
+};
+
+} // PHiLiP namespace
+
+#endif
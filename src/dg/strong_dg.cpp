@@ -176,7 +176,7 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
                 //residual_derivatives[idof] = rhs.fastAccessDx(idof);
                 residual_derivatives[idof] = rhs.fastAccessDx(idof);
             }
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
         }
     }
 }
@@ -312,7 +312,7 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
                 //residual_derivatives[idof] = rhs.fastAccessDx(idof);
                 residual_derivatives[idof] = rhs.fastAccessDx(idof);
             }
-            this->system_matrix.add(cell_dofs_indices[itest], cell_dofs_indices, residual_derivatives);
+            this->add_to_system_matrix(cell_dofs_indices[itest], cell_dofs_indices, residual_derivatives);
         }
     }
 }
@@ -477,8 +477,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR1_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_int, dR1_dW1);
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, dR1_dW2);
+            this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_int, dR1_dW1);
+            if (!this->block_diagonal_system_matrix) this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_ext, dR1_dW2);
         }
     }
 
@@ -504,8 +504,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR2_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, dR2_dW1);
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, dR2_dW2);
+            if (!this->block_diagonal_system_matrix) this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, dR2_dW1);
+            this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, dR2_dW2);
         }
     }
 }
@@ -548,6 +548,10 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
     for (unsigned int idof = 0; idof < n_dofs_cell; ++idof) {
         soln_coeff[idof] = DGBase<dim,real>::solution(cell_dofs_indices[idof]);
     }
+    const unsigned int cell_degree = fe_values_vol.get_fe().tensor_degree();
+    const std::shared_ptr<TensorProductOperators<dim>> tensor_operators =
+        this->all_parameters->use_sum_factorization ? this->tensor_product_operators[cell_degree] : nullptr;
+
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
         for (int istate=0; istate<nstate; istate++) { 
             // Interpolate solution to the volume quadrature points
@@ -555,19 +559,62 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
             soln_grad_at_q[iquad][istate] = 0;
         }
     }
+    if (tensor_operators) {
+        std::vector<double> soln_coeff_state(tensor_operators->n_dofs_scalar);
+        std::vector<double> soln_state_at_q;
+        std::array<std::vector<double>,dim> ref_grad_state_at_q;
+        for (int istate=0; istate<nstate; istate++) {
+            for (unsigned int ishape=0; ishape<tensor_operators->n_dofs_scalar; ++ishape) {
+                soln_coeff_state[ishape] = soln_coeff[tensor_operators->component_dofs[istate][ishape]];
+            }
+            tensor_operators->evaluate_volume(soln_coeff_state, soln_state_at_q, &ref_grad_state_at_q);
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                soln_at_q[iquad][istate] = soln_state_at_q[iquad];
+                const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values_vol.inverse_jacobian(iquad);
+                for (int d_ref=0; d_ref<dim; ++d_ref) {
+                    for (int d_phys=0; d_phys<dim; ++d_phys) {
+                        soln_grad_at_q[iquad][istate][d_phys] += ref_grad_state_at_q[d_ref][iquad] * inv_jacobian[d_ref][d_phys];
+                    }
+                }
+            }
+        }
+    }
     // Interpolate solution to face
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        for (unsigned int idof=0; idof<n_dofs_cell; ++idof) {
-              const unsigned int istate = fe_values_vol.get_fe().system_to_component_index(idof).first;
-              soln_at_q[iquad][istate]      += soln_coeff[idof] * fe_values_vol.shape_value_component(idof, iquad, istate);
-              soln_grad_at_q[iquad][istate] += soln_coeff[idof] * fe_values_vol.shape_grad_component(idof, iquad, istate);
+        if (!tensor_operators) {
+            for (unsigned int idof=0; idof<n_dofs_cell; ++idof) {
+                  const unsigned int istate = fe_values_vol.get_fe().system_to_component_index(idof).first;
+                  soln_at_q[iquad][istate]      += soln_coeff[idof] * fe_values_vol.shape_value_component(idof, iquad, istate);
+                  soln_grad_at_q[iquad][istate] += soln_coeff[idof] * fe_values_vol.shape_grad_component(idof, iquad, istate);
+            }
         }
         //std::cout << "Density " << soln_at_q[iquad][0] << std::endl;
         //if(nstate>1) std::cout << "Momentum " << soln_at_q[iquad][1] << std::endl;
         //std::cout << "Energy " << soln_at_q[iquad][nstate-1] << std::endl;
-        // Evaluate physical convective flux and source term
-        conv_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->convective_flux (soln_at_q[iquad]);
-        diss_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux (soln_at_q[iquad], soln_grad_at_q[iquad]);
+    }
+
+    // Evaluate the physical fluxes of all the quadrature points at once.
+    std::array<std::vector<real>,nstate> soln_batch;
+    std::array<std::array<std::vector<real>,dim>,nstate> soln_grad_batch, conv_flux_batch, diss_flux_batch;
+    for (int istate=0; istate<nstate; istate++) {
+        soln_batch[istate].resize(n_quad_pts);
+        for (int d=0; d<dim; ++d) soln_grad_batch[istate][d].resize(n_quad_pts);
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            soln_batch[istate][iquad] = soln_at_q[iquad][istate];
+            for (int d=0; d<dim; ++d) soln_grad_batch[istate][d][iquad] = soln_grad_at_q[iquad][istate][d];
+        }
+    }
+    DGBaseState<dim,nstate,real>::pde_physics_double->convective_flux_batch (soln_batch, conv_flux_batch);
+    DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux_batch (soln_batch, soln_grad_batch, diss_flux_batch);
+
+    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+        for (int istate=0; istate<nstate; istate++) {
+            for (int d=0; d<dim; ++d) {
+                conv_phys_flux_at_q[iquad][istate][d] = conv_flux_batch[istate][d][iquad];
+                diss_phys_flux_at_q[iquad][istate][d] = diss_flux_batch[istate][d][iquad];
+            }
+        }
+        // Evaluate source term
         if(this->all_parameters->manufactured_convergence_study_param.use_manufactured_source_term) {
             source_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->source_term (fe_values_vol.quadrature_point(iquad), soln_at_q[iquad]);
         }
@@ -575,7 +622,6 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
 
     const double cell_diameter = fe_values_vol.get_cell()->diameter();
     const unsigned int cell_index = fe_values_vol.get_cell()->active_cell_index();
-    const unsigned int cell_degree = fe_values_vol.get_fe().tensor_degree();
     this->max_dt_cell[cell_index] = DGBaseState<dim,nstate,real>::evaluate_CFL ( soln_at_q, 0.0, cell_diameter, cell_degree);
 
 
@@ -583,17 +629,50 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
     // Since we have nodal values of the flux, we use the Lagrange polynomials to obtain the gradients at the quadrature points.
     //const dealii::FEValues<dim,dim> &fe_values_lagrange = this->fe_values_collection_volume_lagrange.get_present_fe_values();
     std::vector<realArray> flux_divergence(n_quad_pts);
-    for (int istate = 0; istate<nstate; ++istate) {
+    if (tensor_operators) {
+        // The Lagrange basis through the quadrature nodes is a tensor product, so that the reference derivative
+        // of a flux basis function is only non-zero at the quadrature points aligned with its node.
+        // The divergence is therefore computed along the lines of quadrature points in each reference direction.
+        const unsigned int n_quad_1d = tensor_operators->n_quad_1d;
+        const real split_factor = (this->all_parameters->use_split_form == true) ? 2.0 : 1.0;
         for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-            flux_divergence[iquad][istate] = 0.0;
-            for ( unsigned int flux_basis = 0; flux_basis < n_quad_pts; ++flux_basis ) {
-                if (this->all_parameters->use_split_form == true)
-                {
-                    flux_divergence[iquad][istate] += 2* DGBaseState<dim,nstate,real>::pde_physics_double->convective_numerical_split_flux(soln_at_q[iquad],soln_at_q[flux_basis])[istate] *  fe_values_lagrange.shape_grad(flux_basis,iquad);
+            for (int istate = 0; istate<nstate; ++istate) {
+                flux_divergence[iquad][istate] = 0.0;
+            }
+            const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values_vol.inverse_jacobian(iquad);
+            for (int d_ref=0; d_ref<dim; ++d_ref) {
+                const unsigned int stride = tensor_operators->quad_stride(d_ref);
+                const unsigned int i_line = (iquad / stride) % n_quad_1d;
+                const unsigned int line_start = iquad - i_line * stride;
+                for (unsigned int j_line = 0; j_line < n_quad_1d; ++j_line) {
+                    const unsigned int flux_basis = line_start + j_line * stride;
+                    const double derivative = tensor_operators->collocated_derivative_1d(i_line, j_line);
+                    const realArrayTensor1 flux = (this->all_parameters->use_split_form == true)
+                        ? DGBaseState<dim,nstate,real>::pde_physics_double->convective_numerical_split_flux(soln_at_q[iquad],soln_at_q[flux_basis])
+                        : conv_phys_flux_at_q[flux_basis];
+                    for (int istate = 0; istate<nstate; ++istate) {
+                        real contravariant_flux = 0.0;
+                        for (int d_phys=0; d_phys<dim; ++d_phys) {
+                            contravariant_flux += inv_jacobian[d_ref][d_phys] * flux[istate][d_phys];
+                        }
+                        flux_divergence[iquad][istate] += split_factor * derivative * contravariant_flux;
+                    }
                 }
-                else
-                {
-                    flux_divergence[iquad][istate] += conv_phys_flux_at_q[flux_basis][istate] * fe_values_lagrange.shape_grad(flux_basis,iquad);
+            }
+        }
+    } else {
+        for (int istate = 0; istate<nstate; ++istate) {
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                flux_divergence[iquad][istate] = 0.0;
+                for ( unsigned int flux_basis = 0; flux_basis < n_quad_pts; ++flux_basis ) {
+                    if (this->all_parameters->use_split_form == true)
+                    {
+                        flux_divergence[iquad][istate] += 2* DGBaseState<dim,nstate,real>::pde_physics_double->convective_numerical_split_flux(soln_at_q[iquad],soln_at_q[flux_basis])[istate] *  fe_values_lagrange.shape_grad(flux_basis,iquad);
+                    }
+                    else
+                    {
+                        flux_divergence[iquad][istate] += conv_phys_flux_at_q[flux_basis][istate] * fe_values_lagrange.shape_grad(flux_basis,iquad);
+                    }
                 }
             }
         }
@@ -607,6 +686,34 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
     // rhs = - \divergence( Fconv + Fdiss ) + source 
     // Since we have done an integration by parts, the volume term resulting from the divergence of Fconv and Fdiss
     // is negative. Therefore, negative of negative means we add that volume term to the right-hand-side
+    if (tensor_operators) {
+        const bool use_source = this->all_parameters->manufactured_convergence_study_param.use_manufactured_source_term;
+        std::vector<double> values_state_at_q(n_quad_pts);
+        std::array<std::vector<double>,dim> ref_flux_state_at_q;
+        for (int d=0; d<dim; ++d) ref_flux_state_at_q[d].resize(n_quad_pts);
+        std::vector<double> rhs_state(tensor_operators->n_dofs_scalar);
+        for (int istate=0; istate<nstate; istate++) {
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                values_state_at_q[iquad] = -flux_divergence[iquad][istate];
+                if (use_source) values_state_at_q[iquad] += source_at_q[iquad][istate];
+                values_state_at_q[iquad] *= JxW[iquad];
+                const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values_vol.inverse_jacobian(iquad);
+                for (int d_ref=0; d_ref<dim; ++d_ref) {
+                    ref_flux_state_at_q[d_ref][iquad] = 0.0;
+                    for (int d_phys=0; d_phys<dim; ++d_phys) {
+                        ref_flux_state_at_q[d_ref][iquad] += inv_jacobian[d_ref][d_phys] * diss_phys_flux_at_q[iquad][istate][d_phys];
+                    }
+                    ref_flux_state_at_q[d_ref][iquad] *= JxW[iquad];
+                }
+            }
+            std::fill(rhs_state.begin(), rhs_state.end(), 0.0);
+            tensor_operators->integrate_volume(&values_state_at_q, &ref_flux_state_at_q, rhs_state);
+            for (unsigned int ishape=0; ishape<tensor_operators->n_dofs_scalar; ++ishape) {
+                local_rhs_int_cell(tensor_operators->component_dofs[istate][ishape]) += rhs_state[ishape];
+            }
+        }
+        return;
+    }
     for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
 
         realtype rhs = 0;
@@ -764,7 +871,7 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_explicit(
                 //residual_derivatives[idof] = rhs.fastAccessDx(idof);
                 residual_derivatives[idof] = rhs.fastAccessDx(idof);
             }
-            this->system_matrix.add(dof_indices_int[itest], dof_indices_int, residual_derivatives);
+            this->add_to_system_matrix(dof_indices_int[itest], dof_indices_int, residual_derivatives);
         }
     }
 }
@@ -922,8 +1029,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_explicit(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR1_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(dof_indices_int[itest_int], dof_indices_int, dR1_dW1);
-            this->system_matrix.add(dof_indices_int[itest_int], dof_indices_ext, dR1_dW2);
+            this->add_to_system_matrix(dof_indices_int[itest_int], dof_indices_int, dR1_dW1);
+            if (!this->block_diagonal_system_matrix) this->add_to_system_matrix(dof_indices_int[itest_int], dof_indices_ext, dR1_dW2);
         }
     }
 
@@ -949,8 +1056,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_explicit(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR2_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(dof_indices_ext[itest_ext], dof_indices_int, dR2_dW1);
-            this->system_matrix.add(dof_indices_ext[itest_ext], dof_indices_ext, dR2_dW2);
+            if (!this->block_diagonal_system_matrix) this->add_to_system_matrix(dof_indices_ext[itest_ext], dof_indices_int, dR2_dW1);
+            this->add_to_system_matrix(dof_indices_ext[itest_ext], dof_indices_ext, dR2_dW2);
         }
     }
 }
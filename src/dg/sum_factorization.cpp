@@ -0,0 +1,299 @@
+#include <deal.II/base/qprojector.h>
+
+#include <deal.II/fe/fe_dgq.h>
+
+#include "sum_factorization.hpp"
+
+namespace PHiLiP {
+
+/// Integer power used to size the tensor-product operators.
+inline unsigned int tensor_size(const unsigned int n_1d, const int n_axes)
+{
+    unsigned int size = 1;
+    for (int d=0; d<n_axes; ++d) size *= n_1d;
+    return size;
+}
+
+template <int dim>
+TensorProductOperators<dim>::TensorProductOperators(
+    const dealii::FiniteElement<dim,dim> &fe,
+    const dealii::Quadrature<1> &oned_quadrature,
+    const dealii::Quadrature<dim-1> &face_quadrature)
+    : n_components(fe.n_components())
+    , n_dofs_1d(fe.tensor_degree()+1)
+    , n_quad_1d(oned_quadrature.size())
+    , n_dofs_scalar(tensor_size(n_dofs_1d, dim))
+    , n_quad_pts(tensor_size(n_quad_1d, dim))
+    , n_face_quad_pts(tensor_size(n_quad_1d, dim-1))
+    , face_operators_available(face_quadrature.size() == n_face_quad_pts)
+{
+    AssertDimension(fe.dofs_per_cell, n_components*n_dofs_scalar);
+
+    // The FE_DGQ basis of each component is numbered lexicographically.
+    component_dofs.resize(n_components, std::vector<unsigned int>(n_dofs_scalar));
+    for (unsigned int idof=0; idof<fe.dofs_per_cell; ++idof) {
+        const std::pair<unsigned int, unsigned int> component_and_index = fe.system_to_component_index(idof);
+        component_dofs[component_and_index.first][component_and_index.second] = idof;
+    }
+
+    const dealii::FE_DGQ<1> fe_1d(fe.tensor_degree());
+    const dealii::FE_DGQArbitraryNodes<1> lagrange_1d(oned_quadrature);
+
+    basis_at_quad_1d.reinit(n_quad_1d, n_dofs_1d);
+    gradient_at_quad_1d.reinit(n_quad_1d, n_dofs_1d);
+    collocated_derivative_1d.reinit(n_quad_1d, n_quad_1d);
+    for (unsigned int iquad=0; iquad<n_quad_1d; ++iquad) {
+        const dealii::Point<1> &point = oned_quadrature.point(iquad);
+        for (unsigned int idof=0; idof<n_dofs_1d; ++idof) {
+            basis_at_quad_1d(iquad,idof) = fe_1d.shape_value(idof, point);
+            gradient_at_quad_1d(iquad,idof) = fe_1d.shape_grad(idof, point)[0];
+        }
+        for (unsigned int jnode=0; jnode<n_quad_1d; ++jnode) {
+            collocated_derivative_1d(iquad,jnode) = lagrange_1d.shape_grad(jnode, point)[0];
+        }
+    }
+
+    for (unsigned int side=0; side<2; ++side) {
+        const dealii::Point<1> point(static_cast<double>(side));
+        basis_at_face_1d[side].reinit(1, n_dofs_1d);
+        gradient_at_face_1d[side].reinit(1, n_dofs_1d);
+        for (unsigned int idof=0; idof<n_dofs_1d; ++idof) {
+            basis_at_face_1d[side](0,idof) = fe_1d.shape_value(idof, point);
+            gradient_at_face_1d[side](0,idof) = fe_1d.shape_grad(idof, point)[0];
+        }
+    }
+
+    // Find where each face quadrature point lies on the tensor grid of the face.
+    // This takes care of the axes permutation of the face coordinates done by the QProjector.
+    if (!face_operators_available) return;
+    const double tolerance = 1e-12;
+    for (unsigned int face_no=0; face_no<2*dim; ++face_no) {
+        const unsigned int normal_axis = face_no / 2;
+        const dealii::Quadrature<dim> projected_quadrature = dealii::QProjector<dim>::project_to_face(
+            dealii::ReferenceCell::get_hypercube(dim), face_quadrature, face_no);
+
+        face_quad_to_tensor[face_no].resize(n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            const dealii::Point<dim> &point = projected_quadrature.point(iquad);
+            unsigned int tensor_index = 0;
+            unsigned int stride = 1;
+            for (int axis=0; axis<dim; ++axis) {
+                if (axis == (int)normal_axis) continue;
+                unsigned int index_1d = n_quad_1d;
+                for (unsigned int j=0; j<n_quad_1d; ++j) {
+                    if (std::abs(oned_quadrature.point(j)[0] - point[axis]) < tolerance) index_1d = j;
+                }
+                if (index_1d == n_quad_1d) {
+                    face_operators_available = false;
+                    return;
+                }
+                tensor_index += index_1d * stride;
+                stride *= n_quad_1d;
+            }
+            face_quad_to_tensor[face_no][iquad] = tensor_index;
+        }
+    }
+}
+
+template <int dim>
+unsigned int TensorProductOperators<dim>::quad_stride(const unsigned int direction) const
+{
+    return tensor_size(n_quad_1d, direction);
+}
+
+template <int dim>
+void TensorProductOperators<dim>::apply_along_axis(
+    const dealii::FullMatrix<double> &operator_1d,
+    const bool transpose,
+    const unsigned int axis,
+    std::array<unsigned int,dim> &sizes,
+    const std::vector<double> &in,
+    std::vector<double> &out) const
+{
+    const unsigned int n_in  = transpose ? operator_1d.m() : operator_1d.n();
+    const unsigned int n_out = transpose ? operator_1d.n() : operator_1d.m();
+    AssertDimension(sizes[axis], n_in);
+
+    unsigned int n_pre = 1;
+    for (unsigned int d=0; d<axis; ++d) n_pre *= sizes[d];
+    unsigned int n_post = 1;
+    for (unsigned int d=axis+1; d<dim; ++d) n_post *= sizes[d];
+
+    out.resize(n_pre*n_out*n_post);
+    for (unsigned int ipost=0; ipost<n_post; ++ipost) {
+        const double *in_post = &in[n_pre*n_in*ipost];
+        double *out_post = &out[n_pre*n_out*ipost];
+        for (unsigned int iout=0; iout<n_out; ++iout) {
+            double *out_line = out_post + n_pre*iout;
+            for (unsigned int ipre=0; ipre<n_pre; ++ipre) out_line[ipre] = 0.0;
+            for (unsigned int iin=0; iin<n_in; ++iin) {
+                const double coeff = transpose ? operator_1d(iin,iout) : operator_1d(iout,iin);
+                const double *in_line = in_post + n_pre*iin;
+                for (unsigned int ipre=0; ipre<n_pre; ++ipre) out_line[ipre] += coeff * in_line[ipre];
+            }
+        }
+    }
+    sizes[axis] = n_out;
+}
+
+template <int dim>
+void TensorProductOperators<dim>::apply_tensor_product(
+    const std::array<const dealii::FullMatrix<double>*,dim> &operators_1d,
+    const bool transpose,
+    std::array<unsigned int,dim> sizes,
+    const std::vector<double> &in,
+    std::vector<double> &out) const
+{
+    std::vector<double> work_in(in);
+    for (int axis=0; axis<dim; ++axis) {
+        apply_along_axis(*(operators_1d[axis]), transpose, axis, sizes, work_in, out);
+        if (axis < dim-1) work_in.swap(out);
+    }
+}
+
+template <int dim>
+void TensorProductOperators<dim>::evaluate_volume(
+    const std::vector<double> &coeff,
+    std::vector<double> &values,
+    std::array<std::vector<double>,dim> *ref_gradients) const
+{
+    AssertDimension(coeff.size(), n_dofs_scalar);
+    std::array<unsigned int,dim> sizes;
+    sizes.fill(n_dofs_1d);
+
+    std::array<const dealii::FullMatrix<double>*,dim> operators_1d;
+    operators_1d.fill(&basis_at_quad_1d);
+    apply_tensor_product(operators_1d, false, sizes, coeff, values);
+
+    if (ref_gradients == nullptr) return;
+    for (int d=0; d<dim; ++d) {
+        operators_1d.fill(&basis_at_quad_1d);
+        operators_1d[d] = &gradient_at_quad_1d;
+        apply_tensor_product(operators_1d, false, sizes, coeff, (*ref_gradients)[d]);
+    }
+}
+
+template <int dim>
+void TensorProductOperators<dim>::integrate_volume(
+    const std::vector<double> *values,
+    const std::array<std::vector<double>,dim> *ref_fluxes,
+    std::vector<double> &coeff) const
+{
+    coeff.resize(n_dofs_scalar);
+    std::array<unsigned int,dim> sizes;
+    sizes.fill(n_quad_1d);
+
+    std::array<const dealii::FullMatrix<double>*,dim> operators_1d;
+    std::vector<double> contribution;
+    if (values != nullptr) {
+        AssertDimension(values->size(), n_quad_pts);
+        operators_1d.fill(&basis_at_quad_1d);
+        apply_tensor_product(operators_1d, true, sizes, *values, contribution);
+        for (unsigned int i=0; i<n_dofs_scalar; ++i) coeff[i] += contribution[i];
+    }
+    if (ref_fluxes == nullptr) return;
+    for (int d=0; d<dim; ++d) {
+        AssertDimension((*ref_fluxes)[d].size(), n_quad_pts);
+        operators_1d.fill(&basis_at_quad_1d);
+        operators_1d[d] = &gradient_at_quad_1d;
+        apply_tensor_product(operators_1d, true, sizes, (*ref_fluxes)[d], contribution);
+        for (unsigned int i=0; i<n_dofs_scalar; ++i) coeff[i] += contribution[i];
+    }
+}
+
+template <int dim>
+void TensorProductOperators<dim>::evaluate_face(
+    const unsigned int face_no,
+    const std::vector<double> &coeff,
+    std::vector<double> &values,
+    std::array<std::vector<double>,dim> *ref_gradients) const
+{
+    Assert(face_operators_available, dealii::ExcMessage("Face quadrature is not a tensor product of the 1D quadrature."));
+    AssertDimension(coeff.size(), n_dofs_scalar);
+    const unsigned int normal_axis = face_no / 2;
+    const unsigned int side = face_no % 2;
+    const std::vector<unsigned int> &quad_to_tensor = face_quad_to_tensor[face_no];
+
+    std::array<unsigned int,dim> sizes;
+    sizes.fill(n_dofs_1d);
+
+    std::vector<double> tensor_values;
+    std::array<const dealii::FullMatrix<double>*,dim> operators_1d;
+    operators_1d.fill(&basis_at_quad_1d);
+    operators_1d[normal_axis] = &basis_at_face_1d[side];
+    apply_tensor_product(operators_1d, false, sizes, coeff, tensor_values);
+
+    values.resize(n_face_quad_pts);
+    for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+        values[iquad] = tensor_values[quad_to_tensor[iquad]];
+    }
+
+    if (ref_gradients == nullptr) return;
+    for (int d=0; d<dim; ++d) {
+        operators_1d.fill(&basis_at_quad_1d);
+        if (d == (int)normal_axis) {
+            operators_1d[normal_axis] = &gradient_at_face_1d[side];
+        } else {
+            operators_1d[normal_axis] = &basis_at_face_1d[side];
+            operators_1d[d] = &gradient_at_quad_1d;
+        }
+        apply_tensor_product(operators_1d, false, sizes, coeff, tensor_values);
+
+        (*ref_gradients)[d].resize(n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            (*ref_gradients)[d][iquad] = tensor_values[quad_to_tensor[iquad]];
+        }
+    }
+}
+
+template <int dim>
+void TensorProductOperators<dim>::integrate_face(
+    const unsigned int face_no,
+    const std::vector<double> *values,
+    const std::array<std::vector<double>,dim> *ref_fluxes,
+    std::vector<double> &coeff) const
+{
+    Assert(face_operators_available, dealii::ExcMessage("Face quadrature is not a tensor product of the 1D quadrature."));
+    coeff.resize(n_dofs_scalar);
+    const unsigned int normal_axis = face_no / 2;
+    const unsigned int side = face_no % 2;
+    const std::vector<unsigned int> &quad_to_tensor = face_quad_to_tensor[face_no];
+
+    std::array<unsigned int,dim> sizes;
+    sizes.fill(n_quad_1d);
+    sizes[normal_axis] = 1;
+
+    std::vector<double> tensor_values(n_face_quad_pts);
+    std::vector<double> contribution;
+    std::array<const dealii::FullMatrix<double>*,dim> operators_1d;
+    if (values != nullptr) {
+        AssertDimension(values->size(), n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            tensor_values[quad_to_tensor[iquad]] = (*values)[iquad];
+        }
+        operators_1d.fill(&basis_at_quad_1d);
+        operators_1d[normal_axis] = &basis_at_face_1d[side];
+        apply_tensor_product(operators_1d, true, sizes, tensor_values, contribution);
+        for (unsigned int i=0; i<n_dofs_scalar; ++i) coeff[i] += contribution[i];
+    }
+    if (ref_fluxes == nullptr) return;
+    for (int d=0; d<dim; ++d) {
+        AssertDimension((*ref_fluxes)[d].size(), n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            tensor_values[quad_to_tensor[iquad]] = (*ref_fluxes)[d][iquad];
+        }
+        operators_1d.fill(&basis_at_quad_1d);
+        if (d == (int)normal_axis) {
+            operators_1d[normal_axis] = &gradient_at_face_1d[side];
+        } else {
+            operators_1d[normal_axis] = &basis_at_face_1d[side];
+            operators_1d[d] = &gradient_at_quad_1d;
+        }
+        apply_tensor_product(operators_1d, true, sizes, tensor_values, contribution);
+        for (unsigned int i=0; i<n_dofs_scalar; ++i) coeff[i] += contribution[i];
+    }
+}
+
+template class TensorProductOperators <PHILIP_DIM>;
+
+} // PHiLiP namespace
@@ -0,0 +1,133 @@
+#ifndef __SUM_FACTORIZATION_H__
+#define __SUM_FACTORIZATION_H__
+
+#include <array>
+#include <vector>
+
+#include <deal.II/base/quadrature.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/lac/full_matrix.h>
+
+namespace PHiLiP {
+
+/// Tensor-product operators used to evaluate the explicit residual through sum-factorization.
+/** The FE_DGQ basis functions and the Gauss (or Gauss-Lobatto) quadrature points of a hexahedral cell
+ *  are tensor products of 1D entities. Interpolating the solution to the quadrature points, or
+ *  integrating against the test functions, can therefore be done one reference direction at a time.
+ *  The cost per cell drops from \f$ \mathcal{O}(p^{2d}) \f$ for the dense operators to
+ *  \f$ \mathcal{O}(p^{d+1}) \f$.
+ *
+ *  All the values are in the reference element. The caller recovers the physical gradients
+ *  through the inverse Jacobian of the mapping, and brings physical fluxes back to the reference
+ *  element before integrating them.
+ *
+ *  Scalar coefficients and volume quadrature points are ordered lexicographically with the first
+ *  coordinate running fastest, which is the ordering used by dealii::FE_DGQ and dealii::QGauss<dim>.
+ *  Face values are given in the same order as the dealii::FEFaceValues quadrature points of a face
+ *  with standard orientation.
+ */
+template <int dim>
+class TensorProductOperators
+{
+public:
+    /// Constructor.
+    /** @param[in] fe FESystem made of FE_DGQ elements, one per state.
+     *  @param[in] oned_quadrature 1D quadrature whose tensor product is the volume quadrature.
+     *  @param[in] face_quadrature Face quadrature used by the FEFaceValues.
+     */
+    TensorProductOperators(
+        const dealii::FiniteElement<dim,dim> &fe,
+        const dealii::Quadrature<1> &oned_quadrature,
+        const dealii::Quadrature<dim-1> &face_quadrature);
+
+    const unsigned int n_components;    ///< Number of components (states) of the FESystem.
+    const unsigned int n_dofs_1d;       ///< Number of 1D basis functions.
+    const unsigned int n_quad_1d;       ///< Number of 1D quadrature points.
+    const unsigned int n_dofs_scalar;   ///< Number of basis functions of a single component.
+    const unsigned int n_quad_pts;      ///< Number of volume quadrature points.
+    const unsigned int n_face_quad_pts; ///< Number of face quadrature points.
+
+    /// Whether the face quadrature is the tensor product of the 1D quadrature.
+    /** If false, the face operators cannot be used and the dense operators should be used instead. */
+    bool face_operators_available;
+
+    /// Local degree of freedom of the FESystem given a component and a lexicographic scalar index.
+    std::vector<std::vector<unsigned int>> component_dofs;
+
+    /// Differentiation matrix of the 1D Lagrange basis through the 1D quadrature nodes.
+    /** Entry (i,j) is the derivative of the j-th Lagrange polynomial at the i-th node.
+     *  Used by the strong form to differentiate fluxes known at the quadrature points.
+     */
+    dealii::FullMatrix<double> collocated_derivative_1d;
+
+    /// Interpolate scalar coefficients to the volume quadrature points.
+    /** Also evaluates the reference gradients if @p ref_gradients is not a nullptr. */
+    void evaluate_volume(
+        const std::vector<double> &coeff,
+        std::vector<double> &values,
+        std::array<std::vector<double>,dim> *ref_gradients) const;
+
+    /// Adds the integral of the quadrature values and reference fluxes against the test functions.
+    /** Computes \f$ \sum_q \phi_i(\xi_q) v_q + \sum_q \nabla_\xi \phi_i(\xi_q) \cdot \mathbf{g}_q \f$.
+     *  Either of @p values or @p ref_fluxes may be nullptr. Quadrature weights and Jacobian determinants
+     *  are expected to have been multiplied into the input.
+     */
+    void integrate_volume(
+        const std::vector<double> *values,
+        const std::array<std::vector<double>,dim> *ref_fluxes,
+        std::vector<double> &coeff) const;
+
+    /// Interpolate scalar coefficients to the quadrature points of face @p face_no.
+    /** Also evaluates the reference gradients if @p ref_gradients is not a nullptr. */
+    void evaluate_face(
+        const unsigned int face_no,
+        const std::vector<double> &coeff,
+        std::vector<double> &values,
+        std::array<std::vector<double>,dim> *ref_gradients) const;
+
+    /// Adds the integral of the face quadrature values and reference fluxes against the test functions.
+    /** Transpose of evaluate_face(). Either of @p values or @p ref_fluxes may be nullptr. */
+    void integrate_face(
+        const unsigned int face_no,
+        const std::vector<double> *values,
+        const std::array<std::vector<double>,dim> *ref_fluxes,
+        std::vector<double> &coeff) const;
+
+    /// Stride between two consecutive quadrature points along a reference direction.
+    unsigned int quad_stride(const unsigned int direction) const;
+
+private:
+    /// 1D basis functions evaluated at the 1D quadrature points. Size n_quad_1d x n_dofs_1d.
+    dealii::FullMatrix<double> basis_at_quad_1d;
+    /// 1D basis functions derivatives evaluated at the 1D quadrature points. Size n_quad_1d x n_dofs_1d.
+    dealii::FullMatrix<double> gradient_at_quad_1d;
+    /// 1D basis functions evaluated at the left and right end of the interval. Size 1 x n_dofs_1d.
+    std::array<dealii::FullMatrix<double>,2> basis_at_face_1d;
+    /// 1D basis functions derivatives evaluated at the left and right end of the interval. Size 1 x n_dofs_1d.
+    std::array<dealii::FullMatrix<double>,2> gradient_at_face_1d;
+
+    /// Maps the FEFaceValues quadrature point to the lexicographic index on the face tensor grid.
+    std::array<std::vector<unsigned int>, 2*dim> face_quad_to_tensor;
+
+    /// Applies a 1D operator along the reference @p axis of a lexicographically ordered tensor.
+    /** @p sizes contains the extent of each axis of @p in and is updated to those of @p out. */
+    void apply_along_axis(
+        const dealii::FullMatrix<double> &operator_1d,
+        const bool transpose,
+        const unsigned int axis,
+        std::array<unsigned int,dim> &sizes,
+        const std::vector<double> &in,
+        std::vector<double> &out) const;
+
+    /// Applies one 1D operator per axis, starting from the first axis.
+    void apply_tensor_product(
+        const std::array<const dealii::FullMatrix<double>*,dim> &operators_1d,
+        const bool transpose,
+        std::array<unsigned int,dim> sizes,
+        const std::vector<double> &in,
+        std::vector<double> &out) const;
+};
+
+} // PHiLiP namespace
+
+#endif
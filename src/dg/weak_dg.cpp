@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/table.h>
 
@@ -20,7 +22,6 @@
 #define KOPRIVA_METRICS_VOL
 #define KOPRIVA_METRICS_FACE
 #define KOPRIVA_METRICS_BOUNDARY
-//#define FADFAD
 
 /// Returns the value from a CoDiPack variable.
 /** The recursive calling allows to retrieve nested CoDiPack types.
@@ -82,6 +83,8 @@ DGWeak<dim,nstate,real>::DGWeak(
     const unsigned int grid_degree_input,
     const std::shared_ptr<Triangulation> triangulation_input)
     : DGBaseState<dim,nstate,real>::DGBaseState(parameters_input, degree, max_degree_input, grid_degree_input, triangulation_input)
+    , volume_tape_physics(nullptr)
+    , volume_tape_signature({{0,0,0}})
 { }
 // Destructor
 template <int dim, int nstate, typename real>
@@ -478,6 +481,10 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_explicit(
 
 
 
+    const unsigned int cell_degree = fe_values_vol.get_fe().tensor_degree();
+    const std::shared_ptr<TensorProductOperators<dim>> tensor_operators =
+        this->all_parameters->use_sum_factorization ? this->tensor_product_operators[cell_degree] : nullptr;
+
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
         for (int istate=0; istate<nstate; istate++) {
             // Interpolate solution to the face quadrature points
@@ -485,16 +492,61 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_explicit(
             soln_grad_at_q[iquad][istate] = 0;
         }
     }
+    if (tensor_operators) {
+        // Interpolate one state at a time through sum-factorization.
+        // Gradients are obtained in the reference element and mapped through the inverse Jacobian.
+        std::vector<double> soln_coeff_state(tensor_operators->n_dofs_scalar);
+        std::vector<double> soln_state_at_q;
+        std::array<std::vector<double>,dim> ref_grad_state_at_q;
+        for (int istate=0; istate<nstate; istate++) {
+            for (unsigned int ishape=0; ishape<tensor_operators->n_dofs_scalar; ++ishape) {
+                soln_coeff_state[ishape] = soln_coeff[tensor_operators->component_dofs[istate][ishape]];
+            }
+            tensor_operators->evaluate_volume(soln_coeff_state, soln_state_at_q, &ref_grad_state_at_q);
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                soln_at_q[iquad][istate] = soln_state_at_q[iquad];
+                const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values_vol.inverse_jacobian(iquad);
+                for (int d_ref=0; d_ref<dim; ++d_ref) {
+                    for (int d_phys=0; d_phys<dim; ++d_phys) {
+                        soln_grad_at_q[iquad][istate][d_phys] += ref_grad_state_at_q[d_ref][iquad] * inv_jacobian[d_ref][d_phys];
+                    }
+                }
+            }
+        }
+    }
     // Interpolate solution to face
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
-              const unsigned int istate = fe_values_vol.get_fe().system_to_component_index(idof).first;
-              soln_at_q[iquad][istate]      += soln_coeff[idof] * fe_values_vol.shape_value_component(idof, iquad, istate);
-              soln_grad_at_q[iquad][istate] += soln_coeff[idof] * fe_values_vol.shape_grad_component(idof, iquad, istate);
+        if (!tensor_operators) {
+            for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
+                  const unsigned int istate = fe_values_vol.get_fe().system_to_component_index(idof).first;
+                  soln_at_q[iquad][istate]      += soln_coeff[idof] * fe_values_vol.shape_value_component(idof, iquad, istate);
+                  soln_grad_at_q[iquad][istate] += soln_coeff[idof] * fe_values_vol.shape_grad_component(idof, iquad, istate);
+            }
+        }
+    }
+
+    // Evaluate the physical fluxes of all the quadrature points at once.
+    std::array<std::vector<real>,nstate> soln_batch;
+    std::array<std::array<std::vector<real>,dim>,nstate> soln_grad_batch, conv_flux_batch, diss_flux_batch;
+    for (int istate=0; istate<nstate; istate++) {
+        soln_batch[istate].resize(n_quad_pts);
+        for (int d=0; d<dim; ++d) soln_grad_batch[istate][d].resize(n_quad_pts);
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            soln_batch[istate][iquad] = soln_at_q[iquad][istate];
+            for (int d=0; d<dim; ++d) soln_grad_batch[istate][d][iquad] = soln_grad_at_q[iquad][istate][d];
+        }
+    }
+    DGBaseState<dim,nstate,real>::pde_physics_double->convective_flux_batch (soln_batch, conv_flux_batch);
+    DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux_batch (soln_batch, soln_grad_batch, diss_flux_batch);
+
+    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+        for (int istate=0; istate<nstate; istate++) {
+            for (int d=0; d<dim; ++d) {
+                conv_phys_flux_at_q[iquad][istate][d] = conv_flux_batch[istate][d][iquad];
+                diss_phys_flux_at_q[iquad][istate][d] = diss_flux_batch[istate][d][iquad];
+            }
         }
-        // Evaluate physical convective flux and source term
-        conv_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->convective_flux (soln_at_q[iquad]);
-        diss_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux (soln_at_q[iquad], soln_grad_at_q[iquad]);
+        // Evaluate artificial dissipation and source term
         if(this->all_parameters->add_artificial_dissipation) {
             const ADArrayTensor1 artificial_diss_phys_flux_at_q = DGBaseState<dim,nstate,real>::pde_physics_double->artificial_dissipative_flux (artificial_diss_coeff, soln_at_q[iquad], soln_grad_at_q[iquad]);
             for (int istate=0; istate<nstate; istate++) {
@@ -510,7 +562,6 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_explicit(
     }
 
     const unsigned int cell_index = fe_values_vol.get_cell()->active_cell_index();
-    const unsigned int cell_degree = fe_values_vol.get_fe().tensor_degree();
     real cell_volume = 0.0;
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
         cell_volume = cell_volume + JxW[iquad];
@@ -531,6 +582,35 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_explicit(
     // rhs = - \divergence( Fconv + Fdiss ) + source
     // Since we have done an integration by parts, the volume term resulting from the divergence of Fconv and Fdiss
     // is negative. Therefore, negative of negative means we add that volume term to the right-hand-side
+    if (tensor_operators) {
+        // Bring the physical fluxes back to the reference element, such that
+        // \nabla_x \phi \cdot F = \nabla_\xi \phi \cdot (J^{-1} F)
+        const bool use_source = this->all_parameters->manufactured_convergence_study_param.use_manufactured_source_term;
+        std::vector<double> source_state_at_q(n_quad_pts);
+        std::array<std::vector<double>,dim> ref_flux_state_at_q;
+        for (int d=0; d<dim; ++d) ref_flux_state_at_q[d].resize(n_quad_pts);
+        std::vector<double> rhs_state(tensor_operators->n_dofs_scalar);
+        for (int istate=0; istate<nstate; istate++) {
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values_vol.inverse_jacobian(iquad);
+                const dealii::Tensor<1,dim,real> flux = conv_phys_flux_at_q[iquad][istate] + diss_phys_flux_at_q[iquad][istate];
+                for (int d_ref=0; d_ref<dim; ++d_ref) {
+                    ref_flux_state_at_q[d_ref][iquad] = 0.0;
+                    for (int d_phys=0; d_phys<dim; ++d_phys) {
+                        ref_flux_state_at_q[d_ref][iquad] += inv_jacobian[d_ref][d_phys] * flux[d_phys];
+                    }
+                    ref_flux_state_at_q[d_ref][iquad] *= JxW[iquad];
+                }
+                if (use_source) source_state_at_q[iquad] = source_at_q[iquad][istate] * JxW[iquad];
+            }
+            std::fill(rhs_state.begin(), rhs_state.end(), 0.0);
+            tensor_operators->integrate_volume(use_source ? &source_state_at_q : nullptr, &ref_flux_state_at_q, rhs_state);
+            for (unsigned int ishape=0; ishape<tensor_operators->n_dofs_scalar; ++ishape) {
+                local_rhs_int_cell(tensor_operators->component_dofs[istate][ishape]) += rhs_state[ishape];
+            }
+        }
+        return;
+    }
     for (unsigned int itest=0; itest<n_soln_dofs_int; ++itest) {
 
         real rhs = 0;
@@ -767,36 +847,154 @@ void DGWeak<dim,nstate,real>::assemble_face_term_explicit(
                                            this->artificial_dissipation_coeffs[neighbor_cell_index]
                                            : 0.0;
 
-    for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+    // Sum-factorization is only used on conforming faces with standard orientation,
+    // where the face quadrature points of both cells are a tensor product of the 1D quadrature.
+    std::shared_ptr<TensorProductOperators<dim>> tensor_operators_int;
+    std::shared_ptr<TensorProductOperators<dim>> tensor_operators_ext;
+    unsigned int face_number_int = 0, face_number_ext = 0;
+    if (this->all_parameters->use_sum_factorization
+        && dynamic_cast<const dealii::FEFaceValues<dim,dim>*>(&fe_values_int)
+        && dynamic_cast<const dealii::FEFaceValues<dim,dim>*>(&fe_values_ext))
+    {
+        face_number_int = fe_values_int.get_face_number();
+        face_number_ext = fe_values_ext.get_face_number();
+        const auto cell_int = fe_values_int.get_cell();
+        const auto cell_ext = fe_values_ext.get_cell();
+        const bool standard_orientation =
+            cell_int->face_orientation(face_number_int) && !cell_int->face_flip(face_number_int) && !cell_int->face_rotation(face_number_int)
+            && cell_ext->face_orientation(face_number_ext) && !cell_ext->face_flip(face_number_ext) && !cell_ext->face_rotation(face_number_ext);
+        tensor_operators_int = this->tensor_product_operators[fe_values_int.get_fe().tensor_degree()];
+        tensor_operators_ext = this->tensor_product_operators[fe_values_ext.get_fe().tensor_degree()];
+        if (!standard_orientation
+            || !tensor_operators_int->face_operators_available || !tensor_operators_ext->face_operators_available
+            || tensor_operators_int->n_face_quad_pts != n_face_quad_pts || tensor_operators_ext->n_face_quad_pts != n_face_quad_pts)
+        {
+            tensor_operators_int = nullptr;
+            tensor_operators_ext = nullptr;
+        }
+    }
+    const bool use_sum_factorization = (tensor_operators_int != nullptr);
+
+    if (use_sum_factorization) {
+        const auto interpolate_to_face = [&](
+            const TensorProductOperators<dim> &tensor_operators,
+            const unsigned int face_number,
+            const dealii::FEFaceValuesBase<dim,dim> &fe_values,
+            const std::vector<real> &soln_coeff,
+            std::vector< doubleArray > &soln,
+            std::vector< doubleArrayTensor1 > &soln_grad)
+        {
+            std::vector<double> soln_coeff_state(tensor_operators.n_dofs_scalar);
+            std::vector<double> soln_state;
+            std::array<std::vector<double>,dim> ref_grad_state;
+            for (int istate=0; istate<nstate; istate++) {
+                for (unsigned int ishape=0; ishape<tensor_operators.n_dofs_scalar; ++ishape) {
+                    soln_coeff_state[ishape] = soln_coeff[tensor_operators.component_dofs[istate][ishape]];
+                }
+                tensor_operators.evaluate_face(face_number, soln_coeff_state, soln_state, &ref_grad_state);
+                for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+                    soln[iquad][istate] = soln_state[iquad];
+                    const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values.inverse_jacobian(iquad);
+                    for (int d_ref=0; d_ref<dim; ++d_ref) {
+                        for (int d_phys=0; d_phys<dim; ++d_phys) {
+                            soln_grad[iquad][istate][d_phys] += ref_grad_state[d_ref][iquad] * inv_jacobian[d_ref][d_phys];
+                        }
+                    }
+                }
+            }
+        };
+        interpolate_to_face(*tensor_operators_int, face_number_int, fe_values_int, soln_coeff_int, soln_int, soln_grad_int);
+        interpolate_to_face(*tensor_operators_ext, face_number_ext, fe_values_ext, soln_coeff_ext, soln_ext, soln_grad_ext);
+    }
 
-        const dealii::Tensor<1,dim,real> normal_int = normals_int[iquad];
-        const dealii::Tensor<1,dim,real> normal_ext = -normal_int;
+    // Interpolate solution to face
+    if (!use_sum_factorization) {
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
+                const unsigned int istate = fe_values_int.get_fe().system_to_component_index(idof).first;
+                soln_int[iquad][istate]      += soln_coeff_int[idof] * fe_values_int.shape_value_component(idof, iquad, istate);
+                soln_grad_int[iquad][istate] += soln_coeff_int[idof] * fe_values_int.shape_grad_component(idof, iquad, istate);
+            }
+            for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
+                const unsigned int istate = fe_values_ext.get_fe().system_to_component_index(idof).first;
+                soln_ext[iquad][istate]      += soln_coeff_ext[idof] * fe_values_ext.shape_value_component(idof, iquad, istate);
+                soln_grad_ext[iquad][istate] += soln_coeff_ext[idof] * fe_values_ext.shape_grad_component(idof, iquad, istate);
+            }
+        }
+    }
 
-        // Interpolate solution to face
-        for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
-            const unsigned int istate = fe_values_int.get_fe().system_to_component_index(idof).first;
-            soln_int[iquad][istate]      += soln_coeff_int[idof] * fe_values_int.shape_value_component(idof, iquad, istate);
-            soln_grad_int[iquad][istate] += soln_coeff_int[idof] * fe_values_int.shape_grad_component(idof, iquad, istate);
+    // The numerical fluxes of the whole face are evaluated at once, using structure-of-arrays storage.
+    using doubleArrayBatch = std::array< std::vector<real>, nstate >;
+    using doubleArrayTensor1Batch = std::array< std::array< std::vector<real>, dim >, nstate >;
+    doubleArrayBatch soln_int_batch, soln_ext_batch;
+    doubleArrayTensor1Batch soln_grad_int_batch, soln_grad_ext_batch;
+    std::array< std::vector<real>, dim > normal_int_batch, normal_ext_batch;
+    for (int d=0; d<dim; d++) {
+        normal_int_batch[d].resize(n_face_quad_pts);
+        normal_ext_batch[d].resize(n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            normal_int_batch[d][iquad] = normals_int[iquad][d];
+            normal_ext_batch[d][iquad] = -normals_int[iquad][d];
         }
-        for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
-            const unsigned int istate = fe_values_ext.get_fe().system_to_component_index(idof).first;
-            soln_ext[iquad][istate]      += soln_coeff_ext[idof] * fe_values_ext.shape_value_component(idof, iquad, istate);
-            soln_grad_ext[iquad][istate] += soln_coeff_ext[idof] * fe_values_ext.shape_grad_component(idof, iquad, istate);
+    }
+    for (int s=0; s<nstate; s++) {
+        soln_int_batch[s].resize(n_face_quad_pts);
+        soln_ext_batch[s].resize(n_face_quad_pts);
+        for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+            soln_int_batch[s][iquad] = soln_int[iquad][s];
+            soln_ext_batch[s][iquad] = soln_ext[iquad][s];
+        }
+        for (int d=0; d<dim; d++) {
+            soln_grad_int_batch[s][d].resize(n_face_quad_pts);
+            soln_grad_ext_batch[s][d].resize(n_face_quad_pts);
+            for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+                soln_grad_int_batch[s][d][iquad] = soln_grad_int[iquad][s][d];
+                soln_grad_ext_batch[s][d][iquad] = soln_grad_ext[iquad][s][d];
+            }
         }
+    }
 
-        // Evaluate physical convective flux, physical dissipative flux, and source term
-        conv_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::conv_num_flux_double->evaluate_flux(soln_int[iquad], soln_ext[iquad], normal_int);
-        diss_soln_num_flux[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_double->evaluate_solution_flux(soln_int[iquad], soln_ext[iquad], normal_int);
+    // Evaluate the numerical fluxes and the physical dissipative fluxes of the solution jumps
+    doubleArrayBatch conv_num_flux_dot_n_batch, diss_soln_num_flux_batch, diss_auxi_num_flux_dot_n_batch;
+    DGBaseState<dim,nstate,real>::conv_num_flux_double->evaluate_flux_batch(soln_int_batch, soln_ext_batch, normal_int_batch, conv_num_flux_dot_n_batch);
+    DGBaseState<dim,nstate,real>::diss_num_flux_double->evaluate_solution_flux_batch(soln_int_batch, soln_ext_batch, normal_int_batch, diss_soln_num_flux_batch);
+
+    doubleArrayTensor1Batch diss_soln_jump_int_batch, diss_soln_jump_ext_batch;
+    for (int s=0; s<nstate; s++) {
+        for (int d=0; d<dim; d++) {
+            diss_soln_jump_int_batch[s][d].resize(n_face_quad_pts);
+            diss_soln_jump_ext_batch[s][d].resize(n_face_quad_pts);
+            for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+                diss_soln_jump_int_batch[s][d][iquad] = (diss_soln_num_flux_batch[s][iquad] - soln_int_batch[s][iquad]) * normal_int_batch[d][iquad];
+                diss_soln_jump_ext_batch[s][d][iquad] = (diss_soln_num_flux_batch[s][iquad] - soln_ext_batch[s][iquad]) * normal_ext_batch[d][iquad];
+            }
+        }
+    }
+    doubleArrayTensor1Batch diss_flux_jump_int_batch, diss_flux_jump_ext_batch;
+    DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux_batch (soln_int_batch, diss_soln_jump_int_batch, diss_flux_jump_int_batch);
+    DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux_batch (soln_ext_batch, diss_soln_jump_ext_batch, diss_flux_jump_ext_batch);
+
+    DGBaseState<dim,nstate,real>::diss_num_flux_double->evaluate_auxiliary_flux_batch(
+        artificial_diss_coeff_int,
+        artificial_diss_coeff_ext,
+        soln_int_batch, soln_ext_batch,
+        soln_grad_int_batch, soln_grad_ext_batch,
+        normal_int_batch, penalty,
+        diss_auxi_num_flux_dot_n_batch);
 
+    for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
         doubleArrayTensor1 diss_soln_jump_int, diss_soln_jump_ext;
         for (int s=0; s<nstate; s++) {
+            conv_num_flux_dot_n[iquad][s] = conv_num_flux_dot_n_batch[s][iquad];
+            diss_soln_num_flux[iquad][s] = diss_soln_num_flux_batch[s][iquad];
+            diss_auxi_num_flux_dot_n[iquad][s] = diss_auxi_num_flux_dot_n_batch[s][iquad];
             for (int d=0; d<dim; d++) {
-                diss_soln_jump_int[s][d] = (diss_soln_num_flux[iquad][s] - soln_int[iquad][s]) * normal_int[d];
-                diss_soln_jump_ext[s][d] = (diss_soln_num_flux[iquad][s] - soln_ext[iquad][s]) * normal_ext[d];
+                diss_soln_jump_int[s][d] = diss_soln_jump_int_batch[s][d][iquad];
+                diss_soln_jump_ext[s][d] = diss_soln_jump_ext_batch[s][d][iquad];
+                diss_flux_jump_int[iquad][s][d] = diss_flux_jump_int_batch[s][d][iquad];
+                diss_flux_jump_ext[iquad][s][d] = diss_flux_jump_ext_batch[s][d][iquad];
             }
         }
-        diss_flux_jump_int[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux (soln_int[iquad], diss_soln_jump_int);
-        diss_flux_jump_ext[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux (soln_ext[iquad], diss_soln_jump_ext);
 
         if (this->all_parameters->add_artificial_dissipation) {
             const doubleArrayTensor1 artificial_diss_flux_jump_int = DGBaseState<dim,nstate,real>::pde_physics_double->artificial_dissipative_flux (artificial_diss_coeff_int, soln_int[iquad], diss_soln_jump_int);
@@ -806,13 +1004,43 @@ void DGWeak<dim,nstate,real>::assemble_face_term_explicit(
                 diss_flux_jump_ext[iquad][s] += artificial_diss_flux_jump_ext[s];
             }
         }
+    }
 
-        diss_auxi_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_double->evaluate_auxiliary_flux(
-            artificial_diss_coeff_int,
-            artificial_diss_coeff_ext,
-            soln_int[iquad], soln_ext[iquad],
-            soln_grad_int[iquad], soln_grad_ext[iquad],
-            normal_int, penalty);
+    if (use_sum_factorization) {
+        const auto integrate_on_face = [&](
+            const TensorProductOperators<dim> &tensor_operators,
+            const unsigned int face_number,
+            const dealii::FEFaceValuesBase<dim,dim> &fe_values,
+            const real sign,
+            const std::vector<doubleArrayTensor1> &diss_flux_jump,
+            dealii::Vector<real> &local_rhs_cell)
+        {
+            std::vector<double> values_state(n_face_quad_pts);
+            std::array<std::vector<double>,dim> ref_flux_state;
+            for (int d=0; d<dim; ++d) ref_flux_state[d].resize(n_face_quad_pts);
+            std::vector<double> rhs_state(tensor_operators.n_dofs_scalar);
+            for (int istate=0; istate<nstate; istate++) {
+                for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+                    values_state[iquad] = -sign * (conv_num_flux_dot_n[iquad][istate] + diss_auxi_num_flux_dot_n[iquad][istate]) * JxW_int[iquad];
+                    const dealii::DerivativeForm<1,dim,dim> &inv_jacobian = fe_values.inverse_jacobian(iquad);
+                    for (int d_ref=0; d_ref<dim; ++d_ref) {
+                        ref_flux_state[d_ref][iquad] = 0.0;
+                        for (int d_phys=0; d_phys<dim; ++d_phys) {
+                            ref_flux_state[d_ref][iquad] += inv_jacobian[d_ref][d_phys] * diss_flux_jump[iquad][istate][d_phys];
+                        }
+                        ref_flux_state[d_ref][iquad] *= JxW_int[iquad];
+                    }
+                }
+                std::fill(rhs_state.begin(), rhs_state.end(), 0.0);
+                tensor_operators.integrate_face(face_number, &values_state, &ref_flux_state, rhs_state);
+                for (unsigned int ishape=0; ishape<tensor_operators.n_dofs_scalar; ++ishape) {
+                    local_rhs_cell(tensor_operators.component_dofs[istate][ishape]) += rhs_state[ishape];
+                }
+            }
+        };
+        integrate_on_face(*tensor_operators_int, face_number_int, fe_values_int,  1.0, diss_flux_jump_int, local_rhs_int_cell);
+        integrate_on_face(*tensor_operators_ext, face_number_ext, fe_values_ext, -1.0, diss_flux_jump_ext, local_rhs_ext_cell);
+        return;
     }
 
     // From test functions associated with interior cell point of view
@@ -834,7 +1062,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term_explicit(
     // From test functions associated with neighbor cell point of view
     for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
         real rhs = 0.0;
-        const unsigned int istate = fe_values_int.get_fe().system_to_component_index(itest_ext).first;
+        const unsigned int istate = fe_values_ext.get_fe().system_to_component_index(itest_ext).first;
 
         for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
             // Convection
@@ -889,11 +1117,20 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     const std::vector<dealii::Point<dim,real>> &unit_quad_pts = face_quadrature.get_points();
     std::vector<dealii::Point<dim,adtype>> real_quad_pts(unit_quad_pts.size());
 
-    std::vector<dealii::Tensor<2,dim,adtype>> metric_jacobian = evaluate_metric_jacobian (unit_quad_pts, coords_coeff, fe_metric);
     std::vector<adtype> jac_det(n_quad_pts);
     std::vector<adtype> surface_jac_det(n_quad_pts);
     std::vector<dealii::Tensor<2,dim,adtype>> jac_inv_tran(n_quad_pts);
 
+    // The metric terms only depend on the grid and can be reused when they are not differentiated.
+    bool use_metric_cache = false;
+    bool metric_terms_from_cache = false;
+    if constexpr (std::is_same<adtype,double>::value) {
+        use_metric_cache = compute_metric_derivatives && this->all_parameters->use_metric_cache;
+        if (use_metric_cache) metric_terms_from_cache = this->metric_cache.get_face_terms(current_cell_index, face_number, jac_det, jac_inv_tran);
+    }
+    std::vector<dealii::Tensor<2,dim,adtype>> metric_jacobian;
+    if (!metric_terms_from_cache) metric_jacobian = evaluate_metric_jacobian (unit_quad_pts, coords_coeff, fe_metric);
+
     const dealii::Tensor<1,dim,real> unit_normal = dealii::GeometryInfo<dim>::unit_normal_vector[face_number];
     std::vector<dealii::Tensor<1,dim,adtype>> normals(n_quad_pts);
 
@@ -904,6 +1141,8 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
                 const int iaxis = fe_metric.system_to_component_index(idof).first;
                 real_quad_pts[iquad][iaxis] += coords_coeff[idof] * fe_metric.shape_value(idof,unit_quad_pts[iquad]);
             }
+            // The normals and surface Jacobians are evaluated from the final metric terms below.
+            if (metric_terms_from_cache) continue;
 
             const adtype jacobian_determinant = dealii::determinant(metric_jacobian[iquad]);
             const dealii::Tensor<2,dim,adtype> jacobian_transpose_inverse = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
@@ -939,7 +1178,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     auto old_jac_inv_tran = jac_inv_tran;
 
     if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,adtype> ( face_quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
+        if (!metric_terms_from_cache) evaluate_covariant_metric_jacobian<dim,adtype> ( face_quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
     }
 
     //for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
@@ -961,6 +1200,9 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     //    }
     //}
 #endif
+    if constexpr (std::is_same<adtype,double>::value) {
+        if (use_metric_cache && !metric_terms_from_cache) this->metric_cache.store_face_terms(current_cell_index, face_number, jac_det, jac_inv_tran);
+    }
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
         if (compute_metric_derivatives) {
             const dealii::Tensor<1,dim,adtype> normal = vmult(jac_inv_tran[iquad], unit_normal);
@@ -1111,9 +1353,8 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     }
 }
 
-#ifdef FADFAD
 template <int dim, int nstate, typename real>
-void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
+void DGWeak<dim,nstate,real>::assemble_boundary_fad_fad_derivatives(
     const dealii::types::global_dof_index current_cell_index,
     const unsigned int face_number,
     const unsigned int boundary_id,
@@ -1213,7 +1454,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
                 residual_derivatives[idof] = rhs[itest].dx(i_dx).val();
                 AssertIsFinite(residual_derivatives[idof]);
             }
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
         }
         if (compute_dRdX) {
             std::vector<real> residual_derivatives(n_metric_dofs);
@@ -1221,7 +1462,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
                 const unsigned int i_dx = idof+x_start;
                 residual_derivatives[idof] = rhs[itest].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
 
     }
@@ -1239,13 +1480,13 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
                 const unsigned int j_dx = jdof+w_start;
                 dWidW[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices[idof], soln_dof_indices, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices[idof], soln_dof_indices, dWidW);
 
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices[idof], metric_dof_indices, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices[idof], metric_dof_indices, dWidX);
         }
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
 
@@ -1256,11 +1497,10 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
                 const unsigned int j_dx = jdof+x_start;
                 dXidX[jdof] = dXi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
     }
 }
-#endif
 
 template <int dim, int nstate, typename real>
 template <typename adtype>
@@ -1376,7 +1616,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
                 residual_derivatives[idof] = jac(itest,i_dx);
                 AssertIsFinite(residual_derivatives[idof]);
             }
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
         }
         th.deleteJacobian(jac);
 
@@ -1391,7 +1631,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
                 const unsigned int i_dx = idof+x_start;
                 residual_derivatives[idof] = jac(itest,i_dx);
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
         th.deleteJacobian(jac);
     }
@@ -1415,13 +1655,13 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+w_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices[idof], soln_dof_indices, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices[idof], soln_dof_indices, dWidW);
 
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices[idof], metric_dof_indices, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices[idof], metric_dof_indices, dWidX);
         }
 
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -1432,7 +1672,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+x_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
 
         th.deleteHessian(hes);
@@ -1519,7 +1759,6 @@ void DGWeak<dim,nstate,real>::assemble_boundary_residual(
 
 }
 
-#ifndef FADFAD
 template <int dim, int nstate, typename real>
 void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
     const dealii::types::global_dof_index current_cell_index,
@@ -1535,7 +1774,21 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
     const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R)
 {
     (void) current_cell_index;
-    if (compute_d2R) {
+    if (this->assembling_derivatives_with_threads) {
+        // The CoDiPack tapes can't be recorded by multiple threads.
+        assemble_boundary_fad_fad_derivatives(
+            current_cell_index,
+            face_number,
+            boundary_id,
+            fe_values_boundary,
+            penalty,
+            fe_soln,
+            quadrature,
+            metric_dof_indices,
+            soln_dof_indices,
+            local_rhs_cell,
+            compute_dRdW, compute_dRdX, compute_d2R);
+    } else if (compute_d2R) {
         assemble_boundary_codi_taped_derivatives<codi_HessianComputationType>(
             current_cell_index,
             face_number,
@@ -1585,7 +1838,6 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
             compute_dRdW, compute_dRdX, compute_d2R);
     }
 }
-#endif
 
 
 template <int dim, int nstate, typename real>
@@ -1688,9 +1940,33 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
 
 
 
+    std::vector<real2> jacobian_determinant_int(n_face_quad_pts);
+    std::vector<real2> jacobian_determinant_ext(n_face_quad_pts);
+    std::vector<Tensor2D> jacobian_transpose_inverse_int(n_face_quad_pts);
+    std::vector<Tensor2D> jacobian_transpose_inverse_ext(n_face_quad_pts);
+
+    // The metric terms only depend on the grid and can be reused when they are not differentiated.
+    // Only whole faces are stored, since subfaces are few and are only found on non-conforming grids.
+    bool use_metric_cache_int = false, use_metric_cache_ext = false;
+    bool metric_terms_from_cache_int = false, metric_terms_from_cache_ext = false;
+    if constexpr (std::is_same<real2,double>::value) {
+        const bool use_metric_cache = compute_metric_derivatives && this->all_parameters->use_metric_cache;
+        use_metric_cache_int = use_metric_cache && (face_subface_int.second == -1);
+        use_metric_cache_ext = use_metric_cache && (face_subface_ext.second == -1);
+        if (use_metric_cache_int) {
+            metric_terms_from_cache_int = this->metric_cache.get_face_terms(
+                current_cell_index, face_subface_int.first, jacobian_determinant_int, jacobian_transpose_inverse_int);
+        }
+        if (use_metric_cache_ext) {
+            metric_terms_from_cache_ext = this->metric_cache.get_face_terms(
+                neighbor_cell_index, face_subface_ext.first, jacobian_determinant_ext, jacobian_transpose_inverse_ext);
+        }
+    }
+
     // Use the metric Jacobian from the interior cell
-    std::vector<Tensor2D> metric_jac_int = evaluate_metric_jacobian (unit_quad_pts_int, coords_coeff_int, fe_metric);
-    std::vector<Tensor2D> metric_jac_ext = evaluate_metric_jacobian (unit_quad_pts_ext, coords_coeff_ext, fe_metric);
+    std::vector<Tensor2D> metric_jac_int, metric_jac_ext;
+    if (!metric_terms_from_cache_int) metric_jac_int = evaluate_metric_jacobian (unit_quad_pts_int, coords_coeff_int, fe_metric);
+    if (!metric_terms_from_cache_ext) metric_jac_ext = evaluate_metric_jacobian (unit_quad_pts_ext, coords_coeff_ext, fe_metric);
     std::vector<Tensor2D> jac_inv_tran_int(n_face_quad_pts);
     std::vector<Tensor2D> jac_inv_tran_ext(n_face_quad_pts);
 
@@ -1744,18 +2020,16 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
                                             this->artificial_dissipation_coeffs[neighbor_cell_index]
                                             : 0.0;
 
-    std::vector<real2> jacobian_determinant_int(n_face_quad_pts);
-    std::vector<real2> jacobian_determinant_ext(n_face_quad_pts);
-    std::vector<Tensor2D> jacobian_transpose_inverse_int(n_face_quad_pts);
-    std::vector<Tensor2D> jacobian_transpose_inverse_ext(n_face_quad_pts);
-
     for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
         if (compute_metric_derivatives) {
-            jacobian_determinant_int[iquad] = dealii::determinant(metric_jac_int[iquad]);
-            jacobian_determinant_ext[iquad] = dealii::determinant(metric_jac_ext[iquad]);
-
-            jacobian_transpose_inverse_int[iquad] = dealii::transpose(dealii::invert(metric_jac_int[iquad]));
-            jacobian_transpose_inverse_ext[iquad] = dealii::transpose(dealii::invert(metric_jac_ext[iquad]));
+            if (!metric_terms_from_cache_int) {
+                jacobian_determinant_int[iquad] = dealii::determinant(metric_jac_int[iquad]);
+                jacobian_transpose_inverse_int[iquad] = dealii::transpose(dealii::invert(metric_jac_int[iquad]));
+            }
+            if (!metric_terms_from_cache_ext) {
+                jacobian_determinant_ext[iquad] = dealii::determinant(metric_jac_ext[iquad]);
+                jacobian_transpose_inverse_ext[iquad] = dealii::transpose(dealii::invert(metric_jac_ext[iquad]));
+            }
         }
     }
 
@@ -1766,8 +2040,8 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
     auto old_jacobian_transpose_inverse_ext = jacobian_transpose_inverse_ext;
 
     if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_int, coords_coeff_int, fe_metric, jacobian_transpose_inverse_int, jacobian_determinant_int);
-        evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_ext, coords_coeff_ext, fe_metric, jacobian_transpose_inverse_ext, jacobian_determinant_ext);
+        if (!metric_terms_from_cache_int) evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_int, coords_coeff_int, fe_metric, jacobian_transpose_inverse_int, jacobian_determinant_int);
+        if (!metric_terms_from_cache_ext) evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_ext, coords_coeff_ext, fe_metric, jacobian_transpose_inverse_ext, jacobian_determinant_ext);
     }
 
     //for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
@@ -1805,6 +2079,14 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
     //    }
     //}
 #endif
+    if constexpr (std::is_same<real2,double>::value) {
+        if (use_metric_cache_int && !metric_terms_from_cache_int) {
+            this->metric_cache.store_face_terms(current_cell_index, face_subface_int.first, jacobian_determinant_int, jacobian_transpose_inverse_int);
+        }
+        if (use_metric_cache_ext && !metric_terms_from_cache_ext) {
+            this->metric_cache.store_face_terms(neighbor_cell_index, face_subface_ext.first, jacobian_determinant_ext, jacobian_transpose_inverse_ext);
+        }
+    }
 
 
     // for (unsigned int idof = 0; idof < fe_metric.n_dofs_per_cell(); ++idof) {
@@ -2070,9 +2352,8 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
 
 }
 
-#ifdef FADFAD
 template <int dim, int nstate, typename real>
-void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
+void DGWeak<dim,nstate,real>::assemble_face_fad_fad_derivatives(
     const dealii::types::global_dof_index current_cell_index,
     const dealii::types::global_dof_index neighbor_cell_index,
     const std::pair<unsigned int, int> face_subface_int,
@@ -2096,8 +2377,6 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
     (void) current_cell_index;
     (void) neighbor_cell_index;
     using adtype = FadFadType;
-    using ADArray = std::array<adtype,nstate>;
-    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,adtype>, nstate >;
 
     const dealii::FESystem<dim> &fe_metric = this->high_order_grid.fe_system;
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
@@ -2203,8 +2482,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
         fe_int,
         fe_ext,
         fe_metric,
-        face_quadrature_int,
-        face_quadrature_ext,
+        face_quadrature,
         rhs_int,
         rhs_ext,
         dual_dot_residual,
@@ -2226,25 +2504,29 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+w_int_start;
                 residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
             }
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_int, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_int, residual_derivatives);
 
             // dR_int_dW_ext
-            residual_derivatives.resize(n_soln_dofs_ext);
-            for (unsigned int idof = 0; idof < n_soln_dofs_ext; ++idof) {
-                const unsigned int i_dx = idof+w_ext_start;
-                residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
+            if (!this->block_diagonal_system_matrix) {
+                residual_derivatives.resize(n_soln_dofs_ext);
+                for (unsigned int idof = 0; idof < n_soln_dofs_ext; ++idof) {
+                    const unsigned int i_dx = idof+w_ext_start;
+                    residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
+                }
+                this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives);
             }
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives);
         }
 
         for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
             // dR_ext_dW_int
-            residual_derivatives.resize(n_soln_dofs_int);
-            for (unsigned int idof = 0; idof < n_soln_dofs_int; ++idof) {
-                const unsigned int i_dx = idof+w_int_start;
-                residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
+            if (!this->block_diagonal_system_matrix) {
+                residual_derivatives.resize(n_soln_dofs_int);
+                for (unsigned int idof = 0; idof < n_soln_dofs_int; ++idof) {
+                    const unsigned int i_dx = idof+w_int_start;
+                    residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
+                }
+                this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives);
             }
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives);
 
             // dR_ext_dW_ext
             residual_derivatives.resize(n_soln_dofs_ext);
@@ -2252,7 +2534,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+w_ext_start;
                 residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
             }
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, residual_derivatives);
         }
     }
     if (compute_dRdX) {
@@ -2263,14 +2545,14 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+x_int_start;
                 residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices_int[itest_int], metric_dof_indices_int, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices_int[itest_int], metric_dof_indices_int, residual_derivatives);
 
             // dR_int_dX_ext
             for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
                 const unsigned int i_dx = idof+x_ext_start;
                 residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices_int[itest_int], metric_dof_indices_ext, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices_int[itest_int], metric_dof_indices_ext, residual_derivatives);
         }
         for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
             // dR_ext_dX_int
@@ -2279,7 +2561,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+x_int_start;
                 residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices_ext[itest_ext], metric_dof_indices_int, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices_ext[itest_ext], metric_dof_indices_int, residual_derivatives);
 
             // dR_ext_dX_ext
             // residual_derivatives.resize(n_metric_dofs);
@@ -2287,7 +2569,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+x_ext_start;
                 residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices_ext[itest_ext], metric_dof_indices_ext, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices_ext[itest_ext], metric_dof_indices_ext, residual_derivatives);
         }
     }
 
@@ -2307,28 +2589,28 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int j_dx = jdof+w_int_start;
                 dWidWint[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_int[idof], soln_dof_indices_int, dWidWint);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_int[idof], soln_dof_indices_int, dWidWint);
 
             // dWint_dWext
             for (unsigned int jdof=0; jdof<n_soln_dofs_ext; ++jdof) {
                 const unsigned int j_dx = jdof+w_ext_start;
                 dWidWext[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_int[idof], soln_dof_indices_ext, dWidWext);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_int[idof], soln_dof_indices_ext, dWidWext);
 
             // dWint_dXint
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_int[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_int[idof], metric_dof_indices_int, dWidX);
 
             // dWint_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
         }
         // dWext
         for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
@@ -2341,28 +2623,28 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int j_dx = jdof+w_int_start;
                 dWidWint[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_ext[idof], soln_dof_indices_int, dWidWint);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_ext[idof], soln_dof_indices_int, dWidWint);
 
             // dWext_dWext
             for (unsigned int jdof=0; jdof<n_soln_dofs_ext; ++jdof) {
                 const unsigned int j_dx = jdof+w_ext_start;
                 dWidWext[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_ext[idof], soln_dof_indices_ext, dWidWext);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_ext[idof], soln_dof_indices_ext, dWidWext);
 
             // dWext_dXint
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
 
             // dWext_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
         }
 
         // dXint
@@ -2376,14 +2658,14 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_int[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_int[idof], metric_dof_indices_int, dWidX);
 
             // dXint_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
         }
         // dXext
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -2396,20 +2678,18 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
 
             // dXext_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
         }
     }
 }
-#endif
 
-#ifndef FADFAD
 template <int dim, int nstate, typename real>
 template <typename adtype>
 void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
@@ -2586,15 +2866,17 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     const unsigned int i_dx = idof+w_int_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_int, residual_derivatives);
+                this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_int, residual_derivatives);
 
                 // dR_int_dW_ext
-                residual_derivatives.resize(n_soln_dofs_ext);
-                for (unsigned int idof = 0; idof < n_soln_dofs_ext; ++idof) {
-                    const unsigned int i_dx = idof+w_ext_start;
-                    residual_derivatives[idof] = jac(i_dependent,i_dx);
+                if (!this->block_diagonal_system_matrix) {
+                    residual_derivatives.resize(n_soln_dofs_ext);
+                    for (unsigned int idof = 0; idof < n_soln_dofs_ext; ++idof) {
+                        const unsigned int i_dx = idof+w_ext_start;
+                        residual_derivatives[idof] = jac(i_dependent,i_dx);
+                    }
+                    this->add_to_system_matrix(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives);
                 }
-                this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives);
             }
 
             for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
@@ -2602,12 +2884,14 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 int i_dependent = n_soln_dofs_int + itest_ext;
 
                 // dR_ext_dW_int
-                residual_derivatives.resize(n_soln_dofs_int);
-                for (unsigned int idof = 0; idof < n_soln_dofs_int; ++idof) {
-                    const unsigned int i_dx = idof+w_int_start;
-                    residual_derivatives[idof] = jac(i_dependent,i_dx);
+                if (!this->block_diagonal_system_matrix) {
+                    residual_derivatives.resize(n_soln_dofs_int);
+                    for (unsigned int idof = 0; idof < n_soln_dofs_int; ++idof) {
+                        const unsigned int i_dx = idof+w_int_start;
+                        residual_derivatives[idof] = jac(i_dependent,i_dx);
+                    }
+                    this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives);
                 }
-                this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives);
 
                 // dR_ext_dW_ext
                 residual_derivatives.resize(n_soln_dofs_ext);
@@ -2615,7 +2899,7 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     const unsigned int i_dx = idof+w_ext_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, residual_derivatives);
+                this->add_to_system_matrix(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, residual_derivatives);
             }
         }
 
@@ -2631,14 +2915,14 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     const unsigned int i_dx = idof+x_int_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->dRdXv.add(soln_dof_indices_int[itest_int], metric_dof_indices_int, residual_derivatives);
+                this->add_to_matrix(this->dRdXv, soln_dof_indices_int[itest_int], metric_dof_indices_int, residual_derivatives);
 
                 // dR_int_dX_ext
                 for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
                     const unsigned int i_dx = idof+x_ext_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->dRdXv.add(soln_dof_indices_int[itest_int], metric_dof_indices_ext, residual_derivatives);
+                this->add_to_matrix(this->dRdXv, soln_dof_indices_int[itest_int], metric_dof_indices_ext, residual_derivatives);
             }
 
             for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
@@ -2650,14 +2934,14 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     const unsigned int i_dx = idof+x_int_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->dRdXv.add(soln_dof_indices_ext[itest_ext], metric_dof_indices_int, residual_derivatives);
+                this->add_to_matrix(this->dRdXv, soln_dof_indices_ext[itest_ext], metric_dof_indices_int, residual_derivatives);
 
                 // dR_ext_dX_ext
                 for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
                     const unsigned int i_dx = idof+x_ext_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->dRdXv.add(soln_dof_indices_ext[itest_ext], metric_dof_indices_ext, residual_derivatives);
+                this->add_to_matrix(this->dRdXv, soln_dof_indices_ext[itest_ext], metric_dof_indices_ext, residual_derivatives);
             }
         }
 
@@ -2683,28 +2967,28 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+w_int_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_int[idof], soln_dof_indices_int, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_int[idof], soln_dof_indices_int, dWidW);
 
             // dWint_dWext
             for (unsigned int jdof=0; jdof<n_soln_dofs_ext; ++jdof) {
                 const unsigned int j_dx = jdof+w_ext_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_int[idof], soln_dof_indices_ext, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_int[idof], soln_dof_indices_ext, dWidW);
 
             // dWint_dXint
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_int[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_int[idof], metric_dof_indices_int, dWidX);
 
             // dWint_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_int[idof], metric_dof_indices_ext, dWidX);
         }
 
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -2716,14 +3000,14 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+x_int_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_int[idof], metric_dof_indices_int, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_int[idof], metric_dof_indices_int, dXidX);
 
             // dXint_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_int[idof], metric_dof_indices_ext, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_int[idof], metric_dof_indices_ext, dXidX);
         }
 
         dWidW.resize(n_soln_dofs_ext);
@@ -2737,28 +3021,28 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+w_int_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_ext[idof], soln_dof_indices_int, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_ext[idof], soln_dof_indices_int, dWidW);
 
             // dWext_dWext
             for (unsigned int jdof=0; jdof<n_soln_dofs_ext; ++jdof) {
                 const unsigned int j_dx = jdof+w_ext_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices_ext[idof], soln_dof_indices_ext, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices_ext[idof], soln_dof_indices_ext, dWidW);
 
             // dWext_dXint
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_int_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_ext[idof], metric_dof_indices_int, dWidX);
 
             // dWext_dXext
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices_ext[idof], metric_dof_indices_ext, dWidX);
         }
 
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -2770,13 +3054,13 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+x_int_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_ext[idof], metric_dof_indices_int, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_ext[idof], metric_dof_indices_int, dXidX);
 
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_ext_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices_ext[idof], metric_dof_indices_ext, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices_ext[idof], metric_dof_indices_ext, dXidX);
         }
 
         th.deleteHessian(hes);
@@ -2907,7 +3191,6 @@ void DGWeak<dim,nstate,real>::assemble_face_residual(
     }
 
 }
-#endif
 
 template <int dim, int nstate, typename real>
 template <typename real2>
@@ -2939,74 +3222,86 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
 
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
 
-    // Evaluate metric terms
-    std::vector<Tensor2D> metric_jacobian;
-    if (compute_metric_derivatives) metric_jacobian = evaluate_metric_jacobian ( points, coords_coeff, fe_metric);
     std::vector<real2> jac_det(n_quad_pts);
     std::vector<Tensor2D> jac_inv_tran(n_quad_pts);
-    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+    // The metric terms only depend on the grid and can be reused when they are not differentiated.
+    bool use_metric_cache = false;
+    bool metric_terms_from_cache = false;
+    if constexpr (std::is_same<real2,double>::value) {
+        use_metric_cache = compute_metric_derivatives && this->all_parameters->use_metric_cache;
+        if (use_metric_cache) metric_terms_from_cache = this->metric_cache.get_volume_terms(current_cell_index, jac_det, jac_inv_tran);
+    }
+    if (!metric_terms_from_cache) {
+        // Evaluate metric terms
+        std::vector<Tensor2D> metric_jacobian;
+        if (compute_metric_derivatives) metric_jacobian = evaluate_metric_jacobian ( points, coords_coeff, fe_metric);
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
 
-        if (compute_metric_derivatives) {
-            const real2 jacobian_determinant = dealii::determinant(metric_jacobian[iquad]);
-            jac_det[iquad] = jacobian_determinant;
+            if (compute_metric_derivatives) {
+                const real2 jacobian_determinant = dealii::determinant(metric_jacobian[iquad]);
+                jac_det[iquad] = jacobian_determinant;
 
-            const Tensor2D jacobian_transpose_inverse = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
-            jac_inv_tran[iquad] = jacobian_transpose_inverse;
-        } else {
-            jac_det[iquad] = fe_values_vol.JxW(iquad) / quadrature.weight(iquad);
+                const Tensor2D jacobian_transpose_inverse = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
+                jac_inv_tran[iquad] = jacobian_transpose_inverse;
+            } else {
+                jac_det[iquad] = fe_values_vol.JxW(iquad) / quadrature.weight(iquad);
+            }
         }
-    }
 #ifdef KOPRIVA_METRICS_VOL
-    auto old_jac_inv_tran = jac_inv_tran;
-    auto old_jac_det = jac_det;
-    if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,real2> ( quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
-    }
-    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        if (abs(old_jac_det[iquad] - jac_det[iquad]) > 1e-10) {
-            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-            std::cout << "Not the same jac det, iquad " << iquad << std::endl;
-            std::cout << old_jac_det[iquad] << std::endl;
-            std::cout << jac_det[iquad] << std::endl;
-        }
-        //for (int row=0;row<dim;++row) {
-        //    for (int col=0;col<dim;++col) {
-        //        if (abs(old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]) > 1e-10) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << "Not the same jac inv tran, iquad " << iquad << " row " << row << " col " << col << std::endl;
-        //            std::cout << old_jac_inv_tran[iquad][row][col] << std::endl;
-        //            std::cout << jac_inv_tran[iquad][row][col] << std::endl;
-        //        }
-        //    }
-        //}
-        //real2 mnorm = 0;
-        //for (int row=0;row<dim;++row) {
-        //    for (int col=0;col<dim;++col) {
-        //        real2 val = (old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]);
-        //        mnorm += val*val;
-        //    }
-        //}
-        //mnorm = sqrt(mnorm);
-        //if (mnorm > 1e-10) {
-        //    std::cout << "Not the same jac inv tran, iquad " << iquad << std::endl;
-        //    for (int row=0;row<dim;++row) {
-        //        for (int col=0;col<dim;++col) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << old_jac_inv_tran[iquad][row][col] << " ";
-        //        }
-        //        std::cout << std::endl;
-        //    }
-        //    std::cout << std::endl;
-        //    for (int row=0;row<dim;++row) {
-        //        for (int col=0;col<dim;++col) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << jac_inv_tran[iquad][row][col] << " ";
-        //        }
-        //        std::cout << std::endl;
-        //    }
-        //}
-    }
+        auto old_jac_inv_tran = jac_inv_tran;
+        auto old_jac_det = jac_det;
+        if constexpr (dim != 1) {
+            evaluate_covariant_metric_jacobian<dim,real2> ( quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
+        }
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            if (abs(old_jac_det[iquad] - jac_det[iquad]) > 1e-10) {
+                std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+                std::cout << "Not the same jac det, iquad " << iquad << std::endl;
+                std::cout << old_jac_det[iquad] << std::endl;
+                std::cout << jac_det[iquad] << std::endl;
+            }
+            //for (int row=0;row<dim;++row) {
+            //    for (int col=0;col<dim;++col) {
+            //        if (abs(old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]) > 1e-10) {
+            //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+            //            std::cout << "Not the same jac inv tran, iquad " << iquad << " row " << row << " col " << col << std::endl;
+            //            std::cout << old_jac_inv_tran[iquad][row][col] << std::endl;
+            //            std::cout << jac_inv_tran[iquad][row][col] << std::endl;
+            //        }
+            //    }
+            //}
+            //real2 mnorm = 0;
+            //for (int row=0;row<dim;++row) {
+            //    for (int col=0;col<dim;++col) {
+            //        real2 val = (old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]);
+            //        mnorm += val*val;
+            //    }
+            //}
+            //mnorm = sqrt(mnorm);
+            //if (mnorm > 1e-10) {
+            //    std::cout << "Not the same jac inv tran, iquad " << iquad << std::endl;
+            //    for (int row=0;row<dim;++row) {
+            //        for (int col=0;col<dim;++col) {
+            //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+            //            std::cout << old_jac_inv_tran[iquad][row][col] << " ";
+            //        }
+            //        std::cout << std::endl;
+            //    }
+            //    std::cout << std::endl;
+            //    for (int row=0;row<dim;++row) {
+            //        for (int col=0;col<dim;++col) {
+            //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+            //            std::cout << jac_inv_tran[iquad][row][col] << " ";
+            //        }
+            //        std::cout << std::endl;
+            //    }
+            //}
+        }
 #endif
+        if constexpr (std::is_same<real2,double>::value) {
+            if (use_metric_cache) this->metric_cache.store_volume_terms(current_cell_index, jac_det, jac_inv_tran);
+        }
+    }
 
 
     // Build operators.
@@ -3153,9 +3448,8 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
 
 }
 
-#ifdef FADFAD
 template <int dim, int nstate, typename real>
-void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
+void DGWeak<dim,nstate,real>::assemble_volume_fad_fad_derivatives(
     const dealii::types::global_dof_index current_cell_index,
     const dealii::FEValues<dim,dim> &fe_values_vol,
     const dealii::FESystem<dim,dim> &fe_soln,
@@ -3168,9 +3462,6 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
 {
     (void) current_cell_index;
 
-    using ADArray = std::array<FadFadType,nstate>;
-    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,FadFadType>, nstate >;
-
     const unsigned int n_soln_dofs     = fe_soln.dofs_per_cell;
 
     AssertDimension (n_soln_dofs, soln_dof_indices.size());
@@ -3248,7 +3539,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
                 residual_derivatives[idof] = rhs[itest].dx(i_dx).val();
                 AssertIsFinite(residual_derivatives[idof]);
             }
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
         }
         if (compute_dRdX) {
             std::vector<real> residual_derivatives(n_metric_dofs);
@@ -3256,7 +3547,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
                 const unsigned int i_dx = idof+x_start;
                 residual_derivatives[idof] = rhs[itest].dx(i_dx).val();
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
         //if (compute_d2R) {
         //    const unsigned int global_residual_row = soln_dof_indices[itest];
@@ -3284,13 +3575,13 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
                 const unsigned int j_dx = jdof+w_start;
                 dWidW[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices[idof], soln_dof_indices, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices[idof], soln_dof_indices, dWidW);
 
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_start;
                 dWidX[jdof] = dWi.dx(j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices[idof], metric_dof_indices, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices[idof], metric_dof_indices, dWidX);
         }
 
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -3302,13 +3593,11 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
                 const unsigned int j_dx = jdof+x_start;
                 dXidX[jdof] = dXi.dx(j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
     }
 
 }
-#endif
-#ifndef FADFAD
 template <int dim, int nstate, typename real>
 template <typename real2>
 void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
@@ -3418,7 +3707,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
                 residual_derivatives[idof] = jac(itest,i_dx);
                 AssertIsFinite(residual_derivatives[idof]);
             }
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
         }
         th.deleteJacobian(jac);
 
@@ -3433,7 +3722,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
                 const unsigned int i_dx = idof+x_start;
                 residual_derivatives[idof] = jac(itest,i_dx);
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
+            this->add_to_matrix(this->dRdXv, soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
         th.deleteJacobian(jac);
     }
@@ -3457,13 +3746,13 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+w_start;
                 dWidW[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdW.add(soln_dof_indices[idof], soln_dof_indices, dWidW);
+            this->add_to_matrix(this->d2RdWdW, soln_dof_indices[idof], soln_dof_indices, dWidW);
 
             for (unsigned int jdof=0; jdof<n_metric_dofs; ++jdof) {
                 const unsigned int j_dx = jdof+x_start;
                 dWidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdWdX.add(soln_dof_indices[idof], metric_dof_indices, dWidX);
+            this->add_to_matrix(this->d2RdWdX, soln_dof_indices[idof], metric_dof_indices, dWidX);
         }
 
         for (unsigned int idof=0; idof<n_metric_dofs; ++idof) {
@@ -3474,7 +3763,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
                 const unsigned int j_dx = jdof+x_start;
                 dXidX[jdof] = hes(i_dependent,i_dx,j_dx);
             }
-            this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
+            this->add_to_matrix(this->d2RdXdX, metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
 
         th.deleteHessian(hes);
@@ -3489,6 +3778,169 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
 
 }
 
+template <int dim, int nstate, typename real>
+void DGWeak<dim,nstate,real>::assemble_volume_codi_replayed_derivatives(
+    const dealii::types::global_dof_index current_cell_index,
+    const dealii::FEValues<dim,dim> &fe_values_vol,
+    const dealii::FESystem<dim,dim> &fe_soln,
+    const dealii::Quadrature<dim> &quadrature,
+    const std::vector<dealii::types::global_dof_index> &metric_dof_indices,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
+    dealii::Vector<real> &local_rhs_cell,
+    const Physics::PhysicsBase<dim, nstate, RadPrimalType> &physics)
+{
+    using adtype = RadPrimalType;
+    using TH = codi::TapeHelper<adtype>;
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    const unsigned int n_soln_dofs = fe_soln.dofs_per_cell;
+
+    AssertDimension (n_soln_dofs, soln_dof_indices.size());
+
+    const dealii::FESystem<dim> &fe_metric = this->high_order_grid.fe_system;
+    const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
+
+    // Derivative ordering is: soln, metric
+    const unsigned int w_start = 0;
+
+    const std::array<unsigned int,3> cell_signature = {{ fe_soln.tensor_degree(), quadrature.size(), n_metric_dofs }};
+    const bool replay_tape = volume_tape
+                             && volume_tape_physics == &physics
+                             && volume_tape_signature == cell_signature;
+
+    if (replay_tape) {
+        // The quadrature, shape functions, and physics are the same as the recorded cell.
+        // Only the solution and grid coefficients need to be updated.
+        adtype::Real *inputs = volume_tape->createPrimalVectorInput();
+        adtype::Real *outputs = volume_tape->createPrimalVectorOutput();
+        std::vector<real> soln_coeff(n_soln_dofs);
+        std::vector<real> coords_coeff(n_metric_dofs);
+        for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+            soln_coeff[idof] = this->solution(soln_dof_indices[idof]);
+            inputs[idof] = soln_coeff[idof];
+        }
+        for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+            coords_coeff[idof] = this->high_order_grid.volume_nodes[metric_dof_indices[idof]];
+            inputs[n_soln_dofs+idof] = coords_coeff[idof];
+        }
+
+        TH::JacobianType& jac = volume_tape->createJacobian();
+        volume_tape->evalJacobianAt(inputs, jac, outputs);
+
+        // The tape replays the branches taken at the recorded cell, such as the clipped pressure of the Euler physics.
+        // Its primal outputs are therefore compared against the residual evaluated with the branches of this cell,
+        // and the tape is recorded again if they differ.
+        const std::vector<real> local_dual(n_soln_dofs, 0.0);
+        const bool compute_metric_derivatives = true;
+        real dual_dot_residual = 0.0;
+        std::vector<real> rhs(n_soln_dofs);
+        assemble_volume_term<real>(
+            current_cell_index,
+            soln_coeff, coords_coeff, local_dual,
+            fe_soln, fe_metric, quadrature,
+            *(DGBaseState<dim,nstate,real>::pde_physics_double),
+            rhs, dual_dot_residual,
+            compute_metric_derivatives, fe_values_vol);
+
+        real max_rhs = 0.0, max_difference = 0.0;
+        for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+            max_rhs = std::max(max_rhs, std::abs(rhs[itest]));
+            max_difference = std::max(max_difference, std::abs(rhs[itest] - outputs[itest]));
+        }
+        const real branch_tolerance = 1e-10;
+        const bool same_branches = (max_difference <= branch_tolerance * max_rhs);
+
+        if (same_branches) {
+            std::vector<real> residual_derivatives(n_soln_dofs);
+            for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+                local_rhs_cell(itest) += rhs[itest];
+                AssertIsFinite(local_rhs_cell(itest));
+
+                for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+                    const unsigned int i_dx = idof+w_start;
+                    residual_derivatives[idof] = jac(itest,i_dx);
+                    AssertIsFinite(residual_derivatives[idof]);
+                }
+                this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+            }
+        }
+        volume_tape->deleteJacobian(jac);
+        volume_tape->deletePrimalVector(inputs);
+        volume_tape->deletePrimalVector(outputs);
+
+        if (same_branches) {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+            this->n_volume_tapes_replayed += 1;
+            this->volume_tapes_replaying_time += elapsed.count();
+            return;
+        }
+        this->n_volume_tape_branch_mismatches += 1;
+    }
+
+    // Recording a new tape resets the global tape, which invalidates the previous one.
+    volume_tape = std::make_unique<TH>();
+    volume_tape_physics = &physics;
+    volume_tape_signature = cell_signature;
+
+    std::vector<adtype> coords_coeff(n_metric_dofs);
+    std::vector<adtype> soln_coeff(n_soln_dofs);
+
+    volume_tape->startRecording();
+    for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+        const real val = this->solution(soln_dof_indices[idof]);
+        soln_coeff[idof] = val;
+        volume_tape->registerInput(soln_coeff[idof]);
+    }
+    // The grid coefficients are always registered such that the metric terms are not recorded as constants.
+    for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+        const real val = this->high_order_grid.volume_nodes[metric_dof_indices[idof]];
+        coords_coeff[idof] = val;
+        volume_tape->registerInput(coords_coeff[idof]);
+    }
+
+    // The dual is only used for d2R, which is never replayed.
+    const std::vector<real> local_dual(n_soln_dofs, 0.0);
+    const bool compute_metric_derivatives = true;
+
+    adtype dual_dot_residual = 0.0;
+    std::vector<adtype> rhs(n_soln_dofs);
+    assemble_volume_term<adtype>(
+        current_cell_index,
+        soln_coeff, coords_coeff, local_dual,
+        fe_soln, fe_metric, quadrature,
+        physics,
+        rhs, dual_dot_residual,
+        compute_metric_derivatives, fe_values_vol);
+
+    for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+        volume_tape->registerOutput(rhs[itest]);
+    }
+    volume_tape->stopRecording();
+
+    for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+        local_rhs_cell(itest) += getValue<adtype>(rhs[itest]);
+        AssertIsFinite(local_rhs_cell(itest));
+    }
+
+    TH::JacobianType& jac = volume_tape->createJacobian();
+    volume_tape->evalJacobian(jac);
+    std::vector<real> residual_derivatives(n_soln_dofs);
+    for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+        for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+            const unsigned int i_dx = idof+w_start;
+            residual_derivatives[idof] = jac(itest,i_dx);
+            AssertIsFinite(residual_derivatives[idof]);
+        }
+        this->add_to_system_matrix(soln_dof_indices[itest], soln_dof_indices, residual_derivatives);
+    }
+    volume_tape->deleteJacobian(jac);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    this->n_volume_tapes_recorded += 1;
+    this->volume_tapes_recording_time += elapsed.count();
+}
+
 template <int dim, int nstate, typename real>
 void DGWeak<dim,nstate,real>::assemble_volume_residual(
     const dealii::types::global_dof_index current_cell_index,
@@ -3564,7 +4016,17 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
 {
     (void) current_cell_index;
     (void) fe_values_lagrange;
-    if (compute_d2R) {
+    if (this->assembling_derivatives_with_threads) {
+        // The CoDiPack tapes can't be recorded by multiple threads.
+        assemble_volume_fad_fad_derivatives(
+            current_cell_index,
+            fe_values_vol,
+            fe_soln, quadrature,
+            metric_dof_indices, soln_dof_indices,
+            local_rhs_cell,
+            fe_values_lagrange,
+            compute_dRdW, compute_dRdX, compute_d2R);
+    } else if (compute_d2R) {
         assemble_volume_codi_taped_derivatives<codi_HessianComputationType>(
             current_cell_index,
             fe_values_vol,
@@ -3574,6 +4036,18 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
             fe_values_lagrange,
             *(DGBaseState<dim,nstate,real>::pde_physics_rad_fad),
             compute_dRdW, compute_dRdX, compute_d2R);
+    } else if (compute_dRdW && this->all_parameters->reuse_jacobian_tapes
+               && !this->all_parameters->add_artificial_dissipation
+               && DGBaseState<dim,nstate,real>::pde_physics_rad_primal) {
+        // The artificial dissipation coefficient is a passive value that differs between cells,
+        // and would be frozen into the recorded tape.
+        assemble_volume_codi_replayed_derivatives(
+            current_cell_index,
+            fe_values_vol,
+            fe_soln, quadrature,
+            metric_dof_indices, soln_dof_indices,
+            local_rhs_cell,
+            *(DGBaseState<dim,nstate,real>::pde_physics_rad_primal));
     } else if (compute_dRdW || compute_dRdX) {
         assemble_volume_codi_taped_derivatives<codi_JacobianComputationType>(
             current_cell_index,
@@ -3623,7 +4097,29 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
 {
     (void) current_cell_index;
     (void) neighbor_cell_index;
-    if (compute_d2R) {
+    if (this->assembling_derivatives_with_threads) {
+        // The CoDiPack tapes can't be recorded by multiple threads.
+        assemble_face_fad_fad_derivatives(
+            current_cell_index,
+            neighbor_cell_index,
+            face_subface_int,
+            face_subface_ext,
+            face_data_set_int,
+            face_data_set_ext,
+            fe_values_int,
+            fe_values_ext,
+            penalty,
+            fe_int,
+            fe_ext,
+            face_quadrature,
+            metric_dof_indices_int,
+            metric_dof_indices_ext,
+            soln_dof_indices_int,
+            soln_dof_indices_ext,
+            local_rhs_int_cell,
+            local_rhs_ext_cell,
+            compute_dRdW, compute_dRdX, compute_d2R);
+    } else if (compute_d2R) {
         assemble_face_codi_taped_derivatives<codi_HessianComputationType>(
             current_cell_index,
             neighbor_cell_index,
@@ -3699,7 +4195,6 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
 
     return;
 }
-#endif
 
 template class DGWeak <PHILIP_DIM, 1, double>;
 template class DGWeak <PHILIP_DIM, 2, double>;
@@ -119,6 +119,37 @@ private:
         const Physics::PhysicsBase<dim, nstate, real2> &physics,
         const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
 
+    /// Volume integral and its dRdW block using a reusable CoDiPack tape.
+    /** The volume term is recorded with a primal-value tape, where both the solution and the grid
+     *  coefficients are registered as inputs. Subsequent cells with the same polynomial degree
+     *  and quadrature re-evaluate the stored tape at their own coefficients instead of recording it again.
+     *  Only a single tape is stored since the CoDiPack tape is global for a given AD type.
+     *
+     *  The replayed residual is checked against the one evaluated with pde_physics_double, and the tape
+     *  is recorded again when they differ, i.e. when the physics took different solution-dependent branches.
+     *
+     *  Only the volume terms are replayed. The boundary and face terms are still recorded for every face
+     *  through assemble_boundary_codi_taped_derivatives() and assemble_face_codi_taped_derivatives(),
+     *  since their penalty is a passive value that depends on the neighbouring cells, and their boundary
+     *  conditions and numerical fluxes branch on the solution at every face.
+     */
+    void assemble_volume_codi_replayed_derivatives(
+        const dealii::types::global_dof_index current_cell_index,
+        const dealii::FEValues<dim,dim> &fe_values_vol,
+        const dealii::FESystem<dim,dim> &fe_soln,
+        const dealii::Quadrature<dim> &quadrature,
+        const std::vector<dealii::types::global_dof_index> &metric_dof_indices,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
+        dealii::Vector<real> &local_rhs_cell,
+        const Physics::PhysicsBase<dim, nstate, RadPrimalType> &physics);
+
+    /// Tape of the last recorded volume term when reuse_jacobian_tapes is set.
+    std::unique_ptr< codi::TapeHelper<RadPrimalType> > volume_tape;
+    /// Physics used to record the volume_tape.
+    const Physics::PhysicsBase<dim, nstate, RadPrimalType> *volume_tape_physics;
+    /// Polynomial degree, number of quadrature points, and number of metric dofs of the cell recorded in volume_tape.
+    std::array<unsigned int,3> volume_tape_signature;
+
     /// Preparation of CoDiPack taping for boundary integral, and derivative evaluation.
     /** Compute both the right-hand side and the corresponding block of dRdW, dRdX, and/or d2R. 
      *  Uses CoDiPack to automatically differentiate the functions.
@@ -171,6 +202,61 @@ private:
         dealii::Vector<real>          &local_rhs_ext_cell,
         const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
 
+    /// Volume integral and its dRdW, dRdX, and/or d2R blocks using the tapeless Sacado FadFadType.
+    /** Used when the derivatives are assembled with multiple threads, since the CoDiPack tapes are global.
+     *  The cost grows with the square of the number of independent variables when d2R is computed.
+     */
+    void assemble_volume_fad_fad_derivatives(
+        const dealii::types::global_dof_index current_cell_index,
+        const dealii::FEValues<dim,dim> &fe_values_vol,
+        const dealii::FESystem<dim,dim> &fe_soln,
+        const dealii::Quadrature<dim> &quadrature,
+        const std::vector<dealii::types::global_dof_index> &metric_dof_indices,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
+        dealii::Vector<real> &local_rhs_cell,
+        const dealii::FEValues<dim,dim> &/*fe_values_lagrange*/,
+        const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
+
+    /// Boundary integral and its dRdW, dRdX, and/or d2R blocks using the tapeless Sacado FadFadType.
+    /** Used when the derivatives are assembled with multiple threads, since the CoDiPack tapes are global.
+     */
+    void assemble_boundary_fad_fad_derivatives(
+        const dealii::types::global_dof_index current_cell_index,
+        const unsigned int face_number,
+        const unsigned int boundary_id,
+        const dealii::FEFaceValuesBase<dim,dim> &fe_values_boundary,
+        const real penalty,
+        const dealii::FESystem<dim,dim> &fe_soln,
+        const dealii::Quadrature<dim-1> &quadrature,
+        const std::vector<dealii::types::global_dof_index> &metric_dof_indices,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
+        dealii::Vector<real> &local_rhs_cell,
+        const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
+
+    /// Internal face integral and its dRdW, dRdX, and/or d2R blocks using the tapeless Sacado FadFadType.
+    /** Used when the derivatives are assembled with multiple threads, since the CoDiPack tapes are global.
+     */
+    void assemble_face_fad_fad_derivatives(
+        const dealii::types::global_dof_index current_cell_index,
+        const dealii::types::global_dof_index neighbor_cell_index,
+        const std::pair<unsigned int, int> face_subface_int,
+        const std::pair<unsigned int, int> face_subface_ext,
+        const typename dealii::QProjector<dim>::DataSetDescriptor face_data_set_int,
+        const typename dealii::QProjector<dim>::DataSetDescriptor face_data_set_ext,
+        const dealii::FEFaceValuesBase<dim,dim>     &fe_values_int,
+        const dealii::FEFaceValuesBase<dim,dim>     &fe_values_ext,
+        const real penalty,
+        const dealii::FESystem<dim,dim> &fe_int,
+        const dealii::FESystem<dim,dim> &fe_ext,
+        const dealii::Quadrature<dim-1> &face_quadrature,
+        const std::vector<dealii::types::global_dof_index> &metric_dof_indices_int,
+        const std::vector<dealii::types::global_dof_index> &metric_dof_indices_ext,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices_int,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices_ext,
+        dealii::Vector<real>          &local_rhs_int_cell,
+        dealii::Vector<real>          &local_rhs_ext_cell,
+        const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
+
 
 private:
 
@@ -2,7 +2,6 @@
 #include <iostream>
 #include <fstream>
 
-#include <Epetra_RowMatrixTransposer.h>
 
 #include <deal.II/dofs/dof_tools.h>
 
@@ -164,17 +163,17 @@ dealii::LinearAlgebra::distributed::Vector<real> Adjoint<dim, nstate, real>::fin
     adjoint_fine.reinit(dg.solution);
     
     dg.assemble_residual(true);
+    // Both matrices apply their transpose without forming it.
+    const bool transpose = true;
+    if (dg.all_parameters->use_block_sparse_system_matrix) {
+        dg.block_system_matrix *= -1.0;
+        dg.invalidate_dRdW();
+        solve_linear(dg.block_system_matrix, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param, transpose);
+        return adjoint_fine;
+    }
     dg.system_matrix *= -1.0;
-
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
-    Epetra_CrsMatrix *system_matrix_transpose_tril;
-
-    Epetra_RowMatrixTransposer epmt(const_cast<Epetra_CrsMatrix *>(&dg.system_matrix.trilinos_matrix()));
-    epmt.CreateTranspose(false, system_matrix_transpose_tril);
-    system_matrix_transpose.reinit(*system_matrix_transpose_tril,true);
-    delete system_matrix_transpose_tril;
-    solve_linear(system_matrix_transpose, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param);
-    // solve_linear(dg.system_matrix, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param);
+    dg.invalidate_dRdW();
+    solve_linear(dg.system_matrix, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param, transpose);
 
     return adjoint_fine;
 }
@@ -194,16 +193,17 @@ dealii::LinearAlgebra::distributed::Vector<real> Adjoint<dim, nstate, real>::coa
     adjoint_coarse.reinit(dg.solution);
 
     dg.assemble_residual(true);
+    // Both matrices apply their transpose without forming it.
+    const bool transpose = true;
+    if (dg.all_parameters->use_block_sparse_system_matrix) {
+        dg.block_system_matrix *= -1.0;
+        dg.invalidate_dRdW();
+        solve_linear(dg.block_system_matrix, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param, transpose);
+        return adjoint_coarse;
+    }
     dg.system_matrix *= -1.0;
-
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
-    Epetra_CrsMatrix *system_matrix_transpose_tril;
-
-    Epetra_RowMatrixTransposer epmt(const_cast<Epetra_CrsMatrix *>(&dg.system_matrix.trilinos_matrix()));
-    epmt.CreateTranspose(false, system_matrix_transpose_tril);
-    system_matrix_transpose.reinit(*system_matrix_transpose_tril);
-    solve_linear(system_matrix_transpose, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param);
-    // solve_linear(dg.system_matrix, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param);
+    dg.invalidate_dRdW();
+    solve_linear(dg.system_matrix, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param, transpose);
 
     return adjoint_coarse;
 }
@@ -1,4 +1,5 @@
 // includes
+#include <type_traits>
 #include <vector>
 
 #include <Sacado.hpp>
@@ -33,6 +34,8 @@ Functional<dim,nstate,real>::Functional(
     using FadType = Sacado::Fad::DFad<real>;
     using FadFadType = Sacado::Fad::DFad<FadType>;
     physics_fad_fad = Physics::PhysicsFactory<dim,nstate,FadFadType>::create_Physics(dg->all_parameters);
+    physics_fad = Physics::PhysicsFactory<dim,nstate,FadType>::create_Physics(dg->all_parameters);
+    physics_double = Physics::PhysicsFactory<dim,nstate,real>::create_Physics(dg->all_parameters);
 
     init_vectors();
 }
@@ -69,6 +72,13 @@ Functional<dim,nstate,real>::Functional(
     : Functional(_dg, _uses_solution_values, _uses_solution_gradient)
 {
     physics_fad_fad = _physics_fad_fad;
+
+    // The other physics have been overriden along with the provided one.
+    std::shared_ptr<DGBaseState<dim,nstate,real>> dg_state = std::dynamic_pointer_cast<DGBaseState<dim,nstate,real>>(dg);
+    if (dg_state) {
+        physics_fad = dg_state->pde_physics_fad;
+        physics_double = dg_state->pde_physics_double;
+    }
 }
 
 template <int dim, int nstate, typename real>
@@ -134,9 +144,9 @@ void Functional<dim,nstate,real>::allocate_derivatives(const bool compute_dIdW,
 template <int dim, int nstate, typename real>
 void Functional<dim,nstate,real>::set_derivatives(
     const bool compute_dIdW, const bool compute_dIdX, const bool compute_d2I,
-    const Sacado::Fad::DFad<Sacado::Fad::DFad<real>> volume_local_sum,
-    std::vector<dealii::types::global_dof_index> cell_soln_dofs_indices,
-    std::vector<dealii::types::global_dof_index> cell_metric_dofs_indices)
+    const Sacado::Fad::DFad<Sacado::Fad::DFad<real>> &volume_local_sum,
+    const std::vector<dealii::types::global_dof_index> &cell_soln_dofs_indices,
+    const std::vector<dealii::types::global_dof_index> &cell_metric_dofs_indices)
 {
     using FadType = Sacado::Fad::DFad<real>;
 
@@ -198,6 +208,36 @@ void Functional<dim,nstate,real>::set_derivatives(
     AssertDimension(i_derivative, n_total_indep);
 }
 
+template <int dim, int nstate, typename real>
+void Functional<dim,nstate,real>::set_derivatives(
+    const bool compute_dIdW, const bool compute_dIdX,
+    const Sacado::Fad::DFad<real> &volume_local_sum,
+    const std::vector<dealii::types::global_dof_index> &cell_soln_dofs_indices,
+    const std::vector<dealii::types::global_dof_index> &cell_metric_dofs_indices)
+{
+    const unsigned int n_total_indep = volume_local_sum.size();
+    (void) n_total_indep; // Not used apart from assert.
+    const unsigned int n_soln_dofs_cell = cell_soln_dofs_indices.size();
+    const unsigned int n_metric_dofs_cell = cell_metric_dofs_indices.size();
+    unsigned int i_derivative = 0;
+
+    if (compute_dIdW) {
+        std::vector<real> local_dIdw(n_soln_dofs_cell);
+        for(unsigned int idof = 0; idof < n_soln_dofs_cell; ++idof){
+            local_dIdw[idof] = volume_local_sum.dx(i_derivative++);
+        }
+        dIdw.add(cell_soln_dofs_indices, local_dIdw);
+    }
+    if (compute_dIdX) {
+        std::vector<real> local_dIdX(n_metric_dofs_cell);
+        for(unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof){
+            local_dIdX[idof] = volume_local_sum.dx(i_derivative++);
+        }
+        dIdX.add(cell_metric_dofs_indices, local_dIdX);
+    }
+    AssertDimension(i_derivative, n_total_indep);
+}
+
 template <int dim, int nstate, typename real>
 template <typename real2>
 real2 Functional<dim, nstate, real>::evaluate_volume_cell_functional(
@@ -271,6 +311,18 @@ real Functional<dim, nstate, real>::evaluate_volume_cell_functional(
     return evaluate_volume_cell_functional<real>(physics, soln_coeff, fe_solution, coords_coeff, fe_metric, volume_quadrature);
 }
 
+template <int dim, int nstate, typename real>
+Sacado::Fad::DFad<real> Functional<dim, nstate, real>::evaluate_volume_cell_functional(
+    const Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<real>> &physics_fad,
+    const std::vector< Sacado::Fad::DFad<real> > &soln_coeff,
+    const dealii::FESystem<dim> &fe_solution,
+    const std::vector< Sacado::Fad::DFad<real> > &coords_coeff,
+    const dealii::FESystem<dim> &fe_metric,
+    const dealii::Quadrature<dim> &volume_quadrature) const
+{
+    return evaluate_volume_cell_functional<Sacado::Fad::DFad<real>>(physics_fad, soln_coeff, fe_solution, coords_coeff, fe_metric, volume_quadrature);
+}
+
 template <int dim, int nstate, typename real>
 Sacado::Fad::DFad<Sacado::Fad::DFad<real>> Functional<dim, nstate, real>::evaluate_volume_cell_functional(
     const Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<Sacado::Fad::DFad<real>>> &physics_fad_fad,
@@ -284,6 +336,42 @@ Sacado::Fad::DFad<Sacado::Fad::DFad<real>> Functional<dim, nstate, real>::evalua
 }
 
 
+template <int dim, int nstate, typename real>
+Sacado::Fad::DFad<real> Functional<dim, nstate, real>::evaluate_cell_boundary(
+    const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &/*physics*/,
+    const unsigned int boundary_id,
+    const dealii::FEFaceValues<dim,dim> &fe_values_boundary,
+    const std::vector<FadType> &local_solution) const
+{
+    // The FadType derivatives are carried by the values of the FadFadType coefficients.
+    const std::vector<FadFadType> local_solution_fad_fad(local_solution.begin(), local_solution.end());
+    return evaluate_cell_boundary(*physics_fad_fad, boundary_id, fe_values_boundary, local_solution_fad_fad).val();
+}
+
+template <int dim, int nstate, typename real>
+Sacado::Fad::DFad<real> Functional<dim, nstate, real>::evaluate_volume_integrand(
+    const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &/*physics*/,
+    const dealii::Point<dim,FadType> &phys_coord,
+    const std::array<FadType,nstate> &soln_at_q,
+    const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const
+{
+    // The FadType derivatives are carried by the values of the FadFadType arguments.
+    dealii::Point<dim,FadFadType> phys_coord_fad_fad;
+    std::array<FadFadType,nstate> soln_at_q_fad_fad;
+    std::array<dealii::Tensor<1,dim,FadFadType>,nstate> soln_grad_at_q_fad_fad;
+    for (int d=0; d<dim; ++d) {
+        phys_coord_fad_fad[d] = phys_coord[d];
+    }
+    for (int s=0; s<nstate; ++s) {
+        soln_at_q_fad_fad[s] = soln_at_q[s];
+        for (int d=0; d<dim; ++d) {
+            soln_grad_at_q_fad_fad[s][d] = soln_grad_at_q[s][d];
+        }
+    }
+    return evaluate_volume_integrand(*physics_fad_fad, phys_coord_fad_fad, soln_at_q_fad_fad, soln_grad_at_q_fad_fad).val();
+}
+
+
 template <int dim, int nstate, typename real>
 void Functional<dim, nstate, real>::need_compute(bool &compute_value, bool &compute_dIdW, bool &compute_dIdX, bool &compute_d2I)
 {
@@ -395,9 +483,6 @@ real Functional<dim, nstate, real>::evaluate_functional(
     const bool compute_dIdX,
     const bool compute_d2I)
 {
-    using FadType = Sacado::Fad::DFad<real>;
-    using FadFadType = Sacado::Fad::DFad<FadType>;
-
     bool actually_compute_value = true;
     bool actually_compute_dIdW = compute_dIdW;
     bool actually_compute_dIdX = compute_dIdX;
@@ -411,6 +496,47 @@ real Functional<dim, nstate, real>::evaluate_functional(
         return current_functional_value;
     }
 
+    allocate_derivatives(actually_compute_dIdW, actually_compute_dIdX, actually_compute_d2I);
+
+    // Nested derivatives are only seeded when the Hessians are requested.
+    real local_functional;
+    if (actually_compute_d2I) {
+        local_functional = assemble_functional(*physics_fad_fad, actually_compute_dIdW, actually_compute_dIdX, actually_compute_d2I);
+    } else if (actually_compute_dIdW || actually_compute_dIdX) {
+        local_functional = assemble_functional(*physics_fad, actually_compute_dIdW, actually_compute_dIdX, actually_compute_d2I);
+    } else {
+        local_functional = assemble_functional(*physics_double, actually_compute_dIdW, actually_compute_dIdX, actually_compute_d2I);
+    }
+
+    current_functional_value = dealii::Utilities::MPI::sum(local_functional, MPI_COMM_WORLD);
+    // compress before the return
+    if (actually_compute_dIdW) dIdw.compress(dealii::VectorOperation::add);
+    if (actually_compute_dIdX) dIdX.compress(dealii::VectorOperation::add);
+    if (actually_compute_d2I) {
+        d2IdWdW.compress(dealii::VectorOperation::add);
+        d2IdWdX.compress(dealii::VectorOperation::add);
+        d2IdXdX.compress(dealii::VectorOperation::add);
+    }
+
+    return current_functional_value;
+}
+
+template <int dim, int nstate, typename real>
+template <typename adtype>
+real Functional<dim, nstate, real>::assemble_functional(
+    const Physics::PhysicsBase<dim,nstate,adtype> &physics,
+    const bool compute_dIdW,
+    const bool compute_dIdX,
+    const bool compute_d2I)
+{
+    using FadType = Sacado::Fad::DFad<real>;
+    using FadFadType = Sacado::Fad::DFad<FadType>;
+    constexpr bool is_real = std::is_same<adtype,real>::value;
+    constexpr bool is_fad_fad = std::is_same<adtype,FadFadType>::value;
+    static_assert(is_real || std::is_same<adtype,FadType>::value || is_fad_fad, "Unsupported coefficient type.");
+    Assert(!is_real || (!compute_dIdW && !compute_dIdX && !compute_d2I), dealii::ExcMessage("real coefficients cannot provide derivatives."));
+    Assert(is_fad_fad || !compute_d2I, dealii::ExcMessage("Second derivatives require FadFadType coefficients."));
+
     // Returned value
     real local_functional = 0.0;
 
@@ -418,22 +544,18 @@ real Functional<dim, nstate, real>::evaluate_functional(
     const dealii::FESystem<dim,dim> &fe_metric = dg->high_order_grid.fe_system;
     const unsigned int n_metric_dofs_cell = fe_metric.dofs_per_cell;
     std::vector<dealii::types::global_dof_index> cell_metric_dofs_indices(n_metric_dofs_cell);
+    std::vector<adtype> coords_coeff(n_metric_dofs_cell);
 
     // setup it mostly the same as evaluating the value (with exception that local solution is also AD)
     const unsigned int max_dofs_per_cell = dg->dof_handler.get_fe_collection().max_dofs_per_cell();
     std::vector<dealii::types::global_dof_index> cell_soln_dofs_indices(max_dofs_per_cell);
-    std::vector<FadFadType> soln_coeff(max_dofs_per_cell); // for obtaining the local derivatives (to be copied back afterwards)
-    std::vector<real>   local_dIdw(max_dofs_per_cell);
-
-    std::vector<real>   local_dIdX(n_metric_dofs_cell);
+    std::vector<adtype> soln_coeff(max_dofs_per_cell); // for obtaining the local derivatives (to be copied back afterwards)
 
     const auto mapping = (*(dg->high_order_grid.mapping_fe_field));
     dealii::hp::MappingCollection<dim> mapping_collection(mapping);
 
     dealii::hp::FEFaceValues<dim,dim> fe_values_collection_face  (mapping_collection, dg->fe_collection, dg->face_quadrature_collection,   this->face_update_flags);
 
-    allocate_derivatives(actually_compute_dIdW, actually_compute_dIdX, actually_compute_d2I);
-
     dg->solution.update_ghost_values();
     auto metric_cell = dg->high_order_grid.dof_handler_grid.begin_active();
     auto soln_cell = dg->dof_handler.begin_active();
@@ -454,47 +576,49 @@ real Functional<dim, nstate, real>::evaluate_functional(
 
         // Get metric coefficients
         metric_cell->get_dof_indices (cell_metric_dofs_indices);
-        std::vector< FadFadType > coords_coeff(n_metric_dofs_cell);
-        for (unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof) {
-            coords_coeff[idof] = dg->high_order_grid.volume_nodes[cell_metric_dofs_indices[idof]];
-        }
 
         // Setup automatic differentiation
         unsigned int n_total_indep = 0;
-        if (actually_compute_dIdW || actually_compute_d2I) n_total_indep += n_soln_dofs_cell;
-        if (actually_compute_dIdX || actually_compute_d2I) n_total_indep += n_metric_dofs_cell;
+        if (compute_dIdW || compute_d2I) n_total_indep += n_soln_dofs_cell;
+        if (compute_dIdX || compute_d2I) n_total_indep += n_metric_dofs_cell;
         unsigned int i_derivative = 0;
         for(unsigned int idof = 0; idof < n_soln_dofs_cell; ++idof) {
             const real val = dg->solution[cell_soln_dofs_indices[idof]];
             soln_coeff[idof] = val;
-            if (actually_compute_dIdW || actually_compute_d2I) soln_coeff[idof].diff(i_derivative++, n_total_indep);
+            if constexpr (!is_real) {
+                if (compute_dIdW || compute_d2I) soln_coeff[idof].diff(i_derivative++, n_total_indep);
+            }
         }
         for (unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof) {
             const real val = dg->high_order_grid.volume_nodes[cell_metric_dofs_indices[idof]];
             coords_coeff[idof] = val;
-            if (actually_compute_dIdX || actually_compute_d2I) coords_coeff[idof].diff(i_derivative++, n_total_indep);
+            if constexpr (!is_real) {
+                if (compute_dIdX || compute_d2I) coords_coeff[idof].diff(i_derivative++, n_total_indep);
+            }
         }
         AssertDimension(i_derivative, n_total_indep);
-        if (actually_compute_d2I) {
-            unsigned int i_derivative = 0;
-            for(unsigned int idof = 0; idof < n_soln_dofs_cell; ++idof) {
-                const real val = dg->solution[cell_soln_dofs_indices[idof]];
-                soln_coeff[idof].val() = val;
-                soln_coeff[idof].val().diff(i_derivative++, n_total_indep);
-            }
-            for (unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof) {
-                const real val = dg->high_order_grid.volume_nodes[cell_metric_dofs_indices[idof]];
-                coords_coeff[idof].val() = val;
-                coords_coeff[idof].val().diff(i_derivative++, n_total_indep);
+        if constexpr (is_fad_fad) {
+            if (compute_d2I) {
+                unsigned int i_derivative = 0;
+                for(unsigned int idof = 0; idof < n_soln_dofs_cell; ++idof) {
+                    const real val = dg->solution[cell_soln_dofs_indices[idof]];
+                    soln_coeff[idof].val() = val;
+                    soln_coeff[idof].val().diff(i_derivative++, n_total_indep);
+                }
+                for (unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof) {
+                    const real val = dg->high_order_grid.volume_nodes[cell_metric_dofs_indices[idof]];
+                    coords_coeff[idof].val() = val;
+                    coords_coeff[idof].val().diff(i_derivative++, n_total_indep);
+                }
+                AssertDimension(i_derivative, n_total_indep);
             }
         }
-        AssertDimension(i_derivative, n_total_indep);
 
         // Get quadrature point on reference cell
         const dealii::Quadrature<dim> &volume_quadrature = dg->volume_quadrature_collection[i_quad];
 
         // Evaluate integral on the cell volume
-        FadFadType volume_local_sum = evaluate_volume_cell_functional(*physics_fad_fad, soln_coeff, fe_solution, coords_coeff, fe_metric, volume_quadrature);
+        adtype volume_local_sum = evaluate_volume_cell_functional(physics, soln_coeff, fe_solution, coords_coeff, fe_metric, volume_quadrature);
 
         // next looping over the faces of the cell checking for boundary elements
         for(unsigned int iface = 0; iface < dealii::GeometryInfo<dim>::faces_per_cell; ++iface){
@@ -506,75 +630,24 @@ real Functional<dim, nstate, real>::evaluate_functional(
 
                 const unsigned int boundary_id = face->boundary_id();
 
-                volume_local_sum += this->evaluate_cell_boundary(*physics_fad_fad, boundary_id, fe_values_face, soln_coeff);
+                volume_local_sum += this->evaluate_cell_boundary(physics, boundary_id, fe_values_face, soln_coeff);
             }
 
         }
 
-        local_functional += volume_local_sum.val().val();
-        // now getting the values and adding them to the derivaitve vector
-
-        i_derivative = 0;
-        if (actually_compute_dIdW) {
-            local_dIdw.resize(n_soln_dofs_cell);
-            for(unsigned int idof = 0; idof < n_soln_dofs_cell; ++idof){
-                local_dIdw[idof] = volume_local_sum.dx(i_derivative++).val();
-            }
-            dIdw.add(cell_soln_dofs_indices, local_dIdw);
-        }
-        if (actually_compute_dIdX) {
-            local_dIdX.resize(n_metric_dofs_cell);
-            for(unsigned int idof = 0; idof < n_metric_dofs_cell; ++idof){
-                local_dIdX[idof] = volume_local_sum.dx(i_derivative++).val();
-            }
-            dIdX.add(cell_metric_dofs_indices, local_dIdX);
-        }
-        if (actually_compute_dIdW || actually_compute_dIdX) AssertDimension(i_derivative, n_total_indep);
-        if (actually_compute_d2I) {
-            std::vector<real> dWidW(n_soln_dofs_cell);
-            std::vector<real> dWidX(n_metric_dofs_cell);
-            std::vector<real> dXidX(n_metric_dofs_cell);
-
-            i_derivative = 0;
-            for (unsigned int idof=0; idof<n_soln_dofs_cell; ++idof) {
-                unsigned int j_derivative = 0;
-                const FadType dWi = volume_local_sum.dx(i_derivative++);
-                for (unsigned int jdof=0; jdof<n_soln_dofs_cell; ++jdof) {
-                    dWidW[jdof] = dWi.dx(j_derivative++);
-                }
-                d2IdWdW.add(cell_soln_dofs_indices[idof], cell_soln_dofs_indices, dWidW);
-
-                for (unsigned int jdof=0; jdof<n_metric_dofs_cell; ++jdof) {
-                    dWidX[jdof] = dWi.dx(j_derivative++);
-                }
-                d2IdWdX.add(cell_soln_dofs_indices[idof], cell_metric_dofs_indices, dWidX);
-            }
-
-            for (unsigned int idof=0; idof<n_metric_dofs_cell; ++idof) {
-
-                const FadType dXi = volume_local_sum.dx(i_derivative++);
-
-                unsigned int j_derivative = n_soln_dofs_cell;
-                for (unsigned int jdof=0; jdof<n_metric_dofs_cell; ++jdof) {
-                    dXidX[jdof] = dXi.dx(j_derivative++);
-                }
-                d2IdXdX.add(cell_metric_dofs_indices[idof], cell_metric_dofs_indices, dXidX);
-            }
+        // now getting the values and adding them to the derivative vectors
+        if constexpr (is_fad_fad) {
+            local_functional += volume_local_sum.val().val();
+            set_derivatives(compute_dIdW, compute_dIdX, compute_d2I, volume_local_sum, cell_soln_dofs_indices, cell_metric_dofs_indices);
+        } else if constexpr (!is_real) {
+            local_functional += volume_local_sum.val();
+            set_derivatives(compute_dIdW, compute_dIdX, volume_local_sum, cell_soln_dofs_indices, cell_metric_dofs_indices);
+        } else {
+            local_functional += volume_local_sum;
         }
-        AssertDimension(i_derivative, n_total_indep);
-    }
-
-    current_functional_value = dealii::Utilities::MPI::sum(local_functional, MPI_COMM_WORLD);
-    // compress before the return
-    if (actually_compute_dIdW) dIdw.compress(dealii::VectorOperation::add);
-    if (actually_compute_dIdX) dIdX.compress(dealii::VectorOperation::add);
-    if (actually_compute_d2I) {
-        d2IdWdW.compress(dealii::VectorOperation::add);
-        d2IdWdX.compress(dealii::VectorOperation::add);
-        d2IdXdX.compress(dealii::VectorOperation::add);
     }
 
-    return current_functional_value;
+    return local_functional;
 }
 
 template <int dim, int nstate, typename real>
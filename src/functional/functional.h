@@ -51,6 +51,10 @@ public:
 protected:
     /// Physics that should correspond to the one in DGBase
     std::shared_ptr<Physics::PhysicsBase<dim,nstate,FadFadType>> physics_fad_fad;
+    /// Physics with real type, used when only the functional value is needed.
+    std::shared_ptr<Physics::PhysicsBase<dim,nstate,real>> physics_double;
+    /// Physics with FadType, used when only first derivatives are needed.
+    std::shared_ptr<Physics::PhysicsBase<dim,nstate,FadType>> physics_fad;
 
 public:
     /** Constructor.
@@ -65,7 +69,9 @@ public:
         const bool _uses_solution_gradient = true);
 
     /** Constructor.
-     *  Uses provided physics instead of creating a new one base on DGBase */
+     *  Uses provided physics instead of creating a new one base on DGBase.
+     *  The real and FadType physics are then taken from the DGBaseState if @p _dg is one,
+     *  since they would have been overriden through DGWeak::set_physics() as well. */
     Functional(
         std::shared_ptr<PHiLiP::DGBase<dim,real>> _dg,
         std::shared_ptr<PHiLiP::Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<Sacado::Fad::DFad<real>> >> _physics_fad_fad,
@@ -94,6 +100,9 @@ public:
      *  \f]
      * 
      *  Calls the functions evaluate_volume_integrand() and evaluate_cell_boundary() to be overridden
+     *
+     *  The cells are evaluated with the cheapest type providing the requested derivatives:
+     *  real for the value only, FadType for dIdW and dIdX, and FadFadType only when compute_d2I is requested.
      */
     virtual real evaluate_functional(
         const bool compute_dIdW = false,
@@ -170,9 +179,25 @@ protected:
     /** Helper function to simplify the evaluate_functional */
     void set_derivatives(
         const bool compute_dIdW, const bool compute_dIdX, const bool compute_d2I,
-        const Sacado::Fad::DFad<Sacado::Fad::DFad<real>> volume_local_sum,
-        std::vector<dealii::types::global_dof_index> cell_soln_dofs_indices,
-        std::vector<dealii::types::global_dof_index> cell_metric_dofs_indices);
+        const Sacado::Fad::DFad<Sacado::Fad::DFad<real>> &volume_local_sum,
+        const std::vector<dealii::types::global_dof_index> &cell_soln_dofs_indices,
+        const std::vector<dealii::types::global_dof_index> &cell_metric_dofs_indices);
+    /// Set the first derivative vectors.
+    /** Corresponding FadType function, which cannot provide the second derivatives */
+    void set_derivatives(
+        const bool compute_dIdW, const bool compute_dIdX,
+        const Sacado::Fad::DFad<real> &volume_local_sum,
+        const std::vector<dealii::types::global_dof_index> &cell_soln_dofs_indices,
+        const std::vector<dealii::types::global_dof_index> &cell_metric_dofs_indices);
+
+    /// Loops over the cells to evaluate the functional and its requested derivatives.
+    /** Helper function of evaluate_functional templated on the type of the cell coefficients.
+     *  real only provides the value, FadType the first derivatives, and FadFadType the second derivatives.
+     */
+    template <typename adtype>
+    real assemble_functional(
+        const Physics::PhysicsBase<dim,nstate,adtype> &physics,
+        const bool compute_dIdW, const bool compute_dIdX, const bool compute_d2I);
 
 protected:
     /// Checks which derivatives actually need to be recomputed.
@@ -198,6 +223,14 @@ protected:
         const std::vector< real > &coords_coeff,
         const dealii::FESystem<dim> &fe_metric,
         const dealii::Quadrature<dim> &volume_quadrature) const;
+    /// Corresponding FadType function to evaluate a cell's volume functional.
+    virtual Sacado::Fad::DFad<real> evaluate_volume_cell_functional(
+        const Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<real>> &physics_fad,
+        const std::vector< Sacado::Fad::DFad<real> > &soln_coeff,
+        const dealii::FESystem<dim> &fe_solution,
+        const std::vector< Sacado::Fad::DFad<real> > &coords_coeff,
+        const dealii::FESystem<dim> &fe_metric,
+        const dealii::Quadrature<dim> &volume_quadrature) const;
     /// Corresponding FadFadType function to evaluate a cell's volume functional.
     virtual Sacado::Fad::DFad<Sacado::Fad::DFad<real>> evaluate_volume_cell_functional(
         const Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<Sacado::Fad::DFad<real>>> &physics_fad_fad,
@@ -216,6 +249,17 @@ protected:
         const std::vector<real> &/*local_solution*/) const
     { return (real) 0.0; }
 
+    /// Virtual function for Sacado computation of cell boundary functional term and first derivatives
+    /** Used only in the computation of evaluate_dIdw(). If not overriden, evaluates the FadFadType
+     *  function with the physics_fad_fad and returns its value, such that functionals only providing
+     *  the real and FadFadType terms still obtain their first derivatives.
+     */
+    virtual FadType evaluate_cell_boundary(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+        const unsigned int boundary_id,
+        const dealii::FEFaceValues<dim,dim> &fe_values_boundary,
+        const std::vector<FadType> &local_solution) const;
+
     /// Virtual function for Sacado computation of cell boundary functional term and derivatives
     /** Used only in the computation of evaluate_dIdw(). If not overriden returns 0. */
     virtual FadFadType evaluate_cell_boundary(
@@ -233,6 +277,14 @@ protected:
         const std::array<real,nstate> &/*soln_at_q*/,
         const std::array<dealii::Tensor<1,dim,real>,nstate> &/*soln_grad_at_q*/) const
     { return (real) 0.0; }
+    /// Virtual function for Sacado computation of cell volume functional term and first derivatives
+    /** Used only in the computation of evaluate_dIdw(). If not overriden, evaluates the FadFadType
+     *  function with the physics_fad_fad and returns its value, as evaluate_cell_boundary() does.
+     */
+    virtual FadType evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+        const dealii::Point<dim,FadType> &phys_coord, const std::array<FadType,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const;
     /// Virtual function for Sacado computation of cell volume functional term and derivatives
     /** Used only in the computation of evaluate_dIdw(). If not overriden returns 0. */
     virtual FadFadType evaluate_volume_integrand(
@@ -0,0 +1,150 @@
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include "parameters/all_parameters.h"
+
+#include "dg/dg.h"
+#include "functional.h"
+#include "multi_functional_adjoint.h"
+#include "linear_solver/linear_solver.h"
+#include "post_processor/physics_post_processor.h"
+
+namespace PHiLiP {
+
+template <int dim, int nstate, typename real>
+MultiFunctionalAdjoint<dim, nstate, real>::MultiFunctionalAdjoint(
+    std::shared_ptr<DGBase<dim,real>> _dg,
+    const std::vector<std::shared_ptr<Functional<dim,nstate,real>>> &_functionals)
+    : dg(_dg)
+    , functionals(_functionals)
+    , mpi_communicator(MPI_COMM_WORLD)
+    , pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(mpi_communicator)==0)
+{}
+
+template <int dim, int nstate, typename real>
+void MultiFunctionalAdjoint<dim, nstate, real>::solve_adjoints(const bool compute_sensitivities)
+{
+    const unsigned int n_functionals = functionals.size();
+    functional_values.resize(n_functionals);
+    dIdw.resize(n_functionals);
+    adjoints.resize(n_functionals);
+    linear_iterations.resize(n_functionals);
+
+    const bool compute_dIdW = true;
+    const bool compute_dIdX = compute_sensitivities;
+    for (unsigned int ifunctional = 0; ifunctional < n_functionals; ++ifunctional) {
+        functional_values[ifunctional] = functionals[ifunctional]->evaluate_functional(compute_dIdW, compute_dIdX);
+        dIdw[ifunctional] = functionals[ifunctional]->dIdw;
+    }
+
+    // The Jacobian is assembled once and left unmodified, such that DGBase keeps it.
+    dg->assemble_residual(true);
+
+    const Parameters::LinearSolverParam &linear_param = dg->all_parameters->linear_solver_param;
+    const bool transpose = true;
+    ReusablePreconditioner preconditioner;
+
+    // Orthonormal basis of the previous right-hand sides, and the solutions of the transposed system for them.
+    std::vector<VectorType> rhs_basis, solution_basis;
+    VectorType rhs_remainder;
+    for (unsigned int ifunctional = 0; ifunctional < n_functionals; ++ifunctional) {
+        pcout << "Solving the adjoint of functional " << ifunctional << "..." << std::endl;
+        VectorType &right_hand_side = dIdw[ifunctional];
+        VectorType &adjoint = adjoints[ifunctional];
+        adjoint.reinit(dg->solution);
+
+        // Initial guess from the previous solutions, where the right-hand side is projected by modified Gram-Schmidt.
+        rhs_remainder = right_hand_side;
+        std::vector<double> projection(rhs_basis.size());
+        for (unsigned int ibasis = 0; ibasis < rhs_basis.size(); ++ibasis) {
+            projection[ibasis] = rhs_basis[ibasis] * rhs_remainder;
+            rhs_remainder.add(-projection[ibasis], rhs_basis[ibasis]);
+            adjoint.add(projection[ibasis], solution_basis[ibasis]);
+        }
+
+        std::pair<unsigned int, double> linear_result;
+        if (dg->all_parameters->use_block_sparse_system_matrix) {
+            linear_result = solve_linear(dg->block_system_matrix, right_hand_side, adjoint, linear_param, transpose, &preconditioner);
+        } else {
+            linear_result = solve_linear(dg->system_matrix, right_hand_side, adjoint, linear_param, transpose, &preconditioner);
+        }
+        linear_iterations[ifunctional] = linear_result.first;
+        preconditioner.reuse = true;
+
+        // Extend the basis unless the right-hand side was already spanned by the previous ones.
+        const double remainder_norm = rhs_remainder.l2_norm();
+        if (remainder_norm > 1e-12 * right_hand_side.l2_norm()) {
+            VectorType solution_remainder = adjoint;
+            for (unsigned int ibasis = 0; ibasis < rhs_basis.size(); ++ibasis) {
+                solution_remainder.add(-projection[ibasis], solution_basis[ibasis]);
+            }
+            rhs_remainder *= 1.0/remainder_norm;
+            solution_remainder *= 1.0/remainder_norm;
+            rhs_basis.push_back(rhs_remainder);
+            solution_basis.push_back(solution_remainder);
+        }
+
+        // The transposed system has been solved for dIdW instead of -dIdW.
+        adjoint *= -1.0;
+        adjoint.update_ghost_values();
+    }
+
+    if (!compute_sensitivities) return;
+
+    dg->assemble_residual(false, true, false);
+    sensitivities.resize(n_functionals);
+    for (unsigned int ifunctional = 0; ifunctional < n_functionals; ++ifunctional) {
+        sensitivities[ifunctional].reinit(functionals[ifunctional]->dIdX);
+        dg->dRdXv.Tvmult(sensitivities[ifunctional], adjoints[ifunctional]);
+        sensitivities[ifunctional] += functionals[ifunctional]->dIdX;
+        sensitivities[ifunctional].update_ghost_values();
+    }
+}
+
+template <int dim, int nstate, typename real>
+void MultiFunctionalAdjoint<dim,nstate,real>::output_results_vtk(const unsigned int cycle) const
+{
+    dealii::DataOut<dim, dealii::DoFHandler<dim>> data_out;
+    data_out.attach_dof_handler(dg->dof_handler);
+
+    const std::unique_ptr< dealii::DataPostprocessor<dim> > post_processor = Postprocess::PostprocessorFactory<dim>::create_Postprocessor(dg->all_parameters);
+    data_out.add_data_vector(dg->solution, *post_processor);
+
+    for (unsigned int ifunctional = 0; ifunctional < adjoints.size(); ++ifunctional) {
+        std::vector<std::string> adjoint_names;
+        for(int s=0;s<nstate;++s) {
+            std::string varname = "psi" + dealii::Utilities::int_to_string(ifunctional,1) + "_" + dealii::Utilities::int_to_string(s,1);
+            adjoint_names.push_back(varname);
+        }
+        data_out.add_data_vector(adjoints[ifunctional], adjoint_names, dealii::DataOut_DoFData<dealii::DoFHandler<dim>,dim>::DataVectorType::type_dof_data);
+    }
+
+    const int iproc = dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+    data_out.build_patches();
+    const std::string filename_prefix = "multi-adjoint-" + dealii::Utilities::int_to_string(dim, 1) + "D-" + dealii::Utilities::int_to_string(cycle, 4);
+    std::string filename = filename_prefix + "." + dealii::Utilities::int_to_string(iproc, 4) + ".vtu";
+    std::ofstream output(filename);
+    data_out.write_vtu(output);
+
+    if (iproc == 0) {
+        std::vector<std::string> filenames;
+        for (unsigned int iproc = 0; iproc < dealii::Utilities::MPI::n_mpi_processes(mpi_communicator); ++iproc) {
+            filenames.push_back(filename_prefix + "." + dealii::Utilities::int_to_string(iproc, 4) + ".vtu");
+        }
+        std::ofstream master_output(filename_prefix + ".pvtu");
+        data_out.write_pvtu_record(master_output, filenames);
+    }
+}
+
+template class MultiFunctionalAdjoint <PHILIP_DIM, 1, double>;
+template class MultiFunctionalAdjoint <PHILIP_DIM, 2, double>;
+template class MultiFunctionalAdjoint <PHILIP_DIM, 3, double>;
+template class MultiFunctionalAdjoint <PHILIP_DIM, 4, double>;
+template class MultiFunctionalAdjoint <PHILIP_DIM, 5, double>;
+
+} // PHiLiP namespace
@@ -0,0 +1,85 @@
+#ifndef __MULTI_FUNCTIONAL_ADJOINT_H__
+#define __MULTI_FUNCTIONAL_ADJOINT_H__
+
+/* includes */
+#include <memory>
+#include <vector>
+
+#include <deal.II/base/conditional_ostream.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "functional.h"
+#include "dg/dg.h"
+
+namespace PHiLiP {
+
+/// Adjoints and sensitivities of several functionals of the same flow solution
+/** The adjoint \f$ \boldsymbol{\psi}_k \f$ of each functional \f$ \mathcal{J}_k \f$ solves
+ *
+ *  \f[
+ *      \left( \frac{\partial \mathbf{R}}{\partial \mathbf{u}} \right)^T \boldsymbol{\psi}_k
+ *      = - \left( \frac{\partial \mathcal{J}_k}{\partial \mathbf{u}} \right)^T
+ *  \f]
+ *
+ *  for the same Jacobian. Therefore, dRdW is assembled once, and the preconditioner set up
+ *  for the first adjoint is reused by all the others. Each solve starts from the combination
+ *  of the previous adjoints whose right-hand sides best approximate its own, such that
+ *  functionals with similar sensitivities, e.g. lift and moment, converge in fewer iterations.
+ *
+ *  The total derivatives with respect to the volume nodes
+ *
+ *  \f[
+ *      \frac{\mathrm{d} \mathcal{J}_k}{\mathrm{d} \mathbf{x}}
+ *      = \frac{\partial \mathcal{J}_k}{\partial \mathbf{x}}
+ *      + \boldsymbol{\psi}_k^T \frac{\partial \mathbf{R}}{\partial \mathbf{x}}
+ *  \f]
+ *
+ *  are then obtained from a single assembly of dRdX.
+ */
+template <int dim, int nstate, typename real>
+class MultiFunctionalAdjoint
+{
+public:
+    /// Vector type of the adjoints and sensitivities.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<real>;
+
+    /// Constructor.
+    MultiFunctionalAdjoint(
+        std::shared_ptr<DGBase<dim,real>> _dg,
+        const std::vector<std::shared_ptr<Functional<dim,nstate,real>>> &_functionals);
+
+    /// Solves the adjoints of all the functionals at the current solution and volume nodes of DGBase.
+    /** If @p compute_sensitivities is true, also evaluates the total derivatives of the functionals
+     *  with respect to the volume nodes.
+     */
+    void solve_adjoints(const bool compute_sensitivities = true);
+
+    /// Outputs the solution and the adjoint of every functional in a single file.
+    void output_results_vtk(const unsigned int cycle) const;
+
+    /// DG class
+    std::shared_ptr<DGBase<dim,real>> dg;
+    /// Functionals sharing the flow solution.
+    std::vector<std::shared_ptr<Functional<dim,nstate,real>>> functionals;
+
+    /// Functional values.
+    std::vector<real> functional_values;
+    /// Functional derivatives with respect to the solution.
+    std::vector<VectorType> dIdw;
+    /// Adjoint of each functional.
+    std::vector<VectorType> adjoints;
+    /// Total derivative of each functional with respect to the volume nodes.
+    std::vector<VectorType> sensitivities;
+    /// Linear iterations taken by each adjoint solve.
+    std::vector<unsigned int> linear_iterations;
+
+protected:
+    MPI_Comm mpi_communicator; ///< MPI communicator
+    dealii::ConditionalOStream pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
+
+}; // MultiFunctionalAdjoint class
+
+} // PHiLiP namespace
+
+#endif // __MULTI_FUNCTIONAL_ADJOINT_H__
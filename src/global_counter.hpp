@@ -3,8 +3,11 @@
 
 extern unsigned int n_vmult;
 extern unsigned int dRdW_form;
+extern unsigned int dRdW_reuse;
 extern unsigned int dRdW_mult;
 extern unsigned int dRdX_mult;
 extern unsigned int d2R_mult;
+extern unsigned int preconditioner_setup;
+extern unsigned int preconditioner_reuse;
 
 #endif
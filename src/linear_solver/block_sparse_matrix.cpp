@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <map>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include "block_sparse_matrix.h"
+
+namespace PHiLiP {
+
+namespace {
+
+/// MPI tag of the messages sent by BlockSparseMatrix::compress().
+const int block_sparse_matrix_compress_tag = 4321;
+
+} // anonymous namespace
+
+BlockSparseMatrix::BlockSparseMatrix()
+    : mpi_communicator(MPI_COMM_WORLD)
+    , n_owned_cells(0)
+{}
+
+void BlockSparseMatrix::reinit (
+    const dealii::IndexSet &locally_owned_dofs,
+    const dealii::IndexSet &locally_relevant_dofs,
+    const std::vector<std::vector<size_type>> &cell_global_dofs,
+    const std::vector<unsigned int> &cell_owners_input,
+    const std::vector<std::vector<unsigned int>> &block_pattern,
+    const MPI_Comm mpi_communicator_input)
+{
+    mpi_communicator = mpi_communicator_input;
+    const unsigned int this_process = dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    dealii::IndexSet ghost_dofs = locally_relevant_dofs;
+    ghost_dofs.subtract_set(locally_owned_dofs);
+    partitioner = std::make_shared<const dealii::Utilities::MPI::Partitioner>(locally_owned_dofs, ghost_dofs, mpi_communicator);
+    ghosted_vector.reinit(partitioner);
+
+    const unsigned int n_cells = cell_global_dofs.size();
+    AssertDimension(cell_owners_input.size(), n_cells);
+    AssertDimension(block_pattern.size(), n_cells);
+    cell_owners = cell_owners_input;
+
+    // Local vector indices of the cells' degrees of freedom.
+    const unsigned int n_relevant_dofs = locally_relevant_dofs.n_elements();
+    dof_cell.assign(n_relevant_dofs, n_cells);
+    dof_position.assign(n_relevant_dofs, 0);
+    cell_dofs.clear();
+    cell_dof_start.assign(1, 0);
+    n_owned_cells = 0;
+    for (unsigned int icell = 0; icell < n_cells; ++icell) {
+        if (cell_owners[icell] == this_process) {
+            Assert(n_owned_cells == icell, dealii::ExcMessage("Locally owned cells must come first."));
+            ++n_owned_cells;
+        }
+        for (unsigned int idof = 0; idof < cell_global_dofs[icell].size(); ++idof) {
+            const unsigned int local_index = partitioner->global_to_local(cell_global_dofs[icell][idof]);
+            dof_cell[local_index] = icell;
+            dof_position[local_index] = idof;
+            cell_dofs.push_back(local_index);
+        }
+        cell_dof_start.push_back(cell_dofs.size());
+    }
+
+    // Block pattern, sorted by block column within each block row.
+    block_row_start.assign(1, 0);
+    block_columns.clear();
+    block_values_start.clear();
+    std::size_t n_values = 0;
+    std::vector<unsigned int> columns;
+    std::vector<unsigned int> ghost_rows_targets;
+    for (unsigned int icell = 0; icell < n_cells; ++icell) {
+        columns = block_pattern[icell];
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+        for (const unsigned int jcell : columns) {
+            block_columns.push_back(jcell);
+            block_values_start.push_back(n_values);
+            n_values += n_cell_dofs(icell) * n_cell_dofs(jcell);
+        }
+        block_row_start.push_back(block_columns.size());
+
+        if (icell >= n_owned_cells && !columns.empty()) ghost_rows_targets.push_back(cell_owners[icell]);
+    }
+    values.assign(n_values, 0.0);
+
+    std::sort(ghost_rows_targets.begin(), ghost_rows_targets.end());
+    ghost_rows_targets.erase(std::unique(ghost_rows_targets.begin(), ghost_rows_targets.end()), ghost_rows_targets.end());
+    compress_targets = ghost_rows_targets;
+    compress_sources = dealii::Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator, compress_targets);
+}
+
+void BlockSparseMatrix::clear ()
+{
+    partitioner.reset();
+    ghosted_vector.reinit(0);
+    cell_dofs.clear(); cell_dofs.shrink_to_fit();
+    cell_dof_start.clear(); cell_dof_start.shrink_to_fit();
+    cell_owners.clear(); cell_owners.shrink_to_fit();
+    n_owned_cells = 0;
+    dof_cell.clear(); dof_cell.shrink_to_fit();
+    dof_position.clear(); dof_position.shrink_to_fit();
+    block_row_start.clear(); block_row_start.shrink_to_fit();
+    block_columns.clear(); block_columns.shrink_to_fit();
+    block_values_start.clear(); block_values_start.shrink_to_fit();
+    values.clear(); values.shrink_to_fit();
+    compress_targets.clear();
+    compress_sources.clear();
+}
+
+BlockSparseMatrix &BlockSparseMatrix::operator= (const double d)
+{
+    Assert(d == 0.0, dealii::ExcMessage("Only zero can be assigned to a BlockSparseMatrix."));
+    (void) d;
+    std::fill(values.begin(), values.end(), 0.0);
+    return *this;
+}
+
+BlockSparseMatrix &BlockSparseMatrix::operator*= (const double factor)
+{
+    for (auto &value : values) value *= factor;
+    return *this;
+}
+
+void BlockSparseMatrix::add (const size_type row, const std::vector<size_type> &col_indices, const std::vector<double> &row_values)
+{
+    AssertDimension(col_indices.size(), row_values.size());
+    if (col_indices.empty()) return;
+
+    const unsigned int local_row = partitioner->global_to_local(row);
+    const unsigned int local_col = partitioner->global_to_local(col_indices[0]);
+    const unsigned int row_cell = dof_cell[local_row];
+    const unsigned int col_cell = dof_cell[local_col];
+    const unsigned int iblock = find_block(row_cell, col_cell);
+    AssertThrow(iblock != n_blocks(), dealii::ExcMessage("Block is not part of the BlockSparseMatrix pattern."));
+
+    const unsigned int n_cols = n_cell_dofs(col_cell);
+    double *block_row = &values[block_values_start[iblock] + dof_position[local_row]*n_cols];
+    for (unsigned int i = 0; i < col_indices.size(); ++i) {
+        const unsigned int local_index = partitioner->global_to_local(col_indices[i]);
+        Assert(dof_cell[local_index] == col_cell, dealii::ExcMessage("Columns must belong to the same cell."));
+        block_row[dof_position[local_index]] += row_values[i];
+    }
+}
+
+void BlockSparseMatrix::add (const double factor, const dealii::TrilinosWrappers::SparseMatrix &matrix)
+{
+    const std::pair<size_type, size_type> local_range = matrix.local_range();
+    for (size_type row = local_range.first; row < local_range.second; ++row) {
+        const unsigned int local_row = partitioner->global_to_local(row);
+        const unsigned int row_cell = dof_cell[local_row];
+        for (auto entry = matrix.begin(row); entry != matrix.end(row); ++entry) {
+            const unsigned int local_col = partitioner->global_to_local(entry->column());
+            const unsigned int col_cell = dof_cell[local_col];
+            const unsigned int iblock = find_block(row_cell, col_cell);
+            AssertThrow(iblock != n_blocks(), dealii::ExcMessage("Block is not part of the BlockSparseMatrix pattern."));
+            values[block_values_start[iblock] + dof_position[local_row]*n_cell_dofs(col_cell) + dof_position[local_col]] += factor * entry->value();
+        }
+    }
+}
+
+void BlockSparseMatrix::compress ()
+{
+    // Each block is sent as the global indices of the first degree of freedom of its row and column cells,
+    // followed by its values. Global indices are exactly represented by doubles up to 2^53.
+    std::map<unsigned int, std::vector<double>> send_buffers;
+    for (unsigned int icell = n_owned_cells; icell < cell_owners.size(); ++icell) {
+        if (block_row_start[icell] == block_row_start[icell+1]) continue;
+        std::vector<double> &buffer = send_buffers[cell_owners[icell]];
+        for (unsigned int iblock = block_row_start[icell]; iblock < block_row_start[icell+1]; ++iblock) {
+            const unsigned int jcell = block_columns[iblock];
+            buffer.push_back(partitioner->local_to_global(cell_dofs[cell_dof_start[icell]]));
+            buffer.push_back(partitioner->local_to_global(cell_dofs[cell_dof_start[jcell]]));
+            double *block = &values[block_values_start[iblock]];
+            const std::size_t block_size = n_cell_dofs(icell) * n_cell_dofs(jcell);
+            buffer.insert(buffer.end(), block, block + block_size);
+            std::fill(block, block + block_size, 0.0);
+        }
+    }
+
+    std::vector<MPI_Request> requests(compress_targets.size());
+    for (unsigned int i = 0; i < compress_targets.size(); ++i) {
+        std::vector<double> &buffer = send_buffers[compress_targets[i]];
+        const int ierr = MPI_Isend(buffer.data(), buffer.size(), MPI_DOUBLE, compress_targets[i],
+                                   block_sparse_matrix_compress_tag, mpi_communicator, &requests[i]);
+        AssertThrowMPI(ierr);
+    }
+
+    std::vector<double> receive_buffer;
+    for (unsigned int i = 0; i < compress_sources.size(); ++i) {
+        MPI_Status status;
+        int ierr = MPI_Probe(MPI_ANY_SOURCE, block_sparse_matrix_compress_tag, mpi_communicator, &status);
+        AssertThrowMPI(ierr);
+        int n_received = 0;
+        ierr = MPI_Get_count(&status, MPI_DOUBLE, &n_received);
+        AssertThrowMPI(ierr);
+        receive_buffer.resize(n_received);
+        ierr = MPI_Recv(receive_buffer.data(), n_received, MPI_DOUBLE, status.MPI_SOURCE,
+                        block_sparse_matrix_compress_tag, mpi_communicator, MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+
+        std::size_t position = 0;
+        while (position < receive_buffer.size()) {
+            const size_type row_dof = static_cast<size_type>(receive_buffer[position++]);
+            const size_type col_dof = static_cast<size_type>(receive_buffer[position++]);
+            const unsigned int row_cell = dof_cell[partitioner->global_to_local(row_dof)];
+            const unsigned int col_cell = dof_cell[partitioner->global_to_local(col_dof)];
+            const unsigned int iblock = find_block(row_cell, col_cell);
+            AssertThrow(iblock != n_blocks(), dealii::ExcMessage("Received block is not part of the BlockSparseMatrix pattern."));
+            const std::size_t block_size = n_cell_dofs(row_cell) * n_cell_dofs(col_cell);
+            double *block = &values[block_values_start[iblock]];
+            for (std::size_t k = 0; k < block_size; ++k) block[k] += receive_buffer[position++];
+        }
+    }
+
+    if (!requests.empty()) {
+        const int ierr = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        AssertThrowMPI(ierr);
+    }
+}
+
+void BlockSparseMatrix::vmult (VectorType &dst, const VectorType &src) const
+{
+    const unsigned int n_owned_dofs = partitioner->locally_owned_range().n_elements();
+    for (unsigned int i = 0; i < n_owned_dofs; ++i) ghosted_vector.local_element(i) = src.local_element(i);
+    ghosted_vector.update_ghost_values();
+
+    for (unsigned int icell = 0; icell < n_owned_cells; ++icell) {
+        const unsigned int *row_dofs = cell_dof_indices(icell);
+        const unsigned int n_rows = n_cell_dofs(icell);
+        for (unsigned int i = 0; i < n_rows; ++i) dst.local_element(row_dofs[i]) = 0.0;
+
+        for (unsigned int iblock = block_row_start[icell]; iblock < block_row_start[icell+1]; ++iblock) {
+            const unsigned int jcell = block_columns[iblock];
+            const unsigned int *col_dofs = cell_dof_indices(jcell);
+            const unsigned int n_cols = n_cell_dofs(jcell);
+            const double *block = &values[block_values_start[iblock]];
+            for (unsigned int i = 0; i < n_rows; ++i) {
+                double sum = 0.0;
+                for (unsigned int j = 0; j < n_cols; ++j) {
+                    sum += block[i*n_cols+j] * ghosted_vector.local_element(col_dofs[j]);
+                }
+                dst.local_element(row_dofs[i]) += sum;
+            }
+        }
+    }
+    ghosted_vector.zero_out_ghosts();
+}
+
+void BlockSparseMatrix::Tvmult (VectorType &dst, const VectorType &src) const
+{
+    ghosted_vector = 0.0;
+    ghosted_vector.zero_out_ghosts();
+    for (unsigned int icell = 0; icell < n_owned_cells; ++icell) {
+        const unsigned int *row_dofs = cell_dof_indices(icell);
+        const unsigned int n_rows = n_cell_dofs(icell);
+        for (unsigned int iblock = block_row_start[icell]; iblock < block_row_start[icell+1]; ++iblock) {
+            const unsigned int jcell = block_columns[iblock];
+            const unsigned int *col_dofs = cell_dof_indices(jcell);
+            const unsigned int n_cols = n_cell_dofs(jcell);
+            const double *block = &values[block_values_start[iblock]];
+            for (unsigned int i = 0; i < n_rows; ++i) {
+                const double src_i = src.local_element(row_dofs[i]);
+                for (unsigned int j = 0; j < n_cols; ++j) {
+                    ghosted_vector.local_element(col_dofs[j]) += block[i*n_cols+j] * src_i;
+                }
+            }
+        }
+    }
+    ghosted_vector.compress(dealii::VectorOperation::add);
+
+    const unsigned int n_owned_dofs = partitioner->locally_owned_range().n_elements();
+    for (unsigned int i = 0; i < n_owned_dofs; ++i) dst.local_element(i) = ghosted_vector.local_element(i);
+}
+
+std::size_t BlockSparseMatrix::memory_consumption () const
+{
+    return values.capacity() * sizeof(double)
+           + block_values_start.capacity() * sizeof(std::size_t)
+           + (block_columns.capacity() + block_row_start.capacity()
+              + cell_dofs.capacity() + cell_dof_start.capacity() + cell_owners.capacity()
+              + dof_cell.capacity() + dof_position.capacity()) * sizeof(unsigned int);
+}
+
+unsigned int BlockSparseMatrix::n_locally_owned_cells () const
+{
+    return n_owned_cells;
+}
+
+unsigned int BlockSparseMatrix::n_cell_dofs (const unsigned int icell) const
+{
+    return cell_dof_start[icell+1] - cell_dof_start[icell];
+}
+
+const unsigned int *BlockSparseMatrix::cell_dof_indices (const unsigned int icell) const
+{
+    return &cell_dofs[cell_dof_start[icell]];
+}
+
+std::pair<unsigned int, unsigned int> BlockSparseMatrix::block_row_range (const unsigned int icell) const
+{
+    return {block_row_start[icell], block_row_start[icell+1]};
+}
+
+unsigned int BlockSparseMatrix::block_column (const unsigned int iblock) const
+{
+    return block_columns[iblock];
+}
+
+const double *BlockSparseMatrix::block_values (const unsigned int iblock) const
+{
+    return &values[block_values_start[iblock]];
+}
+
+double *BlockSparseMatrix::block_values (const unsigned int iblock)
+{
+    return &values[block_values_start[iblock]];
+}
+
+unsigned int BlockSparseMatrix::find_block (const unsigned int row_cell, const unsigned int column_cell) const
+{
+    const auto begin = block_columns.begin() + block_row_start[row_cell];
+    const auto end = block_columns.begin() + block_row_start[row_cell+1];
+    const auto found = std::lower_bound(begin, end, column_cell);
+    if (found == end || *found != column_cell) return n_blocks();
+    return found - block_columns.begin();
+}
+
+unsigned int BlockSparseMatrix::n_blocks () const
+{
+    return block_columns.size();
+}
+
+} // PHiLiP namespace
@@ -0,0 +1,127 @@
+#ifndef __BLOCK_SPARSE_MATRIX_H__
+#define __BLOCK_SPARSE_MATRIX_H__
+
+#include <memory>
+#include <vector>
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+namespace PHiLiP {
+
+/// Block sparse matrix made of dense cell-to-cell blocks.
+/** The degrees of freedom of a cell are stored once, and each (cell, neighbor) block
+ *  only stores its block column and a dense row-major array of values.
+ *  A scalar sparse matrix instead stores a column index for every entry.
+ *
+ *  The cells are numbered locally: the locally owned cells come first, followed by the ghost cells.
+ *  Contributions added to the rows of ghost cells are sent to their owner by compress().
+ *  The blocks of the locally owned cells are used by vmult() and Tvmult(), such that the transpose
+ *  never needs to be formed.
+ */
+class BlockSparseMatrix
+{
+public:
+    /// Vector type on which the matrix is applied.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+    /// Global index type of the rows and columns.
+    using size_type = dealii::types::global_dof_index;
+
+    /// Constructor. The matrix is empty until reinit() is called.
+    BlockSparseMatrix();
+
+    /// Allocates the blocks and sets them to zero.
+    /** @p cell_dofs holds the global degrees of freedom of the locally owned cells first,
+     *  followed by the ghost cells. @p cell_owners holds the processor owning each cell.
+     *  @p block_pattern[icell] lists the cells coupled to the rows of icell, including icell itself.
+     *  Ghost cells only need a pattern if this processor adds contributions to their rows.
+     */
+    void reinit (
+        const dealii::IndexSet &locally_owned_dofs,
+        const dealii::IndexSet &locally_relevant_dofs,
+        const std::vector<std::vector<size_type>> &cell_dofs,
+        const std::vector<unsigned int> &cell_owners,
+        const std::vector<std::vector<unsigned int>> &block_pattern,
+        const MPI_Comm mpi_communicator);
+
+    /// Releases the memory of the matrix.
+    void clear ();
+
+    /// Sets all the blocks to @p d, which must be zero.
+    BlockSparseMatrix &operator= (const double d);
+
+    /// Scales all the blocks by @p factor.
+    BlockSparseMatrix &operator*= (const double factor);
+
+    /// Adds @p values to the entries (@p row, @p col_indices).
+    /** Same interface as dealii::TrilinosWrappers::SparseMatrix::add().
+     *  The columns must all belong to the same cell, which only requires a single block lookup.
+     */
+    void add (const size_type row, const std::vector<size_type> &col_indices, const std::vector<double> &values);
+
+    /// Adds @p factor times @p matrix, whose entries must lie within the blocks of the locally owned cells.
+    void add (const double factor, const dealii::TrilinosWrappers::SparseMatrix &matrix);
+
+    /// Sends the contributions to the rows of ghost cells to their owner.
+    void compress ();
+
+    /// Matrix-vector product dst = A*src.
+    void vmult (VectorType &dst, const VectorType &src) const;
+
+    /// Transposed matrix-vector product dst = A^T*src.
+    void Tvmult (VectorType &dst, const VectorType &src) const;
+
+    /// Memory used by the values and indices of the matrix in bytes.
+    std::size_t memory_consumption () const;
+
+    /// Number of locally owned cells, which are the first cells of the local numbering.
+    unsigned int n_locally_owned_cells () const;
+    /// Number of degrees of freedom of @p icell.
+    unsigned int n_cell_dofs (const unsigned int icell) const;
+    /// Local vector indices of the degrees of freedom of @p icell.
+    const unsigned int *cell_dof_indices (const unsigned int icell) const;
+    /// Range of the blocks of the rows of @p icell, sorted by block column.
+    std::pair<unsigned int, unsigned int> block_row_range (const unsigned int icell) const;
+    /// Cell of the columns of block @p iblock.
+    unsigned int block_column (const unsigned int iblock) const;
+    /// Row-major values of block @p iblock.
+    const double *block_values (const unsigned int iblock) const;
+    /// Row-major values of block @p iblock.
+    double *block_values (const unsigned int iblock);
+    /// Finds the block (@p row_cell, @p column_cell). Returns n_blocks() if it does not exist.
+    unsigned int find_block (const unsigned int row_cell, const unsigned int column_cell) const;
+    /// Number of blocks stored on this processor.
+    unsigned int n_blocks () const;
+
+private:
+    MPI_Comm mpi_communicator; ///< MPI communicator.
+
+    /// Partitioner of the locally owned and relevant degrees of freedom.
+    std::shared_ptr<const dealii::Utilities::MPI::Partitioner> partitioner;
+
+    /// Local vector indices of the cells' degrees of freedom, where cell i holds cell_dofs[cell_dof_start[i]:cell_dof_start[i+1]].
+    std::vector<unsigned int> cell_dofs;
+    std::vector<unsigned int> cell_dof_start; ///< Start of each cell in cell_dofs.
+    std::vector<unsigned int> cell_owners;    ///< Processor owning each cell.
+    unsigned int n_owned_cells;                ///< Number of locally owned cells.
+
+    std::vector<unsigned int> dof_cell;     ///< Cell of each locally relevant degree of freedom.
+    std::vector<unsigned int> dof_position; ///< Position of each locally relevant degree of freedom within its cell.
+
+    std::vector<unsigned int> block_row_start;    ///< Start of the blocks of each cell in block_columns.
+    std::vector<unsigned int> block_columns;      ///< Cell of the columns of each block.
+    std::vector<std::size_t> block_values_start;  ///< Start of each block in values.
+    std::vector<double> values;                   ///< Contiguous row-major storage of the blocks.
+
+    std::vector<unsigned int> compress_targets;   ///< Processors receiving ghost rows from this processor.
+    std::vector<unsigned int> compress_sources;   ///< Processors sending ghost rows to this processor.
+
+    mutable VectorType ghosted_vector; ///< Work vector with ghost entries used by vmult() and Tvmult().
+};
+
+} // PHiLiP namespace
+
+#endif
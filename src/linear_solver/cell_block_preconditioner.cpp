@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include <deal.II/base/exceptions.h>
+
+#include "cell_block_preconditioner.h"
+
+namespace PHiLiP {
+
+namespace {
+
+/// Dense product C += alpha * A * B, where A is m x k, B is k x n, and C is m x n, all in row-major order.
+void dense_matrix_matrix_product(
+    const unsigned int m, const unsigned int n, const unsigned int k,
+    const double alpha, const double *A, const double *B, double *C)
+{
+    for (unsigned int i = 0; i < m; ++i) {
+        for (unsigned int l = 0; l < k; ++l) {
+            const double a_il = alpha * A[i*k+l];
+            const double *B_l = B + l*n;
+            double *C_i = C + i*n;
+            for (unsigned int j = 0; j < n; ++j) {
+                C_i[j] += a_il * B_l[j];
+            }
+        }
+    }
+}
+
+/// Dense product y += alpha * A * x, where A is m x n in row-major order.
+void dense_matrix_vector_product(
+    const unsigned int m, const unsigned int n,
+    const double alpha, const double *A, const double *x, double *y)
+{
+    for (unsigned int i = 0; i < m; ++i) {
+        const double *A_i = A + i*n;
+        double sum = 0.0;
+        for (unsigned int j = 0; j < n; ++j) {
+            sum += A_i[j] * x[j];
+        }
+        y[i] += alpha * sum;
+    }
+}
+
+/// Dense product y += alpha * A^T * x, where A is m x n in row-major order.
+void dense_transpose_matrix_vector_product(
+    const unsigned int m, const unsigned int n,
+    const double alpha, const double *A, const double *x, double *y)
+{
+    for (unsigned int i = 0; i < m; ++i) {
+        const double *A_i = A + i*n;
+        const double x_i = alpha * x[i];
+        for (unsigned int j = 0; j < n; ++j) {
+            y[j] += A_i[j] * x_i;
+        }
+    }
+}
+
+/// Replaces the n x n row-major matrix A by its inverse using an LU factorization with partial pivoting.
+void invert_dense_matrix(const unsigned int n, double *A, std::vector<double> &lu, std::vector<unsigned int> &pivots, std::vector<double> &column)
+{
+    lu.assign(A, A+n*n);
+    pivots.resize(n);
+    column.resize(n);
+
+    for (unsigned int k = 0; k < n; ++k) {
+        unsigned int pivot = k;
+        double max_value = std::abs(lu[k*n+k]);
+        for (unsigned int i = k+1; i < n; ++i) {
+            if (std::abs(lu[i*n+k]) > max_value) {
+                max_value = std::abs(lu[i*n+k]);
+                pivot = i;
+            }
+        }
+        AssertThrow(max_value > 0.0, dealii::ExcMessage("Singular diagonal block in CellBlockPreconditioner."));
+        pivots[k] = pivot;
+        if (pivot != k) {
+            for (unsigned int j = 0; j < n; ++j) std::swap(lu[k*n+j], lu[pivot*n+j]);
+        }
+        const double inverse_pivot = 1.0 / lu[k*n+k];
+        for (unsigned int i = k+1; i < n; ++i) {
+            lu[i*n+k] *= inverse_pivot;
+            const double l_ik = lu[i*n+k];
+            for (unsigned int j = k+1; j < n; ++j) {
+                lu[i*n+j] -= l_ik * lu[k*n+j];
+            }
+        }
+    }
+
+    // Solve for each column of the identity.
+    for (unsigned int icol = 0; icol < n; ++icol) {
+        std::fill(column.begin(), column.end(), 0.0);
+        column[icol] = 1.0;
+        for (unsigned int k = 0; k < n; ++k) {
+            std::swap(column[k], column[pivots[k]]);
+        }
+        for (unsigned int i = 0; i < n; ++i) {
+            for (unsigned int j = 0; j < i; ++j) {
+                column[i] -= lu[i*n+j] * column[j];
+            }
+        }
+        for (unsigned int i = n; i-- > 0;) {
+            for (unsigned int j = i+1; j < n; ++j) {
+                column[i] -= lu[i*n+j] * column[j];
+            }
+            column[i] /= lu[i*n+i];
+        }
+        for (unsigned int i = 0; i < n; ++i) {
+            A[i*n+icol] = column[i];
+        }
+    }
+}
+
+} // anonymous namespace
+
+CellBlockPreconditioner::CellBlockPreconditioner(const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type)
+    : use_ilu(preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::block_ilu0)
+    , first_local_row(0)
+{
+    Assert(preconditioner_type != Parameters::LinearSolverParam::PreconditionerEnum::ilut,
+           dealii::ExcMessage("CellBlockPreconditioner only provides block preconditioners."));
+}
+
+void CellBlockPreconditioner::initialize(const dealii::TrilinosWrappers::SparseMatrix &matrix)
+{
+    using size_type = dealii::TrilinosWrappers::SparseMatrix::size_type;
+    const std::pair<size_type, size_type> local_range = matrix.local_range();
+    first_local_row = local_range.first;
+    const unsigned int n_local_rows = local_range.second - local_range.first;
+    const auto is_local = [&](const size_type global_index) {
+        return global_index >= local_range.first && global_index < local_range.second;
+    };
+
+    // Group the rows with identical sparsity patterns into blocks.
+    block_rows.clear();
+    row_block.resize(n_local_rows);
+    row_position.resize(n_local_rows);
+    std::map<std::vector<size_type>, unsigned int> pattern_to_block;
+    std::vector<size_type> pattern;
+    for (unsigned int irow = 0; irow < n_local_rows; ++irow) {
+        pattern.clear();
+        for (auto entry = matrix.begin(first_local_row+irow); entry != matrix.end(first_local_row+irow); ++entry) {
+            pattern.push_back(entry->column());
+        }
+        std::sort(pattern.begin(), pattern.end());
+
+        const auto inserted = pattern_to_block.emplace(pattern, block_rows.size());
+        if (inserted.second) block_rows.emplace_back();
+        const unsigned int iblock = inserted.first->second;
+        row_block[irow] = iblock;
+        row_position[irow] = block_rows[iblock].size();
+        block_rows[iblock].push_back(irow);
+    }
+    pattern_to_block.clear();
+
+    // Block sparsity pattern. Only the diagonal blocks are kept for block-Jacobi.
+    std::vector<std::vector<unsigned int>> block_neighbors(block_rows.size());
+    for (unsigned int iblock = 0; iblock < block_rows.size(); ++iblock) {
+        block_neighbors[iblock].assign(1, iblock);
+        if (!use_ilu) continue;
+        const size_type row = first_local_row + block_rows[iblock][0];
+        for (auto entry = matrix.begin(row); entry != matrix.end(row); ++entry) {
+            if (is_local(entry->column())) block_neighbors[iblock].push_back(row_block[entry->column() - first_local_row]);
+        }
+    }
+    allocate_blocks(block_neighbors);
+
+    // Copy the matrix entries into the dense blocks.
+    for (unsigned int irow = 0; irow < n_local_rows; ++irow) {
+        const unsigned int iblock = row_block[irow];
+        for (auto entry = matrix.begin(first_local_row+irow); entry != matrix.end(first_local_row+irow); ++entry) {
+            if (!is_local(entry->column())) continue;
+            const unsigned int icol = entry->column() - first_local_row;
+            const unsigned int index = find_block(iblock, row_block[icol]);
+            if (index == block_columns.size()) continue;
+            const unsigned int n_cols = block_rows[row_block[icol]].size();
+            block_values[block_values_start[index] + row_position[irow]*n_cols + row_position[icol]] = entry->value();
+        }
+    }
+
+    factorize();
+}
+
+void CellBlockPreconditioner::initialize(const BlockSparseMatrix &matrix, const bool transpose)
+{
+    first_local_row = 0;
+
+    // The locally owned cells of the matrix are the blocks.
+    const unsigned int n_blocks = matrix.n_locally_owned_cells();
+    block_rows.resize(n_blocks);
+    unsigned int n_local_rows = 0;
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        n_local_rows += matrix.n_cell_dofs(iblock);
+    }
+    row_block.resize(n_local_rows);
+    row_position.resize(n_local_rows);
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        const unsigned int *dofs = matrix.cell_dof_indices(iblock);
+        block_rows[iblock].assign(dofs, dofs + matrix.n_cell_dofs(iblock));
+        for (unsigned int i = 0; i < block_rows[iblock].size(); ++i) {
+            row_block[block_rows[iblock][i]] = iblock;
+            row_position[block_rows[iblock][i]] = i;
+        }
+    }
+
+    // The block pattern of the face graph is symmetric, such that the transpose has the same block pattern.
+    std::vector<std::vector<unsigned int>> block_neighbors(n_blocks);
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        block_neighbors[iblock].assign(1, iblock);
+        if (!use_ilu) continue;
+        const std::pair<unsigned int, unsigned int> range = matrix.block_row_range(iblock);
+        for (unsigned int k = range.first; k < range.second; ++k) {
+            if (matrix.block_column(k) < n_blocks) block_neighbors[iblock].push_back(matrix.block_column(k));
+        }
+    }
+    allocate_blocks(block_neighbors);
+
+    // Copy the blocks, or the transposed blocks.
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        const unsigned int n_rows = block_rows[iblock].size();
+        for (unsigned int ij = block_row_start[iblock]; ij < block_row_start[iblock+1]; ++ij) {
+            const unsigned int jblock = block_columns[ij];
+            const unsigned int n_cols = block_rows[jblock].size();
+            double *block = &block_values[block_values_start[ij]];
+            if (!transpose) {
+                const unsigned int matrix_block = matrix.find_block(iblock, jblock);
+                if (matrix_block == matrix.n_blocks()) continue;
+                std::copy(matrix.block_values(matrix_block), matrix.block_values(matrix_block) + n_rows*n_cols, block);
+            } else {
+                const unsigned int matrix_block = matrix.find_block(jblock, iblock);
+                if (matrix_block == matrix.n_blocks()) continue;
+                const double *transposed_block = matrix.block_values(matrix_block);
+                for (unsigned int i = 0; i < n_rows; ++i) {
+                    for (unsigned int j = 0; j < n_cols; ++j) {
+                        block[i*n_cols+j] = transposed_block[j*n_rows+i];
+                    }
+                }
+            }
+        }
+    }
+
+    factorize();
+}
+
+void CellBlockPreconditioner::allocate_blocks(std::vector<std::vector<unsigned int>> &block_neighbors)
+{
+    const unsigned int n_blocks = block_rows.size();
+    block_row_start.assign(1, 0);
+    block_columns.clear();
+    block_values_start.clear();
+    diagonal_block.resize(n_blocks);
+    std::size_t n_values = 0;
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        std::vector<unsigned int> &neighbors = block_neighbors[iblock];
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        const unsigned int n_rows = block_rows[iblock].size();
+        for (const unsigned int jblock : neighbors) {
+            if (jblock == iblock) diagonal_block[iblock] = block_columns.size();
+            block_columns.push_back(jblock);
+            block_values_start.push_back(n_values);
+            n_values += n_rows * block_rows[jblock].size();
+        }
+        block_row_start.push_back(block_columns.size());
+    }
+    block_values.assign(n_values, 0.0);
+}
+
+void CellBlockPreconditioner::factorize()
+{
+    // Block factorization, where the lower blocks of each block row are eliminated in increasing order.
+    const unsigned int n_blocks = block_rows.size();
+    std::vector<double> work, lu, column;
+    std::vector<unsigned int> pivots;
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        const unsigned int n_rows = block_rows[iblock].size();
+        for (unsigned int ik = block_row_start[iblock]; ik < diagonal_block[iblock]; ++ik) {
+            const unsigned int kblock = block_columns[ik];
+            const unsigned int n_k = block_rows[kblock].size();
+
+            // L_IK = A_IK * inverse(U_KK)
+            double *A_ik = &block_values[block_values_start[ik]];
+            work.assign(A_ik, A_ik + n_rows*n_k);
+            std::fill(A_ik, A_ik + n_rows*n_k, 0.0);
+            dense_matrix_matrix_product(n_rows, n_k, n_k, 1.0, work.data(), &block_values[block_values_start[diagonal_block[kblock]]], A_ik);
+
+            // A_IJ -= L_IK * U_KJ, dropping the fill-in outside of the block pattern.
+            for (unsigned int kj = diagonal_block[kblock]+1; kj < block_row_start[kblock+1]; ++kj) {
+                const unsigned int jblock = block_columns[kj];
+                const unsigned int ij = find_block(iblock, jblock);
+                if (ij == block_columns.size()) continue;
+                const unsigned int n_j = block_rows[jblock].size();
+                dense_matrix_matrix_product(n_rows, n_j, n_k, -1.0, A_ik, &block_values[block_values_start[kj]], &block_values[block_values_start[ij]]);
+            }
+        }
+        invert_dense_matrix(n_rows, &block_values[block_values_start[diagonal_block[iblock]]], lu, pivots, column);
+    }
+}
+
+void CellBlockPreconditioner::vmult(VectorType &dst, const VectorType &src) const
+{
+    const unsigned int n_blocks = block_rows.size();
+    std::vector<double> block_rhs, block_neighbor, block_solution;
+
+    // Forward substitution with the unit lower blocks.
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        const std::vector<unsigned int> &rows = block_rows[iblock];
+        block_rhs.resize(rows.size());
+        for (unsigned int i = 0; i < rows.size(); ++i) block_rhs[i] = src.local_element(rows[i]);
+
+        for (unsigned int ik = block_row_start[iblock]; ik < diagonal_block[iblock]; ++ik) {
+            const std::vector<unsigned int> &neighbor_rows = block_rows[block_columns[ik]];
+            block_neighbor.resize(neighbor_rows.size());
+            for (unsigned int k = 0; k < neighbor_rows.size(); ++k) block_neighbor[k] = dst.local_element(neighbor_rows[k]);
+            dense_matrix_vector_product(rows.size(), neighbor_rows.size(), -1.0, &block_values[block_values_start[ik]], block_neighbor.data(), block_rhs.data());
+        }
+        for (unsigned int i = 0; i < rows.size(); ++i) dst.local_element(rows[i]) = block_rhs[i];
+    }
+
+    // Backward substitution with the upper blocks and the inverted diagonal blocks.
+    for (unsigned int iblock = n_blocks; iblock-- > 0;) {
+        const std::vector<unsigned int> &rows = block_rows[iblock];
+        block_rhs.resize(rows.size());
+        for (unsigned int i = 0; i < rows.size(); ++i) block_rhs[i] = dst.local_element(rows[i]);
+
+        for (unsigned int ij = diagonal_block[iblock]+1; ij < block_row_start[iblock+1]; ++ij) {
+            const std::vector<unsigned int> &neighbor_rows = block_rows[block_columns[ij]];
+            block_neighbor.resize(neighbor_rows.size());
+            for (unsigned int j = 0; j < neighbor_rows.size(); ++j) block_neighbor[j] = dst.local_element(neighbor_rows[j]);
+            dense_matrix_vector_product(rows.size(), neighbor_rows.size(), -1.0, &block_values[block_values_start[ij]], block_neighbor.data(), block_rhs.data());
+        }
+        block_solution.assign(rows.size(), 0.0);
+        dense_matrix_vector_product(rows.size(), rows.size(), 1.0, &block_values[block_values_start[diagonal_block[iblock]]], block_rhs.data(), block_solution.data());
+        for (unsigned int i = 0; i < rows.size(); ++i) dst.local_element(rows[i]) = block_solution[i];
+    }
+}
+
+void CellBlockPreconditioner::Tvmult(VectorType &dst, const VectorType &src) const
+{
+    // The transpose of LU is U^T L^T, where U^T is block lower triangular and L^T block upper triangular.
+    // Each solved block is eliminated from the right-hand side of the blocks that follow, such that
+    // the stored blocks are read by block row, as in vmult().
+    const unsigned int n_blocks = block_rows.size();
+    std::vector<double> block_rhs, block_solution;
+    for (const std::vector<unsigned int> &rows : block_rows) {
+        for (const unsigned int row : rows) dst.local_element(row) = src.local_element(row);
+    }
+
+    // Forward substitution with the transposed upper blocks and the inverted diagonal blocks.
+    for (unsigned int iblock = 0; iblock < n_blocks; ++iblock) {
+        const std::vector<unsigned int> &rows = block_rows[iblock];
+        block_rhs.resize(rows.size());
+        for (unsigned int i = 0; i < rows.size(); ++i) block_rhs[i] = dst.local_element(rows[i]);
+        block_solution.assign(rows.size(), 0.0);
+        dense_transpose_matrix_vector_product(rows.size(), rows.size(), 1.0, &block_values[block_values_start[diagonal_block[iblock]]], block_rhs.data(), block_solution.data());
+        for (unsigned int i = 0; i < rows.size(); ++i) dst.local_element(rows[i]) = block_solution[i];
+
+        for (unsigned int ij = diagonal_block[iblock]+1; ij < block_row_start[iblock+1]; ++ij) {
+            const std::vector<unsigned int> &neighbor_rows = block_rows[block_columns[ij]];
+            block_rhs.assign(neighbor_rows.size(), 0.0);
+            dense_transpose_matrix_vector_product(rows.size(), neighbor_rows.size(), -1.0, &block_values[block_values_start[ij]], block_solution.data(), block_rhs.data());
+            for (unsigned int j = 0; j < neighbor_rows.size(); ++j) dst.local_element(neighbor_rows[j]) += block_rhs[j];
+        }
+    }
+
+    // Backward substitution with the transposed unit lower blocks.
+    for (unsigned int iblock = n_blocks; iblock-- > 0;) {
+        const std::vector<unsigned int> &rows = block_rows[iblock];
+        block_solution.resize(rows.size());
+        for (unsigned int i = 0; i < rows.size(); ++i) block_solution[i] = dst.local_element(rows[i]);
+
+        for (unsigned int ik = block_row_start[iblock]; ik < diagonal_block[iblock]; ++ik) {
+            const std::vector<unsigned int> &neighbor_rows = block_rows[block_columns[ik]];
+            block_rhs.assign(neighbor_rows.size(), 0.0);
+            dense_transpose_matrix_vector_product(rows.size(), neighbor_rows.size(), -1.0, &block_values[block_values_start[ik]], block_solution.data(), block_rhs.data());
+            for (unsigned int k = 0; k < neighbor_rows.size(); ++k) dst.local_element(neighbor_rows[k]) += block_rhs[k];
+        }
+    }
+}
+
+unsigned int CellBlockPreconditioner::n_blocks() const
+{
+    return block_rows.size();
+}
+
+unsigned int CellBlockPreconditioner::max_block_size() const
+{
+    unsigned int max_size = 0;
+    for (const auto &rows : block_rows) {
+        max_size = std::max(max_size, static_cast<unsigned int>(rows.size()));
+    }
+    return max_size;
+}
+
+unsigned int CellBlockPreconditioner::find_block(const unsigned int block_row, const unsigned int block_column) const
+{
+    const auto begin = block_columns.begin() + block_row_start[block_row];
+    const auto end = block_columns.begin() + block_row_start[block_row+1];
+    const auto found = std::lower_bound(begin, end, block_column);
+    if (found == end || *found != block_column) return block_columns.size();
+    return found - block_columns.begin();
+}
+
+} // PHiLiP namespace
@@ -0,0 +1,104 @@
+#ifndef __CELL_BLOCK_PRECONDITIONER_H__
+#define __CELL_BLOCK_PRECONDITIONER_H__
+
+#include <vector>
+
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "parameters/parameters_linear_solver.h"
+#include "block_sparse_matrix.h"
+
+namespace PHiLiP {
+
+/// Preconditioner operating on the dense cell blocks of a DG matrix.
+/** Rows sharing the same sparsity pattern are grouped into a block, which recovers the
+ *  cell blocks of a DG discretization independently of the degrees of freedom numbering.
+ *  The blocks are copied into contiguous dense storage and applied with dense kernels.
+ *
+ *  Block-Jacobi inverts the diagonal blocks.
+ *  Block-ILU(0) performs an incomplete LU factorization restricted to the block sparsity pattern,
+ *  which is the face graph of the mesh, and stores the inverse of the factored diagonal blocks.
+ *
+ *  Couplings with the rows owned by other processors are ignored, such that the preconditioner
+ *  is applied independently on each subdomain.
+ */
+class CellBlockPreconditioner
+{
+public:
+    /// Vector type on which the preconditioner is applied.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Constructor.
+    /** @p preconditioner_type must be either block_jacobi or block_ilu0.
+     */
+    explicit CellBlockPreconditioner(const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type);
+
+    /// Extracts the cell blocks of @p matrix and factorizes them.
+    void initialize(const dealii::TrilinosWrappers::SparseMatrix &matrix);
+
+    /// Factorizes the blocks of the locally owned cells of @p matrix, or of its transpose if @p transpose is true.
+    void initialize(const BlockSparseMatrix &matrix, const bool transpose = false);
+
+    /// Applies the inverse of the factorization to @p src.
+    void vmult(VectorType &dst, const VectorType &src) const;
+
+    /// Applies the inverse of the transposed factorization to @p src.
+    /** Preconditions the transposed system without factorizing the transposed matrix.
+     */
+    void Tvmult(VectorType &dst, const VectorType &src) const;
+
+    /// Number of blocks found on this processor.
+    unsigned int n_blocks() const;
+
+    /// Largest block size found on this processor.
+    unsigned int max_block_size() const;
+
+private:
+    /// Use block-ILU(0) if true, block-Jacobi otherwise.
+    const bool use_ilu;
+
+    /// Global index of the first locally owned row.
+    dealii::types::global_dof_index first_local_row;
+
+    /// Local rows of each block.
+    std::vector<std::vector<unsigned int>> block_rows;
+
+    /// Block of each local row.
+    std::vector<unsigned int> row_block;
+    /// Position of each local row within its block.
+    std::vector<unsigned int> row_position;
+
+    /// Index of the first block of each block row in block_columns.
+    /** The blocks of block row I are block_columns[block_row_start[I]:block_row_start[I+1]]
+     *  and are sorted by block column.
+     */
+    std::vector<unsigned int> block_row_start;
+    /// Block column of each stored block.
+    std::vector<unsigned int> block_columns;
+    /// Index of each stored block within block_values.
+    std::vector<std::size_t> block_values_start;
+    /// Index of the diagonal block of each block row in block_columns.
+    std::vector<unsigned int> diagonal_block;
+
+    /// Contiguous storage of the dense blocks in row-major order.
+    /** The lower blocks hold the ILU(0) factor L with unit diagonal blocks left implicit,
+     *  the diagonal blocks hold the inverse of the diagonal blocks of U, and the upper blocks hold U.
+     */
+    std::vector<double> block_values;
+
+    /// Allocates the blocks coupling each block to its @p block_neighbors, which are sorted in place.
+    void allocate_blocks(std::vector<std::vector<unsigned int>> &block_neighbors);
+
+    /// Factorizes the blocks in place.
+    void factorize();
+
+    /// Finds the stored block (@p block_row, @p block_column).
+    /** Returns block_columns.size() if the block is not part of the pattern.
+     */
+    unsigned int find_block(const unsigned int block_row, const unsigned int block_column) const;
+};
+
+} // PHiLiP namespace
+
+#endif
@@ -1,3 +1,11 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <Amesos.h>
+#include <AztecOO.h>
+#include <Epetra_LinearProblem.h>
+
 #include <deal.II/base/conditional_ostream.h>
 
 #include <deal.II/lac/solver_control.h>
@@ -7,17 +15,359 @@
 #include <deal.II/lac/solver_gmres.h>
 
 #include "linear_solver.h"
+#include "cell_block_preconditioner.h"
+#include "p_multigrid_preconditioner.h"
+#include "pipelined_gmres.h"
+#include "recycling_gmres.h"
 
 #include "global_counter.hpp"
 
 namespace PHiLiP {
 
+namespace {
+
+/// Transpose of a matrix, applied through its Tvmult() without being formed.
+template <typename MatrixType>
+struct TransposedMatrix
+{
+    const MatrixType &matrix; ///< Matrix to be transposed.
+    /// dst = A^T*src.
+    void vmult(dealii::LinearAlgebra::distributed::Vector<double> &dst, const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+    {
+        matrix.Tvmult(dst, src);
+    }
+};
+
+/// Preconditioner of the transposed system, applied through the Tvmult() of the preconditioner of the system.
+/** An incomplete factorization LU of A is also one of A^T, U^T L^T, such that the
+ *  factorization is neither transposed nor recomputed.
+ */
+template <typename PreconditionerType>
+struct TransposedPreconditioner
+{
+    const PreconditionerType &preconditioner; ///< Preconditioner of the system.
+    /// dst = P^{-T}*src.
+    void vmult(dealii::LinearAlgebra::distributed::Vector<double> &dst, const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+    {
+        preconditioner.Tvmult(dst, src);
+    }
+};
+
+/// Describes a CellBlockPreconditioner for the solver output.
+std::string describe_preconditioner (const CellBlockPreconditioner &preconditioner, const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type)
+{
+    return (preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi ? "block-Jacobi" : "block-ILU(0)")
+           + std::string(" on ") + std::to_string(preconditioner.n_blocks())
+           + " local blocks of maximum size " + std::to_string(preconditioner.max_block_size());
+}
+
+/// Describes a PMultigridPreconditioner for the solver output.
+std::string describe_preconditioner (const PMultigridPreconditioner &preconditioner)
+{
+    return "p-multigrid with " + std::to_string(preconditioner.n_levels()) + " levels";
+}
+
+/// Describes the Ifpack ILUT preconditioner for the solver output.
+std::string describe_preconditioner (const dealii::TrilinosWrappers::PreconditionILUT &/*preconditioner*/)
+{
+    return "ILUT";
+}
+
+/// Describes the Krylov method for the solver output.
+std::string describe_gmres_variant (const Parameters::LinearSolverParam::GMRESVariantEnum gmres_variant)
+{
+    using GMRESVariantEnum = Parameters::LinearSolverParam::GMRESVariantEnum;
+    if (gmres_variant == GMRESVariantEnum::pipelined) return "pipelined GMRES";
+    if (gmres_variant == GMRESVariantEnum::flexible) return "FGMRES";
+    if (gmres_variant == GMRESVariantEnum::recycling) return "recycling GMRES";
+    return "GMRES";
+}
+
+/// Returns the RecycledSubspace kept by @p reusable_preconditioner, if given.
+RecycledSubspace *recycled_subspace_of (ReusablePreconditioner *const reusable_preconditioner)
+{
+    return reusable_preconditioner ? &reusable_preconditioner->recycled_subspace : nullptr;
+}
+
+/// Solves the system with the gmres_variant and one of the preconditioners above.
+/** @p start_time is used to report the wall time including the preconditioner setup.
+ *  The recycling gmres_variant keeps its directions in @p recycled_subspace if given.
+ */
+template <typename MatrixType, typename PreconditionerType>
+std::pair<unsigned int, double>
+solve_linear_preconditioned (
+    const MatrixType &system_matrix,
+    const PreconditionerType &preconditioner,
+    const std::string &preconditioner_description,
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    const std::chrono::steady_clock::time_point start_time,
+    RecycledSubspace *const recycled_subspace)
+{
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    const double rhs_norm = right_hand_side.l2_norm();
+    const double linear_residual = param.linear_residual * rhs_norm;
+    pcout << " Solving linear system with max_iterations = " << param.max_iterations
+          << " and linear residual tolerance: " << linear_residual
+          << " using " << describe_gmres_variant(param.gmres_variant)
+          << " with " << preconditioner_description << std::endl;
+    if (param.gmres_variant == Parameters::LinearSolverParam::GMRESVariantEnum::recycling && recycled_subspace) {
+        pcout << " Recycling " << recycled_subspace->size() << " directions" << std::endl;
+    }
+
+    dealii::SolverControl solver_control(param.max_iterations, linear_residual);
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+    try {
+        if (param.gmres_variant == Parameters::LinearSolverParam::GMRESVariantEnum::pipelined) {
+            PipelinedGMRES solver(solver_control, param.restart_number);
+            solver.solve(system_matrix, solution, right_hand_side, preconditioner);
+        } else if (param.gmres_variant == Parameters::LinearSolverParam::GMRESVariantEnum::flexible) {
+            dealii::SolverFGMRES<VectorType> solver(solver_control,
+                typename dealii::SolverFGMRES<VectorType>::AdditionalData(param.restart_number));
+            solver.solve(system_matrix, solution, right_hand_side, preconditioner);
+        } else if (param.gmres_variant == Parameters::LinearSolverParam::GMRESVariantEnum::recycling) {
+            // Without a kept subspace, the directions are still recycled across the restarts.
+            RecycledSubspace local_subspace;
+            RecyclingGMRES solver(solver_control, param.restart_number,
+                                  recycled_subspace ? *recycled_subspace : local_subspace, param.recycled_subspace_size);
+            solver.solve(system_matrix, solution, right_hand_side, preconditioner);
+        } else {
+            const bool right_preconditioning = true;
+            dealii::SolverGMRES<VectorType> solver(solver_control,
+                typename dealii::SolverGMRES<VectorType>::AdditionalData(param.restart_number+2, right_preconditioning));
+            solver.solve(system_matrix, solution, right_hand_side, preconditioner);
+        }
+    } catch (dealii::SolverControl::NoConvergence &) {
+        // Same as AztecOO, return the last iterate.
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    pcout << " Linear solver took " << solver_control.last_step()
+          << " iterations resulting in a linear residual of " << solver_control.last_value()
+          << " in " << elapsed.count() << "s" << std::endl
+          << " Current RHS norm: " << right_hand_side.l2_norm()
+          << " Linear solution norm: " << solution.l2_norm() << std::endl;
+
+    n_vmult += solver_control.last_step();
+    dRdW_mult += solver_control.last_step();
+
+    return {solver_control.last_step(), solver_control.last_value()};
+}
+
+/// Solves the system, or its transpose if @p transpose is true, with solve_linear_preconditioned().
+template <typename MatrixType, typename PreconditionerType>
+std::pair<unsigned int, double>
+solve_linear_preconditioned (
+    const MatrixType &system_matrix,
+    const PreconditionerType &preconditioner,
+    const std::string &preconditioner_description,
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    const bool transpose,
+    const std::chrono::steady_clock::time_point start_time,
+    RecycledSubspace *const recycled_subspace)
+{
+    if (transpose) {
+        const TransposedMatrix<MatrixType> transposed_matrix{system_matrix};
+        const TransposedPreconditioner<PreconditionerType> transposed_preconditioner{preconditioner};
+        return solve_linear_preconditioned(transposed_matrix, transposed_preconditioner, "transposed " + preconditioner_description,
+                                           right_hand_side, solution, param, start_time, recycled_subspace);
+    }
+    return solve_linear_preconditioned(system_matrix, preconditioner, preconditioner_description, right_hand_side, solution, param, start_time, recycled_subspace);
+}
+
+/// Solves the system, or its transpose if @p transpose is true, with the KLU direct solver of Amesos.
+std::pair<unsigned int, double>
+solve_linear_direct (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const bool transpose)
+{
+    Epetra_Vector x(View, system_matrix.trilinos_matrix().DomainMap(), solution.begin());
+    Epetra_Vector b(View, system_matrix.trilinos_matrix().RangeMap(), right_hand_side.begin());
+    Epetra_LinearProblem linear_problem(const_cast<Epetra_CrsMatrix *>(&system_matrix.trilinos_matrix()), &x, &b);
+
+    Amesos factory;
+    std::unique_ptr<Amesos_BaseSolver> solver(factory.Create("Amesos_Klu", linear_problem));
+    AssertThrow(solver, dealii::ExcMessage("Amesos_Klu is not available."));
+    AssertThrow(solver->SetUseTranspose(transpose) == 0, dealii::ExcMessage("Amesos_Klu failed to use the transpose."));
+    AssertThrow(solver->SymbolicFactorization() == 0, dealii::ExcMessage("Amesos_Klu symbolic factorization failed."));
+    AssertThrow(solver->NumericFactorization() == 0, dealii::ExcMessage("Amesos_Klu numeric factorization failed."));
+    AssertThrow(solver->Solve() == 0, dealii::ExcMessage("Amesos_Klu solve failed."));
+    return {1, 0.0};
+}
+
+/// Returns the CellBlockPreconditioner kept by @p reusable_preconditioner if it is to be reused.
+/** Otherwise, sets up a new one through @p initialize, and keeps it in @p reusable_preconditioner
+ *  if given, or in @p local_preconditioner.
+ */
+template <typename InitializeFunction>
+const CellBlockPreconditioner &
+setup_cell_block_preconditioner (
+    const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type,
+    const InitializeFunction &initialize,
+    ReusablePreconditioner *const reusable_preconditioner,
+    std::unique_ptr<CellBlockPreconditioner> &local_preconditioner)
+{
+    if (reusable_preconditioner && reusable_preconditioner->reuse && reusable_preconditioner->cell_block_preconditioner) {
+        ++preconditioner_reuse;
+        return *reusable_preconditioner->cell_block_preconditioner;
+    }
+    ++preconditioner_setup;
+    std::unique_ptr<CellBlockPreconditioner> &preconditioner
+        = reusable_preconditioner ? reusable_preconditioner->cell_block_preconditioner : local_preconditioner;
+    if (reusable_preconditioner) reusable_preconditioner->clear();
+    preconditioner = std::make_unique<CellBlockPreconditioner>(preconditioner_type);
+    initialize(*preconditioner);
+    return *preconditioner;
+}
+
+/// Returns the Ifpack ILUT kept by @p reusable_preconditioner if it is to be reused.
+/** Otherwise, factorizes @p system_matrix with the ILUT parameters and the same overlap as the AztecOO path.
+ */
+const dealii::TrilinosWrappers::PreconditionILUT &
+setup_ilut_preconditioner (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    const Parameters::LinearSolverParam &param,
+    ReusablePreconditioner *const reusable_preconditioner,
+    std::unique_ptr<dealii::TrilinosWrappers::PreconditionILUT> &local_preconditioner)
+{
+    if (reusable_preconditioner && reusable_preconditioner->reuse && reusable_preconditioner->ilut_preconditioner) {
+        ++preconditioner_reuse;
+        return *reusable_preconditioner->ilut_preconditioner;
+    }
+    ++preconditioner_setup;
+    std::unique_ptr<dealii::TrilinosWrappers::PreconditionILUT> &preconditioner
+        = reusable_preconditioner ? reusable_preconditioner->ilut_preconditioner : local_preconditioner;
+    if (reusable_preconditioner) reusable_preconditioner->clear();
+    preconditioner = std::make_unique<dealii::TrilinosWrappers::PreconditionILUT>();
+    const unsigned int overlap = 1;
+    const dealii::TrilinosWrappers::PreconditionILUT::AdditionalData additional_data(
+        param.ilut_drop, param.ilut_fill, param.ilut_atol, param.ilut_rtol, overlap);
+    preconditioner->initialize(system_matrix, additional_data);
+    return *preconditioner;
+}
+
+/// Initializes the p-multigrid levels with @p system_matrix, unless @p reusable_preconditioner requests to reuse them.
+template <typename MatrixType>
+void setup_p_multigrid_preconditioner (
+    const MatrixType &system_matrix,
+    PMultigridPreconditioner &preconditioner,
+    ReusablePreconditioner *const reusable_preconditioner)
+{
+    if (reusable_preconditioner && reusable_preconditioner->reuse && reusable_preconditioner->p_multigrid_is_set_up) {
+        ++preconditioner_reuse;
+        return;
+    }
+    ++preconditioner_setup;
+    preconditioner.initialize(system_matrix);
+    if (reusable_preconditioner) {
+        reusable_preconditioner->clear();
+        reusable_preconditioner->p_multigrid_is_set_up = true;
+    }
+}
+
+} // anonymous namespace
+
+ReusablePreconditioner::ReusablePreconditioner()
+    : reuse(false)
+    , p_multigrid_is_set_up(false)
+{}
+
+ReusablePreconditioner::~ReusablePreconditioner() {}
+
+void ReusablePreconditioner::clear()
+{
+    cell_block_preconditioner.reset();
+    aztec_solver.reset();
+    ilut_preconditioner.reset();
+    p_multigrid_is_set_up = false;
+    recycled_subspace.invalidate_products();
+}
+
+bool ReusablePreconditioner::is_set_up() const
+{
+    return cell_block_preconditioner || aztec_solver || ilut_preconditioner || p_multigrid_is_set_up;
+}
+
+std::pair<unsigned int, double>
+solve_linear (
+    const BlockSparseMatrix &system_matrix,
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    const bool transpose,
+    ReusablePreconditioner *const reusable_preconditioner)
+{
+    AssertThrow(param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::gmres,
+                dealii::ExcMessage("The block sparse system matrix is only supported by GMRES."));
+
+    const auto start_time = std::chrono::steady_clock::now();
+    // ILUT requires a Trilinos matrix. Use block-ILU(0) instead.
+    const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type
+        = (param.preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi)
+          ? Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi
+          : Parameters::LinearSolverParam::PreconditionerEnum::block_ilu0;
+    std::unique_ptr<CellBlockPreconditioner> local_preconditioner;
+    const CellBlockPreconditioner &preconditioner = setup_cell_block_preconditioner(
+        preconditioner_type,
+        [&] (CellBlockPreconditioner &new_preconditioner) { new_preconditioner.initialize(system_matrix, transpose); },
+        reusable_preconditioner,
+        local_preconditioner);
+
+    const std::string description = describe_preconditioner(preconditioner, preconditioner_type);
+    if (transpose) {
+        // The preconditioner has been factorized from the transposed blocks.
+        const TransposedMatrix<BlockSparseMatrix> transposed_matrix{system_matrix};
+        return solve_linear_preconditioned(transposed_matrix, preconditioner, description, right_hand_side, solution, param, start_time,
+                                           recycled_subspace_of(reusable_preconditioner));
+    }
+    return solve_linear_preconditioned(system_matrix, preconditioner, description, right_hand_side, solution, param, start_time,
+                                       recycled_subspace_of(reusable_preconditioner));
+}
+
+std::pair<unsigned int, double>
+solve_linear (
+    const BlockSparseMatrix &system_matrix,
+    PMultigridPreconditioner &preconditioner,
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    ReusablePreconditioner *const reusable_preconditioner)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    setup_p_multigrid_preconditioner(system_matrix, preconditioner, reusable_preconditioner);
+    return solve_linear_preconditioned(system_matrix, preconditioner, describe_preconditioner(preconditioner), right_hand_side, solution, param, start_time,
+                                       recycled_subspace_of(reusable_preconditioner));
+}
+
+std::pair<unsigned int, double>
+solve_linear (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    PMultigridPreconditioner &preconditioner,
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    ReusablePreconditioner *const reusable_preconditioner)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    setup_p_multigrid_preconditioner(system_matrix, preconditioner, reusable_preconditioner);
+    return solve_linear_preconditioned(system_matrix, preconditioner, describe_preconditioner(preconditioner), right_hand_side, solution, param, start_time,
+                                       recycled_subspace_of(reusable_preconditioner));
+}
+
 std::pair<unsigned int, double>
 solve_linear (
     const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
     dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
     dealii::LinearAlgebra::distributed::Vector<double> &solution,
-    const Parameters::LinearSolverParam &param)
+    const Parameters::LinearSolverParam &param,
+    const bool transpose,
+    ReusablePreconditioner *const reusable_preconditioner)
 {
 
     // if (pcout.is_active()) system_matrix.print(pcout.get_stream(), true);
@@ -35,7 +385,9 @@ solve_linear (
     //    pcout<<"Dense matrix:"<<std::endl;
     //    if (pcout.is_active()) fullA.print_formatted(pcout.get_stream(), 3, true, 10, "0", 1., 0.);
     //}
-    if (param.linear_solver_type == direct_type) {
+    if (param.linear_solver_type == direct_type && transpose) {
+        return solve_linear_direct(system_matrix, right_hand_side, solution, transpose);
+    } else if (param.linear_solver_type == direct_type) {
 
         dealii::SolverControl solver_control(1, 0);
         dealii::TrilinosWrappers::SolverDirect::AdditionalData data(false);
@@ -44,24 +396,40 @@ solve_linear (
 
         direct.solve(system_matrix, solution, right_hand_side);
         return {solver_control.last_step(), solver_control.last_value()};
+    } else if (param.linear_solver_type == gmres_type
+               && param.preconditioner_type != Parameters::LinearSolverParam::PreconditionerEnum::ilut) {
+        const auto start_time = std::chrono::steady_clock::now();
+        // Without p-multigrid levels, fall back to the smoother of p-multigrid.
+        const Parameters::LinearSolverParam::PreconditionerEnum preconditioner_type
+            = (param.preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::p_multigrid)
+              ? Parameters::LinearSolverParam::PreconditionerEnum::block_ilu0
+              : param.preconditioner_type;
+        std::unique_ptr<CellBlockPreconditioner> local_preconditioner;
+        const CellBlockPreconditioner &preconditioner = setup_cell_block_preconditioner(
+            preconditioner_type,
+            [&] (CellBlockPreconditioner &new_preconditioner) { new_preconditioner.initialize(system_matrix); },
+            reusable_preconditioner,
+            local_preconditioner);
+        const std::string description = describe_preconditioner(preconditioner, preconditioner_type);
+        return solve_linear_preconditioned(system_matrix, preconditioner, description, right_hand_side, solution, param, transpose, start_time,
+                                           recycled_subspace_of(reusable_preconditioner));
+    } else if (param.linear_solver_type == gmres_type
+               && (param.gmres_variant != Parameters::LinearSolverParam::GMRESVariantEnum::standard || transpose)) {
+        // The in-tree Krylov methods cannot use AztecOO's ILUT, and AztecOO cannot apply its ILUT transposed.
+        const auto start_time = std::chrono::steady_clock::now();
+        std::unique_ptr<dealii::TrilinosWrappers::PreconditionILUT> local_preconditioner;
+        const dealii::TrilinosWrappers::PreconditionILUT &preconditioner
+            = setup_ilut_preconditioner(system_matrix, param, reusable_preconditioner, local_preconditioner);
+        return solve_linear_preconditioned(system_matrix, preconditioner, describe_preconditioner(preconditioner), right_hand_side, solution, param, transpose, start_time,
+                                           recycled_subspace_of(reusable_preconditioner));
     } else if (param.linear_solver_type == gmres_type) {
+        const auto start_time = std::chrono::steady_clock::now();
         Epetra_Vector x(View,
                         system_matrix.trilinos_matrix().DomainMap(),
                         solution.begin());
         Epetra_Vector b(View,
                         system_matrix.trilinos_matrix().RangeMap(),
                         right_hand_side.begin());
-        AztecOO solver;
-        solver.SetAztecOption( AZ_output, (param.linear_solver_output ? AZ_all : AZ_none));
-        solver.SetAztecOption(AZ_solver, AZ_gmres);
-        solver.SetAztecOption(AZ_kspace, param.restart_number);
-        solver.SetRHS(&b);
-        solver.SetLHS(&x);
-        solver.SetAztecOption(AZ_precond, AZ_dom_decomp);
-        solver.SetAztecOption(AZ_subdomain_solve, AZ_ilut);
-        solver.SetAztecOption(AZ_overlap, 1);
-        solver.SetAztecOption(AZ_reorder, 1); // RCM re-ordering
-
         const double rhs_norm = right_hand_side.l2_norm();
         const double
           ilut_drop = param.ilut_drop,
@@ -72,19 +440,47 @@ solve_linear (
           ilut_fill = param.ilut_fill,//1,
           max_iterations = param.max_iterations;//200
 
-        solver.SetAztecParam(AZ_drop, ilut_drop);
-        solver.SetAztecParam(AZ_ilut_fill, ilut_fill);
-        solver.SetAztecParam(AZ_athresh, ilut_atol);
-        solver.SetAztecParam(AZ_rthresh, ilut_rtol);
-        solver.SetUserMatrix(const_cast<Epetra_CrsMatrix *>(&system_matrix.trilinos_matrix()));
+        const bool reuse = reusable_preconditioner && reusable_preconditioner->reuse && reusable_preconditioner->aztec_solver;
+        std::unique_ptr<AztecOO> local_solver;
+        std::unique_ptr<AztecOO> &solver_pointer = reusable_preconditioner ? reusable_preconditioner->aztec_solver : local_solver;
+        if (reuse) {
+            // The kept solver already points to the system_matrix, whose values may have changed.
+            ++preconditioner_reuse;
+        } else {
+            ++preconditioner_setup;
+            if (reusable_preconditioner) reusable_preconditioner->clear();
+            solver_pointer = std::make_unique<AztecOO>();
+            AztecOO &solver = *solver_pointer;
+            solver.SetAztecOption( AZ_output, (param.linear_solver_output ? AZ_all : AZ_none));
+            solver.SetAztecOption(AZ_solver, AZ_gmres);
+            solver.SetAztecOption(AZ_kspace, param.restart_number);
+            solver.SetAztecOption(AZ_precond, AZ_dom_decomp);
+            solver.SetAztecOption(AZ_subdomain_solve, AZ_ilut);
+            solver.SetAztecOption(AZ_overlap, 1);
+            solver.SetAztecOption(AZ_reorder, 1); // RCM re-ordering
+            // Keep the ILUT factorization such that the next solves may reuse it.
+            if (reusable_preconditioner) solver.SetAztecOption(AZ_keep_info, 1);
+
+            solver.SetAztecParam(AZ_drop, ilut_drop);
+            solver.SetAztecParam(AZ_ilut_fill, ilut_fill);
+            solver.SetAztecParam(AZ_athresh, ilut_atol);
+            solver.SetAztecParam(AZ_rthresh, ilut_rtol);
+            solver.SetUserMatrix(const_cast<Epetra_CrsMatrix *>(&system_matrix.trilinos_matrix()));
+        }
+        AztecOO &solver = *solver_pointer;
+        solver.SetAztecOption(AZ_pre_calc, reuse ? AZ_reuse : AZ_calc);
+        solver.SetRHS(&b);
+        solver.SetLHS(&x);
         dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
         pcout << " Solving linear system with max_iterations = " << max_iterations
               << " and linear residual tolerance: " << linear_residual << std::endl;
         solver.Iterate(max_iterations,
                        linear_residual);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
 
         pcout << " Linear solver took " << solver.NumIters()
-              << " iterations resulting in a linear residual of " << solver.ScaledResidual() << std::endl
+              << " iterations resulting in a linear residual of " << solver.ScaledResidual()
+              << " in " << elapsed.count() << "s" << std::endl
               << " Current RHS norm: " << right_hand_side.l2_norm()
               << " Linear solution norm: " << solution.l2_norm() << std::endl;
 
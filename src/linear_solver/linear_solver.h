@@ -1,22 +1,120 @@
 #ifndef __LINEAR_SOLVER_H__
 #define __LINEAR_SOLVER_H__
 
+#include <memory>
+
+#include <deal.II/lac/trilinos_precondition.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include "parameters/all_parameters.h"
+#include "block_sparse_matrix.h"
+#include "p_multigrid_preconditioner.h"
+#include "cell_block_preconditioner.h"
+#include "recycling_gmres.h"
+
+class AztecOO;
 
 namespace PHiLiP {
 
+    /// Preconditioner set up by solve_linear and kept between its calls.
+    /** If reuse is true, the next solve_linear applies the preconditioner set up for a previous
+     *  system matrix instead of setting up a new one. This is only valid if the sparsity pattern
+     *  of the system matrix, the matrix object, and the linear solver parameters did not change.
+     *  The direct solver does not keep its factorization.
+     *
+     *  The recycling gmres_variant also keeps its RecycledSubspace, whose products are recomputed
+     *  whenever the preconditioner is set up again. If the values of the system matrix change while
+     *  the preconditioner is reused, RecycledSubspace::invalidate_products() must be called.
+     */
+    class ReusablePreconditioner
+    {
+    public:
+        ReusablePreconditioner(); ///< Constructor.
+        ~ReusablePreconditioner(); ///< Destructor.
+
+        /// Discards the kept preconditioner, such that the next solve_linear sets it up.
+        /** The recycled directions are kept, since the next system matrix is likely nearby.
+         */
+        void clear();
+
+        /// Whether a preconditioner has been set up by solve_linear and can be reused.
+        bool is_set_up() const;
+
+        /// Apply the kept preconditioner instead of setting up a new one. Ignored if none is set up.
+        bool reuse;
+
+        /// Kept block-Jacobi or block-ILU(0) preconditioner.
+        std::unique_ptr<CellBlockPreconditioner> cell_block_preconditioner;
+        /// Kept AztecOO solver, which holds its ILUT factorization.
+        std::unique_ptr<AztecOO> aztec_solver;
+        /// Kept Ifpack ILUT used by the non-standard gmres_variant.
+        std::unique_ptr<dealii::TrilinosWrappers::PreconditionILUT> ilut_preconditioner;
+        /// Whether the levels of the p-multigrid preconditioner have been initialized with a system matrix.
+        bool p_multigrid_is_set_up;
+        /// Directions kept between the solves by the recycling gmres_variant.
+        RecycledSubspace recycled_subspace;
+    };
+
     /// Still need to make a LinearSolver class for our problems
     /// Note that right hand side should be const
     /// however, the Trilinos wrapper gives and error when trying to
     /// map it. This is probably because the Trilinos function 
     /// does not take right_hand_side as a const
+    ///
+    /// If @p reusable_preconditioner is given, the preconditioner is kept in it and
+    /// reused according to ReusablePreconditioner::reuse.
+    ///
+    /// AztecOO only performs the standard gmres_variant. The pipelined, flexible, and
+    /// recycling variants use the in-tree Krylov methods, where ILUT is then set up by Ifpack.
+    /// The recycling variant only keeps its subspace between solves through a @p reusable_preconditioner.
+    ///
+    /// If @p transpose is true, the transposed system is solved through Tvmult() of
+    /// the matrix and of the preconditioner, such that the transpose is never formed.
+    /// The transposed ILUT is then set up by Ifpack, and the direct solver uses Amesos.
     std::pair<unsigned int, double>
         solve_linear ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
                        dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
                        dealii::LinearAlgebra::distributed::Vector<double> &solution,
-                       const Parameters::LinearSolverParam &param);
+                       const Parameters::LinearSolverParam &param,
+                       const bool transpose = false,
+                       ReusablePreconditioner *const reusable_preconditioner = nullptr);
+
+    /// Solves the system, or its transpose, stored as a BlockSparseMatrix with GMRES.
+    /** The block preconditioners are used, where block-ILU(0) replaces ILUT.
+     *  The transpose is applied through BlockSparseMatrix::Tvmult() without being formed.
+     *  A @p reusable_preconditioner must always be used for the same @p transpose.
+     */
+    std::pair<unsigned int, double>
+        solve_linear ( const BlockSparseMatrix &system_matrix,
+                       const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+                       dealii::LinearAlgebra::distributed::Vector<double> &solution,
+                       const Parameters::LinearSolverParam &param,
+                       const bool transpose = false,
+                       ReusablePreconditioner *const reusable_preconditioner = nullptr);
+
+    /// Solves the system with GMRES preconditioned by a p-multigrid V-cycle.
+    /** The levels of @p preconditioner must have been set up, see DGBase::setup_p_multigrid(),
+     *  and its coarse operators are rebuilt from @p system_matrix unless @p reusable_preconditioner
+     *  requests to reuse the previous ones.
+     */
+    std::pair<unsigned int, double>
+        solve_linear ( const BlockSparseMatrix &system_matrix,
+                       PMultigridPreconditioner &preconditioner,
+                       const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+                       dealii::LinearAlgebra::distributed::Vector<double> &solution,
+                       const Parameters::LinearSolverParam &param,
+                       ReusablePreconditioner *const reusable_preconditioner = nullptr);
+
+    /// Solves the system with GMRES preconditioned by a p-multigrid V-cycle.
+    /** The matrix is copied into the blocks of the finest level of @p preconditioner.
+     */
+    std::pair<unsigned int, double>
+        solve_linear ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+                       PMultigridPreconditioner &preconditioner,
+                       const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+                       dealii::LinearAlgebra::distributed::Vector<double> &solution,
+                       const Parameters::LinearSolverParam &param,
+                       ReusablePreconditioner *const reusable_preconditioner = nullptr);
 
     std::pair<unsigned int, double>
     solve_linear_2 ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
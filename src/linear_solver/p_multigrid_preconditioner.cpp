@@ -0,0 +1,256 @@
+#include <algorithm>
+
+#include <deal.II/base/exceptions.h>
+
+#include "p_multigrid_preconditioner.h"
+
+namespace PHiLiP {
+
+PMultigridPreconditioner::Level::Level()
+    : mpi_communicator(MPI_COMM_WORLD)
+    , smoother(Parameters::LinearSolverParam::PreconditionerEnum::block_ilu0)
+{}
+
+PMultigridPreconditioner::PMultigridPreconditioner(const Parameters::LinearSolverParam &param)
+    : fine_matrix(nullptr)
+    , fine_level_allocated(false)
+    , smoothing_steps(param.p_multigrid_smoothing_steps)
+    , coarse_steps(param.p_multigrid_coarse_steps)
+{}
+
+void PMultigridPreconditioner::clear()
+{
+    levels.clear();
+    fine_matrix = nullptr;
+    fine_level_allocated = false;
+}
+
+void PMultigridPreconditioner::add_level(
+    const dealii::IndexSet &locally_owned_dofs,
+    const dealii::IndexSet &locally_relevant_dofs,
+    const std::vector<std::vector<size_type>> &cell_dofs,
+    const std::vector<unsigned int> &cell_owners,
+    const std::vector<std::vector<unsigned int>> &block_pattern,
+    const std::vector<dealii::FullMatrix<double>> &prolongation_matrices,
+    const std::vector<unsigned int> &cell_prolongation,
+    const MPI_Comm mpi_communicator)
+{
+    levels.emplace_back();
+    Level &level = levels.back();
+    level.locally_owned_dofs = locally_owned_dofs;
+    level.residual.reinit(locally_owned_dofs, mpi_communicator);
+    level.correction.reinit(locally_owned_dofs, mpi_communicator);
+
+    if (levels.size() == 1) {
+        // The finest level may use an external operator, such that its blocks are only allocated when needed.
+        level.locally_relevant_dofs = locally_relevant_dofs;
+        level.cell_dofs = cell_dofs;
+        level.cell_owners = cell_owners;
+        level.block_pattern = block_pattern;
+        level.mpi_communicator = mpi_communicator;
+        return;
+    }
+
+    AssertDimension(cell_prolongation.size(), cell_dofs.size());
+    level.matrix.reinit(locally_owned_dofs, locally_relevant_dofs, cell_dofs, cell_owners, block_pattern, mpi_communicator);
+    level.prolongation_matrices = prolongation_matrices;
+    level.cell_prolongation = cell_prolongation;
+    level.rhs.reinit(locally_owned_dofs, mpi_communicator);
+    level.solution.reinit(locally_owned_dofs, mpi_communicator);
+}
+
+void PMultigridPreconditioner::initialize(const dealii::TrilinosWrappers::SparseMatrix &matrix)
+{
+    Assert(!levels.empty(), dealii::ExcMessage("The p-multigrid levels must be added before initialization."));
+    Level &fine_level = levels[0];
+    if (!fine_level_allocated) {
+        fine_level.matrix.reinit(fine_level.locally_owned_dofs, fine_level.locally_relevant_dofs,
+                                 fine_level.cell_dofs, fine_level.cell_owners, fine_level.block_pattern,
+                                 fine_level.mpi_communicator);
+        fine_level.cell_dofs.clear();
+        fine_level.cell_owners.clear();
+        fine_level.block_pattern.clear();
+        fine_level_allocated = true;
+    }
+    fine_level.matrix = 0;
+    fine_level.matrix.add(1.0, matrix);
+    fine_matrix = &fine_level.matrix;
+
+    build_coarse_levels();
+}
+
+void PMultigridPreconditioner::initialize(const BlockSparseMatrix &matrix)
+{
+    Assert(!levels.empty(), dealii::ExcMessage("The p-multigrid levels must be added before initialization."));
+    fine_matrix = &matrix;
+
+    build_coarse_levels();
+}
+
+void PMultigridPreconditioner::build_coarse_levels()
+{
+    std::vector<double> work;
+    for (unsigned int ilevel = 1; ilevel < levels.size(); ++ilevel) {
+        const BlockSparseMatrix &fine = level_matrix(ilevel-1);
+        Level &level = levels[ilevel];
+        BlockSparseMatrix &coarse = level.matrix;
+        coarse = 0;
+
+        const auto prolongation = [&level](const unsigned int icell) -> const dealii::FullMatrix<double> * {
+            const unsigned int index = level.cell_prolongation[icell];
+            return (index == dealii::numbers::invalid_unsigned_int) ? nullptr : &level.prolongation_matrices[index];
+        };
+
+        // A_KJ^coarse = P_K^T A_KJ P_J for the blocks of the locally owned cells.
+        for (unsigned int kcell = 0; kcell < coarse.n_locally_owned_cells(); ++kcell) {
+            const dealii::FullMatrix<double> *P_K = prolongation(kcell);
+            const unsigned int n_fine_rows = fine.n_cell_dofs(kcell);
+            const unsigned int n_coarse_rows = coarse.n_cell_dofs(kcell);
+
+            const std::pair<unsigned int, unsigned int> range = fine.block_row_range(kcell);
+            for (unsigned int fine_block = range.first; fine_block < range.second; ++fine_block) {
+                const unsigned int jcell = fine.block_column(fine_block);
+                const unsigned int coarse_block = coarse.find_block(kcell, jcell);
+                AssertThrow(coarse_block != coarse.n_blocks(), dealii::ExcMessage("The p-multigrid levels must have the same block pattern."));
+
+                const dealii::FullMatrix<double> *P_J = prolongation(jcell);
+                const unsigned int n_fine_cols = fine.n_cell_dofs(jcell);
+                const unsigned int n_coarse_cols = coarse.n_cell_dofs(jcell);
+                const double *A = fine.block_values(fine_block);
+
+                // work = A_KJ P_J
+                const double *A_P = A;
+                if (P_J) {
+                    work.assign(n_fine_rows * n_coarse_cols, 0.0);
+                    for (unsigned int i = 0; i < n_fine_rows; ++i) {
+                        for (unsigned int k = 0; k < n_fine_cols; ++k) {
+                            const double a_ik = A[i*n_fine_cols+k];
+                            if (a_ik == 0.0) continue;
+                            for (unsigned int j = 0; j < n_coarse_cols; ++j) {
+                                work[i*n_coarse_cols+j] += a_ik * (*P_J)(k,j);
+                            }
+                        }
+                    }
+                    A_P = work.data();
+                }
+
+                // P_K^T work
+                double *block = coarse.block_values(coarse_block);
+                if (!P_K) {
+                    std::copy(A_P, A_P + n_coarse_rows*n_coarse_cols, block);
+                    continue;
+                }
+                for (unsigned int i = 0; i < n_fine_rows; ++i) {
+                    for (unsigned int a = 0; a < n_coarse_rows; ++a) {
+                        const double p_ia = (*P_K)(i,a);
+                        if (p_ia == 0.0) continue;
+                        for (unsigned int j = 0; j < n_coarse_cols; ++j) {
+                            block[a*n_coarse_cols+j] += p_ia * A_P[i*n_coarse_cols+j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (unsigned int ilevel = 0; ilevel < levels.size(); ++ilevel) {
+        levels[ilevel].smoother.initialize(level_matrix(ilevel));
+    }
+}
+
+void PMultigridPreconditioner::smooth(
+    const unsigned int ilevel, const VectorType &rhs, VectorType &solution,
+    const unsigned int n_steps, const bool zero_initial_guess) const
+{
+    const Level &level = levels[ilevel];
+    if (zero_initial_guess) solution = 0.0;
+    for (unsigned int istep = 0; istep < n_steps; ++istep) {
+        if (istep == 0 && zero_initial_guess) {
+            level.smoother.vmult(solution, rhs);
+            continue;
+        }
+        level_matrix(ilevel).vmult(level.residual, solution);
+        level.residual.sadd(-1.0, 1.0, rhs);
+        level.smoother.vmult(level.correction, level.residual);
+        solution += level.correction;
+    }
+}
+
+void PMultigridPreconditioner::v_cycle(const unsigned int ilevel, const VectorType &rhs, VectorType &solution) const
+{
+    const bool zero_initial_guess = true;
+    if (ilevel+1 == levels.size()) {
+        smooth(ilevel, rhs, solution, coarse_steps, zero_initial_guess);
+        return;
+    }
+    smooth(ilevel, rhs, solution, smoothing_steps, zero_initial_guess);
+
+    const Level &level = levels[ilevel];
+    level_matrix(ilevel).vmult(level.residual, solution);
+    level.residual.sadd(-1.0, 1.0, rhs);
+
+    // Restrict the residual with the transposed interpolation, solve, and prolongate the correction.
+    const Level &coarse_level = levels[ilevel+1];
+    const BlockSparseMatrix &fine = level_matrix(ilevel);
+    const BlockSparseMatrix &coarse = coarse_level.matrix;
+    for (unsigned int icell = 0; icell < coarse.n_locally_owned_cells(); ++icell) {
+        const unsigned int *fine_dofs = fine.cell_dof_indices(icell);
+        const unsigned int *coarse_dofs = coarse.cell_dof_indices(icell);
+        const unsigned int index = coarse_level.cell_prolongation[icell];
+        if (index == dealii::numbers::invalid_unsigned_int) {
+            for (unsigned int i = 0; i < coarse.n_cell_dofs(icell); ++i) {
+                coarse_level.rhs.local_element(coarse_dofs[i]) = level.residual.local_element(fine_dofs[i]);
+            }
+            continue;
+        }
+        const dealii::FullMatrix<double> &P = coarse_level.prolongation_matrices[index];
+        for (unsigned int a = 0; a < P.n(); ++a) {
+            double sum = 0.0;
+            for (unsigned int i = 0; i < P.m(); ++i) sum += P(i,a) * level.residual.local_element(fine_dofs[i]);
+            coarse_level.rhs.local_element(coarse_dofs[a]) = sum;
+        }
+    }
+
+    v_cycle(ilevel+1, coarse_level.rhs, coarse_level.solution);
+
+    for (unsigned int icell = 0; icell < coarse.n_locally_owned_cells(); ++icell) {
+        const unsigned int *fine_dofs = fine.cell_dof_indices(icell);
+        const unsigned int *coarse_dofs = coarse.cell_dof_indices(icell);
+        const unsigned int index = coarse_level.cell_prolongation[icell];
+        if (index == dealii::numbers::invalid_unsigned_int) {
+            for (unsigned int i = 0; i < coarse.n_cell_dofs(icell); ++i) {
+                solution.local_element(fine_dofs[i]) += coarse_level.solution.local_element(coarse_dofs[i]);
+            }
+            continue;
+        }
+        const dealii::FullMatrix<double> &P = coarse_level.prolongation_matrices[index];
+        for (unsigned int i = 0; i < P.m(); ++i) {
+            double sum = 0.0;
+            for (unsigned int a = 0; a < P.n(); ++a) sum += P(i,a) * coarse_level.solution.local_element(coarse_dofs[a]);
+            solution.local_element(fine_dofs[i]) += sum;
+        }
+    }
+
+    smooth(ilevel, rhs, solution, smoothing_steps, !zero_initial_guess);
+}
+
+void PMultigridPreconditioner::vmult(VectorType &dst, const VectorType &src) const
+{
+    Assert(fine_matrix, dealii::ExcMessage("PMultigridPreconditioner must be initialized before use."));
+    // The finest level work vectors share the layout of the Krylov vectors.
+    levels[0].residual.reinit(src, true);
+    levels[0].correction.reinit(src, true);
+    v_cycle(0, src, dst);
+}
+
+unsigned int PMultigridPreconditioner::n_levels() const
+{
+    return levels.size();
+}
+
+const BlockSparseMatrix &PMultigridPreconditioner::level_matrix(const unsigned int ilevel) const
+{
+    return (ilevel == 0) ? *fine_matrix : levels[ilevel].matrix;
+}
+
+} // PHiLiP namespace
@@ -0,0 +1,133 @@
+#ifndef __P_MULTIGRID_PRECONDITIONER_H__
+#define __P_MULTIGRID_PRECONDITIONER_H__
+
+#include <vector>
+
+#include <deal.II/base/index_set.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "parameters/parameters_linear_solver.h"
+#include "block_sparse_matrix.h"
+#include "cell_block_preconditioner.h"
+
+namespace PHiLiP {
+
+/// Linear p-multigrid preconditioner on the DG cell blocks.
+/** The levels share the cells of the mesh and only differ by the polynomial degree of each cell,
+ *  which decreases by at most one from a level to the next coarser one.
+ *  The prolongation of a cell from the coarser level is the interpolation between the two
+ *  finite elements of the cell, and the restriction is its transpose.
+ *
+ *  The coarse operators are the Galerkin products \f$ P^T A P \f$, evaluated block by block,
+ *  such that the residual only needs to be linearized on the finest level.
+ *  Each application performs a V-cycle with block-ILU(0) Richardson smoothing,
+ *  where the coarsest level is approximately solved by additional smoothing steps.
+ *
+ *  The cell numbering of every level must be the one of the finest level, see DGBase::setup_p_multigrid().
+ */
+class PMultigridPreconditioner
+{
+public:
+    /// Vector type on which the preconditioner is applied.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+    /// Global index type of the degrees of freedom.
+    using size_type = dealii::types::global_dof_index;
+
+    /// Constructor. Uses the p-multigrid smoothing steps of @p param.
+    explicit PMultigridPreconditioner(const Parameters::LinearSolverParam &param);
+
+    /// Removes all the levels.
+    void clear();
+
+    /// Adds the next coarser level.
+    /** The arguments are the ones of BlockSparseMatrix::reinit().
+     *  @p cell_prolongation[icell] is the index of the matrix of @p prolongation_matrices interpolating
+     *  the cell from this level to the previous finer level, or dealii::numbers::invalid_unsigned_int
+     *  if the cell has the same finite element on both levels. Both are ignored for the finest level.
+     */
+    void add_level(
+        const dealii::IndexSet &locally_owned_dofs,
+        const dealii::IndexSet &locally_relevant_dofs,
+        const std::vector<std::vector<size_type>> &cell_dofs,
+        const std::vector<unsigned int> &cell_owners,
+        const std::vector<std::vector<unsigned int>> &block_pattern,
+        const std::vector<dealii::FullMatrix<double>> &prolongation_matrices,
+        const std::vector<unsigned int> &cell_prolongation,
+        const MPI_Comm mpi_communicator);
+
+    /// Copies @p matrix into the blocks of the finest level and builds the coarse levels.
+    void initialize(const dealii::TrilinosWrappers::SparseMatrix &matrix);
+
+    /// Uses @p matrix as the finest level operator and builds the coarse levels.
+    /** @p matrix must have the cell numbering of the finest level and must outlive the preconditioner's use.
+     */
+    void initialize(const BlockSparseMatrix &matrix);
+
+    /// Applies one V-cycle with a zero initial guess.
+    void vmult(VectorType &dst, const VectorType &src) const;
+
+    /// Number of levels, including the finest one.
+    unsigned int n_levels() const;
+
+private:
+    /// Data of a single level.
+    struct Level
+    {
+        Level(); ///< Constructor.
+
+        dealii::IndexSet locally_owned_dofs;    ///< Locally owned degrees of freedom.
+
+        /// @name Layout of the finest level, kept until its operator is allocated.
+        ///@{
+        dealii::IndexSet locally_relevant_dofs; ///< Locally relevant degrees of freedom.
+        std::vector<std::vector<size_type>> cell_dofs; ///< Global degrees of freedom of the cells.
+        std::vector<unsigned int> cell_owners;         ///< Processor owning each cell.
+        std::vector<std::vector<unsigned int>> block_pattern; ///< Cells coupled to each cell.
+        MPI_Comm mpi_communicator;              ///< MPI communicator.
+        ///@}
+
+        BlockSparseMatrix matrix;        ///< Operator of the level, allocated on first use on the finest level.
+        CellBlockPreconditioner smoother; ///< Block-ILU(0) of the level's operator.
+
+        /// Interpolation matrices from this level to the previous finer level.
+        std::vector<dealii::FullMatrix<double>> prolongation_matrices;
+        /// Index of the prolongation matrix of each cell, or invalid_unsigned_int for the identity.
+        std::vector<unsigned int> cell_prolongation;
+
+        mutable VectorType rhs;        ///< Restricted residual of the finer level.
+        mutable VectorType solution;   ///< Correction of the level.
+        mutable VectorType residual;   ///< Residual of the level.
+        mutable VectorType correction; ///< Smoother update.
+    };
+
+    /// Levels, from the finest to the coarsest.
+    std::vector<Level> levels;
+
+    /// Operator of the finest level.
+    const BlockSparseMatrix *fine_matrix;
+    /// Whether the blocks of the finest level have been allocated to copy a Trilinos matrix.
+    bool fine_level_allocated;
+
+    const unsigned int smoothing_steps; ///< Pre- and post-smoothing steps.
+    const unsigned int coarse_steps;    ///< Smoothing steps on the coarsest level.
+
+    /// Computes the Galerkin coarse operators and factorizes the smoothers.
+    void build_coarse_levels();
+
+    /// Performs @p n_steps block-ILU(0) Richardson iterations on @p ilevel.
+    void smooth(const unsigned int ilevel, const VectorType &rhs, VectorType &solution,
+                const unsigned int n_steps, const bool zero_initial_guess) const;
+
+    /// Approximately solves the operator of @p ilevel with a V-cycle and a zero initial guess.
+    void v_cycle(const unsigned int ilevel, const VectorType &rhs, VectorType &solution) const;
+
+    /// Operator of @p ilevel.
+    const BlockSparseMatrix &level_matrix(const unsigned int ilevel) const;
+};
+
+} // PHiLiP namespace
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef __PIPELINED_GMRES_H__
+#define __PIPELINED_GMRES_H__
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <mpi.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+
+namespace PHiLiP {
+
+/// Right-preconditioned GMRES performing a single, pipelined, global reduction per iteration.
+/** Along with the orthonormal basis \f$ \mathbf{v}_i \f$, the products \f$ \mathbf{z}_i = \mathbf{A}\mathbf{P}^{-1}\mathbf{v}_i \f$
+ *  are stored. The candidate \f$ \mathbf{w}_j \f$ of the next basis vector is orthogonalized by classical Gram-Schmidt,
+ *  while its product is obtained by linearity
+ *  \f[
+ *      \mathbf{w}_{j+1} = \mathbf{z}_j - \sum_{i \leq j} h_{ij} \mathbf{v}_i, \qquad
+ *      \mathbf{A}\mathbf{P}^{-1}\mathbf{w}_{j+1} = \mathbf{A}\mathbf{P}^{-1}\mathbf{z}_j - \sum_{i \leq j} h_{ij} \mathbf{z}_i.
+ *  \f]
+ *  Iteration j therefore starts a non-blocking reduction of \f$ \mathbf{v}_i^T \mathbf{A}\mathbf{P}^{-1}\mathbf{w}_j \f$,
+ *  \f$ \mathbf{w}_j^T \mathbf{A}\mathbf{P}^{-1}\mathbf{w}_j \f$, and \f$ \|\mathbf{w}_j\|^2 \f$, and meanwhile applies the
+ *  preconditioner and the matrix to \f$ \mathbf{z}_j \f$, before \f$ \mathbf{w}_j \f$ is normalized.
+ *  The normalization, and the Hessenberg column it completes, lag one iteration behind.
+ *  This is the unshifted p(1)-GMRES of Ghysels et al. (2013).
+ *
+ *  Classical Gram-Schmidt GMRES needs two to three blocking reductions per iteration, and modified
+ *  Gram-Schmidt j+2. The price is the storage of twice the Krylov basis and, when a cycle ends,
+ *  one reduction without a product to hide behind. The update \f$ \mathbf{P}^{-1}\mathbf{V}\mathbf{y} \f$
+ *  is preconditioned once per restart, such that the preconditioner must not vary between iterations.
+ */
+class PipelinedGMRES
+{
+public:
+    /// Vector type of the linear systems.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Constructor.
+    /** @p restart_number is the maximum number of basis vectors before restarting.
+     */
+    PipelinedGMRES (dealii::SolverControl &solver_control, const unsigned int restart_number)
+    : solver_control(solver_control)
+    , restart_number(restart_number)
+    {}
+
+    /// Solves the system starting from the given @p solution.
+    /** Throws dealii::SolverControl::NoConvergence if the solver_control fails, as the deal.II solvers.
+     */
+    template <typename MatrixType, typename PreconditionerType>
+    void solve (
+        const MatrixType &system_matrix,
+        VectorType &solution,
+        const VectorType &right_hand_side,
+        const PreconditionerType &preconditioner);
+
+private:
+    /// Dot product of the locally owned entries, to be summed over the processors.
+    static double local_dot (const VectorType &a, const VectorType &b)
+    {
+        return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    }
+
+    dealii::SolverControl &solver_control; ///< Convergence criteria.
+    const unsigned int restart_number; ///< Maximum number of basis vectors.
+};
+
+template <typename MatrixType, typename PreconditionerType>
+void PipelinedGMRES::solve (
+    const MatrixType &system_matrix,
+    VectorType &solution,
+    const VectorType &right_hand_side,
+    const PreconditionerType &preconditioner)
+{
+    // Below this fraction of its Hessenberg column, the subdiagonal means that the Krylov subspace is invariant.
+    const double breakdown_tolerance = 1e-14;
+
+    const MPI_Comm mpi_communicator = solution.get_mpi_communicator();
+    const unsigned int max_basis_size = std::max(restart_number, 1u);
+
+    std::vector<VectorType> basis(max_basis_size), products(max_basis_size);
+    const auto allocate = [&] (VectorType &vector) {
+        if (vector.size() != solution.size()) vector.reinit(solution, true);
+    };
+    // The candidate basis vector and its product, and the product of the latter.
+    VectorType candidate, candidate_product, next_product, preconditioned;
+    allocate(candidate);
+    allocate(candidate_product);
+    allocate(next_product);
+    allocate(preconditioned);
+
+    // Columns of the Hessenberg matrix, reduced to upper triangular form by Givens rotations.
+    std::vector<std::vector<double>> hessenberg(max_basis_size, std::vector<double>(max_basis_size+1, 0.0));
+    std::vector<double> givens_cos(max_basis_size), givens_sin(max_basis_size);
+    std::vector<double> least_squares_rhs(max_basis_size+1);
+    std::vector<double> reductions(max_basis_size+2);
+
+    unsigned int iteration = 0;
+    dealii::SolverControl::State state = dealii::SolverControl::iterate;
+    while (state == dealii::SolverControl::iterate) {
+        // The true residual of each restart discards the drift of the recurrences.
+        system_matrix.vmult(candidate, solution);
+        candidate.sadd(-1.0, 1.0, right_hand_side);
+        const double residual_norm = candidate.l2_norm();
+        state = solver_control.check(iteration, residual_norm);
+        if (state != dealii::SolverControl::iterate) break;
+
+        candidate *= 1.0/residual_norm;
+        preconditioner.vmult(preconditioned, candidate);
+        system_matrix.vmult(candidate_product, preconditioned);
+
+        std::fill(least_squares_rhs.begin(), least_squares_rhs.end(), 0.0);
+        least_squares_rhs[0] = residual_norm;
+
+        unsigned int n_columns = 0;
+        for (unsigned int j = 0; j <= max_basis_size; ++j) {
+            for (unsigned int i = 0; i < j; ++i) {
+                reductions[i] = local_dot(basis[i], candidate_product);
+            }
+            reductions[j] = local_dot(candidate, candidate_product);
+            reductions[j+1] = local_dot(candidate, candidate);
+            MPI_Request request;
+            MPI_Iallreduce(MPI_IN_PLACE, reductions.data(), j+2, MPI_DOUBLE, MPI_SUM, mpi_communicator, &request);
+
+            // Overlapped with the reduction, unless the basis is full.
+            if (j < max_basis_size) {
+                preconditioner.vmult(preconditioned, candidate_product);
+                system_matrix.vmult(next_product, preconditioned);
+            }
+
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            const double candidate_norm = std::sqrt(reductions[j+1]);
+
+            bool breakdown = false;
+            if (j > 0) {
+                // The norm of the candidate completes the previous column.
+                std::vector<double> &column = hessenberg[j-1];
+                column[j] = candidate_norm;
+                double column_norm_sqr = 0.0;
+                for (unsigned int i = 0; i <= j; ++i) column_norm_sqr += column[i] * column[i];
+                breakdown = (candidate_norm <= breakdown_tolerance * std::sqrt(column_norm_sqr));
+
+                // Apply the previous rotations to the column and eliminate its subdiagonal.
+                const unsigned int k = j-1;
+                for (unsigned int i = 0; i < k; ++i) {
+                    const double rotated = givens_cos[i] * column[i] + givens_sin[i] * column[i+1];
+                    column[i+1] = -givens_sin[i] * column[i] + givens_cos[i] * column[i+1];
+                    column[i] = rotated;
+                }
+                const double diagonal = std::hypot(column[k], column[k+1]);
+                givens_cos[k] = (diagonal > 0.0) ? column[k] / diagonal : 1.0;
+                givens_sin[k] = (diagonal > 0.0) ? column[k+1] / diagonal : 0.0;
+                column[k] = diagonal;
+                column[k+1] = 0.0;
+                least_squares_rhs[k+1] = -givens_sin[k] * least_squares_rhs[k];
+                least_squares_rhs[k] *= givens_cos[k];
+
+                n_columns = j;
+                ++iteration;
+                state = solver_control.check(iteration, std::abs(least_squares_rhs[k+1]));
+            }
+            if (j == max_basis_size || breakdown || state != dealii::SolverControl::iterate) break;
+
+            // Normalize the candidate and orthogonalize the next one.
+            VectorType &new_basis = basis[j];
+            VectorType &new_product = products[j];
+            allocate(new_basis);
+            allocate(new_product);
+            new_basis.equ(1.0/candidate_norm, candidate);
+            new_product.equ(1.0/candidate_norm, candidate_product);
+            next_product *= 1.0/candidate_norm;
+
+            std::vector<double> &column = hessenberg[j];
+            for (unsigned int i = 0; i < j; ++i) {
+                column[i] = reductions[i] / candidate_norm;
+            }
+            column[j] = reductions[j] / (candidate_norm * candidate_norm);
+
+            candidate = new_product;
+            candidate_product = next_product;
+            for (unsigned int i = 0; i <= j; ++i) {
+                candidate.add(-column[i], basis[i]);
+                candidate_product.add(-column[i], products[i]);
+            }
+        }
+
+        // Solve the triangular system and update the solution.
+        std::vector<double> coefficients(n_columns, 0.0);
+        for (unsigned int i = n_columns; i-- > 0;) {
+            double sum = least_squares_rhs[i];
+            for (unsigned int k = i+1; k < n_columns; ++k) {
+                sum -= hessenberg[k][i] * coefficients[k];
+            }
+            coefficients[i] = (hessenberg[i][i] != 0.0) ? sum / hessenberg[i][i] : 0.0;
+        }
+        candidate = 0.0;
+        for (unsigned int i = 0; i < n_columns; ++i) {
+            candidate.add(coefficients[i], basis[i]);
+        }
+        preconditioner.vmult(preconditioned, candidate);
+        solution += preconditioned;
+    }
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(solver_control.last_step(), solver_control.last_value()));
+}
+
+} // PHiLiP namespace
+
+#endif
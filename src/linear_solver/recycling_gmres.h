@@ -0,0 +1,324 @@
+#ifndef __RECYCLING_GMRES_H__
+#define __RECYCLING_GMRES_H__
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <deal.II/base/exceptions.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+
+namespace PHiLiP {
+
+/// Subspace kept by RecyclingGMRES between the solves of systems with the same or nearby matrices.
+/** The directions \f$ \mathbf{U} \f$ live in the solution space, and their products
+ *  \f$ \mathbf{C} = \mathbf{A}\mathbf{U} \f$ are orthonormal. Since the directions do not depend
+ *  on the preconditioner, they remain useful once the matrix and its preconditioner are set up again,
+ *  and only the products must then be recomputed, see invalidate_products().
+ */
+class RecycledSubspace
+{
+public:
+    /// Vector type of the linear systems.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Constructor.
+    RecycledSubspace() : products_are_current(false) {}
+
+    /// Number of kept directions.
+    unsigned int size() const { return directions.size(); }
+
+    /// Discards the kept directions.
+    void clear()
+    {
+        directions.clear();
+        products.clear();
+        products_are_current = false;
+    }
+
+    /// Recomputes the products with the matrix of the next solve, whose values have changed.
+    void invalidate_products() { products_are_current = false; }
+
+    /// Directions \f$ \mathbf{U} \f$ of previous corrections, from the oldest to the newest.
+    std::vector<VectorType> directions;
+    /// Orthonormal products \f$ \mathbf{C} = \mathbf{A}\mathbf{U} \f$ of the directions.
+    std::vector<VectorType> products;
+    /// Whether the products have been computed with the current matrix.
+    bool products_are_current;
+};
+
+/// Right-preconditioned GCRO recycling the directions of previous corrections.
+/** Each restart first minimizes the residual over the recycled directions,
+ *  \f[
+ *      \mathbf{x} \leftarrow \mathbf{x} + \mathbf{U}\mathbf{C}^T\mathbf{r}, \qquad
+ *      \mathbf{r} \leftarrow (\mathbf{I} - \mathbf{C}\mathbf{C}^T)\mathbf{r},
+ *  \f]
+ *  and then builds the Arnoldi basis \f$ \mathbf{V} \f$ of the deflated operator
+ *  \f$ (\mathbf{I} - \mathbf{C}\mathbf{C}^T)\mathbf{A}\mathbf{P}^{-1} \f$, such that
+ *  \f$ \mathbf{A}\mathbf{P}^{-1}\mathbf{V}_m = \mathbf{C}\mathbf{B}_m + \mathbf{V}_{m+1}\bar{\mathbf{H}}_m \f$.
+ *  The least-squares solution \f$ \mathbf{y} \f$ of the Hessenberg system then gives the correction
+ *  \f$ \mathbf{d} = \mathbf{P}^{-1}\mathbf{V}_m\mathbf{y} - \mathbf{U}\mathbf{B}_m\mathbf{y} \f$,
+ *  which minimizes the residual over both subspaces (de Sturler, 1999).
+ *
+ *  Every correction is then appended to the recycled directions, with its product
+ *  \f$ \mathbf{A}\mathbf{d} = \mathbf{V}_{m+1}\bar{\mathbf{H}}_m\mathbf{y} \f$ obtained without another product,
+ *  and the oldest directions are discarded beyond the maximum subspace size.
+ *  Within a solve, the restarts therefore keep the subspaces of the previous cycles. Across solves,
+ *  the corrections of the previous solutions, started from zero, are the solutions themselves, and the
+ *  first projection is the best initial guess from their combinations.
+ *  The recycled subspace of GCRO-DR (Parks et al., 2006) instead keeps harmonic Ritz vectors,
+ *  which requires a generalized non-symmetric eigensolver at each restart.
+ *
+ *  The update \f$ \mathbf{P}^{-1}\mathbf{V}\mathbf{y} \f$ is preconditioned once per restart,
+ *  such that the preconditioner must not vary between iterations.
+ */
+class RecyclingGMRES
+{
+public:
+    /// Vector type of the linear systems.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Constructor.
+    /** @p restart_number is the maximum number of Arnoldi basis vectors before restarting,
+     *  and @p max_subspace_size the maximum number of directions kept in @p recycled_subspace.
+     */
+    RecyclingGMRES (
+        dealii::SolverControl &solver_control,
+        const unsigned int restart_number,
+        RecycledSubspace &recycled_subspace,
+        const unsigned int max_subspace_size)
+    : solver_control(solver_control)
+    , restart_number(restart_number)
+    , recycled_subspace(recycled_subspace)
+    , max_subspace_size(max_subspace_size)
+    {}
+
+    /// Solves the system starting from the given @p solution.
+    /** The products of the recycled subspace are recomputed with @p system_matrix if they are not current.
+     *  Throws dealii::SolverControl::NoConvergence if the solver_control fails, as the deal.II solvers.
+     */
+    template <typename MatrixType, typename PreconditionerType>
+    void solve (
+        const MatrixType &system_matrix,
+        VectorType &solution,
+        const VectorType &right_hand_side,
+        const PreconditionerType &preconditioner);
+
+private:
+    /// Orthonormalizes @p product against the recycled products, and appends it along with @p direction.
+    /** The same operations are applied to @p direction, such that the product remains the one of the direction.
+     *  Returns false if the product is numerically spanned by the recycled ones, in which case nothing is appended.
+     */
+    bool append_direction (VectorType &direction, VectorType &product);
+
+    /// Discards the oldest directions beyond the maximum subspace size.
+    void truncate_subspace ();
+
+    dealii::SolverControl &solver_control; ///< Convergence criteria.
+    const unsigned int restart_number; ///< Maximum number of Arnoldi basis vectors.
+    RecycledSubspace &recycled_subspace; ///< Directions kept between the solves.
+    const unsigned int max_subspace_size; ///< Maximum number of recycled directions.
+};
+
+inline bool RecyclingGMRES::append_direction (VectorType &direction, VectorType &product)
+{
+    // Below this fraction of its initial norm, the product is spanned by the recycled products.
+    const double dependence_tolerance = 1e-10;
+
+    const double initial_norm = product.l2_norm();
+    if (initial_norm == 0.0) return false;
+    for (unsigned int k = 0; k < recycled_subspace.size(); ++k) {
+        const double projection = recycled_subspace.products[k] * product;
+        product.add(-projection, recycled_subspace.products[k]);
+        direction.add(-projection, recycled_subspace.directions[k]);
+    }
+    const double product_norm = product.l2_norm();
+    if (product_norm <= dependence_tolerance * initial_norm) return false;
+
+    product *= 1.0/product_norm;
+    direction *= 1.0/product_norm;
+    recycled_subspace.directions.push_back(direction);
+    recycled_subspace.products.push_back(product);
+    return true;
+}
+
+inline void RecyclingGMRES::truncate_subspace ()
+{
+    // Removing the oldest directions keeps the remaining products orthonormal.
+    const unsigned int n_discarded = recycled_subspace.size() - std::min(recycled_subspace.size(), max_subspace_size);
+    recycled_subspace.directions.erase(recycled_subspace.directions.begin(), recycled_subspace.directions.begin() + n_discarded);
+    recycled_subspace.products.erase(recycled_subspace.products.begin(), recycled_subspace.products.begin() + n_discarded);
+}
+
+template <typename MatrixType, typename PreconditionerType>
+void RecyclingGMRES::solve (
+    const MatrixType &system_matrix,
+    VectorType &solution,
+    const VectorType &right_hand_side,
+    const PreconditionerType &preconditioner)
+{
+    // Below this fraction of its Hessenberg column, the subdiagonal means that the Krylov subspace is invariant.
+    const double breakdown_tolerance = 1e-14;
+
+    const unsigned int max_basis_size = std::max(restart_number, 1u);
+    const auto allocate = [&] (VectorType &vector) {
+        if (vector.size() != solution.size()) vector.reinit(solution, true);
+    };
+
+    // Directions of another discretization, e.g. before a mesh refinement, cannot be recycled.
+    if (recycled_subspace.size() > 0
+        && (recycled_subspace.directions[0].size() != solution.size()
+            || !recycled_subspace.directions[0].partitioners_are_compatible(*solution.get_partitioner()))) {
+        recycled_subspace.clear();
+    }
+    truncate_subspace();
+    if (!recycled_subspace.products_are_current) {
+        // Products with the new matrix, orthonormalized by modified Gram-Schmidt.
+        std::vector<VectorType> old_directions;
+        old_directions.swap(recycled_subspace.directions);
+        recycled_subspace.products.clear();
+        VectorType product;
+        allocate(product);
+        for (VectorType &direction : old_directions) {
+            system_matrix.vmult(product, direction);
+            append_direction(direction, product);
+        }
+        recycled_subspace.products_are_current = true;
+    }
+
+    std::vector<VectorType> basis(max_basis_size+1);
+    VectorType residual, preconditioned;
+    allocate(residual);
+    allocate(preconditioned);
+
+    // Columns of the Hessenberg matrix, reduced to upper triangular form by Givens rotations,
+    // and their unrotated copies giving the product of the correction.
+    std::vector<std::vector<double>> hessenberg(max_basis_size, std::vector<double>(max_basis_size+1, 0.0));
+    std::vector<std::vector<double>> arnoldi_hessenberg = hessenberg;
+    // Columns of the projections of the Arnoldi products on the recycled products.
+    std::vector<std::vector<double>> recycled_projections(max_basis_size);
+    std::vector<double> givens_cos(max_basis_size), givens_sin(max_basis_size);
+    std::vector<double> least_squares_rhs(max_basis_size+1);
+
+    unsigned int iteration = 0;
+    dealii::SolverControl::State state = dealii::SolverControl::iterate;
+    while (state == dealii::SolverControl::iterate) {
+        // The true residual of each restart discards the drift of the recurrences.
+        system_matrix.vmult(residual, solution);
+        residual.sadd(-1.0, 1.0, right_hand_side);
+
+        // Minimize the residual over the recycled directions.
+        for (unsigned int k = 0; k < recycled_subspace.size(); ++k) {
+            const double projection = recycled_subspace.products[k] * residual;
+            residual.add(-projection, recycled_subspace.products[k]);
+            solution.add(projection, recycled_subspace.directions[k]);
+        }
+
+        const double residual_norm = residual.l2_norm();
+        state = solver_control.check(iteration, residual_norm);
+        if (state != dealii::SolverControl::iterate) break;
+
+        allocate(basis[0]);
+        basis[0].equ(1.0/residual_norm, residual);
+        std::fill(least_squares_rhs.begin(), least_squares_rhs.end(), 0.0);
+        least_squares_rhs[0] = residual_norm;
+
+        unsigned int n_columns = 0;
+        for (unsigned int j = 0; j < max_basis_size; ++j) {
+            VectorType &candidate = basis[j+1];
+            allocate(candidate);
+            preconditioner.vmult(preconditioned, basis[j]);
+            system_matrix.vmult(candidate, preconditioned);
+
+            // Orthogonalize against the recycled products, and then the Arnoldi basis, by modified Gram-Schmidt.
+            std::vector<double> &projections = recycled_projections[j];
+            projections.resize(recycled_subspace.size());
+            for (unsigned int k = 0; k < recycled_subspace.size(); ++k) {
+                projections[k] = recycled_subspace.products[k] * candidate;
+                candidate.add(-projections[k], recycled_subspace.products[k]);
+            }
+            std::vector<double> &column = hessenberg[j];
+            for (unsigned int i = 0; i <= j; ++i) {
+                column[i] = basis[i] * candidate;
+                candidate.add(-column[i], basis[i]);
+            }
+            column[j+1] = candidate.l2_norm();
+            arnoldi_hessenberg[j] = column;
+
+            double column_norm_sqr = 0.0;
+            for (unsigned int i = 0; i <= j+1; ++i) column_norm_sqr += column[i] * column[i];
+            const bool breakdown = (column[j+1] <= breakdown_tolerance * std::sqrt(column_norm_sqr));
+            // The unnormalized candidate still gives the last term of the product of the correction.
+            if (!breakdown) candidate *= 1.0/column[j+1];
+
+            // Apply the previous rotations to the column and eliminate its subdiagonal.
+            for (unsigned int i = 0; i < j; ++i) {
+                const double rotated = givens_cos[i] * column[i] + givens_sin[i] * column[i+1];
+                column[i+1] = -givens_sin[i] * column[i] + givens_cos[i] * column[i+1];
+                column[i] = rotated;
+            }
+            const double diagonal = std::hypot(column[j], column[j+1]);
+            givens_cos[j] = (diagonal > 0.0) ? column[j] / diagonal : 1.0;
+            givens_sin[j] = (diagonal > 0.0) ? column[j+1] / diagonal : 0.0;
+            column[j] = diagonal;
+            column[j+1] = 0.0;
+            least_squares_rhs[j+1] = -givens_sin[j] * least_squares_rhs[j];
+            least_squares_rhs[j] *= givens_cos[j];
+
+            n_columns = j+1;
+            ++iteration;
+            state = solver_control.check(iteration, std::abs(least_squares_rhs[j+1]));
+            if (breakdown) {
+                // The last basis vector does not contribute to the product of the correction.
+                candidate = 0.0;
+                arnoldi_hessenberg[j][j+1] = 0.0;
+            }
+            if (breakdown || state != dealii::SolverControl::iterate) break;
+        }
+
+        // Solve the triangular system.
+        std::vector<double> coefficients(n_columns, 0.0);
+        for (unsigned int i = n_columns; i-- > 0;) {
+            double sum = least_squares_rhs[i];
+            for (unsigned int k = i+1; k < n_columns; ++k) {
+                sum -= hessenberg[k][i] * coefficients[k];
+            }
+            coefficients[i] = (hessenberg[i][i] != 0.0) ? sum / hessenberg[i][i] : 0.0;
+        }
+
+        // Correction d = P^{-1} V y - U B y, and its product A d = V H y.
+        VectorType correction, correction_product;
+        allocate(correction);
+        allocate(correction_product);
+        residual = 0.0;
+        correction_product = 0.0;
+        for (unsigned int j = 0; j < n_columns; ++j) {
+            residual.add(coefficients[j], basis[j]);
+            for (unsigned int i = 0; i <= j+1; ++i) {
+                correction_product.add(coefficients[j] * arnoldi_hessenberg[j][i], basis[i]);
+            }
+        }
+        preconditioner.vmult(correction, residual);
+        for (unsigned int k = 0; k < recycled_subspace.size(); ++k) {
+            double projection = 0.0;
+            for (unsigned int j = 0; j < n_columns; ++j) projection += recycled_projections[j][k] * coefficients[j];
+            correction.add(-projection, recycled_subspace.directions[k]);
+        }
+        solution += correction;
+
+        // Recycle the correction for the next restarts and solves.
+        if (max_subspace_size > 0 && n_columns > 0) {
+            append_direction(correction, correction_product);
+            truncate_subspace();
+        }
+    }
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(solver_control.last_step(), solver_control.last_value()));
+}
+
+} // PHiLiP namespace
+
+#endif
@@ -1,6 +1,7 @@
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/parameter_handler.h>
 
 #include <fenv.h> // catch nan
@@ -59,6 +60,12 @@ int main (int argc, char *argv[])
 
         AssertDimension(all_parameters.dimension, PHILIP_DIM);
 
+        // MPI_InitFinalize limited each process to a single thread.
+        const unsigned int max_threads = (all_parameters.threads_per_mpi_process == 0) ? dealii::numbers::invalid_unsigned_int
+                                                                                       : all_parameters.threads_per_mpi_process;
+        dealii::MultithreadInfo::set_thread_limit(max_threads);
+        pcout << "Using up to " << dealii::MultithreadInfo::n_threads() << " threads per processor..." << std::endl;
+
         const int max_dim = PHILIP_DIM;
         const int max_nstate = 5;
         std::unique_ptr<PHiLiP::Tests::TestsBase> test = PHiLiP::Tests::TestsFactory<max_dim,max_nstate>::create_test(&all_parameters);
@@ -59,6 +59,35 @@ NumericalFluxFactory<dim, nstate, real>
 template <int dim, int nstate, typename real>
 NumericalFluxConvective<dim,nstate,real>::~NumericalFluxConvective() {}
 
+template <int dim, int nstate, typename real>
+void NumericalFluxConvective<dim,nstate,real>
+::evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+    for (int s=0; s<nstate; s++) {
+        numerical_flux_dot_n[s].resize(n_pts);
+    }
+    std::array<real, nstate> soln_int_at_point, soln_ext_at_point;
+    dealii::Tensor<1,dim,real> normal_at_point;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln_int_at_point[s] = soln_int[s][ipoint];
+            soln_ext_at_point[s] = soln_ext[s][ipoint];
+        }
+        for (int d=0; d<dim; ++d) {
+            normal_at_point[d] = normal_int[d][ipoint];
+        }
+        const std::array<real, nstate> flux = evaluate_flux(soln_int_at_point, soln_ext_at_point, normal_at_point);
+        for (int s=0; s<nstate; s++) {
+            numerical_flux_dot_n[s][ipoint] = flux[s];
+        }
+    }
+}
+
 template<int dim, int nstate, typename real>
 std::array<real, nstate> LaxFriedrichs<dim,nstate,real>
 ::evaluate_flux (
@@ -107,6 +136,47 @@ std::array<real, nstate> LaxFriedrichs<dim,nstate,real>
     return numerical_flux_dot_n;
 }
 
+template<int dim, int nstate, typename real>
+void LaxFriedrichs<dim,nstate,real>
+::evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+
+    std::array<std::array<std::vector<real>, dim>, nstate> conv_phys_flux_int, conv_phys_flux_ext;
+    pde_physics->convective_flux_batch (soln_int, conv_phys_flux_int);
+    pde_physics->convective_flux_batch (soln_ext, conv_phys_flux_ext);
+
+    std::vector<real> conv_max_eig_int, conv_max_eig_ext;
+    pde_physics->max_convective_eigenvalue_batch (soln_int, conv_max_eig_int);
+    pde_physics->max_convective_eigenvalue_batch (soln_ext, conv_max_eig_ext);
+    // Replaced the std::max with an if-statement for the AD to work properly.
+    std::vector<real> &conv_max_eig = conv_max_eig_int;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        if (conv_max_eig_ext[ipoint] >= conv_max_eig_int[ipoint]) conv_max_eig[ipoint] = conv_max_eig_ext[ipoint];
+    }
+
+    // Scalar dissipation
+    for (int s=0; s<nstate; s++) {
+        std::vector<real> &flux_dot_n = numerical_flux_dot_n[s];
+        flux_dot_n.assign(n_pts, 0.0);
+        for (int d=0; d<dim; ++d) {
+            const real *flux_int = conv_phys_flux_int[s][d].data();
+            const real *flux_ext = conv_phys_flux_ext[s][d].data();
+            const real *normal = normal_int[d].data();
+            for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+                flux_dot_n[ipoint] += 0.5*(flux_int[ipoint] + flux_ext[ipoint])*normal[ipoint];
+            }
+        }
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            flux_dot_n[ipoint] = flux_dot_n[ipoint] - 0.5 * conv_max_eig[ipoint] * (soln_ext[s][ipoint]-soln_int[s][ipoint]);
+        }
+    }
+}
+
 template<int dim, int nstate, typename real>
 std::array<real, nstate> Roe<dim,nstate,real>
 ::evaluate_flux (
@@ -253,6 +323,35 @@ std::array<real, nstate> Roe<dim,nstate,real>
     return numerical_flux_dot_n;
 }
 
+template<int dim, int nstate, typename real>
+void Roe<dim,nstate,real>
+::evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+    for (int s=0; s<nstate; s++) {
+        numerical_flux_dot_n[s].resize(n_pts);
+    }
+    std::array<real, nstate> soln_int_at_point, soln_ext_at_point;
+    dealii::Tensor<1,dim,real> normal_at_point;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln_int_at_point[s] = soln_int[s][ipoint];
+            soln_ext_at_point[s] = soln_ext[s][ipoint];
+        }
+        for (int d=0; d<dim; ++d) {
+            normal_at_point[d] = normal_int[d][ipoint];
+        }
+        const std::array<real, nstate> flux = Roe<dim,nstate,real>::evaluate_flux(soln_int_at_point, soln_ext_at_point, normal_at_point);
+        for (int s=0; s<nstate; s++) {
+            numerical_flux_dot_n[s][ipoint] = flux[s];
+        }
+    }
+}
+
 
 // Instantiation
 template class NumericalFluxConvective<PHILIP_DIM, 1, double>;
@@ -24,6 +24,18 @@ virtual std::array<real, nstate> evaluate_flux (
     const std::array<real, nstate> &soln_ext,
     const dealii::Tensor<1,dim,real> &normal1) const = 0;
 
+/// Returns the convective numerical flux at a batch of interface points.
+/** Structure-of-arrays version of evaluate_flux(), where @p soln_int[istate][ipoint],
+ *  @p normal1[idim][ipoint] and @p numerical_flux_dot_n[istate][ipoint].
+ *  Used to evaluate a whole face in one call. The default implementation calls evaluate_flux()
+ *  at every point.
+ */
+virtual void evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal1,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const;
+
 };
 
 
@@ -47,6 +59,15 @@ std::array<real, nstate> evaluate_flux (
     const std::array<real, nstate> &soln_ext,
     const dealii::Tensor<1,dim,real> &normal1) const;
 
+/// Returns the Lax-Friedrichs convective numerical flux at a batch of interface points.
+/** The physical fluxes and eigenvalues are evaluated through the batched physics functions.
+ */
+void evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal1,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const override;
+
 protected:
 /// Numerical flux requires physics to evaluate convective eigenvalues.
 const std::shared_ptr < Physics::PhysicsBase<dim, nstate, real> > pde_physics;
@@ -73,6 +94,15 @@ std::array<real, nstate> evaluate_flux (
     const std::array<real, nstate> &soln_ext,
     const dealii::Tensor<1,dim,real> &normal1) const;
 
+/// Returns the Roe convective numerical flux at a batch of interface points.
+/** Calls the Roe flux directly, avoiding the virtual call per point.
+ */
+void evaluate_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal1,
+    std::array<std::vector<real>, nstate> &numerical_flux_dot_n) const override;
+
 protected:
 /// Numerical flux requires physics to evaluate convective eigenvalues.
 const std::shared_ptr < Physics::Euler<dim, nstate, real> > euler_physics;
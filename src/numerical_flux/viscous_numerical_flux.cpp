@@ -51,6 +51,78 @@ std::array<dealii::Tensor<1,dim,real>,nstate> array_jump(
 template <int dim, int nstate, typename real>
 NumericalFluxDissipative<dim,nstate,real>::~NumericalFluxDissipative() {}
 
+template <int dim, int nstate, typename real>
+void NumericalFluxDissipative<dim,nstate,real>
+::evaluate_solution_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &soln_flux) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+    for (int s=0; s<nstate; s++) {
+        soln_flux[s].resize(n_pts);
+    }
+    std::array<real, nstate> soln_int_at_point, soln_ext_at_point;
+    dealii::Tensor<1,dim,real> normal_at_point;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln_int_at_point[s] = soln_int[s][ipoint];
+            soln_ext_at_point[s] = soln_ext[s][ipoint];
+        }
+        for (int d=0; d<dim; ++d) {
+            normal_at_point[d] = normal_int[d][ipoint];
+        }
+        const std::array<real, nstate> flux = evaluate_solution_flux(soln_int_at_point, soln_ext_at_point, normal_at_point);
+        for (int s=0; s<nstate; s++) {
+            soln_flux[s][ipoint] = flux[s];
+        }
+    }
+}
+
+template <int dim, int nstate, typename real>
+void NumericalFluxDissipative<dim,nstate,real>
+::evaluate_auxiliary_flux_batch (
+    const real artificial_diss_coeff_int,
+    const real artificial_diss_coeff_ext,
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_int,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    const real &penalty,
+    std::array<std::vector<real>, nstate> &auxiliary_flux_dot_n) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+    for (int s=0; s<nstate; s++) {
+        auxiliary_flux_dot_n[s].resize(n_pts);
+    }
+    std::array<real, nstate> soln_int_at_point, soln_ext_at_point;
+    std::array<dealii::Tensor<1,dim,real>, nstate> soln_grad_int_at_point, soln_grad_ext_at_point;
+    dealii::Tensor<1,dim,real> normal_at_point;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln_int_at_point[s] = soln_int[s][ipoint];
+            soln_ext_at_point[s] = soln_ext[s][ipoint];
+            for (int d=0; d<dim; ++d) {
+                soln_grad_int_at_point[s][d] = soln_grad_int[s][d][ipoint];
+                soln_grad_ext_at_point[s][d] = soln_grad_ext[s][d][ipoint];
+            }
+        }
+        for (int d=0; d<dim; ++d) {
+            normal_at_point[d] = normal_int[d][ipoint];
+        }
+        const std::array<real, nstate> flux = evaluate_auxiliary_flux(
+            artificial_diss_coeff_int, artificial_diss_coeff_ext,
+            soln_int_at_point, soln_ext_at_point,
+            soln_grad_int_at_point, soln_grad_ext_at_point,
+            normal_at_point, penalty);
+        for (int s=0; s<nstate; s++) {
+            auxiliary_flux_dot_n[s][ipoint] = flux[s];
+        }
+    }
+}
+
 
 //template<int dim, int nstate, typename real>
 //void NumericalFluxDissipative<dim,nstate,real>
@@ -221,6 +293,105 @@ std::array<real, nstate> SymmetricInternalPenalty<dim,nstate,real>
     return auxiliary_flux_dot_n;
 }
 
+template<int dim, int nstate, typename real>
+void SymmetricInternalPenalty<dim,nstate,real>
+::evaluate_solution_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &/*normal_int*/,
+    std::array<std::vector<real>, nstate> &soln_flux) const
+{
+    const unsigned int n_pts = soln_int[0].size();
+    for (int s=0; s<nstate; s++) {
+        soln_flux[s].resize(n_pts);
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            soln_flux[s][ipoint] = 0.5*(soln_int[s][ipoint] + soln_ext[s][ipoint]);
+        }
+    }
+}
+
+template<int dim, int nstate, typename real>
+void SymmetricInternalPenalty<dim,nstate,real>
+::evaluate_auxiliary_flux_batch (
+    const real artificial_diss_coeff_int,
+    const real artificial_diss_coeff_ext,
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_int,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    const real &penalty,
+    std::array<std::vector<real>, nstate> &auxiliary_flux_dot_n) const
+{
+    using ArrayTensor1Batch = std::array<std::array<std::vector<real>, dim>, nstate>;
+    const unsigned int n_pts = soln_int[0].size();
+
+    // {{A*grad_u}}
+    ArrayTensor1Batch phys_flux_int, phys_flux_ext;
+    pde_physics->dissipative_flux_batch (soln_int, soln_grad_int, phys_flux_int);
+    pde_physics->dissipative_flux_batch (soln_ext, soln_grad_ext, phys_flux_ext);
+
+    // {{A}}*[[u]]
+    ArrayTensor1Batch soln_jump;
+    for (int s=0; s<nstate; s++) {
+        for (int d=0; d<dim; d++) {
+            soln_jump[s][d].resize(n_pts);
+            for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+                soln_jump[s][d][ipoint] = (soln_int[s][ipoint] - soln_ext[s][ipoint])*normal_int[d][ipoint];
+            }
+        }
+    }
+    ArrayTensor1Batch A_jumpu_int, A_jumpu_ext;
+    pde_physics->dissipative_flux_batch (soln_int, soln_jump, A_jumpu_int);
+    pde_physics->dissipative_flux_batch (soln_ext, soln_jump, A_jumpu_ext);
+
+    for (int s=0; s<nstate; s++) {
+        std::vector<real> &flux_dot_n = auxiliary_flux_dot_n[s];
+        flux_dot_n.assign(n_pts, 0.0);
+        for (int d=0; d<dim; ++d) {
+            for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+                const real phys_flux_avg = 0.5*(phys_flux_int[s][d][ipoint] + phys_flux_ext[s][d][ipoint]);
+                const real A_jumpu_avg = 0.5*(A_jumpu_int[s][d][ipoint] + A_jumpu_ext[s][d][ipoint]);
+                flux_dot_n[ipoint] += (phys_flux_avg - penalty * A_jumpu_avg) * normal_int[d][ipoint];
+            }
+        }
+    }
+
+    if (artificial_diss_coeff_int > 1e-13 && artificial_diss_coeff_ext > 1e-13) {
+        using ArrayTensor1 = std::array<dealii::Tensor<1,dim,real>, nstate>;
+        std::array<real, nstate> soln_int_at_point, soln_ext_at_point;
+        ArrayTensor1 soln_grad_int_at_point, soln_grad_ext_at_point, soln_jump_at_point;
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            for (int s=0; s<nstate; s++) {
+                soln_int_at_point[s] = soln_int[s][ipoint];
+                soln_ext_at_point[s] = soln_ext[s][ipoint];
+                for (int d=0; d<dim; ++d) {
+                    soln_grad_int_at_point[s][d] = soln_grad_int[s][d][ipoint];
+                    soln_grad_ext_at_point[s][d] = soln_grad_ext[s][d][ipoint];
+                    soln_jump_at_point[s][d] = soln_jump[s][d][ipoint];
+                }
+            }
+            // {{A*grad_u}}
+            const ArrayTensor1 artificial_phys_flux_int = pde_physics->artificial_dissipative_flux (artificial_diss_coeff_int, soln_int_at_point, soln_grad_int_at_point);
+            const ArrayTensor1 artificial_phys_flux_ext = pde_physics->artificial_dissipative_flux (artificial_diss_coeff_ext, soln_ext_at_point, soln_grad_ext_at_point);
+            const ArrayTensor1 artificial_phys_flux_avg = array_average<nstate,dim,real>(artificial_phys_flux_int, artificial_phys_flux_ext);
+
+            // {{A}}*[[u]]
+            const ArrayTensor1 artificial_A_jumpu_int = pde_physics->artificial_dissipative_flux (artificial_diss_coeff_int, soln_int_at_point, soln_jump_at_point);
+            const ArrayTensor1 artificial_A_jumpu_ext = pde_physics->artificial_dissipative_flux (artificial_diss_coeff_ext, soln_ext_at_point, soln_jump_at_point);
+            const ArrayTensor1 artificial_A_jumpu_avg = array_average<nstate,dim,real>(artificial_A_jumpu_int, artificial_A_jumpu_ext);
+
+            for (int s=0; s<nstate; s++) {
+                real arti = 0.0;
+                for (int d=0; d<dim; ++d) {
+                    arti += (artificial_phys_flux_avg[s][d] - penalty * artificial_A_jumpu_avg[s][d]) * normal_int[d][ipoint];
+                }
+                auxiliary_flux_dot_n[s][ipoint] += arti;
+            }
+        }
+    }
+}
+
 //template<int dim, int nstate, typename real>
 //std::array<real, nstate> BassiRebay2<dim,nstate,real>
 //::evaluate_auxiliary_flux (
@@ -32,6 +32,32 @@ virtual std::array<real, nstate> evaluate_auxiliary_flux (
     const real &penalty,
     const bool on_boundary = false) const = 0;
 
+/// Solution flux at a batch of interface points.
+/** Structure-of-arrays version of evaluate_solution_flux(), where @p soln_int[istate][ipoint]
+ *  and @p normal_int[idim][ipoint]. The default implementation calls evaluate_solution_flux()
+ *  at every point.
+ */
+virtual void evaluate_solution_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &soln_flux) const;
+
+/// Auxiliary flux at a batch of interface points.
+/** Structure-of-arrays version of evaluate_auxiliary_flux(), where @p soln_grad_int[istate][idim][ipoint].
+ *  The default implementation calls evaluate_auxiliary_flux() at every point.
+ */
+virtual void evaluate_auxiliary_flux_batch (
+    const real artificial_diss_coeff_int,
+    const real artificial_diss_coeff_ext,
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_int,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    const real &penalty,
+    std::array<std::vector<real>, nstate> &auxiliary_flux_dot_n) const;
+
 // dealii::Tensor<1,dim, dealii::Tensor<1,nstate,real>> diffusion_matrix_int;
 // dealii::Tensor<1,dim, dealii::Tensor<1,nstate,real>> diffusion_matrix_int_transpose;
 // dealii::Tensor<1,dim, dealii::Tensor<1,nstate,real>> diffusion_matrix_ext;
@@ -76,6 +102,27 @@ std::array<real, nstate> evaluate_auxiliary_flux (
     const dealii::Tensor<1,dim,real> &normal_int,
     const real &penalty,
     const bool on_boundary = false) const;
+
+/// Evaluate solution flux at a batch of interface points.
+void evaluate_solution_flux_batch (
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    std::array<std::vector<real>, nstate> &soln_flux) const override;
+
+/// Evaluate auxiliary flux at a batch of interior face points.
+/** The physical dissipative fluxes are evaluated through the batched physics functions.
+ */
+void evaluate_auxiliary_flux_batch (
+    const real artificial_diss_coeff_int,
+    const real artificial_diss_coeff_ext,
+    const std::array<std::vector<real>, nstate> &soln_int,
+    const std::array<std::vector<real>, nstate> &soln_ext,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_int,
+    const std::array<std::array<std::vector<real>, dim>, nstate> &soln_grad_ext,
+    const std::array<std::vector<real>, dim> &normal_int,
+    const real &penalty,
+    std::array<std::vector<real>, nstate> &auxiliary_flux_dot_n) const override;
     
 protected:
 const std::shared_ptr < Physics::PhysicsBase<dim, nstate, real> > pde_physics; ///< Associated physics.
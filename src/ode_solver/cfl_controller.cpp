@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cmath>
+
+#include <deal.II/base/exceptions.h>
+
+#include "cfl_controller.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+std::unique_ptr<CFLController> CFLController::create (const Parameters::ODESolverParam &ode_param)
+{
+    using CFLControllerEnum = Parameters::ODESolverParam::CFLControllerEnum;
+    if (ode_param.cfl_controller == CFLControllerEnum::residual_ramp) {
+        return std::make_unique<ResidualRampCFLController>(ode_param);
+    } else if (ode_param.cfl_controller == CFLControllerEnum::ser) {
+        return std::make_unique<SERCFLController>(ode_param);
+    } else if (ode_param.cfl_controller == CFLControllerEnum::exponential) {
+        return std::make_unique<ExponentialCFLController>(ode_param);
+    }
+    AssertThrow(false, dealii::ExcMessage("Unknown CFL controller."));
+    return nullptr;
+}
+
+CFLController::CFLController (const Parameters::ODESolverParam &ode_param)
+    : initial_cfl(ode_param.initial_time_step)
+    , max_cfl(std::max(ode_param.max_cfl, ode_param.initial_time_step))
+    , reduction_factor(ode_param.cfl_reduction_factor)
+    , cfl(initial_cfl)
+    , initial_residual_norm(1.0)
+    , previous_residual_norm(1.0)
+{}
+
+void CFLController::initialize (const double initial_residual_norm_input)
+{
+    cfl = initial_cfl;
+    initial_residual_norm = initial_residual_norm_input;
+    previous_residual_norm = initial_residual_norm_input;
+}
+
+double CFLController::current_cfl () const
+{
+    return cfl;
+}
+
+void CFLController::update (const double residual_norm)
+{
+    cfl = std::min(grow_cfl(residual_norm), max_cfl);
+    previous_residual_norm = residual_norm;
+}
+
+void CFLController::reject ()
+{
+    reduce_cfl();
+}
+
+void CFLController::reduce_cfl ()
+{
+    cfl *= reduction_factor;
+}
+
+ResidualRampCFLController::ResidualRampCFLController (const Parameters::ODESolverParam &ode_param)
+    : CFLController(ode_param)
+    , factor(ode_param.time_step_factor_residual)
+    , exponent(ode_param.time_step_factor_residual_exp)
+    , ramp_scaling(1.0)
+{}
+
+void ResidualRampCFLController::initialize (const double initial_residual_norm_input)
+{
+    CFLController::initialize(initial_residual_norm_input);
+    ramp_scaling = 1.0;
+}
+
+double ResidualRampCFLController::grow_cfl (const double residual_norm) const
+{
+    const double residual_norm_decrease = residual_norm / initial_residual_norm;
+    double ramped_cfl = initial_cfl;
+    if (residual_norm_decrease < 1.0) {
+        ramped_cfl *= std::pow((1.0-std::log10(residual_norm_decrease)*factor), exponent);
+    }
+    return ramp_scaling * std::max(ramped_cfl, initial_cfl);
+}
+
+void ResidualRampCFLController::reduce_cfl ()
+{
+    CFLController::reduce_cfl();
+    ramp_scaling *= reduction_factor;
+}
+
+SERCFLController::SERCFLController (const Parameters::ODESolverParam &ode_param)
+    : CFLController(ode_param)
+    , exponent(ode_param.ser_exponent)
+{}
+
+double SERCFLController::grow_cfl (const double residual_norm) const
+{
+    if (residual_norm <= 0.0) return max_cfl;
+    return cfl * std::pow(previous_residual_norm / residual_norm, exponent);
+}
+
+ExponentialCFLController::ExponentialCFLController (const Parameters::ODESolverParam &ode_param)
+    : CFLController(ode_param)
+    , growth_factor(ode_param.cfl_growth_factor)
+{}
+
+double ExponentialCFLController::grow_cfl (const double /*residual_norm*/) const
+{
+    return cfl * growth_factor;
+}
+
+} // ODE namespace
+} // PHiLiP namespace
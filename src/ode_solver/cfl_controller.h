@@ -0,0 +1,112 @@
+#ifndef __CFL_CONTROLLER_H__
+#define __CFL_CONTROLLER_H__
+
+#include <memory>
+
+#include "parameters/parameters_ode_solver.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+/// Policy choosing the pseudo-time step, or CFL, of ODESolver::steady_state().
+/** The CFL starts from the initial_time_step and is updated after every steady iteration.
+ *  Accepted iterations grow it according to the derived policy, bounded by max_cfl,
+ *  while iterations rejected by the linesearch only multiply it by the cfl_reduction_factor.
+ */
+class CFLController
+{
+public:
+    /// Creates the policy selected by ODESolverParam::cfl_controller.
+    static std::unique_ptr<CFLController> create (const Parameters::ODESolverParam &ode_param);
+
+    virtual ~CFLController() = default; ///< Destructor.
+
+    /// Restarts from the initial_time_step given the residual norm of the initial solution.
+    virtual void initialize (const double initial_residual_norm);
+
+    /// CFL of the next steady iteration.
+    double current_cfl () const;
+
+    /// Grows the CFL given the residual norm after an accepted iteration.
+    void update (const double residual_norm);
+
+    /// Reduces the CFL after an iteration rejected by the linesearch.
+    /** The residual norm of the rejected iteration is not used by the policies.
+     */
+    void reject ();
+
+protected:
+    /// Constructor.
+    explicit CFLController (const Parameters::ODESolverParam &ode_param);
+
+    /// CFL proposed by the policy after an accepted iteration, before being bounded by max_cfl.
+    virtual double grow_cfl (const double residual_norm) const = 0;
+
+    /// Reduces the CFL after a rejected iteration.
+    virtual void reduce_cfl ();
+
+    const double initial_cfl; ///< Initial CFL.
+    const double max_cfl; ///< Upper bound on the CFL.
+    const double reduction_factor; ///< Reduction of the CFL after a rejected iteration.
+
+    double cfl; ///< CFL of the next iteration.
+    double initial_residual_norm; ///< Residual norm of the initial solution.
+    double previous_residual_norm; ///< Residual norm before the last accepted iteration.
+};
+
+/// Ramp of the CFL on the residual decrease.
+/** \f[
+ *      \mathrm{CFL} = \mathrm{CFL}_0 \left(1 - c \log_{10}\frac{\|\mathbf{R}\|}{\|\mathbf{R}_0\|}\right)^{e}
+ *  \f]
+ *  where \f$ c \f$ is the time_step_factor_residual and \f$ e \f$ its time_step_factor_residual_exp.
+ *  Since the ramp only depends on the residual, rejected iterations scale all subsequent CFLs.
+ */
+class ResidualRampCFLController : public CFLController
+{
+public:
+    /// Constructor.
+    explicit ResidualRampCFLController (const Parameters::ODESolverParam &ode_param);
+    /// Also discards the reductions of the previous solve.
+    void initialize (const double initial_residual_norm) override;
+protected:
+    double grow_cfl (const double residual_norm) const override;
+    void reduce_cfl () override;
+
+    const double factor; ///< time_step_factor_residual.
+    const double exponent; ///< time_step_factor_residual_exp.
+    double ramp_scaling; ///< Product of the reductions of the rejected iterations.
+};
+
+/// Switched evolution relaxation of Mulder and van Leer.
+/** \f[
+ *      \mathrm{CFL}^{n+1} = \mathrm{CFL}^{n} \left(\frac{\|\mathbf{R}^{n}\|}{\|\mathbf{R}^{n+1}\|}\right)^{e}
+ *  \f]
+ *  where \f$ e \f$ is the ser_exponent, such that the CFL also decreases when the residual grows.
+ */
+class SERCFLController : public CFLController
+{
+public:
+    /// Constructor.
+    explicit SERCFLController (const Parameters::ODESolverParam &ode_param);
+protected:
+    double grow_cfl (const double residual_norm) const override;
+
+    const double exponent; ///< ser_exponent.
+};
+
+/// Geometric progression of the CFL by the cfl_growth_factor.
+class ExponentialCFLController : public CFLController
+{
+public:
+    /// Constructor.
+    explicit ExponentialCFLController (const Parameters::ODESolverParam &ode_param);
+protected:
+    double grow_cfl (const double residual_norm) const override;
+
+    const double growth_factor; ///< cfl_growth_factor.
+};
+
+} // ODE namespace
+} // PHiLiP namespace
+
+#endif
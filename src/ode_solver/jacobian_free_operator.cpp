@@ -0,0 +1,74 @@
+#include <cmath>
+#include <limits>
+
+#include "jacobian_free_operator.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+template <int dim, typename real>
+JacobianFreeOperator<dim,real>::JacobianFreeOperator(std::shared_ptr<DGBase<dim,real>> dg_input, const double perturbation_input)
+    : dg(dg_input)
+    , perturbation(perturbation_input)
+    , dt(1.0)
+    , pseudotime(false)
+    , solution_linearization_norm(0.0)
+    , n_residual_evaluations_since_reinit(0)
+{}
+
+template <int dim, typename real>
+void JacobianFreeOperator<dim,real>::reinit(const double dt_input, const bool pseudotime_input)
+{
+    dt = dt_input;
+    pseudotime = pseudotime_input;
+
+    solution_linearization = dg->solution;
+    residual_linearization = dg->right_hand_side;
+    solution_linearization_norm = solution_linearization.l2_norm();
+
+    n_residual_evaluations_since_reinit = 0;
+}
+
+template <int dim, typename real>
+void JacobianFreeOperator<dim,real>::vmult(VectorType &dst, const VectorType &src) const
+{
+    const double src_norm = src.l2_norm();
+    if (src_norm == 0.0) {
+        dst = 0.0;
+        return;
+    }
+
+    double epsilon = perturbation;
+    if (epsilon == 0.0) {
+        epsilon = std::sqrt(std::numeric_limits<double>::epsilon()) * (1.0 + solution_linearization_norm) / src_norm;
+    }
+
+    dg->solution = solution_linearization;
+    dg->solution.add(epsilon, src);
+    dg->assemble_residual ();
+    ++n_residual_evaluations_since_reinit;
+
+    if (pseudotime) {
+        dg->time_scaled_mass_matrix_vmult(dst, src);
+    } else {
+        dg->global_mass_matrix.vmult(dst, src);
+        dst *= 1.0/dt;
+    }
+    // dst = M/dt*v - (R(w+eps*v) - R(w)) / eps
+    dst.add(-1.0/epsilon, dg->right_hand_side, 1.0/epsilon, residual_linearization);
+
+    dg->solution = solution_linearization;
+    dg->right_hand_side = residual_linearization;
+    dg->invalidate_residual();
+}
+
+template <int dim, typename real>
+unsigned int JacobianFreeOperator<dim,real>::n_residual_evaluations() const
+{
+    return n_residual_evaluations_since_reinit;
+}
+
+template class JacobianFreeOperator<PHILIP_DIM, double>;
+
+} // ODE namespace
+} // PHiLiP namespace
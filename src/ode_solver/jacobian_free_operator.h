@@ -0,0 +1,73 @@
+#ifndef __JACOBIAN_FREE_OPERATOR_H__
+#define __JACOBIAN_FREE_OPERATOR_H__
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "dg/dg.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+/// Linearized implicit operator applied without assembling the Jacobian.
+/** Represents the operator of the backward-Euler linear system
+ *  \f[
+ *      \mathbf{A}\mathbf{v} = \frac{\mathbf{M}}{\Delta t}\mathbf{v}
+ *          - \left. \frac{\partial \mathbf{R}}{\partial \mathbf{w}} \right|_{\mathbf{w}^{n}} \mathbf{v}
+ *  \f]
+ *  where the Jacobian-vector product is approximated by a first-order finite difference of the residual
+ *  \f[
+ *      \frac{\partial \mathbf{R}}{\partial \mathbf{w}} \mathbf{v}
+ *          \approx \frac{\mathbf{R}(\mathbf{w}^{n}+\epsilon\mathbf{v}) - \mathbf{R}(\mathbf{w}^{n})}{\epsilon}.
+ *  \f]
+ *  Each product costs one residual evaluation, and only vectors need to be stored.
+ */
+template <int dim, typename real>
+class JacobianFreeOperator
+{
+public:
+    /// Vector type of the DG solution and residual.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Constructor.
+    /** A @p perturbation_input of 0 uses the finite difference step
+     *  \f$ \epsilon = \sqrt{\epsilon_{machine}} (1 + \|\mathbf{w}\|) / \|\mathbf{v}\| \f$.
+     */
+    JacobianFreeOperator(std::shared_ptr<DGBase<dim,real>> dg_input, const double perturbation_input);
+
+    /// Stores the current DG solution and right-hand side as the linearization point.
+    /** If @p pseudotime is true, the mass matrices are scaled by the local time steps through
+     *  DGBase::time_scaled_mass_matrices(), which must be evaluated beforehand.
+     *  Otherwise, they are scaled by 1/dt.
+     */
+    void reinit(const double dt_input, const bool pseudotime_input);
+
+    /// Applies the linearized operator to @p src.
+    /** The DG solution and right-hand side are restored to the linearization point afterwards.
+     */
+    void vmult(VectorType &dst, const VectorType &src) const;
+
+    /// Number of residual evaluations performed by vmult() since the last reinit().
+    unsigned int n_residual_evaluations() const;
+
+private:
+    /// Smart pointer to DGBase used to evaluate the residual.
+    std::shared_ptr<DGBase<dim,real>> dg;
+
+    /// User-specified finite difference step. Computed at every product if 0.
+    const double perturbation;
+
+    double dt; ///< Time step scaling the mass matrices.
+    bool pseudotime; ///< Use the local time steps to scale the mass matrices.
+
+    VectorType solution_linearization; ///< Solution at which the Jacobian is applied.
+    VectorType residual_linearization; ///< Residual at the linearization point.
+    double solution_linearization_norm; ///< L2-norm of the solution_linearization.
+
+    /// Number of residual evaluations performed since the last reinit().
+    mutable unsigned int n_residual_evaluations_since_reinit;
+};
+
+} // ODE namespace
+} // PHiLiP namespace
+
+#endif
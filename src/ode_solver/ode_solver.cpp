@@ -1,8 +1,21 @@
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include <deal.II/base/utilities.h>
+
 #include <deal.II/distributed/solution_transfer.h>
 
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+
 #include "ode_solver.h"
+#include "cfl_controller.h"
 
 #include "linear_solver/linear_solver.h"
+#include "linear_solver/cell_block_preconditioner.h"
+
+#include "global_counter.hpp"
 
 namespace PHiLiP {
 namespace ODE {
@@ -12,6 +25,10 @@ double global_step = 1.0;
 template <int dim, typename real>
 ODESolver<dim,real>::ODESolver(std::shared_ptr< DGBase<dim, real> > dg_input)
     : current_time(0.0)
+    , local_error_norm(0.0)
+    , local_error_order(0)
+    , pseudotime_step_length(1.0)
+    , n_linear_iterations(0)
     , dg(dg_input)
     , all_parameters(dg->all_parameters)
     , mpi_communicator(MPI_COMM_WORLD)
@@ -67,7 +84,11 @@ int ODESolver<dim,real>::steady_state ()
     }
     Parameters::ODESolverParam ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
     pcout << " Performing steady state analysis... " << std::endl;
+    const auto start_time = std::chrono::steady_clock::now();
+    const unsigned int dRdW_form_start = dRdW_form, dRdW_reuse_start = dRdW_reuse;
+    const unsigned int preconditioner_setup_start = preconditioner_setup, preconditioner_reuse_start = preconditioner_reuse;
     allocate_ode_system ();
+    n_linear_iterations = 0;
 
     this->residual_norm_decrease = 1; // Always do at least 1 iteration
     update_norm = 1; // Always do at least 1 iteration
@@ -83,8 +104,10 @@ int ODESolver<dim,real>::steady_state ()
           << " Initial absolute residual norm: " << this->residual_norm
           << std::endl;
 
-    // Initial Courant-Friedrichs-Lax number
-    double initial_CFL = all_parameters->ode_solver_param.initial_time_step;
+    // Courant-Friedrichs-Lax number
+    const double initial_CFL = all_parameters->ode_solver_param.initial_time_step;
+    std::unique_ptr<CFLController> cfl_controller = CFLController::create(ode_param);
+    cfl_controller->initialize(initial_residual_norm);
 
     double old_residual_norm = this->residual_norm; (void) old_residual_norm;
     // Output initial solution
@@ -113,17 +136,14 @@ int ODESolver<dim,real>::steady_state ()
             pcout << " Evaluating right-hand side and setting system_matrix to Jacobian... " << std::endl;
         }
 
-        double ramped_CFL = initial_CFL;
-        if (this->residual_norm_decrease < 1.0) {
-            ramped_CFL *= pow((1.0-std::log10(this->residual_norm_decrease)*ode_param.time_step_factor_residual), ode_param.time_step_factor_residual_exp);
-        }
-        ramped_CFL = std::max(ramped_CFL,initial_CFL);
-        pcout << "Initial CFL = " << initial_CFL << ". Current CFL = " << ramped_CFL << std::endl;
-
+        const double current_CFL = cfl_controller->current_cfl();
+        pcout << "Initial CFL = " << initial_CFL << ". Current CFL = " << current_CFL << std::endl;
 
+        pseudotime_step_length = 1.0;
         const bool pseudotime = true;
-        step_in_time(ramped_CFL, pseudotime);
+        step_in_time(current_CFL, pseudotime);
 
+        // Skipped by the DG if the linesearch already evaluated the residual of the accepted solution.
         this->dg->assemble_residual ();
 
         ++(this->current_iteration);
@@ -148,8 +168,28 @@ int ODESolver<dim,real>::steady_state ()
         old_residual_norm = this->residual_norm;
         this->residual_norm = this->dg->get_residual_l2norm();
         this->residual_norm_decrease = this->residual_norm / this->initial_residual_norm;
+        // Only the accepted iterations grow the CFL.
+        if (pseudotime_step_length == 0.0) {
+            cfl_controller->reject();
+        } else {
+            cfl_controller->update(this->residual_norm);
+        }
     }
 
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    const double wall_time = dealii::Utilities::MPI::max(elapsed.count(), mpi_communicator);
+
+    // VmHWM is the peak resident memory in kB.
+    dealii::Utilities::System::MemoryStats memory_stats;
+    dealii::Utilities::System::get_memory_stats(memory_stats);
+    const double peak_memory_MB = dealii::Utilities::MPI::max(memory_stats.VmHWM / 1024.0, mpi_communicator);
+    const double system_matrix_bytes = this->all_parameters->use_block_sparse_system_matrix
+                                       ? this->dg->block_system_matrix.memory_consumption()
+                                       : this->dg->system_matrix.memory_consumption();
+    const double system_matrix_MB = dealii::Utilities::MPI::sum(system_matrix_bytes / (1024.0*1024.0), mpi_communicator);
+
+    pcout.set_condition(dealii::Utilities::MPI::this_mpi_process(mpi_communicator) == 0);
+
     pcout << " ********************************************************** "
           << std::endl
           << " ODESolver steady_state stopped at"
@@ -157,6 +197,18 @@ int ODESolver<dim,real>::steady_state ()
           << " Nonlinear iteration: " << this->current_iteration
           << " residual norm: " << this->residual_norm
           << std::endl
+          << " Wall time: " << wall_time << "s"
+          << " Peak memory per process: " << peak_memory_MB << "MB"
+          << " System matrix memory: " << system_matrix_MB << "MB"
+          << (ode_param.jacobian_free_newton_krylov ? " (diagonal blocks only)" : "")
+          << std::endl
+          << " Linear iterations: " << n_linear_iterations
+          << std::endl
+          << " Jacobian assemblies: " << dRdW_form - dRdW_form_start
+          << " reuses: " << dRdW_reuse - dRdW_reuse_start
+          << " Preconditioner setups: " << preconditioner_setup - preconditioner_setup_start
+          << " reuses: " << preconditioner_reuse - preconditioner_reuse_start
+          << std::endl
           << " ********************************************************** "
           << std::endl;
 
@@ -167,34 +219,53 @@ template <int dim, typename real>
 int ODESolver<dim,real>::advance_solution_time (double time_advance)
 {
     Parameters::ODESolverParam ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
+    using TimeStepControlEnum = Parameters::ODESolverParam::TimeStepControlEnum;
+    const bool adaptive_time_step = (ode_param.time_step_control != TimeStepControlEnum::constant_time_step);
+    const bool error_control = (ode_param.time_step_control == TimeStepControlEnum::embedded_error);
 
-    const unsigned int number_of_time_steps = static_cast<int>(ceil(time_advance/ode_param.initial_time_step));
-    const double constant_time_step = time_advance/number_of_time_steps;
+    const unsigned int number_of_time_steps = adaptive_time_step ? 0 : static_cast<int>(ceil(time_advance/ode_param.initial_time_step));
+    const double constant_time_step = adaptive_time_step ? 0.0 : time_advance/number_of_time_steps;
+    const double final_time = this->current_time + time_advance;
 
     if (!valid_initial_conditions())
     {
         std::abort();
     }
 
-    pcout
-        << " Advancing solution by " << time_advance << " time units, using "
-        << number_of_time_steps << " iterations of size dt=" << constant_time_step << " ... " << std::endl;
+    if (adaptive_time_step) {
+        pcout
+            << " Advancing solution by " << time_advance << " time units, using "
+            << (error_control ? "error controlled" : "CFL based") << " time steps ... " << std::endl;
+    } else {
+        pcout
+            << " Advancing solution by " << time_advance << " time units, using "
+            << number_of_time_steps << " iterations of size dt=" << constant_time_step << " ... " << std::endl;
+    }
     allocate_ode_system ();
+    AssertThrow(!error_control || local_error_order > 0,
+                dealii::ExcMessage("The embedded_error time_step_control requires the explicit ODE solver."));
 
     this->current_iteration = 0;
+    unsigned int n_rejected_steps = 0;
+
+    // Proposed by the PI controller, and bounded by the CFL time step.
+    double error_time_step = std::numeric_limits<double>::max();
+    double previous_error = 1.0;
+    dealii::LinearAlgebra::distributed::Vector<double> solution_before_step;
 
     // Output initial solution
     this->dg->output_results_vtk(this->current_iteration);
 
-    while (this->current_iteration < number_of_time_steps)
+    while (adaptive_time_step ? (final_time - this->current_time > 1e-12 * time_advance)
+                              : (this->current_iteration < number_of_time_steps))
     {
         if ((ode_param.ode_output) == Parameters::OutputEnum::verbose &&
             (this->current_iteration%ode_param.print_iteration_modulo) == 0 ) {
         pcout << " ********************************************************** "
               << std::endl
-              << " Iteration: " << this->current_iteration + 1
-              << " out of: " << number_of_time_steps
-              << std::endl;
+              << " Iteration: " << this->current_iteration + 1;
+        if (!adaptive_time_step) pcout << " out of: " << number_of_time_steps;
+        pcout << std::endl;
     }
         dg->assemble_residual(false);
 
@@ -203,9 +274,36 @@ int ODESolver<dim,real>::advance_solution_time (double time_advance)
         pcout << " Evaluating right-hand side and setting system_matrix to Jacobian... " << std::endl;
     }
 
-    const bool pseudotime = false;
-    step_in_time(constant_time_step, pseudotime);
+    double time_step = constant_time_step;
+    if (adaptive_time_step) {
+        // The stable time steps of the cells have been updated by assemble_residual.
+        const double cfl_time_step = ode_param.time_step_cfl * dg->get_global_min_max_dt_cell() * cfl_time_step_multiplier();
+        time_step = error_control ? std::min(error_time_step, cfl_time_step) : cfl_time_step;
+        time_step = std::min(time_step, final_time - this->current_time);
+        pcout << " Time: " << this->current_time << " dt=" << time_step << std::endl;
+    }
+    if (error_control) solution_before_step = this->dg->solution;
 
+    const bool pseudotime = false;
+    step_in_time(time_step, pseudotime);
+
+    if (error_control) {
+        // PI controller of Gustafsson, with the gains recommended by Hairer and Wanner.
+        const double safety_factor = 0.9;
+        const double error = std::max(local_error_norm, 1e-10);
+        const double k = local_error_order;
+        if (local_error_norm > 1.0) {
+            this->dg->solution = solution_before_step;
+            this->current_time -= time_step;
+            error_time_step = time_step * std::max(0.2, safety_factor * std::pow(error, -1.0/k));
+            ++n_rejected_steps;
+            pcout << " Rejected time step with scaled error estimate " << local_error_norm << std::endl;
+            continue;
+        }
+        const double factor = safety_factor * std::pow(error, -0.7/k) * std::pow(previous_error, 0.4/k);
+        error_time_step = time_step * std::min(5.0, std::max(0.2, factor));
+        previous_error = error;
+    }
 
     if (this->current_iteration%ode_param.print_iteration_modulo == 0) {
         this->dg->output_results_vtk(this->current_iteration);
@@ -215,52 +313,325 @@ int ODESolver<dim,real>::advance_solution_time (double time_advance)
 
         //this->dg->output_results_vtk(this->current_iteration);
     }
+    if (adaptive_time_step) {
+        pcout << " Reached time " << this->current_time << " after " << this->current_iteration << " time steps";
+        if (error_control) pcout << " and " << n_rejected_steps << " rejected time steps";
+        pcout << "." << std::endl;
+    }
     return 1;
 }
 
+template <int dim, typename real>
+Implicit_ODESolver<dim,real>::Implicit_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input)
+    : ODESolver<dim,real>::ODESolver(dg_input)
+    , dirk_tableau(DiagonallyImplicitRungeKuttaTableau::create(
+        dg_input->all_parameters->ode_solver_param.implicit_time_integration == Parameters::ODESolverParam::ImplicitTimeIntegrationEnum::bdf2
+        ? Parameters::ODESolverParam::ImplicitTimeIntegrationEnum::backward_euler
+        : dg_input->all_parameters->ode_solver_param.implicit_time_integration))
+    , lagged_jacobian_is_valid(false)
+    , lagged_jacobian_mass_scaling(0.0)
+    , lagged_jacobian_age(0)
+    , n_jacobian_assemblies(0)
+    , jacobian_uses(0)
+    , preconditioner_uses(0)
+    , reference_linear_iterations(0)
+    , previous_time_step(0.0)
+{}
+
 template <int dim, typename real>
 void Implicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
 {
-    const bool compute_dRdW = true;
-    this->dg->assemble_residual(compute_dRdW);
+    if (!pseudotime) {
+        time_accurate_step(dt);
+        return;
+    }
+
+    Parameters::ODESolverParam ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
+    lagged_jacobian_is_valid = false;
+
+    const bool reuse_jacobian = (jacobian_uses > 0 && jacobian_uses < ode_param.jacobian_reuse_iterations);
+    if (reuse_jacobian) {
+        // The system_matrix keeps the time-scaled mass matrices of its assembly.
+        this->dg->assemble_residual ();
+        ++dRdW_reuse;
+    } else {
+        const bool compute_dRdW = true;
+        this->dg->assemble_residual(compute_dRdW);
+        jacobian_uses = 0;
+    }
+    ++jacobian_uses;
     this->current_time += dt;
     // Solve (M/dt - dRdW) dw = R
     // w = w + dw
-    Parameters::ODESolverParam ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
 
-    this->dg->system_matrix *= -1.0;
+    if (!reuse_jacobian) {
+        const bool use_block_sparse_system_matrix = ODESolver<dim,real>::all_parameters->use_block_sparse_system_matrix;
+        if (use_block_sparse_system_matrix) {
+            this->dg->block_system_matrix *= -1.0;
+        } else {
+            this->dg->system_matrix *= -1.0;
+        }
+        this->dg->invalidate_dRdW();
 
-    if (pseudotime) {
         const double CFL = dt;
         this->dg->time_scaled_mass_matrices(CFL);
         this->dg->add_time_scaled_mass_matrices();
-    } else { 
-        this->dg->add_mass_matrices(1.0/dt);
+        // The preconditioner may be reused for the new system_matrix.
+        reusable_preconditioner.recycled_subspace.invalidate_products();
     }
-    //(void) pseudotime;
-    //this->dg->add_mass_matrices(1.0/dt);
 
     if ((ode_param.ode_output) == Parameters::OutputEnum::verbose &&
         (this->current_iteration%ode_param.print_iteration_modulo) == 0 ) {
         pcout << " Evaluating system update... " << std::endl;
     }
 
-    solve_linear (
-        this->dg->system_matrix,
-        this->dg->right_hand_side,
-        this->solution_update,
-        this->ODESolver<dim,real>::all_parameters->linear_solver_param);
+    // An unchanged system_matrix always reuses its preconditioner.
+    reusable_preconditioner.reuse = preconditioner_uses > 0
+                                    && (reuse_jacobian || preconditioner_uses < ode_param.preconditioner_reuse_iterations);
+    const unsigned int linear_iterations = solve_linearized_system(this->dg->right_hand_side, dt, pseudotime);
+    this->n_linear_iterations += linear_iterations;
+    if (!reusable_preconditioner.reuse) {
+        reference_linear_iterations = linear_iterations;
+        preconditioner_uses = 0;
+    }
+    ++preconditioner_uses;
+
+    const double linear_iterations_growth = static_cast<double>(linear_iterations) / std::max(reference_linear_iterations, 1u);
+    if (linear_iterations_growth > ode_param.reuse_linear_iterations_growth) {
+        pcout << " Linear iterations grew from " << reference_linear_iterations << " to " << linear_iterations
+              << ". Refreshing the Jacobian and preconditioner at the next iteration." << std::endl;
+        jacobian_uses = 0;
+        preconditioner_uses = 0;
+    }
 
     //this->dg->solution += this->solution_update;
     global_step = linesearch();
+    this->pseudotime_step_length = global_step;
+    if (global_step == 0.0) {
+        // The system_matrix of the rejected iteration does not use the reduced CFL.
+        jacobian_uses = 0;
+        preconditioner_uses = 0;
+    }
+
+    this->update_norm = this->solution_update.l2_norm();
+}
+
+template <int dim, typename real>
+void Implicit_ODESolver<dim,real>::time_accurate_step (const double dt)
+{
+    const Parameters::ODESolverParam &ode_param = this->all_parameters->ode_solver_param;
+    using ImplicitEnum = Parameters::ODESolverParam::ImplicitTimeIntegrationEnum;
+
+    if (lagged_jacobian_age >= ode_param.jacobian_lagging_max_age) lagged_jacobian_is_valid = false;
+
+    initial_solution = this->dg->solution;
+    VectorType explicit_residual;
+    explicit_residual.reinit(this->dg->right_hand_side);
+
+    if (ode_param.implicit_time_integration == ImplicitEnum::bdf2 && previous_time_step > 0.0) {
+        // Variable step BDF2, M (w^{n+1} - w_base) = dt (1+r)/(1+2r) R(w^{n+1}),
+        // where r is the ratio between the current and previous time steps.
+        const double r = dt / previous_time_step;
+        VectorType base_solution = initial_solution;
+        base_solution.sadd((1.0+r)*(1.0+r)/(1.0+2.0*r), -r*r/(1.0+2.0*r), previous_solution);
+        solve_implicit_stage(dt*(1.0+r)/(1.0+2.0*r), base_solution, explicit_residual);
+    } else {
+        const unsigned int n_stages = dirk_tableau.n_stages();
+        const double gamma = dirk_tableau.diagonal();
+        unsigned int first_implicit_stage = 0;
+        if (dirk_tableau.explicit_first_stage()) {
+            this->dg->assemble_residual ();
+            stage_residuals[0] = this->dg->right_hand_side;
+            first_implicit_stage = 1;
+        }
+        for (unsigned int istage = first_implicit_stage; istage < n_stages; ++istage) {
+            // The previous stage is the initial guess of the current one.
+            explicit_residual = 0.0;
+            for (unsigned int jstage = 0; jstage < istage; ++jstage) {
+                if (dirk_tableau.a[istage][jstage] == 0.0) continue;
+                explicit_residual.add(dirk_tableau.a[istage][jstage] / gamma, stage_residuals[jstage]);
+            }
+            solve_implicit_stage(gamma*dt, initial_solution, explicit_residual);
+            // The method is stiffly accurate, and the last stage is the new solution.
+            if (istage < n_stages-1) stage_residuals[istage] = this->dg->right_hand_side;
+        }
+    }
+
+    if (ode_param.implicit_time_integration == ImplicitEnum::bdf2) previous_solution = initial_solution;
+    previous_time_step = dt;
+    ++lagged_jacobian_age;
 
+    this->current_time += dt;
+    this->solution_update = this->dg->solution;
+    this->solution_update -= initial_solution;
     this->update_norm = this->solution_update.l2_norm();
 }
 
+template <int dim, typename real>
+void Implicit_ODESolver<dim,real>::solve_implicit_stage (const double gamma_dt, const VectorType &base_solution, const VectorType &explicit_residual)
+{
+    const Parameters::ODESolverParam &ode_param = this->all_parameters->ode_solver_param;
+    // Newton iterations contracting the residual by less than this factor refresh the lagged Jacobian.
+    const double slow_contraction = 0.5;
+
+    VectorType stage_residual;
+    stage_residual.reinit(this->dg->right_hand_side);
+    double initial_residual_norm = 0.0;
+    double previous_residual_norm = 0.0;
+    for (unsigned int iteration = 0; ; ++iteration) {
+        // r = R(w) + E - M (w - w_base) / (gamma dt)
+        this->dg->assemble_residual ();
+        this->solution_update = this->dg->solution;
+        this->solution_update -= base_solution;
+        this->dg->global_mass_matrix.vmult(stage_residual, this->solution_update);
+        stage_residual.sadd(-1.0/gamma_dt, 1.0, this->dg->right_hand_side);
+        stage_residual += explicit_residual;
+
+        const double residual_norm = stage_residual.l2_norm();
+        if (iteration == 0) initial_residual_norm = residual_norm;
+        if (ode_param.ode_output == Parameters::OutputEnum::verbose) {
+            pcout << " Newton iteration: " << iteration << " Stage residual norm: " << residual_norm << std::endl;
+        }
+
+        if (residual_norm <= ode_param.implicit_newton_tolerance * initial_residual_norm) break;
+        if (iteration == ode_param.implicit_newton_max_iterations) {
+            pcout << " Newton iterations did not converge. Stage residual was reduced from "
+                  << initial_residual_norm << " to " << residual_norm << std::endl;
+            break;
+        }
+
+        const bool stalled = (iteration > 0 && residual_norm > slow_contraction * previous_residual_norm);
+        // The preconditioner is only set up again along with the Jacobian.
+        reusable_preconditioner.reuse = lagged_jacobian_is_valid && !stalled;
+        if (!lagged_jacobian_is_valid || stalled) {
+            refresh_jacobian(gamma_dt);
+        } else {
+            ++dRdW_reuse;
+            if (lagged_jacobian_mass_scaling != 1.0/gamma_dt) {
+                // Only the time step of the lagged system_matrix changed.
+                this->dg->add_mass_matrices(1.0/gamma_dt - lagged_jacobian_mass_scaling);
+                lagged_jacobian_mass_scaling = 1.0/gamma_dt;
+                reusable_preconditioner.recycled_subspace.invalidate_products();
+            }
+        }
+
+        const bool pseudotime = false;
+        solve_linearized_system(stage_residual, gamma_dt, pseudotime);
+        this->dg->solution += this->solution_update;
+        previous_residual_norm = residual_norm;
+    }
+}
+
+template <int dim, typename real>
+void Implicit_ODESolver<dim,real>::refresh_jacobian (const double gamma_dt)
+{
+    const bool compute_dRdW = true;
+    this->dg->assemble_residual(compute_dRdW);
+    if (this->all_parameters->use_block_sparse_system_matrix) {
+        this->dg->block_system_matrix *= -1.0;
+    } else {
+        this->dg->system_matrix *= -1.0;
+    }
+    this->dg->add_mass_matrices(1.0/gamma_dt);
+    this->dg->invalidate_dRdW();
+
+    lagged_jacobian_is_valid = true;
+    lagged_jacobian_mass_scaling = 1.0/gamma_dt;
+    lagged_jacobian_age = 0;
+    ++n_jacobian_assemblies;
+    if (this->all_parameters->ode_solver_param.ode_output == Parameters::OutputEnum::verbose) {
+        pcout << " Assembled Jacobian " << n_jacobian_assemblies << " at time " << this->current_time << std::endl;
+    }
+}
+
+template <int dim, typename real>
+unsigned int Implicit_ODESolver<dim,real>::solve_linearized_system (VectorType &rhs, const double dt, const bool pseudotime)
+{
+    const bool use_block_sparse_system_matrix = this->all_parameters->use_block_sparse_system_matrix;
+    const Parameters::LinearSolverParam &linear_param = this->ODESolver<dim,real>::all_parameters->linear_solver_param;
+    if (this->all_parameters->ode_solver_param.jacobian_free_newton_krylov) {
+        // The system_matrix only contains the diagonal blocks of the operator.
+        jacobian_free_operator->reinit(dt, pseudotime);
+
+        if (reusable_preconditioner.reuse && reusable_preconditioner.cell_block_preconditioner) {
+            ++preconditioner_reuse;
+        } else {
+            ++preconditioner_setup;
+            reusable_preconditioner.clear();
+            reusable_preconditioner.cell_block_preconditioner
+                = std::make_unique<CellBlockPreconditioner>(Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi);
+            if (use_block_sparse_system_matrix) {
+                reusable_preconditioner.cell_block_preconditioner->initialize(this->dg->block_system_matrix);
+            } else {
+                reusable_preconditioner.cell_block_preconditioner->initialize(this->dg->system_matrix);
+            }
+        }
+        const CellBlockPreconditioner &preconditioner = *reusable_preconditioner.cell_block_preconditioner;
+
+        const double rhs_norm = rhs.l2_norm();
+        dealii::SolverControl solver_control(linear_param.max_iterations, linear_param.linear_residual * rhs_norm);
+        const bool right_preconditioning = true;
+        dealii::SolverGMRES<VectorType> solver(solver_control,
+            dealii::SolverGMRES<VectorType>::AdditionalData(linear_param.restart_number+2, right_preconditioning));
+
+        // Copy the right-hand side since the operator evaluates perturbed residuals in the DG object.
+        const VectorType right_hand_side = rhs;
+        this->solution_update = 0.0;
+        try {
+            solver.solve(*jacobian_free_operator, this->solution_update, right_hand_side, preconditioner);
+        } catch (dealii::SolverControl::NoConvergence &) {
+            // The linesearch, or the Newton iterations, deal with inexact updates.
+        }
+        pcout << " Jacobian-free linear solver took " << solver_control.last_step()
+              << " iterations and " << jacobian_free_operator->n_residual_evaluations()
+              << " residual evaluations resulting in a linear residual of " << solver_control.last_value() << std::endl;
+        return solver_control.last_step();
+    } else if (p_multigrid && use_block_sparse_system_matrix) {
+        return solve_linear (
+            this->dg->block_system_matrix,
+            *p_multigrid,
+            rhs,
+            this->solution_update,
+            linear_param,
+            &reusable_preconditioner).first;
+    } else if (p_multigrid) {
+        return solve_linear (
+            this->dg->system_matrix,
+            *p_multigrid,
+            rhs,
+            this->solution_update,
+            linear_param,
+            &reusable_preconditioner).first;
+    } else if (use_block_sparse_system_matrix) {
+        const bool transpose = false;
+        return solve_linear (
+            this->dg->block_system_matrix,
+            rhs,
+            this->solution_update,
+            linear_param,
+            transpose,
+            &reusable_preconditioner).first;
+    }
+    const bool transpose = false;
+    return solve_linear (
+        this->dg->system_matrix,
+        rhs,
+        this->solution_update,
+        linear_param,
+        transpose,
+        &reusable_preconditioner).first;
+}
+
 template <int dim, typename real>
 double Implicit_ODESolver<dim,real>::linesearch ()
 {
-    const auto old_solution = this->dg->solution;
+    // The solution is moved along the update by the difference between the trial and applied step lengths,
+    // such that the initial solution does not need to be copied and restored for each trial.
+    double applied_step_length = 0.0;
+    const auto apply_step_length = [&] (const double trial_step_length) {
+        this->dg->solution.add(trial_step_length - applied_step_length, this->solution_update);
+        applied_step_length = trial_step_length;
+    };
     double step_length = 1.0;
 
     const double step_reduction = 0.75;
@@ -270,7 +641,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
 
     const double initial_residual = this->dg->get_residual_l2norm();
 
-    this->dg->solution.add(step_length, this->solution_update);
+    apply_step_length(step_length);
     this->dg->assemble_residual ();
     double new_residual = this->dg->get_residual_l2norm();
     pcout << " Step length " << step_length << ". Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -278,24 +649,30 @@ double Implicit_ODESolver<dim,real>::linesearch ()
     int iline = 0;
     for (iline = 0; iline < maxline && new_residual > initial_residual * reduction_tolerance_1; ++iline) {
         step_length = step_length * step_reduction;
-        this->dg->solution = old_solution;
-        this->dg->solution.add(step_length, this->solution_update);
+        apply_step_length(step_length);
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
     }
 
+    if (iline == maxline && this->all_parameters->ode_solver_param.cfl_backtracking) {
+        pcout << " Line search failed. Rejecting the step and reducing the CFL. " << std::endl;
+        step_length = 0.0;
+        apply_step_length(step_length);
+        this->dg->assemble_residual ();
+        return step_length;
+    }
+
     if (iline == maxline) {
         step_length = 1.0;
         pcout << " Line search failed. Will accept any valid residual less than " << reduction_tolerance_2 << " times the current " << initial_residual << "residual. " << std::endl;
-        this->dg->solution.add(step_length, this->solution_update);
+        apply_step_length(step_length);
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
         for (iline = 0; iline < maxline && new_residual > initial_residual * reduction_tolerance_2 ; ++iline) {
             step_length = step_length * step_reduction;
-            this->dg->solution = old_solution;
-            this->dg->solution.add(step_length, this->solution_update);
+            apply_step_length(step_length);
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -305,28 +682,26 @@ double Implicit_ODESolver<dim,real>::linesearch ()
     if (iline == maxline) {
         pcout << " Line search failed. Trying to step in the opposite direction. " << std::endl;
         step_length = -1.0;
-        this->dg->solution.add(step_length, this->solution_update);
+        apply_step_length(step_length);
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
         for (iline = 0; iline < maxline && new_residual > initial_residual; ++iline) {
             step_length = step_length * step_reduction;
-            this->dg->solution = old_solution;
-            this->dg->solution.add(step_length, this->solution_update);
+            apply_step_length(step_length);
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
         }
         if (iline == maxline) {
             step_length = -1.0;
-            this->dg->solution.add(step_length, this->solution_update);
+            apply_step_length(step_length);
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
             for (iline = 0; iline < maxline && new_residual > initial_residual * reduction_tolerance_2 ; ++iline) {
                 step_length = step_length * step_reduction;
-                this->dg->solution = old_solution;
-                this->dg->solution.add(step_length, this->solution_update);
+                apply_step_length(step_length);
                 this->dg->assemble_residual ();
                 new_residual = this->dg->get_residual_l2norm();
                 pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -346,75 +721,56 @@ void Explicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
 {
     // this->dg->assemble_residual (); // Not needed since it is called in the base class for time step
     this->current_time += dt;
-    const int rk_order = 3;
-    if (rk_order == 1) {
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-        this->update_norm = this->solution_update.l2_norm();
-        if (pseudotime) {
-            const double CFL = dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->dg->solution.add(1.0,this->solution_update);
-        } else {
-            this->dg->solution.add(dt,this->solution_update);
-        }
-    } else if (rk_order == 3) {
-        // Stage 0
-        this->rk_stage[0] = this->dg->solution;
 
-        // Stage 1
-        pcout<< "Stage 1... " << std::flush;
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
+    dealii::LinearAlgebra::distributed::Vector<double> &initial_solution = this->rk_stage[0];
+    dealii::LinearAlgebra::distributed::Vector<double> &accumulated_stages = this->rk_stage[1];
+    dealii::LinearAlgebra::distributed::Vector<double> &increment = rk_tableau.uses_increment_register() ? this->rk_stage[2] : this->solution_update;
+    dealii::LinearAlgebra::distributed::Vector<double> &error_estimate = this->rk_stage[3];
+    const bool estimate_error = (this->local_error_order > 0);
 
-        this->rk_stage[1] = this->rk_stage[0];
-        //this->rk_stage[1].add(dt,this->solution_update);
-        if (pseudotime) {
-            const double CFL = dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[1].add(1.0,this->solution_update);
-        } else {
-            this->rk_stage[1].add(dt,this->solution_update);
-        }
+    if (rk_tableau.uses_initial_solution()) initial_solution = this->dg->solution;
+    if (rk_tableau.uses_accumulation_register()) accumulated_stages = 0.0;
+    if (estimate_error) error_estimate = 0.0;
 
-        // Stage 2
-        pcout<< "2... " << std::flush;
-        this->dg->solution = this->rk_stage[1];
-        this->dg->assemble_residual ();
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
+    pcout<< "Stage ";
+    for (unsigned int istage = 0; istage < rk_tableau.n_stages(); ++istage) {
+        pcout<< istage+1 << "... " << std::flush;
+        if (istage > 0) this->dg->assemble_residual ();
+        this->dg->inverse_mass_operator.vmult(this->solution_update, this->dg->right_hand_side);
+        if (istage == 0) this->update_norm = this->solution_update.l2_norm();
 
-        this->rk_stage[2] = this->rk_stage[0];
-        this->rk_stage[2] *= 0.75;
-        this->rk_stage[2].add(0.25, this->rk_stage[1]);
-        //this->rk_stage[2].add(0.25*dt, this->solution_update);
         if (pseudotime) {
-            const double CFL = 0.25*dt;
+            const double CFL = dt;
             this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[2].add(1.0,this->solution_update);
         } else {
-            this->rk_stage[2].add(0.25*dt,this->solution_update);
+            this->solution_update *= dt;
         }
-
-        // Stage 3
-        pcout<< "3... " << std::flush;
-        this->dg->solution = this->rk_stage[2];
-        this->dg->assemble_residual ();
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-
-        this->rk_stage[3] = this->rk_stage[0];
-        this->rk_stage[3] *= 1.0/3.0;
-        this->rk_stage[3].add(2.0/3.0, this->rk_stage[2]);
-        //this->rk_stage[3].add(2.0/3.0*dt, this->solution_update);
-        if (pseudotime) {
-            const double CFL = (2.0/3.0)*dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[3].add(1.0,this->solution_update);
-        } else {
-            this->rk_stage[3].add((2.0/3.0)*dt,this->solution_update);
+        if (estimate_error && rk_tableau.error_weights[istage] != 0.0) error_estimate.add(rk_tableau.error_weights[istage], this->solution_update);
+        if (rk_tableau.uses_increment_register()) {
+            // The first coefficient is zero, such that the register does not need to be reset.
+            if (istage == 0) increment = this->solution_update;
+            else increment.sadd(rk_tableau.A[istage], 1.0, this->solution_update);
         }
 
-        this->dg->solution = this->rk_stage[3];
-        pcout<< "done." << std::endl;
+        if (rk_tableau.delta[istage] != 0.0) accumulated_stages.add(rk_tableau.delta[istage], this->dg->solution);
+        this->dg->solution.sadd(rk_tableau.gamma1[istage], rk_tableau.B[istage], increment);
+        if (rk_tableau.gamma2[istage] != 0.0) this->dg->solution.add(rk_tableau.gamma2[istage], accumulated_stages);
+        if (rk_tableau.gamma3[istage] != 0.0) this->dg->solution.add(rk_tableau.gamma3[istage], initial_solution);
+    }
+    pcout<< "done." << std::endl;
+
+    if (estimate_error) {
+        // Root mean square of the error scaled by an absolute and relative tolerance.
+        const double tolerance = this->all_parameters->ode_solver_param.time_step_error_tolerance;
+        const unsigned int n_owned_dofs = error_estimate.locally_owned_elements().n_elements();
+        double local_sum = 0.0;
+        for (unsigned int i = 0; i < n_owned_dofs; ++i) {
+            const double scaled_error = error_estimate.local_element(i) / (tolerance * (1.0 + std::abs(this->dg->solution.local_element(i))));
+            local_sum += scaled_error * scaled_error;
+        }
+        const double sum = dealii::Utilities::MPI::sum(local_sum, this->mpi_communicator);
+        this->local_error_norm = std::sqrt(sum / error_estimate.size());
     }
-
 }
 
 template <int dim, typename real>
@@ -425,11 +781,163 @@ void Explicit_ODESolver<dim,real>::allocate_ode_system ()
     this->solution_update.reinit(this->dg->right_hand_side);
     this->dg->evaluate_mass_matrices(do_inverse_mass_matrix);
 
+    pcout << "Using the " << rk_tableau.name << " method with " << rk_tableau.n_stages() << " stages." << std::endl;
     this->rk_stage.resize(4);
-    for (int i=0; i<4; i++) {
-        this->rk_stage[i].reinit(this->dg->solution);
+    if (rk_tableau.uses_initial_solution())      this->rk_stage[0].reinit(this->dg->solution);
+    if (rk_tableau.uses_accumulation_register()) this->rk_stage[1].reinit(this->dg->solution);
+    if (rk_tableau.uses_increment_register())    this->rk_stage[2].reinit(this->dg->right_hand_side);
+
+    this->local_error_order = 0;
+    if (this->all_parameters->ode_solver_param.time_step_control == Parameters::ODESolverParam::TimeStepControlEnum::embedded_error) {
+        AssertThrow(rk_tableau.embedded_order > 0,
+                    dealii::ExcMessage("The " + rk_tableau.name + " method has no embedded error estimate."));
+        this->rk_stage[3].reinit(this->dg->right_hand_side);
+        this->local_error_order = rk_tableau.embedded_order + 1;
+    }
+}
+template <int dim, typename real>
+void LocalTimeStepping_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
+{
+    if (pseudotime) {
+        Explicit_ODESolver<dim,real>::step_in_time(dt, pseudotime);
+        return;
     }
+    this->current_time += dt;
+
+    const unsigned int n_substeps = 1u << (n_levels-1);
+    const double finest_time_step = dt / n_substeps;
+    assign_time_levels(finest_time_step);
+    this->dg->set_local_time_stepping_levels(cell_levels);
+
+    accumulated_update = 0.0;
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (unsigned int isubstep = 0; isubstep < n_substeps; ++isubstep) {
+        // Integrate the contributions of the levels that start a step.
+        for (unsigned int level = 0; level < n_levels; ++level) {
+            const unsigned int level_substeps = 1u << level;
+            if (isubstep % level_substeps != 0 || n_cells_per_level[level] == 0) continue;
+            integrate_level(level, level_substeps * finest_time_step);
+            accumulated_update += level_update;
+        }
+
+        // Advance the cells that end their step.
+        for (auto cell = this->dg->dof_handler.begin_active(); cell != this->dg->dof_handler.end(); ++cell) {
+            if (!cell->is_locally_owned()) continue;
+            if ((isubstep+1) % (1u << cell_levels[cell->active_cell_index()]) != 0) continue;
+
+            dofs_indices.resize(cell->get_fe().n_dofs_per_cell());
+            cell->get_dof_indices (dofs_indices);
+            for (const auto dof_index : dofs_indices) {
+                this->dg->solution[dof_index] += accumulated_update[dof_index];
+                accumulated_update[dof_index] = 0.0;
+            }
+        }
+    }
+    this->dg->active_local_time_stepping_level = -1;
+}
+
+template <int dim, typename real>
+void LocalTimeStepping_ODESolver<dim,real>::integrate_level (const unsigned int level, const double level_time_step)
+{
+    const LowStorageRungeKuttaTableau &rk_tableau = this->rk_tableau;
+    this->dg->active_local_time_stepping_level = level;
+
+    // The stages are written in terms of the update from the initial solution, which is zero for the frozen cells.
+    level_initial_solution = this->dg->solution;
+    level_update = 0.0;
+    dealii::LinearAlgebra::distributed::Vector<double> &accumulated_stages = this->rk_stage[1];
+    dealii::LinearAlgebra::distributed::Vector<double> &increment = rk_tableau.uses_increment_register() ? this->rk_stage[2] : this->solution_update;
+    if (rk_tableau.uses_accumulation_register()) accumulated_stages = 0.0;
+
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (unsigned int istage = 0; istage < rk_tableau.n_stages(); ++istage) {
+        if (istage > 0) {
+            // Only the cells of this level are moved to the stage value.
+            for (auto cell = this->dg->dof_handler.begin_active(); cell != this->dg->dof_handler.end(); ++cell) {
+                if (!cell->is_locally_owned() || cell_levels[cell->active_cell_index()] != level) continue;
+
+                dofs_indices.resize(cell->get_fe().n_dofs_per_cell());
+                cell->get_dof_indices (dofs_indices);
+                for (const auto dof_index : dofs_indices) {
+                    this->dg->solution[dof_index] = level_initial_solution[dof_index] + level_update[dof_index];
+                }
+            }
+        }
+        this->dg->assemble_residual ();
+        this->dg->inverse_mass_operator.vmult(this->solution_update, this->dg->right_hand_side);
+        this->solution_update *= level_time_step;
+        if (rk_tableau.uses_increment_register()) {
+            // The first coefficient is zero, such that the register does not need to be reset.
+            if (istage == 0) increment = this->solution_update;
+            else increment.sadd(rk_tableau.A[istage], 1.0, this->solution_update);
+        }
+
+        // The initial update is zero, such that the gamma3 term vanishes.
+        if (rk_tableau.delta[istage] != 0.0) accumulated_stages.add(rk_tableau.delta[istage], level_update);
+        level_update.sadd(rk_tableau.gamma1[istage], rk_tableau.B[istage], increment);
+        if (rk_tableau.gamma2[istage] != 0.0) level_update.add(rk_tableau.gamma2[istage], accumulated_stages);
+    }
+    this->dg->solution = level_initial_solution;
 }
+
+template <int dim, typename real>
+double LocalTimeStepping_ODESolver<dim,real>::cfl_time_step_multiplier () const
+{
+    return static_cast<double>(1u << (n_levels-1));
+}
+
+template <int dim, typename real>
+void LocalTimeStepping_ODESolver<dim,real>::assign_time_levels (const double finest_time_step)
+{
+    const double cfl = this->all_parameters->ode_solver_param.time_step_cfl;
+    cell_levels.assign(this->dg->triangulation->n_active_cells(), 0);
+    std::vector<unsigned int> n_owned_cells_per_level(n_levels, 0);
+    for (auto cell = this->dg->dof_handler.begin_active(); cell != this->dg->dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned()) continue;
+
+        const dealii::types::global_dof_index cell_index = cell->active_cell_index();
+        const double stable_time_step = cfl * this->dg->max_dt_cell[cell_index];
+        unsigned int level = 0;
+        while (level+1 < n_levels && (1u << (level+1)) * finest_time_step <= stable_time_step) ++level;
+        cell_levels[cell_index] = level;
+        ++n_owned_cells_per_level[level];
+    }
+    n_cells_per_level.resize(n_levels);
+    for (unsigned int level = 0; level < n_levels; ++level) {
+        n_cells_per_level[level] = dealii::Utilities::MPI::sum(n_owned_cells_per_level[level], this->mpi_communicator);
+    }
+
+    const Parameters::ODESolverParam &ode_param = this->all_parameters->ode_solver_param;
+    if (ode_param.ode_output == Parameters::OutputEnum::verbose && this->current_iteration % ode_param.print_iteration_modulo == 0) {
+        // Global time stepping evaluates the stages of every cell at every substep, while the local time stepping
+        // evaluates the stages of the cells of level l every 2^l substeps, plus the full residual of advance_solution_time().
+        const unsigned int n_substeps = 1u << (n_levels-1);
+        const double n_stages = this->rk_tableau.n_stages();
+        double n_cells = 0.0, local_work = 0.0;
+        pcout << " Local time stepping cells per level:";
+        for (unsigned int level = 0; level < n_levels; ++level) {
+            const double n_level_cells = n_cells_per_level[level];
+            n_cells += n_level_cells;
+            local_work += n_stages * n_level_cells * (n_substeps >> level);
+            pcout << " " << n_level_cells;
+        }
+        local_work += n_cells;
+        pcout << std::endl << " Estimated speedup over global time stepping: " << n_stages * n_cells * n_substeps / local_work << std::endl;
+    }
+}
+
+template <int dim, typename real>
+void LocalTimeStepping_ODESolver<dim,real>::allocate_ode_system ()
+{
+    Explicit_ODESolver<dim,real>::allocate_ode_system();
+    AssertThrow(this->local_error_order == 0,
+                dealii::ExcMessage("The local time stepping does not estimate the local error of its steps."));
+    pcout << "Using " << n_levels << " local time stepping levels." << std::endl;
+    accumulated_update.reinit(this->dg->right_hand_side);
+    level_update.reinit(this->dg->right_hand_side);
+    level_initial_solution.reinit(this->dg->solution);
+}
+
 template <int dim, typename real>
 void Implicit_ODESolver<dim,real>::allocate_ode_system ()
 {
@@ -439,6 +947,26 @@ void Implicit_ODESolver<dim,real>::allocate_ode_system ()
 
     this->solution_update.reinit(this->dg->right_hand_side);
 
+    lagged_jacobian_is_valid = false;
+    n_jacobian_assemblies = 0;
+    previous_time_step = 0.0;
+    // The sparsity pattern, and the system_matrix object, may have changed.
+    reusable_preconditioner.clear();
+    jacobian_uses = 0;
+    preconditioner_uses = 0;
+    stage_residuals.resize(dirk_tableau.n_stages()-1);
+    for (auto &stage_residual : stage_residuals) {
+        stage_residual.reinit(this->dg->right_hand_side);
+    }
+
+    if (this->all_parameters->ode_solver_param.jacobian_free_newton_krylov) {
+        jacobian_free_operator = std::make_unique<JacobianFreeOperator<dim,real>>(this->dg, this->all_parameters->ode_solver_param.jacobian_free_perturbation);
+    } else if (this->all_parameters->linear_solver_param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::gmres
+               && this->all_parameters->linear_solver_param.preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::p_multigrid) {
+        p_multigrid = std::make_unique<PMultigridPreconditioner>(this->all_parameters->linear_solver_param);
+        this->dg->setup_p_multigrid(*p_multigrid);
+        pcout << "Set up p-multigrid with " << p_multigrid->n_levels() << " levels." << std::endl;
+    }
 }
 
 //template <int dim, typename real>
@@ -459,6 +987,7 @@ std::shared_ptr<ODESolver<dim,real>> ODESolverFactory<dim,real>::create_ODESolve
     ODEEnum ode_solver_type = dg_input->all_parameters->ode_solver_param.ode_solver_type;
     if(ode_solver_type == ODEEnum::explicit_solver) return std::make_shared<Explicit_ODESolver<dim,real>>(dg_input);
     if(ode_solver_type == ODEEnum::implicit_solver) return std::make_shared<Implicit_ODESolver<dim,real>>(dg_input);
+    if(ode_solver_type == ODEEnum::explicit_local_time_stepping_solver) return std::make_shared<LocalTimeStepping_ODESolver<dim,real>>(dg_input);
     else {
         dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
         pcout << "********************************************************************" << std::endl;
@@ -467,6 +996,7 @@ std::shared_ptr<ODESolver<dim,real>> ODESolverFactory<dim,real>::create_ODESolve
         pcout << "Solver type possible: " << std::endl;
         pcout <<  ODEEnum::explicit_solver << std::endl;
         pcout <<  ODEEnum::implicit_solver << std::endl;
+        pcout <<  ODEEnum::explicit_local_time_stepping_solver << std::endl;
         pcout << "********************************************************************" << std::endl;
         std::abort();
         return nullptr;
@@ -476,6 +1006,7 @@ std::shared_ptr<ODESolver<dim,real>> ODESolverFactory<dim,real>::create_ODESolve
 template class ODESolver<PHILIP_DIM, double>;
 template class Explicit_ODESolver<PHILIP_DIM, double>;
 template class Implicit_ODESolver<PHILIP_DIM, double>;
+template class LocalTimeStepping_ODESolver<PHILIP_DIM, double>;
 template class ODESolverFactory<PHILIP_DIM, double>;
 
 } // ODE namespace
@@ -7,6 +7,10 @@
 
 #include "parameters/all_parameters.h"
 #include "dg/dg.h"
+#include "linear_solver/linear_solver.h"
+#include "linear_solver/p_multigrid_preconditioner.h"
+#include "jacobian_free_operator.h"
+#include "runge_kutta_tableau.h"
 
 
 namespace PHiLiP {
@@ -66,15 +70,38 @@ protected:
     double update_norm; ///< Norm of the solution update.
     double initial_residual_norm; ///< Initial residual norm.
 
+    /// Root mean square of the local error estimate of the last time step, scaled by the error tolerance.
+    /** Only evaluated by the Explicit_ODESolver when the time_step_control is embedded_error.
+     */
+    double local_error_norm;
+    /// Order of the local error estimate, or 0 if the ODE solver does not estimate it.
+    unsigned int local_error_order;
+
+    /// Linesearch step length of the last steady iteration, or 0 if the iteration was rejected.
+    /** Reported to the CFLController of steady_state(). Solvers without a linesearch always take full steps.
+     */
+    double pseudotime_step_length;
+
+    /// Linear iterations of the steady iterations, reported by steady_state().
+    /** Solvers without linear systems leave it at 0.
+     */
+    unsigned int n_linear_iterations;
+
     /// Evaluate stable time-step
     /** Currently not used */
     void compute_time_step();
 
+    /// Ratio between the time step of step_in_time() and the smallest stable time step of the cells.
+    /** Used by advance_solution_time() when the time_step_control is adaptive.
+     */
+    virtual double cfl_time_step_multiplier () const { return 1.0; }
+
     /// Solution update given by the ODE solver
     dealii::LinearAlgebra::distributed::Vector<double> solution_update;
 
-    /// Stores the various RK stages.
-    /** Currently hard-coded to RK4.
+    /// Registers of the explicit Runge-Kutta method.
+    /** Holds the initial solution, the accumulated stages, and the increment of LowStorageRungeKuttaTableau,
+     *  followed by the local error estimate. Only the registers used by the selected method are allocated.
      */
     std::vector<dealii::LinearAlgebra::distributed::Vector<double>> rk_stage;
 
@@ -92,11 +119,8 @@ public:
 }; // end of ODESolver class
 
 /// Implicit ODE solver derived from ODESolver.
-/** Currently works to find steady state of linear problems.
- *  Need to add mass matrix to operator to handle nonlinear problems
- *  and time-accurate solutions.
- *
- *  Uses backward-Euler by linearizing the residual
+/** Steady states are found by pseudo-time stepping with a
+ *  backward-Euler linearizing the residual
  *  \f[
  *      \mathbf{R}(\mathbf{u}^{n+1}) = \mathbf{R}(\mathbf{u}^{n}) + 
  *      \left. \frac{\partial \mathbf{R}}{\partial \mathbf{u}} \right|_{\mathbf{u}^{n}} (\mathbf{u}^{n+1} - \mathbf{u}^{n})
@@ -108,6 +132,14 @@ public:
  *      \frac{\mathbf{u}^{n+1} - \mathbf{u}^{n}}{\Delta t} = \mathbf{R}(\mathbf{u}^{n}) + 
  *      \left. \frac{\partial \mathbf{R}}{\partial \mathbf{u}} \right|_{\mathbf{u}^{n}} (\mathbf{u}^{n+1} - \mathbf{u}^{n})
  *  \f]
+ *  where the system_matrix and its preconditioner may be reused over several iterations,
+ *  see ODESolverParam::jacobian_reuse_iterations and ODESolverParam::preconditioner_reuse_iterations.
+ *
+ *  Unsteady problems are instead advanced by the implicit_time_integration method, where each implicit
+ *  stage, or time step, is solved by Newton iterations. The system_matrix
+ *  \f$ \mathbf{M}/(\gamma \Delta t) - \partial \mathbf{R}/\partial \mathbf{u} \f$ is lagged across
+ *  Newton iterations, stages, and up to jacobian_lagging_max_age time steps, where only its mass term
+ *  is updated when \f$ \gamma \Delta t \f$ changes.
  */
 template<int dim, typename real>
 class Implicit_ODESolver
@@ -116,27 +148,93 @@ class Implicit_ODESolver
 public:
     Implicit_ODESolver() = delete; ///< Constructor.
     /// Constructor.
-    Implicit_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input)
-    :
-    ODESolver<dim,real>::ODESolver(dg_input)
-    {};
+    Implicit_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input);
     ~Implicit_ODESolver() {}; ///< Destructor.
     /// Allocates ODE system based on given DGBase.
     /** Basically allocates solution vector and asks DGBase to evaluate the mass matrix.
+     *  Also discards the lagged Jacobian and the time step history.
      */
     void allocate_ode_system ();
 protected:
     /// Advances the solution in time by \p dt.
     void step_in_time(real dt, const bool pseudotime = false) override;
 
+    /// Vector type of the DG solution and residual.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// Advances the unsteady solution by \p dt using the implicit_time_integration method.
+    void time_accurate_step (const double dt);
+
+    /// Solves an implicit stage with Newton iterations, starting from the current DG solution.
+    /** Finds the solution \f$ \mathbf{w} \f$ satisfying
+     *  \f[
+     *      \frac{\mathbf{M}}{\gamma \Delta t} (\mathbf{w} - \mathbf{w}_{base}) = \mathbf{R}(\mathbf{w}) + \mathbf{E}
+     *  \f]
+     *  where \f$ \mathbf{E} \f$ is the @p explicit_residual. The right_hand_side of the DG then holds
+     *  \f$ \mathbf{R}(\mathbf{w}) \f$.
+     */
+    void solve_implicit_stage (const double gamma_dt, const VectorType &base_solution, const VectorType &explicit_residual);
+
+    /// Assembles the system_matrix \f$ \mathbf{M}/(\gamma \Delta t) - \partial \mathbf{R}/\partial \mathbf{u} \f$ at the current solution.
+    void refresh_jacobian (const double gamma_dt);
+
+    /// Solves the linearized system with the current system_matrix, or its Jacobian-free counterpart, into the solution_update.
+    /** For the Jacobian-free operator, @p dt and @p pseudotime scale its mass matrices and the
+     *  DG right_hand_side must hold the residual at the current solution.
+     *  The preconditioner is reused if requested by the reusable_preconditioner.
+     *  Returns the number of linear iterations.
+     */
+    unsigned int solve_linearized_system (VectorType &rhs, const double dt, const bool pseudotime);
+
     /// Performs a linesearch to reduce the residual.
     /** It first does a backtracking linesearch to make sure the residual is reduced.
-     *  If not found, a linesearch is made to check that the residual is valid.
-     *  Otherwise, take step in the other direction or accept current linesearch, while
-     *  reducing the CFL for the next time step.
+     *  If not found and cfl_backtracking is set, the solution is restored and 0 is returned such that
+     *  the CFLController reduces the CFL of the next iteration.
+     *  Otherwise, a linesearch is made to check that the residual is valid,
+     *  or a step is taken in the other direction.
      */
     double linesearch ();
 
+    /// Linearized operator used when jacobian_free_newton_krylov is set.
+    /** The system_matrix then only contains its diagonal blocks and is used as a preconditioner.
+     */
+    std::unique_ptr<JacobianFreeOperator<dim,real>> jacobian_free_operator;
+
+    /// Polynomial levels used when the GMRES preconditioner_type is p_multigrid.
+    /** Set up by allocate_ode_system(), while its coarse operators are rebuilt at every linear solve.
+     */
+    std::unique_ptr<PMultigridPreconditioner> p_multigrid;
+
+    /// Coefficients of the implicit_time_integration, where bdf2 takes a first backward Euler step.
+    const DiagonallyImplicitRungeKuttaTableau dirk_tableau;
+
+    /// Whether the system_matrix holds a lagged Jacobian of the unsteady implicit_time_integration.
+    bool lagged_jacobian_is_valid;
+    /// Inverse of \f$ \gamma \Delta t \f$ scaling the mass matrices added to the lagged Jacobian.
+    double lagged_jacobian_mass_scaling;
+    /// Number of time steps taken since the lagged Jacobian was assembled.
+    unsigned int lagged_jacobian_age;
+    /// Number of Jacobian assemblies since allocate_ode_system().
+    unsigned int n_jacobian_assemblies;
+
+    /// Preconditioner kept between the linear solves.
+    ReusablePreconditioner reusable_preconditioner;
+    /// Number of steady iterations that used the current system_matrix, or 0 if it must be assembled.
+    unsigned int jacobian_uses;
+    /// Number of steady iterations that used the current preconditioner, or 0 if it must be set up.
+    unsigned int preconditioner_uses;
+    /// Linear iterations of the first solve with the current preconditioner.
+    unsigned int reference_linear_iterations;
+
+    /// Residuals of the previous stages of the diagonally implicit Runge-Kutta method.
+    std::vector<VectorType> stage_residuals;
+    /// Solution at the beginning of the time step.
+    VectorType initial_solution;
+    /// Solution at the beginning of the previous time step, used by bdf2.
+    VectorType previous_solution;
+    /// Previous time step, or 0 if none was taken since allocate_ode_system().
+    double previous_time_step;
+
     using ODESolver<dim,real>::pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
 
 }; // end of Implicit_ODESolver class
@@ -153,7 +251,8 @@ class Explicit_ODESolver
 public:
     /// Constructor.
     Explicit_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input)
-    : ODESolver<dim,real>::ODESolver(dg_input) 
+    : ODESolver<dim,real>::ODESolver(dg_input)
+    , rk_tableau(LowStorageRungeKuttaTableau::create(dg_input->all_parameters->ode_solver_param.runge_kutta_method))
     {};
     /// Destructor.
     ~Explicit_ODESolver() {};
@@ -165,10 +264,80 @@ public:
 protected:
     ///< Advances the solution in time by \p dt.
     void step_in_time(real dt, const bool pseudotime = false) override;
+
+    /// Coefficients of the Runge-Kutta method selected by ODESolverParam::runge_kutta_method.
+    const LowStorageRungeKuttaTableau rk_tableau;
+
     using ODESolver<dim,real>::pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
 }; // end of Explicit_ODESolver class
 
-/// Creates and assemble Explicit_ODESolver or Implicit_ODESolver as ODESolver based on input.
+/// Explicit local time stepping ODE solver derived from Explicit_ODESolver.
+/** The cells are grouped into levels according to their max_dt_cell. Cells of level l are advanced
+ *  by steps of \f$ 2^l \Delta t_0 \f$ of the Runge-Kutta method of the Explicit_ODESolver, where
+ *  \f$ \Delta t_0 \f$ is the time step of the finest level, such that large cells require fewer
+ *  residual evaluations.
+ *
+ *  Each face is evaluated at the stages of its finer cell, while the cells of the other levels are
+ *  frozen at their current solution. The Runge-Kutta update of the face contributions is accumulated
+ *  in both cells until the end of their respective steps. The scheme is therefore conservative and
+ *  each level is as stable as the global Runge-Kutta method, but the coupling between the levels is
+ *  only first-order accurate in time. Pseudo-time steps towards a steady state are already local
+ *  and use the Explicit_ODESolver.
+ */
+template<int dim, typename real>
+class LocalTimeStepping_ODESolver
+    : public Explicit_ODESolver<dim, real>
+{
+public:
+    /// Constructor.
+    LocalTimeStepping_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input)
+    : Explicit_ODESolver<dim,real>::Explicit_ODESolver(dg_input)
+    , n_levels(dg_input->all_parameters->ode_solver_param.local_time_stepping_levels)
+    {};
+    /// Destructor.
+    ~LocalTimeStepping_ODESolver() {};
+    /// Allocates the Explicit_ODESolver system and the accumulated residual.
+    void allocate_ode_system ();
+
+protected:
+    /// Advances the solution in time by \p dt, which is the time step of the coarsest level.
+    void step_in_time(real dt, const bool pseudotime = false) override;
+
+    /// The coarsest level takes 2^(n_levels-1) of the smallest stable time steps.
+    double cfl_time_step_multiplier () const override;
+
+    /// Assigns the locally owned cells to the coarsest level whose time step is stable.
+    /** Also prints the number of cells per level and the resulting reduction of work.
+     */
+    void assign_time_levels (const double finest_time_step);
+
+    /// Takes one Runge-Kutta step of \p level_time_step with the volume and face terms of \p level.
+    /** The other levels are frozen. The solution is left unchanged, and the update of every cell
+     *  touched by the terms of the level is stored in level_update.
+     */
+    void integrate_level (const unsigned int level, const double level_time_step);
+
+    const unsigned int n_levels; ///< Number of time levels.
+
+    /// Time level of the locally owned cells, indexed by active_cell_index.
+    std::vector<unsigned int> cell_levels;
+
+    /// Number of cells of each level over all the processes.
+    std::vector<unsigned int> n_cells_per_level;
+
+    /// Solution updates accumulated since the beginning of the step of each cell.
+    dealii::LinearAlgebra::distributed::Vector<double> accumulated_update;
+
+    /// Update of the last step taken by integrate_level().
+    dealii::LinearAlgebra::distributed::Vector<double> level_update;
+
+    /// Solution at the beginning of the step taken by integrate_level().
+    dealii::LinearAlgebra::distributed::Vector<double> level_initial_solution;
+
+    using ODESolver<dim,real>::pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
+}; // end of LocalTimeStepping_ODESolver class
+
+/// Creates and assemble Explicit_ODESolver, LocalTimeStepping_ODESolver, or Implicit_ODESolver as ODESolver based on input.
 template <int dim, typename real>
 class ODESolverFactory
 {
@@ -0,0 +1,224 @@
+#include <cmath>
+
+#include <deal.II/base/exceptions.h>
+
+#include <deal.II/lac/full_matrix.h>
+
+#include "runge_kutta_tableau.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+LowStorageRungeKuttaTableau LowStorageRungeKuttaTableau::create (const Parameters::ODESolverParam::RungeKuttaEnum method)
+{
+    using RungeKuttaEnum = Parameters::ODESolverParam::RungeKuttaEnum;
+
+    LowStorageRungeKuttaTableau tableau;
+    unsigned int n_stages = 0;
+    if (method == RungeKuttaEnum::forward_euler) {
+        tableau.name = "forward Euler";
+        tableau.order = 1;
+        n_stages = 1;
+    } else if (method == RungeKuttaEnum::ssp_rk3) {
+        tableau.name = "SSP-RK3";
+        tableau.order = 3;
+        n_stages = 3;
+    } else if (method == RungeKuttaEnum::lsrk4_carpenter_kennedy) {
+        tableau.name = "Carpenter-Kennedy RK4(3)5";
+        tableau.order = 4;
+        n_stages = 5;
+    } else if (method == RungeKuttaEnum::ssp_rk10_4) {
+        tableau.name = "SSP-RK(10,4)";
+        tableau.order = 4;
+        n_stages = 10;
+    } else {
+        AssertThrow(false, dealii::ExcMessage("Unknown Runge-Kutta method."));
+    }
+
+    // By default, each stage is a forward Euler step from the previous stage.
+    tableau.A.assign(n_stages, 0.0);
+    tableau.B.assign(n_stages, 1.0);
+    tableau.delta.assign(n_stages, 0.0);
+    tableau.gamma1.assign(n_stages, 1.0);
+    tableau.gamma2.assign(n_stages, 0.0);
+    tableau.gamma3.assign(n_stages, 0.0);
+
+    if (method == RungeKuttaEnum::ssp_rk3) {
+        // Shu and Osher (1988), in its 2S* form.
+        tableau.B      = { 1.0, 1.0/4.0, 2.0/3.0 };
+        tableau.gamma1 = { 1.0, 1.0/4.0, 2.0/3.0 };
+        tableau.gamma3 = { 0.0, 3.0/4.0, 1.0/3.0 };
+    } else if (method == RungeKuttaEnum::lsrk4_carpenter_kennedy) {
+        // Carpenter and Kennedy (1994), solution 3, in its 2N form.
+        tableau.A = { 0.0,
+                      -567301805773.0/1357537059087.0,
+                      -2404267990393.0/2016746695238.0,
+                      -3550918686646.0/2091501179385.0,
+                      -1275806237668.0/842570457699.0 };
+        tableau.B = { 1432997174477.0/9575080441755.0,
+                      5161836677717.0/13612068292357.0,
+                      1720146321549.0/2090206949498.0,
+                      3134564353537.0/4481467310338.0,
+                      2277821191437.0/14882151754819.0 };
+    } else if (method == RungeKuttaEnum::ssp_rk10_4) {
+        // Ketcheson (2008). The two-register implementation is rewritten such that
+        // the fifth stage directly gives the sixth stage value and S holds 9/10 of it.
+        tableau.B.assign(n_stages, 1.0/6.0);
+        tableau.B[4] = 1.0/15.0;
+        tableau.gamma1[4] = 2.0/5.0;
+        tableau.gamma3[4] = 3.0/5.0;
+        tableau.delta[5] = 9.0/10.0;
+        tableau.B[9] = 1.0/10.0;
+        tableau.gamma1[9] = 3.0/5.0;
+        tableau.gamma2[9] = 1.0;
+        tableau.gamma3[9] = -1.0/2.0;
+    }
+    tableau.compute_embedded_method();
+    return tableau;
+}
+
+void LowStorageRungeKuttaTableau::compute_embedded_method ()
+{
+    const unsigned int n = n_stages();
+
+    // Express the registers as u^n plus a combination of the dt*F(Y_j), stage by stage.
+    std::vector<std::vector<double>> butcher_a(n+1, std::vector<double>(n, 0.0));
+    std::vector<double> increment(n, 0.0), accumulated(n, 0.0);
+    double stage_u = 1.0, accumulated_u = 0.0;
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) {
+            increment[j] = A[i] * increment[j] + (i == j ? 1.0 : 0.0);
+            accumulated[j] += delta[i] * butcher_a[i][j];
+            butcher_a[i+1][j] = gamma1[i] * butcher_a[i][j] + gamma2[i] * accumulated[j] + B[i] * increment[j];
+        }
+        accumulated_u += delta[i] * stage_u;
+        stage_u = gamma1[i] * stage_u + gamma2[i] * accumulated_u + gamma3[i];
+        Assert(std::abs(stage_u - 1.0) < 1e-12, dealii::ExcMessage("Inconsistent Runge-Kutta coefficients."));
+    }
+    const std::vector<double> &weights = butcher_a[n];
+
+    std::vector<double> c(n, 0.0), a_c(n, 0.0);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) c[i] += butcher_a[i][j];
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) a_c[i] += butcher_a[i][j] * c[j];
+    }
+
+    embedded_order = std::min(order-1, 3u);
+    error_weights.clear();
+    if (embedded_order == 0) return;
+
+    // Order conditions on the weights of the first n-1 stages.
+    std::vector<std::vector<double>> conditions;
+    std::vector<double> rhs;
+    conditions.push_back(std::vector<double>(n-1, 1.0)); rhs.push_back(1.0);
+    if (embedded_order >= 2) { conditions.push_back(c); rhs.push_back(1.0/2.0); }
+    if (embedded_order >= 3) {
+        std::vector<double> c_squared(n);
+        for (unsigned int i = 0; i < n; ++i) c_squared[i] = c[i]*c[i];
+        conditions.push_back(c_squared); rhs.push_back(1.0/3.0);
+        conditions.push_back(a_c); rhs.push_back(1.0/6.0);
+    }
+
+    // Minimum norm solution of the possibly underdetermined system.
+    const unsigned int n_conditions = conditions.size();
+    if (n_conditions > n-1) {
+        embedded_order = 0;
+        return;
+    }
+    dealii::FullMatrix<double> normal_matrix(n_conditions, n_conditions);
+    for (unsigned int k = 0; k < n_conditions; ++k) {
+        for (unsigned int l = 0; l < n_conditions; ++l) {
+            for (unsigned int j = 0; j < n-1; ++j) normal_matrix(k,l) += conditions[k][j] * conditions[l][j];
+        }
+    }
+    normal_matrix.gauss_jordan();
+
+    error_weights = weights;
+    for (unsigned int j = 0; j < n-1; ++j) {
+        double embedded_weight = 0.0;
+        for (unsigned int k = 0; k < n_conditions; ++k) {
+            for (unsigned int l = 0; l < n_conditions; ++l) {
+                embedded_weight += conditions[k][j] * normal_matrix(k,l) * rhs[l];
+            }
+        }
+        error_weights[j] -= embedded_weight;
+    }
+}
+
+unsigned int LowStorageRungeKuttaTableau::n_stages () const
+{
+    return B.size();
+}
+
+bool LowStorageRungeKuttaTableau::uses_increment_register () const
+{
+    for (const double a : A) if (a != 0.0) return true;
+    return false;
+}
+
+bool LowStorageRungeKuttaTableau::uses_accumulation_register () const
+{
+    for (const double d : delta) if (d != 0.0) return true;
+    return false;
+}
+
+bool LowStorageRungeKuttaTableau::uses_initial_solution () const
+{
+    for (const double g : gamma3) if (g != 0.0) return true;
+    return false;
+}
+
+DiagonallyImplicitRungeKuttaTableau DiagonallyImplicitRungeKuttaTableau::create (const Parameters::ODESolverParam::ImplicitTimeIntegrationEnum method)
+{
+    using ImplicitEnum = Parameters::ODESolverParam::ImplicitTimeIntegrationEnum;
+
+    DiagonallyImplicitRungeKuttaTableau tableau;
+    if (method == ImplicitEnum::backward_euler) {
+        tableau.name = "backward Euler";
+        tableau.order = 1;
+        tableau.a = { { 1.0 } };
+    } else if (method == ImplicitEnum::esdirk3) {
+        // Kennedy and Carpenter (2003), implicit part of ARK3(2)4L[2]SA.
+        const double g = 1767732205903.0/4055673282236.0;
+        tableau.name = "ESDIRK3";
+        tableau.order = 3;
+        tableau.a = { { 0.0 },
+                      { g, g },
+                      { 2746238789719.0/10658868560708.0, -640167445237.0/6845629431997.0, g },
+                      { 1471266399579.0/7840856788654.0, -4482444167858.0/7529755066697.0, 11266239266428.0/11593286722821.0, g } };
+    } else if (method == ImplicitEnum::esdirk4) {
+        // Kennedy and Carpenter (2003), implicit part of ARK4(3)6L[2]SA.
+        const double g = 1.0/4.0;
+        tableau.name = "ESDIRK4";
+        tableau.order = 4;
+        tableau.a = { { 0.0 },
+                      { g, g },
+                      { 8611.0/62500.0, -1743.0/31250.0, g },
+                      { 5012029.0/34652500.0, -654441.0/2922500.0, 174375.0/388108.0, g },
+                      { 15267082809.0/155376265600.0, -71443401.0/120774400.0, 730878875.0/902184768.0, 2285395.0/8070912.0, g },
+                      { 82889.0/524892.0, 0.0, 15625.0/83664.0, 69875.0/102672.0, -2260.0/8211.0, g } };
+    } else {
+        AssertThrow(false, dealii::ExcMessage("Unknown diagonally implicit Runge-Kutta method."));
+    }
+    return tableau;
+}
+
+unsigned int DiagonallyImplicitRungeKuttaTableau::n_stages () const
+{
+    return a.size();
+}
+
+double DiagonallyImplicitRungeKuttaTableau::diagonal () const
+{
+    return a.back().back();
+}
+
+bool DiagonallyImplicitRungeKuttaTableau::explicit_first_stage () const
+{
+    return a[0][0] == 0.0;
+}
+
+} // ODE namespace
+} // PHiLiP namespace
@@ -0,0 +1,100 @@
+#ifndef __RUNGE_KUTTA_TABLEAU_H__
+#define __RUNGE_KUTTA_TABLEAU_H__
+
+#include <string>
+#include <vector>
+
+#include "parameters/parameters_ode_solver.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+/// Coefficients of an explicit Runge-Kutta method written in a low-storage form.
+/** Starting from \f$ \mathbf{Y}_1 = \mathbf{u}^{n} \f$, stage \f$ i \f$ evaluates
+ *  \f$ \mathbf{F}(\mathbf{Y}_i) = \mathbf{M}^{-1}\mathbf{R}(\mathbf{Y}_i) \f$ and updates the registers
+ *  \f[
+ *      \Delta\mathbf{q} = A_i \Delta\mathbf{q} + \Delta t \mathbf{F}(\mathbf{Y}_i), \qquad
+ *      \mathbf{S} = \mathbf{S} + \delta_i \mathbf{Y}_i,
+ *  \f]
+ *  \f[
+ *      \mathbf{Y}_{i+1} = \gamma_{1,i} \mathbf{Y}_i + \gamma_{2,i} \mathbf{S} + \gamma_{3,i} \mathbf{u}^{n} + B_i \Delta\mathbf{q},
+ *  \f]
+ *  where the last stage gives \f$ \mathbf{u}^{n+1} \f$.
+ *
+ *  Williamson's 2N methods only use \f$ A_i \f$ and \f$ B_i \f$, while the Shu-Osher forms of
+ *  Ketcheson's 2S and 3S* methods have \f$ A_i = 0 \f$. The registers that a method does not use
+ *  are not allocated.
+ */
+struct LowStorageRungeKuttaTableau
+{
+    /// Returns the coefficients of the given method.
+    static LowStorageRungeKuttaTableau create (const Parameters::ODESolverParam::RungeKuttaEnum method);
+
+    std::string name; ///< Name of the method.
+    unsigned int order; ///< Order of accuracy.
+
+    std::vector<double> A; ///< Weights of the previous increment \f$ \Delta\mathbf{q} \f$.
+    std::vector<double> B; ///< Weights of the increment in the stage update.
+    std::vector<double> delta; ///< Weights of the stage values accumulated in \f$ \mathbf{S} \f$.
+    std::vector<double> gamma1; ///< Weights of the current stage value.
+    std::vector<double> gamma2; ///< Weights of the accumulated register \f$ \mathbf{S} \f$.
+    std::vector<double> gamma3; ///< Weights of the initial solution \f$ \mathbf{u}^{n} \f$.
+
+    /// Order of the embedded method, or 0 if the method has none.
+    unsigned int embedded_order;
+    /// Difference between the Butcher weights \f$ b_i \f$ of the method and \f$ \hat{b}_i \f$ of its embedded method.
+    /** The local error is then estimated as \f$ \Delta t \sum_i (b_i - \hat{b}_i) \mathbf{F}(\mathbf{Y}_i) \f$.
+     */
+    std::vector<double> error_weights;
+
+    /// Number of stages, i.e. of residual evaluations per time step.
+    unsigned int n_stages () const;
+
+    /// Whether the increment \f$ \Delta\mathbf{q} \f$ is carried across stages.
+    bool uses_increment_register () const;
+    /// Whether the register \f$ \mathbf{S} \f$ is used.
+    bool uses_accumulation_register () const;
+    /// Whether the initial solution \f$ \mathbf{u}^{n} \f$ must be kept.
+    bool uses_initial_solution () const;
+
+private:
+    /// Computes the embedded method from the Butcher tableau equivalent to the low-storage form.
+    /** The embedded weights satisfy the order conditions up to min(order-1, 3), do not use the
+     *  last stage, and are otherwise of minimum norm. No per-method coefficients are therefore needed.
+     */
+    void compute_embedded_method ();
+};
+
+/// Butcher coefficients of a stiffly-accurate diagonally implicit Runge-Kutta method.
+/** Stage \f$ i \f$ solves
+ *  \f[
+ *      \mathbf{M} (\mathbf{Y}_i - \mathbf{u}^{n}) = \Delta t \sum_{j<i} a_{ij} \mathbf{R}(\mathbf{Y}_j) + \Delta t a_{ii} \mathbf{R}(\mathbf{Y}_i),
+ *  \f]
+ *  where a first stage with \f$ a_{11} = 0 \f$ is explicit, i.e. \f$ \mathbf{Y}_1 = \mathbf{u}^{n} \f$.
+ *  Since the last row of \f$ a_{ij} \f$ holds the weights, \f$ \mathbf{u}^{n+1} \f$ is the last stage.
+ *  All implicit stages share the same diagonal coefficient such that they share the same Jacobian.
+ */
+struct DiagonallyImplicitRungeKuttaTableau
+{
+    /// Returns the coefficients of the given method.
+    /** The multistep bdf2 is not a Runge-Kutta method and is not accepted.
+     */
+    static DiagonallyImplicitRungeKuttaTableau create (const Parameters::ODESolverParam::ImplicitTimeIntegrationEnum method);
+
+    std::string name; ///< Name of the method.
+    unsigned int order; ///< Order of accuracy.
+
+    std::vector<std::vector<double>> a; ///< Lower triangular Butcher coefficients \f$ a_{ij} \f$.
+
+    /// Number of stages, including the explicit first stage.
+    unsigned int n_stages () const;
+    /// Diagonal coefficient of the implicit stages.
+    double diagonal () const;
+    /// Whether the first stage is explicit.
+    bool explicit_first_stage () const;
+};
+
+} // ODE namespace
+} // PHiLiP namespace
+
+#endif
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include "optimization/flow_constraints.hpp"
 #include "mesh/meshmover_linear_elasticity.hpp"
 
@@ -5,8 +8,6 @@
 
 #include "ode_solver/ode_solver.h"
 
-#include <Epetra_RowMatrixTransposer.h>
-
 #include "Ifpack.h"
 
 #include "global_counter.hpp"
@@ -24,7 +25,12 @@ FlowConstraints<dim>
     , ffd(_ffd)
     , ffd_design_variables_indices_dim(_ffd_design_variables_indices_dim)
     , jacobian_prec(nullptr)
-    , adjoint_jacobian_prec(nullptr)
+    , jacobian_is_current(false)
+    , jacobian_dRdW_form(0)
+    , jacobian_flow_CFL(0.0)
+    , jacobian_prec_is_current(false)
+    , jacobian_linear_iterations(0)
+    , adjoint_jacobian_linear_iterations(0)
 {
     flow_CFL_ = 0.0;
     ffd_des_var.reinit(ffd_design_variables_indices_dim.size());
@@ -37,13 +43,17 @@ FlowConstraints<dim>
     this->linear_solver_param.parse_parameters (parameter_handler);
     this->linear_solver_param.max_iterations = 1000;
     this->linear_solver_param.restart_number = 200;
-    this->linear_solver_param.linear_residual = 1e-17;
+    // Relative to the right-hand side. Reachable in double precision, such that the solves stop before
+    // max_iterations and the recycled subspaces reduce the iterations of the later solves.
+    this->linear_solver_param.linear_residual = 1e-12;
     this->linear_solver_param.ilut_fill = 5;
     this->linear_solver_param.ilut_drop = 0.0;
     this->linear_solver_param.ilut_atol = 1e-4;
     this->linear_solver_param.ilut_rtol = 1.0+1e-4;
     this->linear_solver_param.linear_solver_output = Parameters::OutputEnum::quiet;
     this->linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    // The Jacobians of consecutive design iterations are nearby, and are solved many times each.
+    this->linear_solver_param.gmres_variant = Parameters::LinearSolverParam::GMRESVariantEnum::recycling;
 
 }
 
@@ -59,7 +69,16 @@ void FlowConstraints<dim>
 ::update_1( const ROL::Vector<double>& des_var_sim, bool flag, int iter )
 {
     (void) flag; (void) iter;
-    dg->solution = ROL_vector_to_dealii_vector_reference(des_var_sim);
+    const auto &des_var_sim_v = ROL_vector_to_dealii_vector_reference(des_var_sim);
+    if (jacobian_is_current && des_var_sim_v.size() == dg->solution.size()) {
+        double max_difference = 0.0;
+        for (unsigned int i = 0; i < des_var_sim_v.local_size(); ++i) {
+            max_difference = std::max(max_difference, std::abs(des_var_sim_v.local_element(i) - dg->solution.local_element(i)));
+        }
+        if (dealii::Utilities::MPI::max(max_difference, MPI_COMM_WORLD) == 0.0) return;
+    }
+    invalidate_jacobian_1();
+    dg->solution = des_var_sim_v;
     dg->solution.update_ghost_values();
 }
 
@@ -76,6 +95,7 @@ void FlowConstraints<dim>
     diff -= current_ffd_des_var;
     const double l2_norm = diff.l2_norm();
     if (l2_norm != 0.0) {
+        invalidate_jacobian_1();
         ffd.set_design_variables( ffd_design_variables_indices_dim, ffd_des_var);
         ffd.deform_mesh(dg->high_order_grid);
 
@@ -86,6 +106,33 @@ void FlowConstraints<dim>
     }
 }
 
+template<int dim>
+void FlowConstraints<dim>
+::invalidate_jacobian_1()
+{
+    jacobian_is_current = false;
+    jacobian_prec_is_current = false;
+    jacobian_solver_preconditioner.reuse = false;
+    adjoint_jacobian_solver_preconditioner.reuse = false;
+}
+
+template<int dim>
+void FlowConstraints<dim>
+::assemble_jacobian_1()
+{
+    if (jacobian_is_current && jacobian_dRdW_form == dRdW_form && jacobian_flow_CFL == flow_CFL_) return;
+
+    // Either the variables or the regularization changed, or the system_matrix has been assembled elsewhere.
+    // The DGBase only compares the solution and the grid before re-assembling the system_matrix.
+    if (jacobian_flow_CFL != flow_CFL_) dg->invalidate_dRdW();
+    invalidate_jacobian_1();
+    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    jacobian_is_current = true;
+    jacobian_dRdW_form = dRdW_form;
+    jacobian_flow_CFL = flow_CFL_;
+}
+
 template<int dim>
 void FlowConstraints<dim>
 ::solve(
@@ -100,6 +147,8 @@ void FlowConstraints<dim>
 
     dg->output_results_vtk(i_out++);
     ffd.output_ffd_vtu(i_out);
+    // The ODE solver overwrites the system_matrix with its pseudo-time systems.
+    invalidate_jacobian_1();
     std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver_1 = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
     ode_solver_1->steady_state();
 
@@ -141,9 +190,7 @@ void FlowConstraints<dim>
 
     update_1(des_var_sim);
     update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    assemble_jacobian_1();
 
     const auto &input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
@@ -166,9 +213,7 @@ void FlowConstraints<dim>
 
     update_1(des_var_sim);
     update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    assemble_jacobian_1();
 
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
     //solve_linear_2 (
@@ -191,7 +236,15 @@ void FlowConstraints<dim>
     auto input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
 
-    solve_linear (dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param);
+    // The preconditioner set up by the first solve is reused until the Jacobian changes,
+    // while its recycled subspace is kept across Jacobians and gives the initial guess.
+    output_vector_v = 0.0;
+    const bool transpose = false;
+    const unsigned int linear_iterations = solve_linear (dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param, transpose, &jacobian_solver_preconditioner).first;
+    jacobian_solver_preconditioner.reuse = true;
+    jacobian_linear_iterations += linear_iterations;
+    if(i_print) std::cout << "Linear solve took " << linear_iterations << " iterations, "
+                          << jacobian_linear_iterations << " in total." << std::endl;
     //solve_linear_2 ( this->dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param);
     //try {
     //  solve_linear (dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param);
@@ -206,13 +259,13 @@ void FlowConstraints<dim>
 {
     delete jacobian_prec;
     jacobian_prec = nullptr;
+    jacobian_prec_is_current = false;
 }
 template<int dim>
 void FlowConstraints<dim>
 ::destroy_AdjointJacobianPreconditioner_1()
 {
-    delete adjoint_jacobian_prec;
-    adjoint_jacobian_prec = nullptr;
+    destroy_JacobianPreconditioner_1();
 }
 
 template<int dim>
@@ -223,9 +276,12 @@ int FlowConstraints<dim>
 {
     update_1(des_var_sim);
     update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    assemble_jacobian_1();
+    if (jacobian_prec && jacobian_prec_is_current) {
+        ++preconditioner_reuse;
+        return 0;
+    }
+    ++preconditioner_setup;
 
     Epetra_CrsMatrix * jacobian = const_cast<Epetra_CrsMatrix *>(&(dg->system_matrix.trilinos_matrix()));
 
@@ -264,11 +320,15 @@ int FlowConstraints<dim>
     List.set("fact: drop tolerance", 1e-12);
 
     List.set("schwarz: reordering type", "rcm");
+    // The overlapping values are added instead of being discarded, such that the transpose applied by
+    // applyInverseAdjointJacobianPreconditioner_1() is the exact adjoint of the preconditioner.
+    List.set("schwarz: combine mode", "Add");
 
 
     IFPACK_CHK_ERR(jacobian_prec->SetParameters(List));
     IFPACK_CHK_ERR(jacobian_prec->Initialize());
     IFPACK_CHK_ERR(jacobian_prec->Compute());
+    jacobian_prec_is_current = true;
 
     return 0;
 
@@ -280,56 +340,8 @@ int FlowConstraints<dim>
     const ROL::Vector<double>& des_var_sim,
     const ROL::Vector<double>& des_var_ctl)
 {
-    update_1(des_var_sim);
-    update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
-
-    Epetra_CrsMatrix * adjoint_jacobian = const_cast<Epetra_CrsMatrix *>(&(dg->system_matrix_transpose.trilinos_matrix()));
-
-    destroy_AdjointJacobianPreconditioner_1();
-    Ifpack Factory;
-    const std::string PrecType = "ILUT"; 
-    //const std::string PrecType = "ILU"; 
-    const int OverlapLevel = 1; // one row of overlap among the processes
-    adjoint_jacobian_prec = Factory.Create(PrecType, adjoint_jacobian, OverlapLevel);
-    assert (adjoint_jacobian_prec != 0);
-
-    Teuchos::ParameterList List;
-    // "fact: level-of-fill":
-    //      defines the level of fill for ILU factorizations.
-    //      This is based on powers of the graph, so the value 0 means no-fill.
-    // "fact: ilut level-of-fill":
-    //      defines the level of fill for ILUT factorizations.
-    //      This is a ratio, so 1.0 means same number of nonzeros for
-    //      the ILU factors as in the original matrix.
-    // "fact: absolute threshold":
-    //      cdefines the value α to add to each diagonal element
-    //      (times the signum of the actual diagonal element),
-    //      for incomplete factorizations only.
-    // "fact: relative threshold":
-    //      defines ρ, so that the diagonal element of the matrix
-    //      (without the contribution specified by "fact: absolute threshold") is multiplied by rho.
-    // "fact: relax value":
-    //      if different from zero, the elements dropped during the factorization process
-    //      will be added to the diagonal term, multiplied by the specified value.
-
-    //List.set("fact: level-of-fill", 2);
-    List.set("fact: ilut level-of-fill", 5.0);
-    // no modifications on the diagonal
-    List.set("fact: absolute threshold", 1e-4);
-    List.set("fact: relative threshold", 1.0+1e-4);
-    List.set("fact: drop tolerance", 1e-12);
-
-    List.set("schwarz: reordering type", "rcm");
-
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->SetParameters(List));
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->Initialize());
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->Compute());
-
-    return 0;
-
+    // The ILUT of the Jacobian is applied transposed, such that the adjoint Jacobian is neither formed nor factorized.
+    return construct_JacobianPreconditioner_1(des_var_sim, des_var_ctl);
 }
 
 template<int dim>
@@ -341,9 +353,9 @@ void FlowConstraints<dim>
     const ROL::Vector<double>& des_var_ctl,
     double& /*tol*/ )
 {
-    (void) des_var_sim; // Preconditioner should be built.
-    (void) des_var_ctl; // Preconditioner should be built.
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // Only factorizes if the variables changed since the preconditioner was constructed.
+    construct_JacobianPreconditioner_1(des_var_sim, des_var_ctl);
 
     // Input vector is copied into temporary non-const vector.
     auto input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
@@ -355,7 +367,7 @@ void FlowConstraints<dim>
     Epetra_Vector output_trilinos(View,
                     dg->system_matrix.trilinos_matrix().RangeMap(),
                     output_vector_v.begin());
-    jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
+    IFPACK_CHK_ERRV(jacobian_prec->ApplyInverse (input_trilinos, output_trilinos));
 
     n_vmult += 2;
     dRdW_mult += 2;
@@ -371,21 +383,26 @@ void FlowConstraints<dim>
     const ROL::Vector<double>& des_var_ctl,
     double& /*tol*/ )
 {
-    (void) des_var_sim; // Preconditioner should be built.
-    (void) des_var_ctl; // Preconditioner should be built.
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
+    // Only factorizes if the variables changed since the preconditioner was constructed.
+    construct_JacobianPreconditioner_1(des_var_sim, des_var_ctl);
 
     // Input vector is copied into temporary non-const vector.
     auto input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
 
     Epetra_Vector input_trilinos(View,
-                    dg->system_matrix_transpose.trilinos_matrix().DomainMap(),
+                    dg->system_matrix.trilinos_matrix().RangeMap(),
                     input_vector_v.begin());
     Epetra_Vector output_trilinos(View,
-                    dg->system_matrix_transpose.trilinos_matrix().RangeMap(),
+                    dg->system_matrix.trilinos_matrix().DomainMap(),
                     output_vector_v.begin());
-    adjoint_jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
+    // The preconditioner is shared with applyInverseJacobianPreconditioner_1(), such that the transpose
+    // is reset before any error of the application is reported.
+    IFPACK_CHK_ERRV(jacobian_prec->SetUseTranspose(true));
+    const int apply_error = jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
+    IFPACK_CHK_ERRV(jacobian_prec->SetUseTranspose(false));
+    IFPACK_CHK_ERRV(apply_error);
 
     n_vmult += 2;
     dRdW_mult += 2;
@@ -403,9 +420,7 @@ double& /*tol*/ )
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
     update_1(des_var_sim);
     update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    assemble_jacobian_1();
 
     // Input vector is copied into temporary non-const vector.
     auto input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
@@ -420,7 +435,15 @@ double& /*tol*/ )
     // system_matrix_transpose.reinit(*system_matrix_transpose_tril, copy_values);
     // delete system_matrix_transpose_tril;
 
-    solve_linear (dg->system_matrix_transpose, input_vector_v, output_vector_v, this->linear_solver_param);
+    // The preconditioner set up by the first solve is reused until the Jacobian changes,
+    // while its recycled subspace is kept across Jacobians and gives the initial guess.
+    output_vector_v = 0.0;
+    const bool transpose = true;
+    const unsigned int linear_iterations = solve_linear (dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param, transpose, &adjoint_jacobian_solver_preconditioner).first;
+    adjoint_jacobian_solver_preconditioner.reuse = true;
+    adjoint_jacobian_linear_iterations += linear_iterations;
+    if(i_print) std::cout << "Linear solve took " << linear_iterations << " iterations, "
+                          << adjoint_jacobian_linear_iterations << " in total." << std::endl;
 
     // dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
     // Epetra_CrsMatrix *system_matrix_transpose_tril;
@@ -506,9 +529,7 @@ double& /*tol*/ )
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
     update_1(des_var_sim);
     update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
+    assemble_jacobian_1();
 
     const auto &input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
@@ -42,7 +42,7 @@ private:
     FreeFormDeformation<dim> ffd;
 
     /// Linear solver parameters.
-    /** Currently set such that the linear systems are fully solved
+    /** Currently set such that the linear systems are solved down to a relative residual of 1e-12.
      */
     Parameters::LinearSolverParam linear_solver_param;
 
@@ -52,11 +52,39 @@ private:
     dealii::LinearAlgebra::distributed::Vector<double> ffd_des_var;
 
     /// Jacobian preconditioner.
-    /** Currently uses ILUT */
+    /** Currently uses ILUT. The adjoint Jacobian preconditioner applies it transposed.
+     */
     Ifpack_Preconditioner *jacobian_prec;
-    /// Adjoint Jacobian preconditioner.
-    /** Currently uses ILUT */
-    Ifpack_Preconditioner *adjoint_jacobian_prec;
+
+    /// Whether the dg->system_matrix holds the Jacobian at the current simulation and control variables.
+    /** Reset by update_1() and update_2() when the variables change, and by solve().
+     */
+    bool jacobian_is_current;
+    /// Value of the dRdW_form counter after the Jacobian has been assembled.
+    /** Detects the assemblies of the system_matrix performed outside of FlowConstraints.
+     */
+    unsigned int jacobian_dRdW_form;
+    /// Value of flow_CFL_ with which the Jacobian has been assembled.
+    double jacobian_flow_CFL;
+    /// Whether jacobian_prec has been factorized from the current Jacobian.
+    bool jacobian_prec_is_current;
+    /// Preconditioner kept by applyInverseJacobian_1() for the current Jacobian.
+    /** Its recycled subspace is kept across the Jacobians of the design iterations.
+     */
+    ReusablePreconditioner jacobian_solver_preconditioner;
+    /// Preconditioner kept by applyInverseAdjointJacobian_1() for the current Jacobian.
+    /** Its recycled subspace is kept across the Jacobians of the design iterations.
+     */
+    ReusablePreconditioner adjoint_jacobian_solver_preconditioner;
+    /// Linear iterations of all the solves of applyInverseJacobian_1().
+    unsigned int jacobian_linear_iterations;
+    /// Linear iterations of all the solves of applyInverseAdjointJacobian_1().
+    unsigned int adjoint_jacobian_linear_iterations;
+
+    /// Discards the Jacobian and its factorizations, which are rebuilt when next needed.
+    void invalidate_jacobian_1();
+    /// Assembles the Jacobian, unless it is current.
+    void assemble_jacobian_1();
 
 protected:
     /// ID used when outputting the flow solution.
@@ -98,10 +126,13 @@ public:
     ~FlowConstraints();
 
     /// Update the simulation variables.
+    /** The cached Jacobian and its factorizations are discarded if the variables changed.
+     */
     void update_1( const ROL::Vector<double>& des_var_sim, bool flag = true, int iter = -1 );
 
     /// Update the control variables.
     /** Update FFD from design variables and then deforms the mesh.
+     *  The cached Jacobian and its factorizations are discarded if the variables changed.
      */
     void update_2( const ROL::Vector<double>& des_var_ctl, bool flag = true, int iter = -1 );
 
@@ -152,15 +183,19 @@ public:
         ) override;
 
     /// Constructs the Jacobian preconditioner.
+    /** The factorization is kept until the simulation or control variables change.
+     */
     int construct_JacobianPreconditioner_1(
         const ROL::Vector<double>& des_var_sim,
         const ROL::Vector<double>& des_var_ctl);
 
     /// Frees Jacobian preconditioner from memory;
+    /** Also frees the adjoint Jacobian preconditioner, which shares its factorization.
+     */
     void destroy_JacobianPreconditioner_1();
 
     /// Applies the inverse Jacobian preconditioner.
-    /** construct_JacobianPreconditioner_1 needs to be called beforehand.
+    /** The preconditioner is constructed if it is not current.
      */
     void applyInverseJacobianPreconditioner_1(
         ROL::Vector<double>& output_vector,
@@ -171,15 +206,19 @@ public:
         );
 
     /// Constructs the Adjoint Jacobian preconditioner.
+    /** Since the ILUT of the Jacobian is applied transposed, this is the Jacobian preconditioner.
+     */
     int construct_AdjointJacobianPreconditioner_1(
         const ROL::Vector<double>& des_var_sim,
         const ROL::Vector<double>& des_var_ctl);
 
     /// Frees adjoint Jacobian preconditioner from memory;
+    /** Also frees the Jacobian preconditioner, which shares its factorization.
+     */
     void destroy_AdjointJacobianPreconditioner_1();
 
     /// Applies the inverse Adjoint Jacobian preconditioner.
-    /** construct_AdjointJacobianPreconditioner_1 needs to be called beforehand.
+    /** The preconditioner is constructed if it is not current.
      */
     void applyInverseAdjointJacobianPreconditioner_1(
         ROL::Vector<double>& output_vector,
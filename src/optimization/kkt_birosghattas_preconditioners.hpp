@@ -76,13 +76,8 @@ public:
             (void) error_precond2;
         }
     }
-    ~BirosGhattasPreconditioner()
-    {
-        if (use_approximate_preconditioner_) {
-            equal_constraints_->destroy_JacobianPreconditioner_1();
-            equal_constraints_->destroy_AdjointJacobianPreconditioner_1();
-        }
-    };
+    /// The factorizations are kept by the FlowConstraints for the next preconditioners at the same design.
+    ~BirosGhattasPreconditioner() {};
 
     /// Application of KKT preconditionner on vector src outputted into dst.
     virtual void vmult (dealiiSolverVectorWrappingROL<Real>       &dst,
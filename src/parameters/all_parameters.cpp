@@ -39,6 +39,32 @@ void AllParameters::declare_parameters (dealii::ParameterHandler &prm)
                       dealii::Patterns::Bool(),
                       "Use original form by defualt. Otherwise, split the fluxes.");
 
+    prm.declare_entry("use_sum_factorization", "false",
+                      dealii::Patterns::Bool(),
+                      "Use the dense operators by default. Otherwise, evaluate the explicit residual with sum-factorization.");
+
+    prm.declare_entry("threads_per_mpi_process", "1",
+                      dealii::Patterns::Integer(0),
+                      "Number of threads used by each MPI process to assemble the residual and its derivatives. "
+                      "If threads_per_mpi_process=0, then all the available cores are used.");
+
+    prm.declare_entry("use_metric_cache", "true",
+                      dealii::Patterns::Bool(),
+                      "Store the metric terms until the grid changes by default. "
+                      "Otherwise, recompute them at every residual evaluation.");
+
+    prm.declare_entry("reuse_jacobian_tapes", "false",
+                      dealii::Patterns::Bool(),
+                      "Record the volume term of dRdW for every cell by default. "
+                      "Otherwise, replay a recorded tape at the new inputs when the cells have the same polynomial degree, "
+                      "and record it again when the cell takes different branches in the physics. "
+                      "The boundary and face terms are always recorded.");
+
+    prm.declare_entry("use_block_sparse_system_matrix", "false",
+                      dealii::Patterns::Bool(),
+                      "Store dRdW in a Trilinos sparse matrix by default. "
+                      "Otherwise, store it as dense cell-to-cell blocks, which is only supported by the implicit ODE solver and the adjoint.");
+
     prm.declare_entry("use_periodic_bc", "false",
                       dealii::Patterns::Bool(),
                       "Use other boundary conditions by default. Otherwise use periodic (for 1d burgers only");
@@ -58,6 +84,7 @@ void AllParameters::declare_parameters (dealii::ParameterHandler &prm)
                       " euler_cylinder | "
                       " euler_cylinder_adjoint | "
                       " euler_vortex | "
+                      " euler_vortex_temporal_convergence | "
                       " euler_entropy_waves | "
                       "  euler_bump_optimization | "
                       "  shock_1d | "
@@ -74,6 +101,7 @@ void AllParameters::declare_parameters (dealii::ParameterHandler &prm)
                       "  euler_gaussian_bump_adjoint | "
                       "  euler_cylinder | "
                       "  euler_vortex | "
+                      "  euler_vortex_temporal_convergence | "
                       "  euler_entropy_waves | "
                       "  euler_cylinder_adjoint "
        "  euler_split_taylor_green |"
@@ -134,6 +162,7 @@ void AllParameters::parse_parameters (dealii::ParameterHandler &prm)
     else if (test_string == "euler_cylinder") { test_type = euler_cylinder; }
     else if (test_string == "euler_cylinder_adjoint") { test_type = euler_cylinder_adjoint; }
     else if (test_string == "euler_vortex") { test_type = euler_vortex; }
+    else if (test_string == "euler_vortex_temporal_convergence") { test_type = euler_vortex_temporal_convergence; }
     else if (test_string == "euler_entropy_waves") { test_type = euler_entropy_waves; }
     else if (test_string == "advection_periodicity") {test_type = advection_periodicity; }
     else if (test_string == "euler_split_taylor_green") {test_type = euler_split_taylor_green;}
@@ -167,6 +196,11 @@ void AllParameters::parse_parameters (dealii::ParameterHandler &prm)
     use_weak_form = prm.get_bool("use_weak_form");
     use_collocated_nodes = prm.get_bool("use_collocated_nodes");
     use_split_form = prm.get_bool("use_split_form");
+    use_sum_factorization = prm.get_bool("use_sum_factorization");
+    threads_per_mpi_process = prm.get_integer("threads_per_mpi_process");
+    use_metric_cache = prm.get_bool("use_metric_cache");
+    reuse_jacobian_tapes = prm.get_bool("reuse_jacobian_tapes");
+    use_block_sparse_system_matrix = prm.get_bool("use_block_sparse_system_matrix");
     use_periodic_bc = prm.get_bool("use_periodic_bc");
     add_artificial_dissipation = prm.get_bool("add_artificial_dissipation");
 
@@ -46,6 +46,46 @@ public:
     /// Flag to use split form.
     bool use_split_form;
 
+    /// Flag to use sum-factorized tensor-product kernels for the explicit residual.
+    /** Only used when the residual is evaluated without any derivatives.
+     *  Interpolation to the quadrature points and the integration against the test functions
+     *  are done one direction at a time, which reduces the cost per cell from O(p^(2d)) to O(p^(d+1)).
+     */
+    bool use_sum_factorization;
+
+    /// Number of threads used by each MPI process during the residual assembly.
+    /** A value of 0 lets the task scheduler use all the available cores.
+     *  With multiple threads, the derivatives (dRdW, dRdX, d2R) of the weak form are obtained
+     *  with Sacado instead of the CoDiPack tapes, which are shared by the threads.
+     */
+    unsigned int threads_per_mpi_process;
+
+    /// Flag to store the metric terms of the residual evaluation.
+    /** The metric terms at the volume and face quadrature points are reused as long as the
+     *  grid nodes do not change. Should be disabled when the grid is modified at every
+     *  residual evaluation, such as in shape optimization, to save memory.
+     */
+    bool use_metric_cache;
+
+    /// Flag to reuse the CoDiPack tape of the weak form volume term when assembling dRdW.
+    /** The volume term is recorded once with a primal-value tape and re-evaluated at the
+     *  solution and grid nodes of every following cell with the same finite element.
+     *  Ignored when artificial dissipation is added, since its coefficient is a passive
+     *  value that differs between cells. The control flow taken at the recorded cell is
+     *  replayed, such that the tape is recorded again whenever the replayed residual differs
+     *  from the one of the cell, e.g. when its pressure is clipped. The boundary and face
+     *  terms are recorded for every face.
+     */
+    bool reuse_jacobian_tapes;
+
+    /// Flag to store dRdW in a BlockSparseMatrix made of dense cell-to-cell blocks.
+    /** Only one index per block is stored instead of one per entry. The Trilinos system_matrix
+     *  is then left unallocated, such that this option is limited to the implicit ODE solver
+     *  and the Adjoint, which applies the transpose through Tvmult().
+     *  Requires the GMRES linear solver.
+     */
+    bool use_block_sparse_system_matrix;
+
     /// Flag to use periodic BC.
     /** Not fully tested.
      */
@@ -70,6 +110,7 @@ public:
         euler_cylinder,
         euler_cylinder_adjoint,
         euler_vortex,
+        euler_vortex_temporal_convergence,
         euler_entropy_waves,
         euler_split_taylor_green,
         burgers_split_form,
@@ -4,7 +4,13 @@ namespace PHiLiP {
 namespace Parameters {
 
 // Linear solver inputs
-LinearSolverParam::LinearSolverParam () {}
+LinearSolverParam::LinearSolverParam ()
+    : preconditioner_type(PreconditionerEnum::ilut)
+    , gmres_variant(GMRESVariantEnum::standard)
+    , p_multigrid_smoothing_steps(2)
+    , p_multigrid_coarse_steps(10)
+    , recycled_subspace_size(10)
+{}
 
 void LinearSolverParam::declare_parameters (dealii::ParameterHandler &prm)
 {
@@ -32,6 +38,34 @@ void LinearSolverParam::declare_parameters (dealii::ParameterHandler &prm)
                               dealii::Patterns::Integer(),
                               "Number of iterations before restarting GMRES");
 
+            prm.declare_entry("preconditioner_type", "ilut",
+                              dealii::Patterns::Selection("ilut|block_jacobi|block_ilu0|p_multigrid"),
+                              "Preconditioner used by GMRES. "
+                              "The block preconditioners operate on the dense cell blocks of the DG matrix. "
+                              "p_multigrid performs a V-cycle down to the lowest polynomial degree "
+                              "and falls back to block_ilu0 outside of the implicit ODE solver. "
+                              "Choices are <ilut|block_jacobi|block_ilu0|p_multigrid>.");
+            prm.declare_entry("gmres_variant", "standard",
+                              dealii::Patterns::Selection("standard|pipelined|flexible|recycling"),
+                              "Krylov method. standard uses AztecOO GMRES with ilut and deal.II GMRES otherwise. "
+                              "pipelined performs a single global reduction per iteration and overlaps it "
+                              "with the next matrix-vector product and preconditioner application, "
+                              "at the cost of twice the Krylov basis storage. "
+                              "flexible allows preconditioners varying between iterations. "
+                              "recycling keeps the directions of previous corrections between the solves "
+                              "sharing a preconditioner, and first minimizes the residual over them. "
+                              "Choices are <standard|pipelined|flexible|recycling>.");
+            prm.declare_entry("p_multigrid_smoothing_steps", "2",
+                              dealii::Patterns::Integer(0),
+                              "Number of block-ILU(0) pre- and post-smoothing steps on each p-multigrid level");
+            prm.declare_entry("p_multigrid_coarse_steps", "10",
+                              dealii::Patterns::Integer(1),
+                              "Number of block-ILU(0) smoothing steps used as the coarsest p-multigrid level solver");
+            prm.declare_entry("recycled_subspace_size", "10",
+                              dealii::Patterns::Integer(0),
+                              "Maximum number of directions kept between the solves by the recycling gmres_variant. "
+                              "The oldest directions are discarded first.");
+
             // ILU with threshold parameters
             prm.declare_entry("ilut_fill", "1",
                               dealii::Patterns::Integer(),
@@ -73,6 +107,20 @@ void LinearSolverParam ::parse_parameters (dealii::ParameterHandler &prm)
                 restart_number  = prm.get_integer("restart_number");
                 linear_residual = prm.get_double("linear_residual_tolerance");
 
+                const std::string preconditioner_string = prm.get("preconditioner_type");
+                if (preconditioner_string == "ilut")         preconditioner_type = PreconditionerEnum::ilut;
+                if (preconditioner_string == "block_jacobi") preconditioner_type = PreconditionerEnum::block_jacobi;
+                if (preconditioner_string == "block_ilu0")   preconditioner_type = PreconditionerEnum::block_ilu0;
+                if (preconditioner_string == "p_multigrid")  preconditioner_type = PreconditionerEnum::p_multigrid;
+                const std::string variant_string = prm.get("gmres_variant");
+                if (variant_string == "standard")  gmres_variant = GMRESVariantEnum::standard;
+                if (variant_string == "pipelined") gmres_variant = GMRESVariantEnum::pipelined;
+                if (variant_string == "flexible")  gmres_variant = GMRESVariantEnum::flexible;
+                if (variant_string == "recycling") gmres_variant = GMRESVariantEnum::recycling;
+                p_multigrid_smoothing_steps = prm.get_integer("p_multigrid_smoothing_steps");
+                p_multigrid_coarse_steps    = prm.get_integer("p_multigrid_coarse_steps");
+                recycled_subspace_size      = prm.get_integer("recycled_subspace_size");
+
                 ilut_fill = prm.get_integer("ilut_fill");
                 ilut_drop = prm.get_double("ilut_drop");
                 ilut_rtol = prm.get_double("ilut_rtol");
@@ -19,12 +19,28 @@ public:
         direct, /// LU.
         gmres   /// GMRES.
     };
+    /// Types of GMRES preconditioners available.
+    enum PreconditionerEnum {
+        ilut,         /// Trilinos ILUT on the scalar matrix with domain decomposition.
+        block_jacobi, /// Block-Jacobi with inverted cell blocks.
+        block_ilu0,   /// Block-ILU(0) over the cell blocks coupled through faces.
+        p_multigrid   /// V-cycle over the polynomial degrees with block-ILU(0) smoothing.
+    };
+    /// Krylov methods used by GMRES.
+    enum GMRESVariantEnum {
+        standard,  /// AztecOO GMRES with ilut, deal.II GMRES otherwise.
+        pipelined, /// In-tree GMRES overlapping a single global reduction per iteration with the next product.
+        flexible,  /// deal.II FGMRES, allowing preconditioners that vary between iterations.
+        recycling  /// In-tree GCRO keeping a subspace of previous corrections between the solves of a ReusablePreconditioner.
+    };
 
     /// Can either be verbose or quiet.
     /** Verbose will print the full dense matrix. Will not work for large matrices
      */
     OutputEnum linear_solver_output; ///< quiet or verbose.
     LinearSolverEnum linear_solver_type; ///< direct or gmres.
+    PreconditionerEnum preconditioner_type; ///< ilut, block_jacobi, block_ilu0, or p_multigrid.
+    GMRESVariantEnum gmres_variant; ///< standard, pipelined, flexible, or recycling.
 
     // GMRES options
     double ilut_drop; ///< Threshold to drop terms close to zero.
@@ -37,6 +53,11 @@ public:
     int max_iterations; ///< Maximum number of linear iteration.
     int restart_number; ///< Number of iterations before restarting GMRES
 
+    int p_multigrid_smoothing_steps; ///< Pre- and post-smoothing steps on each p-multigrid level.
+    int p_multigrid_coarse_steps; ///< Smoothing steps on the coarsest p-multigrid level.
+
+    int recycled_subspace_size; ///< Maximum number of directions kept by the recycling gmres_variant.
+
     /// Declares the possible variables and sets the defaults.
     static void declare_parameters (dealii::ParameterHandler &prm);
     /// Parses input file and sets the variables.
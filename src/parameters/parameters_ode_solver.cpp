@@ -19,9 +19,59 @@ void ODESolverParam::declare_parameters (dealii::ParameterHandler &prm)
                           "Outputs the solution every x steps in .vtk file");
 
         prm.declare_entry("ode_solver_type", "implicit",
-                          dealii::Patterns::Selection("explicit|implicit"),
+                          dealii::Patterns::Selection("explicit|implicit|explicit_local_time_stepping"),
                           "Explicit or implicit solver"
-                          "Choices are <explicit|implicit>.");
+                          "Choices are <explicit|implicit|explicit_local_time_stepping>.");
+
+        prm.declare_entry("runge_kutta_method", "ssp_rk3",
+                          dealii::Patterns::Selection("forward_euler|ssp_rk3|lsrk4_carpenter_kennedy|ssp_rk10_4"),
+                          "Runge-Kutta method used by the explicit solver. "
+                          "Choices are <forward_euler|ssp_rk3|lsrk4_carpenter_kennedy|ssp_rk10_4>.");
+
+        prm.declare_entry("time_step_control", "constant_time_step",
+                          dealii::Patterns::Selection("constant_time_step|cfl_time_step|embedded_error"),
+                          "Physical time step of unsteady simulations. "
+                          "constant_time_step uses initial_time_step, "
+                          "cfl_time_step uses time_step_cfl times the smallest stable time step of the cells, "
+                          "embedded_error controls the error estimate of the explicit Runge-Kutta method within the cfl_time_step. "
+                          "Choices are <constant_time_step|cfl_time_step|embedded_error>.");
+        prm.declare_entry("time_step_cfl", "1.0",
+                          dealii::Patterns::Double(1e-16,dealii::Patterns::Double::max_double_value),
+                          "CFL number multiplying the smallest stable time step of the cells.");
+        prm.declare_entry("time_step_error_tolerance", "1e-6",
+                          dealii::Patterns::Double(1e-16,dealii::Patterns::Double::max_double_value),
+                          "Relative and absolute tolerance on the local error estimate of a time step.");
+        prm.declare_entry("local_time_stepping_levels", "4",
+                          dealii::Patterns::Integer(1,20),
+                          "Number of time levels of the explicit_local_time_stepping solver. "
+                          "Cells of level l take time steps 2^l times larger than the finest level.");
+
+        prm.declare_entry("implicit_time_integration", "backward_euler",
+                          dealii::Patterns::Selection("backward_euler|bdf2|esdirk3|esdirk4"),
+                          "Time integration method used by the implicit solver for unsteady problems. "
+                          "Choices are <backward_euler|bdf2|esdirk3|esdirk4>.");
+        prm.declare_entry("implicit_newton_tolerance", "1e-8",
+                          dealii::Patterns::Double(1e-16,dealii::Patterns::Double::max_double_value),
+                          "Relative reduction of the nonlinear residual of each implicit stage of unsteady problems.");
+        prm.declare_entry("implicit_newton_max_iterations", "20",
+                          dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                          "Maximum number of Newton iterations per implicit stage of unsteady problems.");
+        prm.declare_entry("jacobian_lagging_max_age", "1",
+                          dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                          "Maximum number of time steps over which the Jacobian of unsteady implicit problems is reused. "
+                          "It is refreshed earlier if the Newton iterations stop converging.");
+
+        prm.declare_entry("jacobian_reuse_iterations", "1",
+                          dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                          "Number of steady nonlinear iterations using the same assembled Jacobian. "
+                          "A reused Jacobian keeps the pseudo-time step of its assembly.");
+        prm.declare_entry("preconditioner_reuse_iterations", "1",
+                          dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                          "Number of steady nonlinear iterations using the same preconditioner setup.");
+        prm.declare_entry("reuse_linear_iterations_growth", "2.0",
+                          dealii::Patterns::Double(1.0,dealii::Patterns::Double::max_double_value),
+                          "Refresh the reused Jacobian and preconditioner once the linear iterations grow beyond "
+                          "this factor times those of the first solve with the current preconditioner.");
 
         prm.declare_entry("nonlinear_max_iterations", "500000",
                           dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
@@ -40,6 +90,39 @@ void ODESolverParam::declare_parameters (dealii::ParameterHandler &prm)
                           dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
                           "Scales initial time step by pow(time_step_factor_residual*(-log10(residual_norm_decrease)),time_step_factor_residual_exp).");
 
+        prm.declare_entry("cfl_controller", "residual_ramp",
+                          dealii::Patterns::Selection("residual_ramp|ser|exponential"),
+                          "Policy growing the CFL of steady state solves. "
+                          "Choices are <residual_ramp|ser|exponential>.");
+        prm.declare_entry("cfl_growth_factor", "1.5",
+                          dealii::Patterns::Double(1.0,dealii::Patterns::Double::max_double_value),
+                          "Growth of the CFL per accepted step of the exponential cfl_controller.");
+        prm.declare_entry("ser_exponent", "1.0",
+                          dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
+                          "Exponent of the ratio between the previous and current residual norms "
+                          "scaling the CFL of the ser cfl_controller.");
+        prm.declare_entry("max_cfl", "1e10",
+                          dealii::Patterns::Double(1e-16,dealii::Patterns::Double::max_double_value),
+                          "Upper bound on the CFL of steady state solves.");
+        prm.declare_entry("cfl_backtracking", "false",
+                          dealii::Patterns::Bool(),
+                          "Reject the steady iterations whose linesearch fails to reduce the residual, "
+                          "restore the solution, and reduce the CFL by cfl_reduction_factor. "
+                          "Otherwise, the linesearch accepts a relaxed residual increase.");
+        prm.declare_entry("cfl_reduction_factor", "0.1",
+                          dealii::Patterns::Double(1e-16,1.0),
+                          "Reduction of the CFL after a rejected steady iteration.");
+
+        prm.declare_entry("jacobian_free_newton_krylov", "false",
+                          dealii::Patterns::Bool(),
+                          "Assemble the Jacobian of the implicit solver by default. "
+                          "Otherwise, apply it through finite differences of the residual "
+                          "and only assemble its diagonal blocks as a preconditioner.");
+        prm.declare_entry("jacobian_free_perturbation", "0.0",
+                          dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
+                          "Finite difference step of the Jacobian-vector products. "
+                          "If 0, the step is scaled by the solution and the vector norms.");
+
         prm.declare_entry("print_iteration_modulo", "1",
                           dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
                           "Print every print_iteration_modulo iterations of "
@@ -61,6 +144,33 @@ void ODESolverParam::parse_parameters (dealii::ParameterHandler &prm)
         const std::string solver_string = prm.get("ode_solver_type");
         if (solver_string == "explicit") ode_solver_type = ODESolverEnum::explicit_solver;
         if (solver_string == "implicit") ode_solver_type = ODESolverEnum::implicit_solver;
+        if (solver_string == "explicit_local_time_stepping") ode_solver_type = ODESolverEnum::explicit_local_time_stepping_solver;
+
+        const std::string runge_kutta_string = prm.get("runge_kutta_method");
+        if (runge_kutta_string == "forward_euler")           runge_kutta_method = RungeKuttaEnum::forward_euler;
+        if (runge_kutta_string == "ssp_rk3")                 runge_kutta_method = RungeKuttaEnum::ssp_rk3;
+        if (runge_kutta_string == "lsrk4_carpenter_kennedy") runge_kutta_method = RungeKuttaEnum::lsrk4_carpenter_kennedy;
+        if (runge_kutta_string == "ssp_rk10_4")              runge_kutta_method = RungeKuttaEnum::ssp_rk10_4;
+
+        const std::string time_step_control_string = prm.get("time_step_control");
+        if (time_step_control_string == "constant_time_step") time_step_control = TimeStepControlEnum::constant_time_step;
+        if (time_step_control_string == "cfl_time_step")      time_step_control = TimeStepControlEnum::cfl_time_step;
+        if (time_step_control_string == "embedded_error")     time_step_control = TimeStepControlEnum::embedded_error;
+        time_step_cfl = prm.get_double("time_step_cfl");
+        time_step_error_tolerance = prm.get_double("time_step_error_tolerance");
+        local_time_stepping_levels = prm.get_integer("local_time_stepping_levels");
+
+        const std::string implicit_string = prm.get("implicit_time_integration");
+        if (implicit_string == "backward_euler") implicit_time_integration = ImplicitTimeIntegrationEnum::backward_euler;
+        if (implicit_string == "bdf2")           implicit_time_integration = ImplicitTimeIntegrationEnum::bdf2;
+        if (implicit_string == "esdirk3")        implicit_time_integration = ImplicitTimeIntegrationEnum::esdirk3;
+        if (implicit_string == "esdirk4")        implicit_time_integration = ImplicitTimeIntegrationEnum::esdirk4;
+        implicit_newton_tolerance = prm.get_double("implicit_newton_tolerance");
+        implicit_newton_max_iterations = prm.get_integer("implicit_newton_max_iterations");
+        jacobian_lagging_max_age = prm.get_integer("jacobian_lagging_max_age");
+        jacobian_reuse_iterations = prm.get_integer("jacobian_reuse_iterations");
+        preconditioner_reuse_iterations = prm.get_integer("preconditioner_reuse_iterations");
+        reuse_linear_iterations_growth = prm.get_double("reuse_linear_iterations_growth");
 
         nonlinear_steady_residual_tolerance  = prm.get_double("nonlinear_steady_residual_tolerance");
         nonlinear_max_iterations = prm.get_integer("nonlinear_max_iterations");
@@ -68,6 +178,19 @@ void ODESolverParam::parse_parameters (dealii::ParameterHandler &prm)
         time_step_factor_residual = prm.get_double("time_step_factor_residual");
         time_step_factor_residual_exp = prm.get_double("time_step_factor_residual_exp");
 
+        const std::string cfl_controller_string = prm.get("cfl_controller");
+        if (cfl_controller_string == "residual_ramp") cfl_controller = CFLControllerEnum::residual_ramp;
+        if (cfl_controller_string == "ser")           cfl_controller = CFLControllerEnum::ser;
+        if (cfl_controller_string == "exponential")   cfl_controller = CFLControllerEnum::exponential;
+        cfl_growth_factor = prm.get_double("cfl_growth_factor");
+        ser_exponent = prm.get_double("ser_exponent");
+        max_cfl = prm.get_double("max_cfl");
+        cfl_backtracking = prm.get_bool("cfl_backtracking");
+        cfl_reduction_factor = prm.get_double("cfl_reduction_factor");
+
+        jacobian_free_newton_krylov = prm.get_bool("jacobian_free_newton_krylov");
+        jacobian_free_perturbation = prm.get_double("jacobian_free_perturbation");
+
         print_iteration_modulo = prm.get_integer("print_iteration_modulo");
     }
     prm.leave_subsection();
@@ -14,12 +14,46 @@ public:
     ODESolverParam (); ///< Constructor.
     /// Types of ODE solver
     enum ODESolverEnum {
-        explicit_solver, /// RK4
-        implicit_solver  /// Backward-Euler
+        explicit_solver, /// Runge-Kutta given by runge_kutta_method
+        implicit_solver, /// Backward-Euler for steady states, implicit_time_integration for unsteady problems
+        explicit_local_time_stepping_solver /// Multirate runge_kutta_method with cell-wise time levels
+    };
+
+    /// Explicit Runge-Kutta methods, all implemented in a low-storage form.
+    enum RungeKuttaEnum {
+        forward_euler,           ///< First-order forward Euler.
+        ssp_rk3,                 ///< Three-stage third-order strong stability preserving method of Shu and Osher.
+        lsrk4_carpenter_kennedy, ///< Five-stage fourth-order 2N-storage method RK4(3)5 of Carpenter and Kennedy.
+        ssp_rk10_4               ///< Ten-stage fourth-order strong stability preserving method of Ketcheson.
+    };
+
+    /// Implicit methods used by the implicit solver to advance unsteady problems.
+    enum ImplicitTimeIntegrationEnum {
+        backward_euler, ///< First-order backward Euler.
+        bdf2,           ///< Second-order backward differentiation formula, started by backward Euler.
+        esdirk3,        ///< Four-stage third-order L-stable ESDIRK of Kennedy and Carpenter's ARK3(2)4L[2]SA.
+        esdirk4         ///< Six-stage fourth-order L-stable ESDIRK of Kennedy and Carpenter's ARK4(3)6L[2]SA.
+    };
+
+    /// Policies growing the pseudo-time step, or CFL, of steady_state().
+    enum CFLControllerEnum {
+        residual_ramp, ///< Ramp on the residual decrease given by time_step_factor_residual and time_step_factor_residual_exp.
+        ser,           ///< Switched evolution relaxation, scaling the CFL by the ratio of successive residual norms.
+        exponential    ///< Multiplies the CFL by cfl_growth_factor at every accepted step.
+    };
+
+    /// Choice of the physical time step in advance_solution_time().
+    enum TimeStepControlEnum {
+        constant_time_step, ///< Fixed time step given by initial_time_step.
+        cfl_time_step,      ///< Global minimum of the cell-wise stable time steps times time_step_cfl.
+        embedded_error      ///< PI control of the embedded Runge-Kutta error estimate, bounded by the CFL time step.
     };
 
     OutputEnum ode_output; ///< verbose or quiet.
     ODESolverEnum ode_solver_type; ///< ODE solver type. Note that only implicit has been fully tested for now.
+    RungeKuttaEnum runge_kutta_method; ///< Runge-Kutta method used by the explicit solver.
+    TimeStepControlEnum time_step_control; ///< Choice of the physical time step.
+    ImplicitTimeIntegrationEnum implicit_time_integration; ///< Time integration method of the implicit solver.
 
     int output_solution_every_x_steps; ///< Outputs the solution every x steps to .vtk file
 
@@ -32,6 +66,56 @@ public:
     double time_step_factor_residual; ///< Multiplies initial time-step by time_step_factor_residual*(-log10(residual_norm_decrease))
     double time_step_factor_residual_exp; ///< Scales initial time step by pow(time_step_factor_residual*(-log10(residual_norm_decrease)),time_step_factor_residual_exp)
 
+    CFLControllerEnum cfl_controller; ///< Policy growing the CFL of steady_state().
+    double cfl_growth_factor; ///< Growth of the CFL per accepted step of the exponential cfl_controller.
+    double ser_exponent; ///< Exponent of the residual ratio of the ser cfl_controller.
+    double max_cfl; ///< Upper bound on the CFL of steady_state().
+    /// Flag to reject the pseudo-time steps whose linesearch fails to reduce the residual.
+    /** The solution is then restored and the CFL is multiplied by cfl_reduction_factor.
+     *  Otherwise, the linesearch accepts a relaxed residual increase or steps in the opposite direction.
+     */
+    bool cfl_backtracking;
+    double cfl_reduction_factor; ///< Reduction of the CFL after a rejected pseudo-time step.
+
+    double time_step_cfl; ///< CFL number multiplying the smallest cell-wise stable time step when the time_step_control is adaptive.
+    double time_step_error_tolerance; ///< Relative and absolute tolerance on the local error when time_step_control is embedded_error.
+
+    /// Number of time levels of the explicit_local_time_stepping_solver.
+    /** Cells of level l are advanced with 2^l times the time step of the finest level.
+     */
+    unsigned int local_time_stepping_levels;
+
+    /// Relative reduction of the nonlinear residual of each implicit stage, or time step, of unsteady problems.
+    double implicit_newton_tolerance;
+    /// Maximum number of Newton iterations per implicit stage, or time step, of unsteady problems.
+    unsigned int implicit_newton_max_iterations;
+    /// Maximum number of time steps over which the Jacobian of the implicit_time_integration is reused.
+    /** The Jacobian is also reused across stages and Newton iterations, and refreshed
+     *  earlier if the Newton iterations stop converging.
+     */
+    unsigned int jacobian_lagging_max_age;
+
+    /// Number of steady nonlinear iterations using the same assembled system_matrix.
+    /** A reused system_matrix keeps the pseudo-time step of its assembly.
+     */
+    unsigned int jacobian_reuse_iterations;
+    /// Number of steady nonlinear iterations using the same preconditioner setup, such as the ILUT factorization.
+    unsigned int preconditioner_reuse_iterations;
+    /// The reused Jacobian and preconditioner are refreshed once the linear iterations grow beyond
+    /// this factor times those of the first solve with the current preconditioner.
+    double reuse_linear_iterations_growth;
+
+    /// Flag to solve the implicit linear systems without assembling the Jacobian.
+    /** The Jacobian-vector products are approximated by finite differences of the residual,
+     *  and only the diagonal blocks of the system_matrix are assembled to precondition GMRES.
+     *  Derivative-based features requiring the full dRdW, such as the adjoint, are not available.
+     */
+    bool jacobian_free_newton_krylov;
+    /// Finite difference step used in the Jacobian-vector products.
+    /** If set to 0, the step is given by sqrt(machine_epsilon) * (1 + ||w||) / ||v||.
+     */
+    double jacobian_free_perturbation;
+
     static void declare_parameters (dealii::ParameterHandler &prm); ///< Declares the possible variables and sets the defaults.
     void parse_parameters (dealii::ParameterHandler &prm); ///< Parses input file and sets the variables.
 };
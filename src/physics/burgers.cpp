@@ -208,6 +208,7 @@ template class Burgers < PHILIP_DIM, PHILIP_DIM, FadType  >;
 template class Burgers < PHILIP_DIM, PHILIP_DIM, RadType  >;
 template class Burgers < PHILIP_DIM, PHILIP_DIM, FadFadType >;
 template class Burgers < PHILIP_DIM, PHILIP_DIM, RadFadType >;
+template class Burgers < PHILIP_DIM, PHILIP_DIM, RadPrimalType >;
 
 } // Physics namespace
 } // PHiLiP namespace
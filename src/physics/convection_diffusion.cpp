@@ -221,6 +221,8 @@ template class ConvectionDiffusion < PHILIP_DIM, 1, FadFadType>;
 template class ConvectionDiffusion < PHILIP_DIM, 2, FadFadType>;
 template class ConvectionDiffusion < PHILIP_DIM, 1, RadFadType>;
 template class ConvectionDiffusion < PHILIP_DIM, 2, RadFadType>;
+template class ConvectionDiffusion < PHILIP_DIM, 1, RadPrimalType>;
+template class ConvectionDiffusion < PHILIP_DIM, 2, RadPrimalType>;
 
 } // Physics namespace
 } // PHiLiP namespace
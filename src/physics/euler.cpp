@@ -527,6 +527,129 @@ std::array<dealii::Tensor<1,dim,real>,nstate> Euler<dim,nstate,real>
     return diss_flux;
 }
 
+template <int dim, int nstate, typename real>
+void Euler<dim,nstate,real>
+::convective_flux_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    const real *density = conservative_soln[0].data();
+    const real *tot_energy = conservative_soln[nstate-1].data();
+
+    // Pressure and specific total enthalpy, using the same safeguard as compute_pressure()
+    std::array<std::vector<real>,dim> vel;
+    std::vector<real> pressure(n_pts), specific_total_enthalpy(n_pts);
+    for (int d=0; d<dim; ++d) {
+        vel[d].resize(n_pts);
+        const real *momentum = conservative_soln[1+d].data();
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            vel[d][ipoint] = momentum[ipoint]/density[ipoint];
+        }
+    }
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        real vel2 = 0.0;
+        for (int d=0; d<dim; ++d) { vel2 = vel2 + vel[d][ipoint]*vel[d][ipoint]; }
+        pressure[ipoint] = gamm1*(tot_energy[ipoint] - 0.5*density[ipoint]*vel2);
+        if (pressure[ipoint] < 0.0) pressure[ipoint] = 1e10;
+        specific_total_enthalpy[ipoint] = tot_energy[ipoint]/density[ipoint] + pressure[ipoint]/density[ipoint];
+    }
+
+    for (int flux_dim=0; flux_dim<dim; ++flux_dim) {
+        const real *vel_flux_dim = vel[flux_dim].data();
+        // Density equation
+        conv_flux[0][flux_dim] = conservative_soln[1+flux_dim];
+        // Momentum equation
+        for (int velocity_dim=0; velocity_dim<dim; ++velocity_dim){
+            std::vector<real> &flux = conv_flux[1+velocity_dim][flux_dim];
+            flux.resize(n_pts);
+            const real *vel_velocity_dim = vel[velocity_dim].data();
+            for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+                flux[ipoint] = density[ipoint]*vel_flux_dim[ipoint]*vel_velocity_dim[ipoint];
+            }
+        }
+        // Add diagonal of pressure
+        std::vector<real> &diagonal_flux = conv_flux[1+flux_dim][flux_dim];
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            diagonal_flux[ipoint] += pressure[ipoint];
+        }
+        // Energy equation
+        std::vector<real> &energy_flux = conv_flux[nstate-1][flux_dim];
+        energy_flux.resize(n_pts);
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            energy_flux[ipoint] = density[ipoint]*vel_flux_dim[ipoint]*specific_total_enthalpy[ipoint];
+        }
+    }
+}
+
+template <int dim, int nstate, typename real>
+void Euler<dim,nstate,real>
+::convective_eigenvalues_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    const std::array<std::vector<real>,dim> &normal,
+    std::array<std::vector<real>,nstate> &eig) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    const real *density = conservative_soln[0].data();
+    std::vector<real> vel_dot_n(n_pts, 0.0);
+    for (int d=0; d<dim; ++d) {
+        const real *momentum = conservative_soln[1+d].data();
+        const real *normal_d = normal[d].data();
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            vel_dot_n[ipoint] += (momentum[ipoint]/density[ipoint])*normal_d[ipoint];
+        }
+    }
+    for (int i=0; i<nstate; i++) {
+        eig[i] = vel_dot_n;
+    }
+}
+
+template <int dim, int nstate, typename real>
+void Euler<dim,nstate,real>
+::max_convective_eigenvalue_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    std::vector<real> &max_eig) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    const real *density = conservative_soln[0].data();
+    const real *tot_energy = conservative_soln[nstate-1].data();
+    max_eig.resize(n_pts);
+
+    std::vector<real> vel2(n_pts, 0.0);
+    for (int d=0; d<dim; ++d) {
+        const real *momentum = conservative_soln[1+d].data();
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+            const real vel = momentum[ipoint]/density[ipoint];
+            vel2[ipoint] += vel*vel;
+        }
+    }
+    // Same safeguards as compute_pressure() and compute_sound()
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        real pressure = gamm1*(tot_energy[ipoint] - 0.5*density[ipoint]*vel2[ipoint]);
+        if (pressure < 0.0) pressure = 1e10;
+        real rho = density[ipoint];
+        if (rho < 0.0) rho = 1e10;
+        const real sound = sqrt(pressure*gam/rho);
+        max_eig[ipoint] = sqrt(vel2[ipoint]) + sound;
+    }
+}
+
+template <int dim, int nstate, typename real>
+void Euler<dim,nstate,real>
+::dissipative_flux_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    const std::array<std::array<std::vector<real>,dim>,nstate> &/*solution_gradient*/,
+    std::array<std::array<std::vector<real>,dim>,nstate> &diss_flux) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    // No dissipation
+    for (int i=0; i<nstate; i++) {
+        for (int d=0; d<dim; d++) {
+            diss_flux[i][d].assign(n_pts, 0.0);
+        }
+    }
+}
+
 template <int dim, int nstate, typename real>
 void Euler<dim,nstate,real>
 ::boundary_riemann (
@@ -976,6 +1099,7 @@ template class Euler < PHILIP_DIM, PHILIP_DIM+2, FadType  >;
 template class Euler < PHILIP_DIM, PHILIP_DIM+2, RadType  >;
 template class Euler < PHILIP_DIM, PHILIP_DIM+2, FadFadType >;
 template class Euler < PHILIP_DIM, PHILIP_DIM+2, RadFadType >;
+template class Euler < PHILIP_DIM, PHILIP_DIM+2, RadPrimalType >;
 
 } // Physics namespace
 } // PHiLiP namespace
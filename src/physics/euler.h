@@ -146,6 +146,30 @@ public:
         const std::array<real,nstate> &conservative_soln,
         const std::array<dealii::Tensor<1,dim,real>,nstate> &solution_gradient) const;
 
+    /// Convective flux at a batch of points.
+    /** Evaluated one quantity at a time over all the points, such that the loops are vectorized.
+     */
+    void convective_flux_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const override;
+
+    /// Spectral radius of convective term Jacobian at a batch of points.
+    void convective_eigenvalues_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        const std::array<std::vector<real>,dim> &normal,
+        std::array<std::vector<real>,nstate> &eig) const override;
+
+    /// Maximum convective eigenvalue at a batch of points.
+    void max_convective_eigenvalue_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        std::vector<real> &max_eig) const override;
+
+    /// Dissipative flux at a batch of points: 0
+    void dissipative_flux_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        const std::array<std::array<std::vector<real>,dim>,nstate> &solution_gradient,
+        std::array<std::array<std::vector<real>,dim>,nstate> &diss_flux) const override;
+
     /// Source term is zero or depends on manufactured solution
     std::array<real,nstate> source_term (
         const dealii::Point<dim,real> &pos,
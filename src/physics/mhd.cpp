@@ -469,6 +469,49 @@ std::array<dealii::Tensor<1,dim,real>,nstate> MHD<dim,nstate,real>
     return diss_flux;
 }
 
+template <int dim, int nstate, typename real>
+void MHD<dim,nstate,real>
+::convective_flux_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    for (int s=0; s<nstate; s++) {
+        for (int d=0; d<dim; d++) {
+            conv_flux[s][d].resize(n_pts);
+        }
+    }
+    std::array<real,nstate> soln;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = conservative_soln[s][ipoint];
+        }
+        const std::array<dealii::Tensor<1,dim,real>,nstate> flux = MHD<dim,nstate,real>::convective_flux(soln);
+        for (int s=0; s<nstate; s++) {
+            for (int d=0; d<dim; d++) {
+                conv_flux[s][d][ipoint] = flux[s][d];
+            }
+        }
+    }
+}
+
+template <int dim, int nstate, typename real>
+void MHD<dim,nstate,real>
+::max_convective_eigenvalue_batch (
+    const std::array<std::vector<real>,nstate> &conservative_soln,
+    std::vector<real> &max_eig) const
+{
+    const unsigned int n_pts = conservative_soln[0].size();
+    max_eig.resize(n_pts);
+    std::array<real,nstate> soln;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = conservative_soln[s][ipoint];
+        }
+        max_eig[ipoint] = MHD<dim,nstate,real>::max_convective_eigenvalue(soln);
+    }
+}
+
 //template <int dim, int nstate, typename real>
 //void MHD<dim,nstate,real>
 //::boundary_face_values (
@@ -801,6 +844,7 @@ template class MHD < PHILIP_DIM, 8, FadType >;
 template class MHD < PHILIP_DIM, 8, RadType >;
 template class MHD < PHILIP_DIM, 8, FadFadType >;
 template class MHD < PHILIP_DIM, 8, RadFadType >;
+template class MHD < PHILIP_DIM, 8, RadPrimalType >;
 
 } // Physics namespace
 } // PHiLiP namespace
@@ -122,6 +122,18 @@ public:
         const std::array<real,nstate> &conservative_soln,
         const std::array<dealii::Tensor<1,dim,real>,nstate> &solution_gradient) const;
 
+    /// Convective flux at a batch of points.
+    /** Calls the MHD convective flux directly, avoiding the virtual call per point.
+     */
+    void convective_flux_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const override;
+
+    /// Maximum convective eigenvalue at a batch of points.
+    void max_convective_eigenvalue_batch (
+        const std::array<std::vector<real>,nstate> &conservative_soln,
+        std::vector<real> &max_eig) const override;
+
     /// Source term is zero or depends on manufactured solution
     std::array<real,nstate> source_term (
         const dealii::Point<dim,real> &pos,
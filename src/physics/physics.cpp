@@ -61,6 +61,107 @@ dealii::Tensor<2,dim,double> PhysicsBase<dim,nstate,real>::eval_diffusion_tensor
 template <int dim, int nstate, typename real>
 PhysicsBase<dim,nstate,real>::~PhysicsBase() {}
 
+template <int dim, int nstate, typename real>
+void PhysicsBase<dim,nstate,real>
+::convective_flux_batch (
+    const std::array<std::vector<real>,nstate> &solution,
+    std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const
+{
+    const unsigned int n_pts = solution[0].size();
+    for (int s=0; s<nstate; s++) {
+        for (int d=0; d<dim; d++) {
+            conv_flux[s][d].resize(n_pts);
+        }
+    }
+    std::array<real,nstate> soln;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = solution[s][ipoint];
+        }
+        const std::array<dealii::Tensor<1,dim,real>,nstate> flux = convective_flux(soln);
+        for (int s=0; s<nstate; s++) {
+            for (int d=0; d<dim; d++) {
+                conv_flux[s][d][ipoint] = flux[s][d];
+            }
+        }
+    }
+}
+
+template <int dim, int nstate, typename real>
+void PhysicsBase<dim,nstate,real>
+::convective_eigenvalues_batch (
+    const std::array<std::vector<real>,nstate> &solution,
+    const std::array<std::vector<real>,dim> &normal,
+    std::array<std::vector<real>,nstate> &eig) const
+{
+    const unsigned int n_pts = solution[0].size();
+    for (int s=0; s<nstate; s++) {
+        eig[s].resize(n_pts);
+    }
+    std::array<real,nstate> soln;
+    dealii::Tensor<1,dim,real> normal_at_point;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = solution[s][ipoint];
+        }
+        for (int d=0; d<dim; d++) {
+            normal_at_point[d] = normal[d][ipoint];
+        }
+        const std::array<real,nstate> eig_at_point = convective_eigenvalues(soln, normal_at_point);
+        for (int s=0; s<nstate; s++) {
+            eig[s][ipoint] = eig_at_point[s];
+        }
+    }
+}
+
+template <int dim, int nstate, typename real>
+void PhysicsBase<dim,nstate,real>
+::max_convective_eigenvalue_batch (
+    const std::array<std::vector<real>,nstate> &solution,
+    std::vector<real> &max_eig) const
+{
+    const unsigned int n_pts = solution[0].size();
+    max_eig.resize(n_pts);
+    std::array<real,nstate> soln;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = solution[s][ipoint];
+        }
+        max_eig[ipoint] = max_convective_eigenvalue(soln);
+    }
+}
+
+template <int dim, int nstate, typename real>
+void PhysicsBase<dim,nstate,real>
+::dissipative_flux_batch (
+    const std::array<std::vector<real>,nstate> &solution,
+    const std::array<std::array<std::vector<real>,dim>,nstate> &solution_gradient,
+    std::array<std::array<std::vector<real>,dim>,nstate> &diss_flux) const
+{
+    const unsigned int n_pts = solution[0].size();
+    for (int s=0; s<nstate; s++) {
+        for (int d=0; d<dim; d++) {
+            diss_flux[s][d].resize(n_pts);
+        }
+    }
+    std::array<real,nstate> soln;
+    std::array<dealii::Tensor<1,dim,real>,nstate> soln_grad;
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        for (int s=0; s<nstate; s++) {
+            soln[s] = solution[s][ipoint];
+            for (int d=0; d<dim; d++) {
+                soln_grad[s][d] = solution_gradient[s][d][ipoint];
+            }
+        }
+        const std::array<dealii::Tensor<1,dim,real>,nstate> flux = dissipative_flux(soln, soln_grad);
+        for (int s=0; s<nstate; s++) {
+            for (int d=0; d<dim; d++) {
+                diss_flux[s][d][ipoint] = flux[s][d];
+            }
+        }
+    }
+}
+
 template <int dim, int nstate, typename real>
 std::array<dealii::Tensor<1,dim,real>,nstate> PhysicsBase<dim,nstate,real>
 ::artificial_dissipative_flux (
@@ -250,6 +351,13 @@ template class PhysicsBase < PHILIP_DIM, 4, RadFadType >;
 template class PhysicsBase < PHILIP_DIM, 5, RadFadType >;
 template class PhysicsBase < PHILIP_DIM, 8, RadFadType >;
 
+template class PhysicsBase < PHILIP_DIM, 1, RadPrimalType >;
+template class PhysicsBase < PHILIP_DIM, 2, RadPrimalType >;
+template class PhysicsBase < PHILIP_DIM, 3, RadPrimalType >;
+template class PhysicsBase < PHILIP_DIM, 4, RadPrimalType >;
+template class PhysicsBase < PHILIP_DIM, 5, RadPrimalType >;
+template class PhysicsBase < PHILIP_DIM, 8, RadPrimalType >;
+
 } // Physics namespace
 } // PHiLiP namespace
 
@@ -1,6 +1,9 @@
 #ifndef __PHYSICS__
 #define __PHYSICS__
 
+#include <array>
+#include <vector>
+
 #include <deal.II/base/tensor.h>
 #include <deal.II/numerics/data_component_interpretation.h>
 #include <deal.II/fe/fe_update_flags.h>
@@ -58,6 +61,33 @@ public:
     /// Maximum convective eigenvalue used in Lax-Friedrichs
     virtual real max_convective_eigenvalue (const std::array<real,nstate> &soln) const = 0;
 
+    /// Convective fluxes evaluated at a batch of points.
+    /** Structure-of-arrays version of convective_flux(), where @p solution[istate][ipoint]
+     *  and @p conv_flux[istate][idim][ipoint]. The output is resized by this function.
+     *
+     *  The default implementation calls convective_flux() at every point. Derived classes
+     *  should override it such that the flux of a whole cell or face is evaluated without
+     *  a virtual call per point, and with loops the compiler is able to vectorize.
+     */
+    virtual void convective_flux_batch (
+        const std::array<std::vector<real>,nstate> &solution,
+        std::array<std::array<std::vector<real>,dim>,nstate> &conv_flux) const;
+
+    /// Spectral radius of the convective term Jacobian at a batch of points.
+    /** Structure-of-arrays version of convective_eigenvalues(), where @p normal[idim][ipoint].
+     */
+    virtual void convective_eigenvalues_batch (
+        const std::array<std::vector<real>,nstate> &solution,
+        const std::array<std::vector<real>,dim> &normal,
+        std::array<std::vector<real>,nstate> &eig) const;
+
+    /// Maximum convective eigenvalue at a batch of points.
+    /** Structure-of-arrays version of max_convective_eigenvalue().
+     */
+    virtual void max_convective_eigenvalue_batch (
+        const std::array<std::vector<real>,nstate> &solution,
+        std::vector<real> &max_eig) const;
+
     // /// Evaluate the diffusion matrix \f$ A \f$ such that \f$F_v = A \nabla u\f$.
     // virtual std::array<dealii::Tensor<1,dim,real>,nstate> apply_diffusion_matrix (
     //     const std::array<real,nstate> &solution,
@@ -77,6 +107,15 @@ public:
         const std::array<real,nstate> &solution,
         const std::array<dealii::Tensor<1,dim,real>,nstate> &solution_gradient) const = 0;
 
+    /// Dissipative fluxes evaluated at a batch of points.
+    /** Structure-of-arrays version of dissipative_flux(), where @p solution_gradient[istate][idim][ipoint].
+     *  The default implementation calls dissipative_flux() at every point.
+     */
+    virtual void dissipative_flux_batch (
+        const std::array<std::vector<real>,nstate> &solution,
+        const std::array<std::array<std::vector<real>,dim>,nstate> &solution_gradient,
+        std::array<std::array<std::vector<real>,dim>,nstate> &diss_flux) const;
+
     /// Artificial dissipative fluxes that will be differentiated ONCE in space.
     /** Stems from the Persson2006 paper on subcell shock capturing */
     virtual std::array<dealii::Tensor<1,dim,real>,nstate> artificial_dissipative_flux (
@@ -80,6 +80,13 @@ template class PhysicsFactory<PHILIP_DIM, 4, RadFadType >;
 template class PhysicsFactory<PHILIP_DIM, 5, RadFadType >;
 template class PhysicsFactory<PHILIP_DIM, 8, RadFadType >;
 
+template class PhysicsFactory<PHILIP_DIM, 1, RadPrimalType >;
+template class PhysicsFactory<PHILIP_DIM, 2, RadPrimalType >;
+template class PhysicsFactory<PHILIP_DIM, 3, RadPrimalType >;
+template class PhysicsFactory<PHILIP_DIM, 4, RadPrimalType >;
+template class PhysicsFactory<PHILIP_DIM, 5, RadPrimalType >;
+template class PhysicsFactory<PHILIP_DIM, 8, RadPrimalType >;
+
 
 
 } // Physics namespace
@@ -32,9 +32,12 @@ template<int dim, int nstate>
 double BurgersEnergyStability<dim, nstate>::compute_energy(std::shared_ptr < PHiLiP::DGBase<dim, double> > &dg) const
 {
  double energy = 0.0;
+ dealii::LinearAlgebra::distributed::Vector<double> inverse_mass_diagonal;
+ inverse_mass_diagonal.reinit(dg->solution);
+ dg->inverse_mass_operator.get_diagonal(inverse_mass_diagonal);
  for (unsigned int i = 0; i < dg->solution.size(); ++i)
  {
-  energy += 1./(dg->global_inverse_mass_matrix(i,i)) * dg->solution(i) * dg->solution(i);
+  energy += 1./(inverse_mass_diagonal(i)) * dg->solution(i) * dg->solution(i);
  }
  return energy;
 }
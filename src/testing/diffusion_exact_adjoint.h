@@ -195,6 +195,15 @@ class DiffusionFunctional : public Functional<dim, nstate, real>
    return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
   }
      /// Non-template functions to override the template classes
+  FadType evaluate_volume_integrand(
+            const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+            const dealii::Point<dim,FadType> &phys_coord,
+            const std::array<FadType,nstate> &soln_at_q,
+            const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const override
+  {
+   return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+  }
+     /// Non-template functions to override the template classes
   FadFadType evaluate_volume_integrand(
             const PHiLiP::Physics::PhysicsBase<dim,nstate,FadFadType> &physics,
             const dealii::Point<dim,FadFadType> &phys_coord,
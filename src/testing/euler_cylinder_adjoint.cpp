@@ -85,6 +85,16 @@ public:
     using FadType = Sacado::Fad::DFad<real>; ///< Sacado AD type for first derivatives.
     using FadFadType = Sacado::Fad::DFad<FadType>; ///< Sacado AD type that allows 2nd derivatives.
 
+    /// non-template functions to override the template classes
+    FadType evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+        const dealii::Point<dim,FadType> &phys_coord,
+        const std::array<FadType,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const override
+    {
+        return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+    }
+
     /// non-template functions to override the template classes
     FadFadType evaluate_volume_integrand(
         const PHiLiP::Physics::PhysicsBase<dim,nstate,FadFadType> &physics,
@@ -1,5 +1,6 @@
 #include <stdlib.h>     /* srand, rand */
 #include <iostream>
+#include <cmath>
 
 #include <deal.II/base/convergence_table.h>
 
@@ -138,6 +139,10 @@ template<int dim, int nstate>
 int EulerVortex<dim,nstate>
 ::run_test () const
 {
+    if (TestsBase::all_parameters->test_type == Parameters::AllParameters::TestType::euler_vortex_temporal_convergence) {
+        return run_temporal_convergence();
+    }
+
     using ManParam = Parameters::ManufacturedConvergenceStudyParam;
     using GridEnum = ManParam::GridEnum;
     const Parameters::AllParameters param = *(TestsBase::all_parameters);
@@ -410,6 +415,97 @@ int EulerVortex<dim,nstate>
     return n_fail_poly;
 }
 
+template<int dim, int nstate>
+int EulerVortex<dim,nstate>
+::run_temporal_convergence () const
+{
+    using ImplicitEnum = Parameters::ODESolverParam::ImplicitTimeIntegrationEnum;
+    const Parameters::AllParameters param = *(TestsBase::all_parameters);
+    const Parameters::ManufacturedConvergenceStudyParam &manu_grid_conv_param = param.manufactured_convergence_study_param;
+
+    unsigned int expected_order = 1;
+    if (param.ode_solver_param.implicit_time_integration == ImplicitEnum::bdf2)    expected_order = 2;
+    if (param.ode_solver_param.implicit_time_integration == ImplicitEnum::esdirk3) expected_order = 3;
+    if (param.ode_solver_param.implicit_time_integration == ImplicitEnum::esdirk4) expected_order = 4;
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&param);
+    std::shared_ptr <Physics::Euler<dim,nstate,double>> euler = std::dynamic_pointer_cast<Physics::Euler<dim,nstate,double>>(physics);
+
+    const dealii::Point<dim> initial_vortex_center(-0.0,-0.0);
+    const double vortex_strength = euler->mach_inf*4.0;
+    const double vortex_stddev_decay = 1.0;
+    const double half_length = 5*euler->ref_length;
+    EulerVortexFunction<dim,double> initial_vortex_function(*euler, initial_vortex_center, vortex_strength, vortex_stddev_decay);
+    initial_vortex_function.set_time(0.0);
+
+    using Triangulation = dealii::parallel::distributed::Triangulation<dim>;
+    std::shared_ptr <Triangulation> grid = std::make_shared<Triangulation> (this->mpi_communicator);
+    const unsigned int n_1d_cells = manu_grid_conv_param.initial_grid_size;
+    const std::vector<unsigned int> n_subdivisions(dim, n_1d_cells);
+    const bool colorize = true;
+    dealii::Point<dim> p1(-half_length,-half_length), p2(half_length,half_length);
+    dealii::GridGenerator::subdivided_hyper_rectangle (*grid, n_subdivisions, p1, p2, colorize);
+    for (auto cell = grid->begin_active(); cell != grid->end(); ++cell) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1004); // Farfield
+        }
+    }
+
+    // The coarsest run takes 4 time steps of initial_time_step, and the last run is the reference.
+    const unsigned int poly_degree = manu_grid_conv_param.degree_end;
+    const unsigned int n_time_step_sizes = manu_grid_conv_param.number_of_grids;
+    const double coarsest_time_step = param.ode_solver_param.initial_time_step;
+    const double final_time = 4.0 * coarsest_time_step;
+
+    std::vector<double> time_steps(n_time_step_sizes+1);
+    std::vector<dealii::LinearAlgebra::distributed::Vector<double>> final_solutions(n_time_step_sizes+1);
+    for (unsigned int irun = 0; irun <= n_time_step_sizes; ++irun) {
+        const unsigned int refinement = (irun < n_time_step_sizes) ? irun : n_time_step_sizes+1;
+        time_steps[irun] = coarsest_time_step / std::pow(2.0, refinement);
+
+        Parameters::AllParameters time_step_param = param;
+        time_step_param.ode_solver_param.initial_time_step = time_steps[irun];
+
+        std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&time_step_param, poly_degree, grid);
+        dg->allocate_system ();
+        dealii::VectorTools::interpolate(dg->dof_handler, initial_vortex_function, dg->solution);
+
+        std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+        ode_solver->advance_solution_time(final_time);
+        final_solutions[irun] = dg->solution;
+    }
+
+    dealii::ConvergenceTable convergence_table;
+    std::vector<double> soln_error(n_time_step_sizes);
+    for (unsigned int irun = 0; irun < n_time_step_sizes; ++irun) {
+        dealii::LinearAlgebra::distributed::Vector<double> difference = final_solutions[irun];
+        difference -= final_solutions[n_time_step_sizes];
+        soln_error[irun] = difference.l2_norm();
+
+        convergence_table.add_value("dt", time_steps[irun]);
+        convergence_table.add_value("time_steps", static_cast<unsigned int>(std::round(final_time/time_steps[irun])));
+        convergence_table.add_value("soln_L2_error", soln_error[irun]);
+    }
+    convergence_table.evaluate_convergence_rates("soln_L2_error", "time_steps", dealii::ConvergenceTable::reduction_rate_log2, 1);
+    convergence_table.set_scientific("dt", true);
+    convergence_table.set_scientific("soln_L2_error", true);
+    convergence_table.write_text(std::cout);
+
+    const double last_slope = log(soln_error[n_time_step_sizes-1]/soln_error[n_time_step_sizes-2])
+                              / log(time_steps[n_time_step_sizes-1]/time_steps[n_time_step_sizes-2]);
+    const double slope_deficit_tolerance = -std::abs(manu_grid_conv_param.slope_deficit_tolerance);
+    if (last_slope - expected_order < slope_deficit_tolerance) {
+        std::cout << std::endl
+                  << "Temporal convergence order not achieved. Last slope of "
+                  << last_slope << " instead of expected "
+                  << expected_order << " within a tolerance of "
+                  << slope_deficit_tolerance
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 #if PHILIP_DIM==2
     template class EulerVortex <PHILIP_DIM,PHILIP_DIM+2>;
 #endif
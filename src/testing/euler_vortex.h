@@ -73,6 +73,16 @@ public:
      */
     int run_test () const;
 
+    /// Temporal convergence of the implicit_time_integration method.
+    /** Advances the vortex with a sequence of halved time steps on the initial grid
+     *  with the last polynomial degree of the convergence study. The errors are measured
+     *  against a solution with a four times smaller time step, such that the spatial error
+     *  cancels out, and are expected to converge at the order of the method.
+     *
+     *  Selected by the euler_vortex_temporal_convergence test_type.
+     */
+    int run_temporal_convergence () const;
+
 };
 
 
@@ -1,6 +1,8 @@
 #ifndef __FULL_SPACE_OPTIMIZATION_H__
 #define __FULL_SPACE_OPTIMIZATION_H__
 
+#include <Epetra_RowMatrixTransposer.h>
+
 #include "mesh/meshmover_linear_elasticity.hpp"
 
 #define HESSIAN_DIAG 1e0
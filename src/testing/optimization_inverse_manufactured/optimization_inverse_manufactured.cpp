@@ -645,11 +645,10 @@ int OptimizationInverseManufactured<dim,nstate>
   }
         dRdXs.compress(dealii::VectorOperation::add);
 
-  // Solve for the adjoint variable
-  auto dRdW_T = transpose_trilinos_matrix(dg->system_matrix);
-
+  // Solve for the adjoint variable through the transposed action of dRdW
   Parameters::LinearSolverParam linear_solver_param = all_parameters->linear_solver_param;
-  solve_linear (dRdW_T, inverse_target_functional.dIdw, dg->dual, linear_solver_param);
+  const bool transpose = true;
+  solve_linear (dg->system_matrix, inverse_target_functional.dIdw, dg->dual, linear_solver_param, transpose);
 
   grad_lagrangian = dIdXs;
   grad_lagrangian *= -1.0;
@@ -781,11 +780,10 @@ int OptimizationInverseManufactured<dim,nstate>
   }
         dRdXs.compress(dealii::VectorOperation::add);
 
-  // Solve for the adjoint variable
-  auto dRdW_T = transpose_trilinos_matrix(dg->system_matrix);
-
+  // Solve for the adjoint variable through the transposed action of dRdW
   Parameters::LinearSolverParam linear_solver_param = all_parameters->linear_solver_param;
-  solve_linear (dRdW_T, inverse_target_functional.dIdw, dg->dual, linear_solver_param);
+  const bool transpose = true;
+  solve_linear (dg->system_matrix, inverse_target_functional.dIdw, dg->dual, linear_solver_param, transpose);
 
   const auto old_grad_lagrangian = grad_lagrangian;
   grad_lagrangian = dIdXs;
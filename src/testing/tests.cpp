@@ -80,7 +80,7 @@ std::unique_ptr< TestsBase > TestsFactory<dim,nstate>
         if constexpr (dim==2 && nstate==dim+2) return std::make_unique<EulerCylinder<dim,nstate>>(parameters_input);
     } else if(test_type == Test_enum::euler_cylinder_adjoint) {
         if constexpr (dim==2 && nstate==dim+2) return std::make_unique<EulerCylinderAdjoint<dim,nstate>>(parameters_input);
-    } else if(test_type == Test_enum::euler_vortex) {
+    } else if(test_type == Test_enum::euler_vortex || test_type == Test_enum::euler_vortex_temporal_convergence) {
         if constexpr (dim==2 && nstate==dim+2) return std::make_unique<EulerVortex<dim,nstate>>(parameters_input);
     } else if(test_type == Test_enum::euler_entropy_waves) {
         if constexpr (dim>=2 && nstate==PHILIP_DIM+2) return std::make_unique<EulerEntropyWaves<dim,nstate>>(parameters_input);
@@ -0,0 +1,97 @@
+#include <deal.II/grid/grid_generator.h>
+
+#include "assert_compare_array.h"
+#include "parameters/parameters.h"
+#include "physics/euler.h"
+
+const double TOLERANCE = 1E-12;
+
+int main (int /*argc*/, char * /*argv*/[])
+{
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+
+    const double a = 1.0 , b = 0.0, c = 1.4;
+    PHiLiP::Physics::Euler<dim, nstate, double> euler_physics = PHiLiP::Physics::Euler<dim, nstate, double>(a,c,a,b,b);
+
+    const double min = 0.0;
+    const double max = 1.0;
+    const int nx = 11;
+
+    std::vector<unsigned int> repetitions(dim, nx);
+    dealii::Point<dim,double> corner1, corner2;
+    for (int d=0; d<dim; d++) { 
+        corner1[d] = min;
+        corner2[d] = max;
+    }
+    dealii::Triangulation<dim> grid;
+    dealii::GridGenerator::subdivided_hyper_rectangle(grid, repetitions, corner1, corner2);
+
+    // Gather the manufactured solution at the vertices in a structure-of-arrays batch.
+    std::vector<std::array<double, nstate>> points_soln;
+    std::vector<dealii::Tensor<1,dim,double>> points_normal;
+    for (auto cell : grid.active_cell_iterators()) {
+        for (unsigned int v=0; v < dealii::GeometryInfo<dim>::vertices_per_cell; ++v) {
+            const dealii::Point<dim,double> vertex = cell->vertex(v);
+            std::array<double, nstate> conservative_soln;
+            for (int s=0; s<nstate; s++) {
+                conservative_soln[s] = euler_physics.manufactured_solution_function->value(vertex, s);
+            }
+            dealii::Tensor<1,dim,double> normal;
+            for (int d=0; d<dim; d++) {
+                normal[d] = vertex[d] - 0.5;
+            }
+            points_soln.push_back(conservative_soln);
+            points_normal.push_back(normal);
+        }
+    }
+    const unsigned int n_pts = points_soln.size();
+
+    std::array<std::vector<double>, nstate> soln_batch;
+    std::array<std::vector<double>, dim> normal_batch;
+    std::array<std::array<std::vector<double>, dim>, nstate> soln_grad_batch;
+    for (int s=0; s<nstate; s++) {
+        soln_batch[s].resize(n_pts);
+        for (int d=0; d<dim; d++) soln_grad_batch[s][d].assign(n_pts, 1.0);
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) soln_batch[s][ipoint] = points_soln[ipoint][s];
+    }
+    for (int d=0; d<dim; d++) {
+        normal_batch[d].resize(n_pts);
+        for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) normal_batch[d][ipoint] = points_normal[ipoint][d];
+    }
+
+    std::array<std::array<std::vector<double>, dim>, nstate> conv_flux_batch, diss_flux_batch;
+    std::array<std::vector<double>, nstate> eig_batch;
+    std::vector<double> max_eig_batch;
+    euler_physics.convective_flux_batch(soln_batch, conv_flux_batch);
+    euler_physics.dissipative_flux_batch(soln_batch, soln_grad_batch, diss_flux_batch);
+    euler_physics.convective_eigenvalues_batch(soln_batch, normal_batch, eig_batch);
+    euler_physics.max_convective_eigenvalue_batch(soln_batch, max_eig_batch);
+
+    // The batched evaluation gives the same result as the point-wise one.
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        const std::array<dealii::Tensor<1,dim,double>, nstate> conv_flux = euler_physics.convective_flux(points_soln[ipoint]);
+        for (int d=0; d<dim; d++) {
+            std::array<double, nstate> flux, flux_batch, diss_flux_batch_d;
+            for (int s=0; s<nstate; s++) {
+                flux[s] = conv_flux[s][d];
+                flux_batch[s] = conv_flux_batch[s][d][ipoint];
+                diss_flux_batch_d[s] = diss_flux_batch[s][d][ipoint];
+            }
+            assert_compare_array<nstate> ( flux, flux_batch, 1.0, TOLERANCE);
+            for (int s=0; s<nstate; s++) {
+                if (diss_flux_batch_d[s] != 0.0) std::abort();
+            }
+        }
+
+        const std::array<double, nstate> eig = euler_physics.convective_eigenvalues(points_soln[ipoint], points_normal[ipoint]);
+        std::array<double, nstate> eig_at_point;
+        for (int s=0; s<nstate; s++) eig_at_point[s] = eig_batch[s][ipoint];
+        assert_compare_array<nstate> ( eig, eig_at_point, 1.0, TOLERANCE);
+
+        const std::array<double, 1> max_eig = {{ euler_physics.max_convective_eigenvalue(points_soln[ipoint]) }};
+        const std::array<double, 1> max_eig_at_point = {{ max_eig_batch[ipoint] }};
+        assert_compare_array<1> ( max_eig, max_eig_at_point, 1.0, TOLERANCE);
+    }
+    return 0;
+}
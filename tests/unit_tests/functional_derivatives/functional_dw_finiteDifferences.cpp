@@ -96,6 +96,16 @@ class L2_Norm_Functional : public PHiLiP::Functional<dim, nstate, real>
             return evaluate_cell_boundary<>(physics, boundary_id, fe_values_boundary, local_solution);
         }
 
+        /// Non-templated cell boundary integral.
+        FadType evaluate_cell_boundary(
+            const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+            const unsigned int boundary_id,
+            const dealii::FEFaceValues<dim,dim> &fe_values_boundary,
+            const std::vector<FadType> &local_solution) const override
+        {
+            return evaluate_cell_boundary<>(physics, boundary_id, fe_values_boundary, local_solution);
+        }
+
         /// Non-templated cell boundary integral.
         FadFadType evaluate_cell_boundary(
             const PHiLiP::Physics::PhysicsBase<dim,nstate,FadFadType> &physics,
@@ -116,6 +126,15 @@ class L2_Norm_Functional : public PHiLiP::Functional<dim, nstate, real>
    return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
   }
      /// non-template functions to override the template classes
+  FadType evaluate_volume_integrand(
+            const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+            const dealii::Point<dim,FadType> &phys_coord,
+            const std::array<FadType,nstate> &soln_at_q,
+            const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const override
+  {
+   return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+  }
+     /// non-template functions to override the template classes
   FadFadType evaluate_volume_integrand(
             const PHiLiP::Physics::PhysicsBase<dim,nstate,FadFadType> &physics,
             const dealii::Point<dim,FadFadType> &phys_coord,
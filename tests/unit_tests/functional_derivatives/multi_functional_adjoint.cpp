@@ -0,0 +1,232 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "functional/adjoint.h"
+#include "functional/functional.h"
+#include "functional/multi_functional_adjoint.h"
+#include "global_counter.hpp"
+#include "linear_solver/linear_solver.h"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Relative residual of the adjoint equations required from each adjoint.
+const double TOLERANCE = 1e-8;
+/// Relative difference allowed with the adjoints and sensitivities of the single-functional Adjoint.
+const double REFERENCE_TOLERANCE = 1e-6;
+
+/// Volume integral of a cubic polynomial of the solution.
+template <int dim, int nstate, typename real>
+class Polynomial_Functional : public PHiLiP::Functional<dim, nstate, real>
+{
+    using FadType = Sacado::Fad::DFad<real>; ///< Sacado AD type for first derivatives.
+    using FadFadType = Sacado::Fad::DFad<FadType>; ///< Sacado AD type that allows 2nd derivatives.
+public:
+    /// Constructor
+    Polynomial_Functional(
+        std::shared_ptr<PHiLiP::DGBase<dim,real>> dg_input,
+        const double _cubic_weight,
+        const double _quadratic_weight,
+        const double _linear_weight)
+        : PHiLiP::Functional<dim,nstate,real>(dg_input,true,false)
+        , cubic_weight(_cubic_weight)
+        , quadratic_weight(_quadratic_weight)
+        , linear_weight(_linear_weight)
+    {}
+
+    /// Templated volume integrand.
+    template <typename real2>
+    real2 evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,real2> &/*physics*/,
+        const dealii::Point<dim,real2> &/*phys_coord*/,
+        const std::array<real2,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,real2>,nstate> &/*soln_grad_at_q*/) const
+    {
+        real2 integrand = 0;
+        for (int istate=0; istate<nstate; ++istate) {
+            const real2 soln = soln_at_q[istate];
+            integrand += ((cubic_weight * soln + quadratic_weight) * soln + linear_weight) * soln;
+        }
+        return integrand;
+    }
+
+    /// Non-template functions to override the template classes
+    real evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,real> &physics,
+        const dealii::Point<dim,real> &phys_coord,
+        const std::array<real,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,real>,nstate> &soln_grad_at_q) const override
+    {
+        return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+    }
+    /// Non-template functions to override the template classes
+    FadType evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,FadType> &physics,
+        const dealii::Point<dim,FadType> &phys_coord,
+        const std::array<FadType,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,FadType>,nstate> &soln_grad_at_q) const override
+    {
+        return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+    }
+    /// Non-template functions to override the template classes
+    FadFadType evaluate_volume_integrand(
+        const PHiLiP::Physics::PhysicsBase<dim,nstate,FadFadType> &physics,
+        const dealii::Point<dim,FadFadType> &phys_coord,
+        const std::array<FadFadType,nstate> &soln_at_q,
+        const std::array<dealii::Tensor<1,dim,FadFadType>,nstate> &soln_grad_at_q) const override
+    {
+        return evaluate_volume_integrand<>(physics, phys_coord, soln_at_q, soln_grad_at_q);
+    }
+
+private:
+    const double cubic_weight; ///< Weight of the cubed solution.
+    const double quadratic_weight; ///< Weight of the squared solution.
+    const double linear_weight; ///< Weight of the solution.
+};
+
+/** Checks the adjoints of several functionals solved by MultiFunctionalAdjoint.
+ *
+ *  Each adjoint must satisfy its adjoint equation, and match, along with its sensitivities,
+ *  the one of the single-functional Adjoint, while the Jacobian is only assembled once and its
+ *  preconditioner only set up once. The last functional adds a cubic term to the sum of the
+ *  first two, such that its right-hand side is not spanned by the previous ones, and its
+ *  initial guess must still save iterations compared to a solve from zero.
+ */
+int main(int argc, char *argv[])
+{
+    const int dim = PHILIP_DIM;
+    const int nstate = 1;
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    dealii::ParameterHandler parameter_handler;
+    PHiLiP::Parameters::AllParameters::declare_parameters(parameter_handler);
+    PHiLiP::Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters(parameter_handler);
+    all_parameters.linear_solver_param.linear_residual = 1e-12;
+    all_parameters.linear_solver_param.max_iterations = 2000;
+
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+#if PHILIP_DIM!=1
+        MPI_COMM_WORLD,
+#endif
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+    const unsigned int n_refinements = 3;
+    const bool colorize = true;
+    dealii::GridGenerator::hyper_cube(*grid, 0.0, 1.0, colorize);
+    grid->refine_global(n_refinements);
+
+    const unsigned int poly_degree = 2;
+    std::shared_ptr < PHiLiP::DGBase<dim, double> > dg = PHiLiP::DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system();
+
+    std::shared_ptr <PHiLiP::Physics::PhysicsBase<dim,nstate,double>> physics_double = PHiLiP::Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+
+    std::vector<std::shared_ptr<PHiLiP::Functional<dim,nstate,double>>> functionals;
+    functionals.push_back(std::make_shared<Polynomial_Functional<dim,nstate,double>>(dg, 0.0, 1.0, 0.0));
+    functionals.push_back(std::make_shared<Polynomial_Functional<dim,nstate,double>>(dg, 0.0, 0.0, 1.0));
+    functionals.push_back(std::make_shared<Polynomial_Functional<dim,nstate,double>>(dg, 0.1, 1.0, 1.0));
+
+    PHiLiP::MultiFunctionalAdjoint<dim,nstate,double> multi_adjoint(dg, functionals);
+    const unsigned int dRdW_form_start = dRdW_form;
+    const unsigned int preconditioner_setup_start = preconditioner_setup;
+    multi_adjoint.solve_adjoints();
+    const unsigned int n_dRdW_form = dRdW_form - dRdW_form_start;
+    const unsigned int n_preconditioner_setup = preconditioner_setup - preconditioner_setup_start;
+
+    int error = 0;
+    if (n_dRdW_form != 1 || n_preconditioner_setup != 1) {
+        pcout << "The Jacobian was assembled " << n_dRdW_form << " times and its preconditioner set up "
+              << n_preconditioner_setup << " times instead of once." << std::endl;
+        error = 1;
+    }
+
+    // The multi-adjoint leaves the Jacobian assembled.
+    dg->assemble_residual(true);
+    for (unsigned int ifunctional = 0; ifunctional < functionals.size(); ++ifunctional) {
+        VectorType residual;
+        residual.reinit(multi_adjoint.dIdw[ifunctional]);
+        dg->system_matrix.Tvmult(residual, multi_adjoint.adjoints[ifunctional]);
+        residual += multi_adjoint.dIdw[ifunctional];
+        const double relative_residual = residual.l2_norm() / multi_adjoint.dIdw[ifunctional].l2_norm();
+
+        pcout << "Adjoint " << ifunctional << " took " << multi_adjoint.linear_iterations[ifunctional]
+              << " iterations and has a relative residual of " << relative_residual << std::endl;
+        if (relative_residual > TOLERANCE) {
+            pcout << "The adjoint of functional " << ifunctional << " does not satisfy its adjoint equation." << std::endl;
+            error = 1;
+        }
+
+        if (multi_adjoint.sensitivities[ifunctional].size() != dg->high_order_grid.volume_nodes.size()) {
+            pcout << "The sensitivities of functional " << ifunctional << " have not been computed." << std::endl;
+            error = 1;
+        }
+    }
+
+    // Same adjoint solve without the initial guess from the previous adjoints.
+    const unsigned int last = functionals.size()-1;
+    VectorType cold_adjoint;
+    cold_adjoint.reinit(multi_adjoint.dIdw[last]);
+    const bool transpose = true;
+    const unsigned int cold_iterations = PHiLiP::solve_linear(dg->system_matrix, multi_adjoint.dIdw[last], cold_adjoint, all_parameters.linear_solver_param, transpose).first;
+    pcout << "Adjoint " << last << " took " << cold_iterations << " iterations without an initial guess." << std::endl;
+    if (multi_adjoint.linear_iterations[last] >= cold_iterations) {
+        pcout << "The initial guess of functional " << last << " did not save any iteration." << std::endl;
+        error = 1;
+    }
+
+    // Reference adjoints, each solved on its own with a preconditioner set up for it.
+    std::shared_ptr <PHiLiP::Physics::PhysicsBase<dim,nstate,Sacado::Fad::DFad<double>>> physics_fad = PHiLiP::Physics::PhysicsFactory<dim, nstate, Sacado::Fad::DFad<double>>::create_Physics(&all_parameters);
+    std::vector<VectorType> reference_adjoints;
+    for (unsigned int ifunctional = 0; ifunctional < functionals.size(); ++ifunctional) {
+        PHiLiP::Adjoint<dim,nstate,double> adjoint(*dg, *functionals[ifunctional], *physics_fad);
+        reference_adjoints.push_back(adjoint.coarse_grid_adjoint());
+        reference_adjoints.back().update_ghost_values();
+    }
+
+    dg->assemble_residual(false, true, false);
+    for (unsigned int ifunctional = 0; ifunctional < functionals.size(); ++ifunctional) {
+        VectorType adjoint_difference = multi_adjoint.adjoints[ifunctional];
+        adjoint_difference -= reference_adjoints[ifunctional];
+        const double adjoint_error = adjoint_difference.l2_norm() / reference_adjoints[ifunctional].l2_norm();
+
+        const bool compute_dIdW = false, compute_dIdX = true;
+        functionals[ifunctional]->evaluate_functional(compute_dIdW, compute_dIdX);
+        VectorType reference_sensitivity;
+        reference_sensitivity.reinit(functionals[ifunctional]->dIdX);
+        dg->dRdXv.Tvmult(reference_sensitivity, reference_adjoints[ifunctional]);
+        reference_sensitivity += functionals[ifunctional]->dIdX;
+        VectorType sensitivity_difference = multi_adjoint.sensitivities[ifunctional];
+        sensitivity_difference -= reference_sensitivity;
+        const double sensitivity_error = sensitivity_difference.l2_norm() / reference_sensitivity.l2_norm();
+
+        pcout << "Functional " << ifunctional << " has a relative adjoint difference of " << adjoint_error
+              << " and a relative sensitivity difference of " << sensitivity_error << " with the single-functional Adjoint." << std::endl;
+        if (adjoint_error > REFERENCE_TOLERANCE || sensitivity_error > REFERENCE_TOLERANCE) {
+            pcout << "The adjoint or sensitivities of functional " << ifunctional << " differ from the single-functional Adjoint." << std::endl;
+            error = 1;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,124 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/convergence_table.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include "linear_solver/linear_solver.h"
+#include "pseudotime_linear_system.h"
+
+using GMRESVariantEnum = PHiLiP::Parameters::LinearSolverParam::GMRESVariantEnum;
+using PreconditionerEnum = PHiLiP::Parameters::LinearSolverParam::PreconditionerEnum;
+
+/// Cells along each direction owned by each process. The grid is extended along x with the number of processes.
+const unsigned int CELLS_PER_DIRECTION = 8;
+/// Number of solves timed per configuration.
+const int N_SOLVES = 3;
+/// Relative difference allowed between the solutions of the Krylov methods.
+const double TOLERANCE = 1e-5;
+
+/** Weak-scaling benchmark of the pseudo-time linear systems of the Euler equations.
+ *
+ *  Each process owns the same number of cells, such that the wall time of a solve should remain constant
+ *  as processes are added. The standard, pipelined, and flexible GMRES are timed for each preconditioner,
+ *  and their solutions are compared with the standard GMRES with ILUT.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    const unsigned int n_mpi = dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    PseudotimeLinearSystem<dim> system = create_pseudotime_linear_system<dim,nstate>(poly_degree, grid, all_parameters);
+    const std::shared_ptr<DGBase<dim,double>> dg = system.dg;
+    dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side = system.right_hand_side;
+
+    pcout << "Processes: " << n_mpi << " Poly degree: " << poly_degree
+          << " Cells: " << grid->n_global_active_cells() << " DoFs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    const std::vector<GMRESVariantEnum> variants { GMRESVariantEnum::standard, GMRESVariantEnum::pipelined, GMRESVariantEnum::flexible };
+    const std::vector<std::string> variant_names { "standard", "pipelined", "flexible" };
+    const std::vector<PreconditionerEnum> preconditioners { PreconditionerEnum::ilut, PreconditionerEnum::block_jacobi, PreconditionerEnum::block_ilu0 };
+    const std::vector<std::string> preconditioner_names { "ilut", "block_jacobi", "block_ilu0" };
+
+    dealii::LinearAlgebra::distributed::Vector<double> reference_solution;
+    dealii::ConvergenceTable timings;
+    int error = 0;
+    for (unsigned int iprecond = 0; iprecond < preconditioners.size(); ++iprecond) {
+        for (unsigned int ivariant = 0; ivariant < variants.size(); ++ivariant) {
+            Parameters::LinearSolverParam linear_param = all_parameters.linear_solver_param;
+            linear_param.gmres_variant = variants[ivariant];
+            linear_param.preconditioner_type = preconditioners[iprecond];
+
+            dealii::LinearAlgebra::distributed::Vector<double> solution;
+            double max_time = 0.0;
+            std::pair<unsigned int, double> result;
+            for (int isolve = 0; isolve < N_SOLVES; ++isolve) {
+                solution.reinit(right_hand_side);
+                MPI_Barrier(MPI_COMM_WORLD);
+                const double timing_start = MPI_Wtime();
+                result = solve_linear(dg->system_matrix, right_hand_side, solution, linear_param);
+                const double timing_end = MPI_Wtime();
+                max_time = std::max(max_time, dealii::Utilities::MPI::max(timing_end - timing_start, MPI_COMM_WORLD));
+            }
+
+            double difference = 0.0;
+            if (reference_solution.size() == 0) {
+                reference_solution = solution;
+            } else {
+                dealii::LinearAlgebra::distributed::Vector<double> solution_difference = solution;
+                solution_difference -= reference_solution;
+                difference = solution_difference.l2_norm() / reference_solution.l2_norm();
+            }
+
+            timings.add_value("processes", n_mpi);
+            timings.add_value("dofs_per_process", dg->dof_handler.n_dofs() / n_mpi);
+            timings.add_value("preconditioner", preconditioner_names[iprecond]);
+            timings.add_value("gmres_variant", variant_names[ivariant]);
+            timings.add_value("iterations", result.first);
+            timings.add_value("wall_time", max_time);
+            timings.add_value("difference", difference);
+
+            // The relative tolerance of all the solvers bounds their difference.
+            if (difference > TOLERANCE) {
+                pcout << "The " << variant_names[ivariant] << " GMRES with " << preconditioner_names[iprecond]
+                      << " differs by " << difference << " from the standard GMRES with ILUT." << std::endl;
+                error = 1;
+            }
+        }
+    }
+    timings.set_scientific("wall_time", true);
+    timings.set_scientific("difference", true);
+    if (pcout.is_active()) timings.write_text(pcout.get_stream());
+
+    return error;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const unsigned int n_mpi = dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+    Parameters::AllParameters all_parameters;
+    parse_pseudotime_parameters(all_parameters, 1e-10);
+
+    std::shared_ptr<Triangulation> grid = create_pseudotime_grid();
+
+    // Constant number of cells per process.
+    std::vector<unsigned int> repetitions(dim, CELLS_PER_DIRECTION);
+    repetitions[0] *= n_mpi;
+    dealii::Point<dim> lower_left, upper_right;
+    for (int d = 0; d < dim; ++d) upper_right[d] = 1.0;
+    upper_right[0] = n_mpi;
+    dealii::GridGenerator::subdivided_hyper_rectangle(*grid, repetitions, lower_left, upper_right);
+    set_farfield_boundaries(*grid);
+
+    const unsigned int poly_degree = 2;
+    return test<dim,dim+2>(poly_degree, grid, all_parameters);
+}
@@ -0,0 +1,111 @@
+#ifndef __PSEUDOTIME_LINEAR_SYSTEM_H__
+#define __PSEUDOTIME_LINEAR_SYSTEM_H__
+
+#include <memory>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Pseudo-time step of the linear systems, as used by the implicit ODE solver.
+const double PSEUDOTIME_CFL = 1e3;
+
+/// Linear system of a pseudo-time step of the Euler equations, shared by the linear solver tests.
+template<int dim>
+struct PseudotimeLinearSystem
+{
+    /// Vector type of the linear system.
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    /// DG whose system_matrix holds M/dt - dRdW.
+    std::shared_ptr<PHiLiP::DGBase<dim,double>> dg;
+    /// Residual offset by one, since it may be small for the manufactured solution.
+    VectorType right_hand_side;
+    /// Manufactured solution at which the system is assembled, without ghost entries.
+    VectorType manufactured_solution;
+};
+
+/// Sets the default parameters, and those of the Euler equations and of GMRES used by the linear solver tests.
+inline void parse_pseudotime_parameters (PHiLiP::Parameters::AllParameters &all_parameters, const double linear_residual)
+{
+    dealii::ParameterHandler parameter_handler;
+    PHiLiP::Parameters::AllParameters::declare_parameters (parameter_handler);
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation::euler;
+    all_parameters.linear_solver_param.linear_residual = linear_residual;
+    all_parameters.linear_solver_param.max_iterations = 2000;
+    all_parameters.linear_solver_param.restart_number = 60;
+}
+
+/// Creates an empty grid, distributed unless in 1D.
+inline std::shared_ptr<Triangulation> create_pseudotime_grid ()
+{
+    const int dim = PHILIP_DIM;
+    return std::make_shared<Triangulation>(
+#if PHILIP_DIM!=1
+        MPI_COMM_WORLD,
+#endif
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+}
+
+/// Sets the farfield boundary condition on all the boundary faces of @p grid.
+inline void set_farfield_boundaries (Triangulation &grid)
+{
+    const int dim = PHILIP_DIM;
+    for (auto &cell : grid.active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+}
+
+/// Assembles the linear system of a pseudo-time step at the manufactured solution.
+template<int dim, int nstate>
+PseudotimeLinearSystem<dim> create_pseudotime_linear_system (
+    const unsigned int poly_degree,
+    const std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    PseudotimeLinearSystem<dim> system;
+    system.dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    DGBase<dim,double> &dg = *system.dg;
+    dg.allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    system.manufactured_solution.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg.dof_handler, *(physics_double->manufactured_solution_function), system.manufactured_solution);
+    dg.solution = system.manufactured_solution;
+    dg.solution.update_ghost_values();
+
+    // Same linear system as a pseudo-time step of the implicit ODE solver.
+    const bool do_inverse_mass_matrix = false;
+    dg.evaluate_mass_matrices(do_inverse_mass_matrix);
+    const bool compute_dRdW = true;
+    dg.assemble_residual(compute_dRdW);
+    dg.system_matrix *= -1.0;
+    dg.invalidate_dRdW();
+    dg.time_scaled_mass_matrices(PSEUDOTIME_CFL);
+    dg.add_time_scaled_mass_matrices();
+
+    system.right_hand_side = dg.right_hand_side;
+    system.right_hand_side.add(1.0);
+    return system;
+}
+
+#endif
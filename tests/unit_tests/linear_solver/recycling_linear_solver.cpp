@@ -0,0 +1,124 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include "linear_solver/linear_solver.h"
+#include "pseudotime_linear_system.h"
+
+using GMRESVariantEnum = PHiLiP::Parameters::LinearSolverParam::GMRESVariantEnum;
+
+/// Relative residual required from each solve.
+const double TOLERANCE = 1e-8;
+/// Number of solves with the same matrix and right-hand sides varying along a direction.
+const int N_SOLVES = 3;
+/// Relative perturbation of the right-hand side between consecutive solves.
+const double RHS_PERTURBATION = 1e-2;
+/// Scaling of the mass matrix added to the system matrix to obtain a nearby one.
+const double MATRIX_PERTURBATION = 1.0;
+
+/** Checks that the recycling GMRES of solve_linear() converges in fewer iterations
+ *  when its subspace is kept by a ReusablePreconditioner between solves.
+ *
+ *  The systems, and their transposes, are solved for right-hand sides varying along a direction,
+ *  and then for a nearby matrix, whose preconditioner is set up again.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    PseudotimeLinearSystem<dim> system = create_pseudotime_linear_system<dim,nstate>(poly_degree, grid, all_parameters);
+    const std::shared_ptr<DGBase<dim,double>> dg = system.dg;
+    const VectorType &right_hand_side = system.right_hand_side;
+    // Direction along which the right-hand sides vary.
+    VectorType perturbation = system.manufactured_solution;
+    perturbation *= RHS_PERTURBATION * right_hand_side.l2_norm() / perturbation.l2_norm();
+
+    Parameters::LinearSolverParam linear_param = all_parameters.linear_solver_param;
+    linear_param.gmres_variant = GMRESVariantEnum::recycling;
+
+    // Solves the system, or its transpose, and returns the iterations, or 0 if the relative residual is not met.
+    const auto solve = [&] (VectorType rhs, const bool transpose, ReusablePreconditioner *const reusable_preconditioner) {
+        VectorType solution;
+        solution.reinit(rhs);
+        const std::pair<unsigned int, double> result = solve_linear(dg->system_matrix, rhs, solution, linear_param, transpose, reusable_preconditioner);
+
+        VectorType residual;
+        residual.reinit(rhs);
+        if (transpose) {
+            dg->system_matrix.Tvmult(residual, solution);
+        } else {
+            dg->system_matrix.vmult(residual, solution);
+        }
+        residual -= rhs;
+        const double relative_residual = residual.l2_norm() / rhs.l2_norm();
+        pcout << (transpose ? "Transposed solve" : "Solve") << " took " << result.first
+              << " iterations and has a relative residual of " << relative_residual << std::endl;
+        return (relative_residual > TOLERANCE) ? 0u : result.first;
+    };
+
+    int error = 0;
+    for (const bool transpose : {false, true}) {
+        ReusablePreconditioner reusable_preconditioner;
+        std::vector<unsigned int> iterations(N_SOLVES);
+        for (int isolve = 0; isolve < N_SOLVES; ++isolve) {
+            VectorType rhs = right_hand_side;
+            rhs.add(isolve, perturbation);
+            iterations[isolve] = solve(rhs, transpose, &reusable_preconditioner);
+            reusable_preconditioner.reuse = true;
+
+            if (iterations[isolve] == 0) {
+                pcout << "Solve " << isolve << " did not converge." << std::endl;
+                error = 1;
+            } else if (isolve > 0 && iterations[isolve] >= iterations[0]) {
+                pcout << "Solve " << isolve << " took " << iterations[isolve] << " iterations, while the first one took "
+                      << iterations[0] << " without a recycled subspace." << std::endl;
+                error = 1;
+            }
+        }
+
+        // The preconditioner is set up again for the nearby matrix, while the recycled directions are kept.
+        dg->add_mass_matrices(MATRIX_PERTURBATION);
+        dg->invalidate_dRdW();
+        reusable_preconditioner.reuse = false;
+        const unsigned int fresh_iterations = solve(right_hand_side, transpose, nullptr);
+        const unsigned int recycled_iterations = solve(right_hand_side, transpose, &reusable_preconditioner);
+        if (fresh_iterations == 0 || recycled_iterations == 0) {
+            pcout << "The solve with the nearby matrix did not converge." << std::endl;
+            error = 1;
+        } else if (recycled_iterations >= fresh_iterations) {
+            pcout << "The solve with the nearby matrix took " << recycled_iterations << " iterations with the recycled subspace and "
+                  << fresh_iterations << " without." << std::endl;
+            error = 1;
+        }
+        dg->add_mass_matrices(-MATRIX_PERTURBATION);
+        dg->invalidate_dRdW();
+    }
+
+    return error;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    Parameters::AllParameters all_parameters;
+    parse_pseudotime_parameters(all_parameters, 1e-12);
+
+    std::shared_ptr<Triangulation> grid = create_pseudotime_grid();
+    const unsigned int n_refinements = 3;
+    dealii::GridGenerator::hyper_cube(*grid);
+    grid->refine_global(n_refinements);
+    set_farfield_boundaries(*grid);
+
+    const unsigned int poly_degree = 2;
+    return test<dim,dim+2>(poly_degree, grid, all_parameters);
+}
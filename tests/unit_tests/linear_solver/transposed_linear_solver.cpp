@@ -0,0 +1,84 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include "linear_solver/linear_solver.h"
+#include "pseudotime_linear_system.h"
+
+using GMRESVariantEnum = PHiLiP::Parameters::LinearSolverParam::GMRESVariantEnum;
+using LinearSolverEnum = PHiLiP::Parameters::LinearSolverParam::LinearSolverEnum;
+using PreconditionerEnum = PHiLiP::Parameters::LinearSolverParam::PreconditionerEnum;
+
+/// Relative residual of the transposed system required from each solver.
+const double TOLERANCE = 1e-8;
+
+/** Checks that the transposed solves of solve_linear() satisfy A^T x = b.
+ *
+ *  The transpose is only applied through Tvmult(), and each preconditioner is applied transposed.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    PseudotimeLinearSystem<dim> system = create_pseudotime_linear_system<dim,nstate>(poly_degree, grid, all_parameters);
+    const std::shared_ptr<DGBase<dim,double>> dg = system.dg;
+    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side = system.right_hand_side;
+
+    const std::vector<LinearSolverEnum> solver_types { LinearSolverEnum::gmres, LinearSolverEnum::gmres, LinearSolverEnum::gmres, LinearSolverEnum::gmres, LinearSolverEnum::direct };
+    const std::vector<PreconditionerEnum> preconditioners { PreconditionerEnum::ilut, PreconditionerEnum::ilut, PreconditionerEnum::block_jacobi, PreconditionerEnum::block_ilu0, PreconditionerEnum::ilut };
+    const std::vector<GMRESVariantEnum> variants { GMRESVariantEnum::standard, GMRESVariantEnum::pipelined, GMRESVariantEnum::standard, GMRESVariantEnum::standard, GMRESVariantEnum::standard };
+    const std::vector<std::string> names { "ilut", "ilut pipelined", "block_jacobi", "block_ilu0", "direct" };
+
+    int error = 0;
+    for (unsigned int isolver = 0; isolver < names.size(); ++isolver) {
+        Parameters::LinearSolverParam linear_param = all_parameters.linear_solver_param;
+        linear_param.linear_solver_type = solver_types[isolver];
+        linear_param.preconditioner_type = preconditioners[isolver];
+        linear_param.gmres_variant = variants[isolver];
+
+        dealii::LinearAlgebra::distributed::Vector<double> solution;
+        solution.reinit(right_hand_side);
+        dealii::LinearAlgebra::distributed::Vector<double> rhs = right_hand_side;
+        const bool transpose = true;
+        solve_linear(dg->system_matrix, rhs, solution, linear_param, transpose);
+
+        dealii::LinearAlgebra::distributed::Vector<double> residual;
+        residual.reinit(right_hand_side);
+        dg->system_matrix.Tvmult(residual, solution);
+        residual -= right_hand_side;
+        const double relative_residual = residual.l2_norm() / right_hand_side.l2_norm();
+
+        pcout << "Transposed solve with " << names[isolver] << " has a relative residual of " << relative_residual << std::endl;
+        if (relative_residual > TOLERANCE) {
+            pcout << "The transposed solve with " << names[isolver] << " did not converge." << std::endl;
+            error = 1;
+        }
+    }
+
+    return error;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    Parameters::AllParameters all_parameters;
+    parse_pseudotime_parameters(all_parameters, 1e-12);
+
+    std::shared_ptr<Triangulation> grid = create_pseudotime_grid();
+    const unsigned int n_refinements = 3;
+    dealii::GridGenerator::hyper_cube(*grid);
+    grid->refine_global(n_refinements);
+    set_farfield_boundaries(*grid);
+
+    const unsigned int poly_degree = 2;
+    return test<dim,dim+2>(poly_degree, grid, all_parameters);
+}
@@ -228,6 +228,102 @@ int test_convective_numerical_flux_consistency (const PHiLiP::Parameters::AllPar
     return 0;
 }
 
+template<int dim, int nstate>
+int test_numerical_flux_batch (const PHiLiP::Parameters::AllParameters *const all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr <Physics::PhysicsBase<dim, nstate, double>> pde_physics = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(all_parameters);
+
+    std::unique_ptr<NumericalFlux::NumericalFluxConvective<dim, nstate, double>> conv_num_flux = 
+        NumericalFlux::NumericalFluxFactory<dim, nstate, double>
+        ::create_convective_numerical_flux (all_parameters->conv_num_flux_type, pde_physics);
+    std::unique_ptr<NumericalFlux::NumericalFluxDissipative<dim, nstate, double>> diss_num_flux = 
+        NumericalFlux::NumericalFluxFactory<dim, nstate, double>
+        ::create_dissipative_numerical_flux (all_parameters->diss_num_flux_type, pde_physics);
+
+    // Batch of face points with different states on each side
+    const unsigned int n_pts = 5;
+    std::array<std::vector<double>, nstate> soln_int_batch, soln_ext_batch;
+    std::array<std::array<std::vector<double>, dim>, nstate> soln_grad_int_batch, soln_grad_ext_batch;
+    std::array<std::vector<double>, dim> normal_batch;
+    for (int d=0; d<dim; d++) normal_batch[d].resize(n_pts);
+    for (int s=0; s<nstate; s++) {
+        soln_int_batch[s].resize(n_pts);
+        soln_ext_batch[s].resize(n_pts);
+        for (int d=0; d<dim; d++) {
+            soln_grad_int_batch[s][d].resize(n_pts);
+            soln_grad_ext_batch[s][d].resize(n_pts);
+        }
+    }
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        dealii::Point<dim> point_1;
+        dealii::Point<dim> point_2;
+        for(int d=0; d<dim; d++) {
+            point_1[d] = 0.1 + 0.2*ipoint;
+            point_2[d] = 0.15 + 0.2*ipoint;
+            normal_batch[d][ipoint] = (d == (int)(ipoint % dim)) ? 1.0 : 0.0;
+        }
+        for(int s=0; s<nstate; s++) {
+            soln_int_batch[s][ipoint] = pde_physics->manufactured_solution_function->value(point_1,s);
+            soln_ext_batch[s][ipoint] = pde_physics->manufactured_solution_function->value(point_2,s);
+            const dealii::Tensor<1,dim,double> grad_int = pde_physics->manufactured_solution_function->gradient(point_1,s);
+            const dealii::Tensor<1,dim,double> grad_ext = pde_physics->manufactured_solution_function->gradient(point_2,s);
+            for(int d=0; d<dim; d++) {
+                soln_grad_int_batch[s][d][ipoint] = grad_int[d];
+                soln_grad_ext_batch[s][d][ipoint] = grad_ext[d];
+            }
+        }
+    }
+
+    const double penalty = 100;
+    const double artificial_diss_int = 1.0, artificial_diss_ext = 2.0;
+    std::array<std::vector<double>, nstate> conv_num_flux_batch, diss_soln_num_flux_batch, diss_auxi_num_flux_batch;
+    conv_num_flux->evaluate_flux_batch(soln_int_batch, soln_ext_batch, normal_batch, conv_num_flux_batch);
+    diss_num_flux->evaluate_solution_flux_batch(soln_int_batch, soln_ext_batch, normal_batch, diss_soln_num_flux_batch);
+    diss_num_flux->evaluate_auxiliary_flux_batch(
+                 artificial_diss_int, artificial_diss_ext,
+                 soln_int_batch, soln_ext_batch,
+                 soln_grad_int_batch, soln_grad_ext_batch,
+                 normal_batch, penalty,
+                 diss_auxi_num_flux_batch);
+
+    for (unsigned int ipoint=0; ipoint<n_pts; ++ipoint) {
+        dealii::Tensor<1,dim,double> normal_int;
+        std::array<double, nstate> soln_int, soln_ext;
+        std::array<dealii::Tensor<1,dim,double>, nstate> soln_grad_int, soln_grad_ext;
+        std::array<double, nstate> conv_num_flux_dot_n_batch, diss_soln_num_flux_dot_n_batch, diss_auxi_num_flux_dot_n_batch;
+        for(int d=0; d<dim; d++) normal_int[d] = normal_batch[d][ipoint];
+        for(int s=0; s<nstate; s++) {
+            soln_int[s] = soln_int_batch[s][ipoint];
+            soln_ext[s] = soln_ext_batch[s][ipoint];
+            for(int d=0; d<dim; d++) {
+                soln_grad_int[s][d] = soln_grad_int_batch[s][d][ipoint];
+                soln_grad_ext[s][d] = soln_grad_ext_batch[s][d][ipoint];
+            }
+            conv_num_flux_dot_n_batch[s] = conv_num_flux_batch[s][ipoint];
+            diss_soln_num_flux_dot_n_batch[s] = diss_soln_num_flux_batch[s][ipoint];
+            diss_auxi_num_flux_dot_n_batch[s] = diss_auxi_num_flux_batch[s][ipoint];
+        }
+
+        const std::array<double, nstate> conv_num_flux_dot_n = conv_num_flux->evaluate_flux(soln_int, soln_ext, normal_int);
+        const std::array<double, nstate> diss_soln_num_flux_dot_n = diss_num_flux->evaluate_solution_flux(soln_int, soln_ext, normal_int);
+        const std::array<double, nstate> diss_auxi_num_flux_dot_n = diss_num_flux->evaluate_auxiliary_flux(
+                 artificial_diss_int, artificial_diss_ext,
+                 soln_int, soln_ext,
+                 soln_grad_int, soln_grad_ext,
+                 normal_int, penalty);
+
+        std::cout << "Batched convective numerical flux should equal the point-wise one" << std::endl;
+        compare_array<dim,nstate> (conv_num_flux_dot_n, conv_num_flux_dot_n_batch, 1.0);
+        std::cout << "Batched dissipative solution flux should equal the point-wise one" << std::endl;
+        compare_array<dim,nstate> (diss_soln_num_flux_dot_n, diss_soln_num_flux_dot_n_batch, 1.0);
+        std::cout << "Batched dissipative auxiliary flux should equal the point-wise one" << std::endl;
+        compare_array<dim,nstate> (diss_auxi_num_flux_dot_n, diss_auxi_num_flux_dot_n_batch, 1.0);
+    }
+
+    return 0;
+}
+
 int main (int argc, char * argv[])
 {
     dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
@@ -278,6 +374,13 @@ int main (int argc, char * argv[])
             if(*pde==PDEType::advection_vector) success = test_convective_numerical_flux_consistency<PHILIP_DIM,2> (&all_parameters);
             if(*pde==PDEType::burgers_inviscid) success = test_convective_numerical_flux_consistency<PHILIP_DIM,PHILIP_DIM> (&all_parameters);
             if(*pde==PDEType::euler) success = test_convective_numerical_flux_consistency<PHILIP_DIM,PHILIP_DIM+2> (&all_parameters);
+
+            if(*pde==PDEType::advection) success = test_numerical_flux_batch<PHILIP_DIM,1> (&all_parameters);
+            if(*pde==PDEType::diffusion) success = test_numerical_flux_batch<PHILIP_DIM,1> (&all_parameters);
+            if(*pde==PDEType::convection_diffusion) success = test_numerical_flux_batch<PHILIP_DIM,1> (&all_parameters);
+            if(*pde==PDEType::advection_vector) success = test_numerical_flux_batch<PHILIP_DIM,2> (&all_parameters);
+            if(*pde==PDEType::burgers_inviscid) success = test_numerical_flux_batch<PHILIP_DIM,PHILIP_DIM> (&all_parameters);
+            if(*pde==PDEType::euler) success = test_numerical_flux_batch<PHILIP_DIM,PHILIP_DIM+2> (&all_parameters);
         }
         for (auto diss = diss_type.begin(); diss != diss_type.end() && success == 0; diss++) {
 
@@ -0,0 +1,158 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/function_parser.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "ode_solver/ode_solver.h"
+#include "parameters/all_parameters.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+/// Change of the total mass allowed, relative to the total absolute mass.
+const double TOLERANCE = 1e-12;
+/// Number of time levels of the local time stepping.
+const unsigned int N_LEVELS = 3;
+
+/// Periodic unit hypercube whose cells grow geometrically from both sides towards the center of the domain.
+std::shared_ptr<Triangulation> create_stretched_grid ()
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+
+    const unsigned int n_half_cells = 6;
+    const double stretching = 1.5;
+    std::vector<double> step_sizes;
+    for (unsigned int i = 0; i < n_half_cells; ++i) step_sizes.push_back(std::pow(stretching, i));
+    for (unsigned int i = 0; i < n_half_cells; ++i) step_sizes.push_back(std::pow(stretching, n_half_cells-1-i));
+    double length = 0.0;
+    for (const double step_size : step_sizes) length += step_size;
+    for (double &step_size : step_sizes) step_size /= length;
+
+    const std::vector<std::vector<double>> all_step_sizes(dim, step_sizes);
+    dealii::Point<dim> p1, p2;
+    for (int d = 0; d < dim; ++d) p2[d] = 1.0;
+    const bool colorize = true;
+    dealii::GridGenerator::subdivided_hyper_rectangle(*grid, all_step_sizes, p1, p2, colorize);
+
+    std::vector<dealii::GridTools::PeriodicFacePair<typename Triangulation::cell_iterator> > matched_pairs;
+    for (int d = 0; d < dim; ++d) {
+        dealii::GridTools::collect_periodic_faces(*grid, 2*d, 2*d+1, d, matched_pairs);
+    }
+    grid->add_periodicity(matched_pairs);
+    return grid;
+}
+
+/// Returns the sum of the entries of M*u, or of |M*u| if \p absolute is set, over all the processes.
+double total_mass (const PHiLiP::DGBase<PHILIP_DIM,double> &dg, const bool absolute)
+{
+    double mass = 0.0;
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (auto cell = dg.dof_handler.begin_active(); cell != dg.dof_handler.end(); ++cell) {
+        if (!cell->is_locally_owned()) continue;
+        const dealii::FullMatrix<double> &cell_mass_matrix = dg.cell_mass_matrices[cell->active_cell_index()];
+        dofs_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices (dofs_indices);
+        for (unsigned int itest = 0; itest < dofs_indices.size(); ++itest) {
+            double mass_times_solution = 0.0;
+            for (unsigned int itrial = 0; itrial < dofs_indices.size(); ++itrial) {
+                mass_times_solution += cell_mass_matrix(itest,itrial) * dg.solution[dofs_indices[itrial]];
+            }
+            mass += absolute ? std::abs(mass_times_solution) : mass_times_solution;
+        }
+    }
+    return dealii::Utilities::MPI::sum(mass, MPI_COMM_WORLD);
+}
+
+/** Advects a smooth periodic solution on a stretched grid with the local time stepping at p = 1 and 2.
+ *
+ *  Checks that the cells are assigned to more than one time level, that the total mass M*u is conserved
+ *  to round-off across the levels, and that the high-order solution remains bounded.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::advection;
+    all_parameters.conv_num_flux_type = Parameters::AllParameters::ConvectiveNumericalFlux::lax_friedrichs;
+    all_parameters.use_weak_form = true;
+    all_parameters.ode_solver_param.ode_output = Parameters::OutputEnum::quiet;
+    all_parameters.ode_solver_param.ode_solver_type = Parameters::ODESolverParam::ODESolverEnum::explicit_local_time_stepping_solver;
+    all_parameters.ode_solver_param.local_time_stepping_levels = N_LEVELS;
+    all_parameters.ode_solver_param.time_step_control = Parameters::ODESolverParam::TimeStepControlEnum::cfl_time_step;
+    all_parameters.ode_solver_param.time_step_cfl = 0.5;
+
+    int error = 0;
+    for (unsigned int poly_degree = 1; poly_degree <= 2; ++poly_degree) {
+        std::shared_ptr<Triangulation> grid = create_stretched_grid();
+        std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+        dg->allocate_system ();
+
+        dealii::FunctionParser<dim> initial_condition;
+        const std::string variables = "x,y";
+        std::map<std::string,double> constants;
+        constants["pi"] = dealii::numbers::PI;
+        initial_condition.initialize(variables, "1.0 + 0.5*sin(2*pi*x)*sin(2*pi*y)", constants);
+        VectorType solution_no_ghost;
+        solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+        dealii::VectorTools::interpolate(dg->dof_handler, initial_condition, solution_no_ghost);
+        dg->solution = solution_no_ghost;
+        dg->solution.update_ghost_values();
+        const double initial_max = dg->solution.linfty_norm();
+
+        // The cell mass matrices are only stored along with the global mass matrix.
+        const bool do_inverse_mass_matrix = false;
+        dg->evaluate_mass_matrices(do_inverse_mass_matrix);
+        const double initial_mass = total_mass(*dg, false);
+        const double mass_scale = total_mass(*dg, true);
+
+        std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+        const double final_time = 1.0;
+        ode_solver->advance_solution_time(final_time);
+
+        std::vector<unsigned int> n_owned_cells_per_level(N_LEVELS, 0);
+        for (auto cell = dg->dof_handler.begin_active(); cell != dg->dof_handler.end(); ++cell) {
+            if (!cell->is_locally_owned()) continue;
+            ++n_owned_cells_per_level[dg->local_time_stepping_levels[cell->active_cell_index()]];
+        }
+        unsigned int n_populated_levels = 0;
+        for (unsigned int level = 0; level < N_LEVELS; ++level) {
+            if (dealii::Utilities::MPI::sum(n_owned_cells_per_level[level], MPI_COMM_WORLD) > 0) ++n_populated_levels;
+        }
+
+        const double mass_change = std::abs(total_mass(*dg, false) - initial_mass) / mass_scale;
+        const double final_max = dg->solution.linfty_norm();
+
+        pcout << "Poly degree " << poly_degree << ": " << n_populated_levels << " populated levels,"
+              << " relative mass change " << mass_change
+              << ", max |u| from " << initial_max << " to " << final_max << std::endl;
+        if (n_populated_levels < 2) {
+            pcout << "The stretched grid only populated a single time level." << std::endl;
+            error = 1;
+        }
+        if (mass_change > TOLERANCE) {
+            pcout << "The local time stepping does not conserve the total mass." << std::endl;
+            error = 1;
+        }
+        if (!(final_max < 2.0 * initial_max)) {
+            pcout << "The local time stepping is unstable." << std::endl;
+            error = 1;
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,158 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "mesh/grids/naca_airfoil_grid.hpp"
+#include "ode_solver/ode_solver.h"
+#include "parameters/all_parameters.h"
+#include "physics/euler.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+/// Number of time levels of the local time stepping.
+const unsigned int N_LEVELS = 4;
+/// Number of smallest stable time steps taken by the global time stepping.
+const unsigned int N_FINEST_TIME_STEPS = 64;
+
+/// NACA0012 grid of EulerNACA0012::run_test().
+std::shared_ptr<Triangulation> create_naca0012_grid ()
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        MPI_COMM_WORLD,
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+
+    dealii::GridGenerator::Airfoil::AdditionalData airfoil_data;
+    airfoil_data.airfoil_type = "NACA";
+    airfoil_data.naca_id      = "0012";
+    airfoil_data.airfoil_length = 1.0;
+    airfoil_data.height         = 150.0; // Farfield radius.
+    airfoil_data.length_b2      = 150.0;
+    airfoil_data.incline_factor = 0.0;
+    airfoil_data.bias_factor    = 5.0;
+    airfoil_data.refinements    = 0;
+    airfoil_data.n_subdivision_x_0 = 16;
+    airfoil_data.n_subdivision_x_1 = 16;
+    airfoil_data.n_subdivision_x_2 = 16;
+    airfoil_data.n_subdivision_y = 16;
+    airfoil_data.airfoil_sampling_factor = 100000;
+    PHiLiP::Grids::naca_airfoil(*grid, airfoil_data);
+    return grid;
+}
+
+/// Creates the DG of the NACA0012 grid, initialized with the free stream.
+std::shared_ptr< PHiLiP::DGBase<PHILIP_DIM,double> > create_free_stream_dg (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+    std::shared_ptr<Triangulation> grid = create_naca0012_grid();
+    const unsigned int grid_degree = poly_degree+1;
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, poly_degree, grid_degree, grid);
+    dg->allocate_system ();
+
+    const Physics::Euler<dim,nstate,double> euler_physics_double(
+        all_parameters.euler_param.ref_length,
+        all_parameters.euler_param.gamma_gas,
+        all_parameters.euler_param.mach_inf,
+        all_parameters.euler_param.angle_of_attack,
+        all_parameters.euler_param.side_slip_angle);
+    const Physics::FreeStreamInitialConditions<dim,nstate> initial_conditions(euler_physics_double);
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    return dg;
+}
+
+/// Advances the free stream around the NACA0012 by \p final_time, and returns the wall time.
+double time_ode_solver (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters,
+    const double final_time,
+    VectorType &solution)
+{
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    std::shared_ptr < DGBase<dim, double> > dg = create_free_stream_dg(poly_degree, all_parameters);
+
+    std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+    const double start_time = MPI_Wtime();
+    ode_solver->advance_solution_time(final_time);
+    const double wall_time = dealii::Utilities::MPI::max(MPI_Wtime() - start_time, MPI_COMM_WORLD);
+
+    solution = dg->solution;
+    return wall_time;
+}
+
+/** Reports the wall time of the explicit NACA0012 transient with the global and local time stepping.
+ *
+ *  Both advance the free stream by the same physical time, which corresponds to N_FINEST_TIME_STEPS
+ *  of the smallest stable time step, using the same Runge-Kutta method. Only fails if a solution is
+ *  not finite, since the timings depend on the machine.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    using ODEEnum = Parameters::ODESolverParam::ODESolverEnum;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters global_parameters, local_parameters;
+    for (Parameters::AllParameters *all_parameters : {&global_parameters, &local_parameters}) {
+        all_parameters->parse_parameters (parameter_handler);
+        all_parameters->pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+        all_parameters->conv_num_flux_type = Parameters::AllParameters::ConvectiveNumericalFlux::lax_friedrichs;
+        all_parameters->euler_param.mach_inf = 0.35;
+        all_parameters->euler_param.angle_of_attack = 2.0;
+        all_parameters->ode_solver_param.ode_output = Parameters::OutputEnum::quiet;
+        all_parameters->ode_solver_param.time_step_control = Parameters::ODESolverParam::TimeStepControlEnum::cfl_time_step;
+        all_parameters->ode_solver_param.time_step_cfl = 0.5;
+        all_parameters->ode_solver_param.local_time_stepping_levels = N_LEVELS;
+    }
+    global_parameters.ode_solver_param.ode_solver_type = ODEEnum::explicit_solver;
+    local_parameters.ode_solver_param.ode_solver_type = ODEEnum::explicit_local_time_stepping_solver;
+    // Prints the number of cells per level and the estimated speedup.
+    local_parameters.ode_solver_param.ode_output = Parameters::OutputEnum::verbose;
+
+    int error = 0;
+    pcout << "Processes: " << dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD) << std::endl;
+    for (unsigned int poly_degree = 1; poly_degree <= 2; ++poly_degree) {
+        // The physical time is based on the smallest stable time step of the free stream.
+        std::shared_ptr < DGBase<dim, double> > dg = create_free_stream_dg(poly_degree, global_parameters);
+        dg->assemble_residual();
+        const double final_time = N_FINEST_TIME_STEPS * global_parameters.ode_solver_param.time_step_cfl * dg->get_global_min_max_dt_cell();
+
+        VectorType global_solution, difference;
+        const double global_time = time_ode_solver(poly_degree, global_parameters, final_time, global_solution);
+        const double local_time = time_ode_solver(poly_degree, local_parameters, final_time, difference);
+        const bool finite = std::isfinite(global_solution.l2_norm()) && std::isfinite(difference.l2_norm());
+        difference -= global_solution;
+
+        pcout << "Poly degree " << poly_degree
+              << " Global time stepping: " << global_time << " s"
+              << " Local time stepping: " << local_time << " s"
+              << " Speedup: " << global_time / local_time
+              << " Relative difference: " << difference.l2_norm() / global_solution.l2_norm() << std::endl;
+        if (!finite) {
+            pcout << "The NACA0012 solution is not finite." << std::endl;
+            error = 1;
+        }
+    }
+
+    return error;
+}
@@ -258,6 +258,33 @@ int test(const unsigned int nx_ffd)
 
     }
 
+    *outStream << "con->applyInverseAdjointJacobianPreconditioner_1..." << std::endl;
+    *outStream << "Checks (Pt^-1 x) y versus x (P^-1 y)  ..." << std::endl;
+    {
+        const auto x = des_var_sim_rol_p->clone();
+        const auto y = des_var_sim_rol_p->clone();
+        const auto Ptinv_x = des_var_sim_rol_p->clone();
+        const auto Pinv_y = des_var_sim_rol_p->clone();
+        DealiiVector &x_v = ROL_vector_to_dealii_vector_reference(*x);
+        DealiiVector &y_v = ROL_vector_to_dealii_vector_reference(*y);
+        for (const auto i : x_v.locally_owned_elements()) {
+            x_v[i] = std::sin(1.0*i);
+            y_v[i] = std::cos(3.0*i);
+        }
+        double tol = 1e-12;
+        con->applyInverseAdjointJacobianPreconditioner_1(*Ptinv_x, *x, *des_var_sim_rol_p, *des_var_ctl_rol_p, tol);
+        con->applyInverseJacobianPreconditioner_1(*Pinv_y, *y, *des_var_sim_rol_p, *des_var_ctl_rol_p, tol);
+        const double Ptinv_x_dot_y = Ptinv_x->dot(*y);
+        const double x_dot_Pinv_y = x->dot(*Pinv_y);
+        const double relative_difference = std::abs(Ptinv_x_dot_y - x_dot_Pinv_y) / std::abs(Ptinv_x_dot_y);
+        *outStream << "(Pt^-1 x) y = " << Ptinv_x_dot_y << " x (P^-1 y) = " << x_dot_Pinv_y
+                   << " relative difference = " << relative_difference << std::endl;
+        if (relative_difference > CONSISTENCY_ABS_TOL) {
+            test_error++;
+            *outStream << "Failed con->applyInverseAdjointJacobianPreconditioner_1..." << std::endl;
+        }
+    }
+
     *outStream << "con->checkAdjointConsistencyJacobian..." << std::endl;
     *outStream << "Checks (w J v) versus (v Jt w)  ..." << std::endl;
     {
@@ -0,0 +1,175 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+using MatrixType = dealii::TrilinosWrappers::SparseMatrix;
+
+/// Largest entry-wise difference allowed between the replayed and recorded dRdW, relative to the largest entry.
+const double TOLERANCE = 1e-12;
+/// Highest polynomial degree tested.
+const unsigned int MAX_POLY_DEGREE = 3;
+
+/// Returns the largest entry-wise difference of the locally owned rows, relative to the largest entry of the reference.
+double max_entry_difference (
+    const MatrixType &matrix,
+    const MatrixType &reference,
+    const dealii::IndexSet &locally_owned_rows)
+{
+    double max_difference = 0.0, max_entry = 0.0;
+    for (const auto row : locally_owned_rows) {
+        for (auto entry = reference.begin(row); entry != reference.end(row); ++entry) {
+            max_entry = std::max(max_entry, std::abs(entry->value()));
+            max_difference = std::max(max_difference, std::abs(matrix.el(row, entry->column()) - entry->value()));
+        }
+    }
+    max_difference = dealii::Utilities::MPI::max(max_difference, MPI_COMM_WORLD);
+    max_entry = dealii::Utilities::MPI::max(max_entry, MPI_COMM_WORLD);
+    return max_difference / max_entry;
+}
+
+/// Sets the solution to the manufactured solution.
+/** If clip_pressure is set, the energy of every other cell is set to zero, such that the Euler physics
+ *  clips the negative pressure of those cells and takes a different branch than the other cells.
+ */
+template<int dim, int nstate>
+void set_solution (
+    PHiLiP::DGBase<dim,double> &dg,
+    const PHiLiP::Physics::PhysicsBase<dim,nstate,double> &physics,
+    const bool clip_pressure)
+{
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg.high_order_grid.mapping_fe_field), dg.dof_handler, *(physics.manufactured_solution_function), solution_no_ghost);
+    if (clip_pressure) {
+        std::vector<dealii::types::global_dof_index> dof_indices;
+        unsigned int icell = 0;
+        for (const auto &cell : dg.dof_handler.active_cell_iterators()) {
+            if (!cell->is_locally_owned()) continue;
+            if (icell++ % 2) continue;
+            const dealii::FiniteElement<dim> &fe = cell->get_fe();
+            dof_indices.resize(fe.dofs_per_cell);
+            cell->get_dof_indices(dof_indices);
+            for (unsigned int idof = 0; idof < fe.dofs_per_cell; ++idof) {
+                if (fe.system_to_component_index(idof).first == nstate-1) solution_no_ghost[dof_indices[idof]] = 0.0;
+            }
+        }
+    }
+    dg.solution = solution_no_ghost;
+    dg.solution.update_ghost_values();
+}
+
+/** Checks that dRdW assembled by replaying the volume tapes matches, entry by entry, the one obtained
+ *  by recording a tape for every cell.
+ *
+ *  The Euler dRdW is compared on a distorted grid with hanging nodes at the manufactured solution,
+ *  and at the same state where the pressure of every other cell is clipped. The latter must be detected
+ *  as a branch mismatch, such that the tapes of those cells are recorded again instead of being replayed.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+    all_parameters.use_weak_form = true;
+    // The replayed physics is only created if the tapes are reused when the DG is constructed.
+    all_parameters.reuse_jacobian_tapes = true;
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+
+    int error = 0;
+    for (unsigned int poly_degree = 1; poly_degree <= MAX_POLY_DEGREE; ++poly_degree) {
+        std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+            MPI_COMM_WORLD,
+            typename dealii::Triangulation<dim>::MeshSmoothing(
+                dealii::Triangulation<dim>::smoothing_on_refinement |
+                dealii::Triangulation<dim>::smoothing_on_coarsening));
+        const unsigned int n_subdivisions = 4;
+        dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+        const double random_factor = 0.2;
+        const bool keep_boundary = false;
+        dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+        for (auto &cell : grid->active_cell_iterators()) {
+            for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+            }
+        }
+
+        std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+
+        // Refine the first cells to obtain hanging nodes.
+        dg->high_order_grid.prepare_for_coarsening_and_refinement();
+        grid->prepare_coarsening_and_refinement();
+        unsigned int icell = 0;
+        for (auto cell = grid->begin_active(); cell!=grid->end(); ++cell) {
+            if (!cell->is_locally_owned()) continue;
+            if (++icell < grid->n_active_cells()/2) cell->set_refine_flag();
+        }
+        grid->execute_coarsening_and_refinement();
+        dg->high_order_grid.execute_coarsening_and_refinement();
+        dg->allocate_system ();
+
+        for (const bool clip_pressure : {false, true}) {
+            set_solution<dim,nstate>(*dg, *physics_double, clip_pressure);
+
+            // The DG reads the flag at every assembly.
+            all_parameters.reuse_jacobian_tapes = false;
+            dg->invalidate_dRdW();
+            dg->assemble_residual(true, false, false);
+            const VectorType recorded_residual = dg->right_hand_side;
+            MatrixType recorded_dRdW;
+            recorded_dRdW.copy_from(dg->system_matrix);
+
+            all_parameters.reuse_jacobian_tapes = true;
+            const unsigned int n_replayed_before = dealii::Utilities::MPI::sum(dg->n_volume_tapes_replayed, MPI_COMM_WORLD);
+            const unsigned int n_mismatches_before = dealii::Utilities::MPI::sum(dg->n_volume_tape_branch_mismatches, MPI_COMM_WORLD);
+            dg->invalidate_dRdW();
+            dg->assemble_residual(true, false, false);
+            const unsigned int n_replayed = dealii::Utilities::MPI::sum(dg->n_volume_tapes_replayed, MPI_COMM_WORLD) - n_replayed_before;
+            const unsigned int n_mismatches = dealii::Utilities::MPI::sum(dg->n_volume_tape_branch_mismatches, MPI_COMM_WORLD) - n_mismatches_before;
+
+            VectorType residual_difference = dg->right_hand_side;
+            residual_difference -= recorded_residual;
+            const double residual_difference_norm = residual_difference.l2_norm() / recorded_residual.l2_norm();
+            const double dRdW_difference = max_entry_difference(dg->system_matrix, recorded_dRdW, dg->locally_owned_dofs);
+
+            pcout << "Poly degree " << poly_degree << (clip_pressure ? " with" : " without") << " clipped pressures:"
+                  << " replayed " << n_replayed << " tapes, " << n_mismatches << " branch mismatches,"
+                  << " residual difference " << residual_difference_norm
+                  << " dRdW entry difference " << dRdW_difference << std::endl;
+
+            if (residual_difference_norm > TOLERANCE || dRdW_difference > TOLERANCE) {
+                pcout << "The replayed dRdW does not match the recorded one." << std::endl;
+                error = 1;
+            }
+            if (n_replayed == 0) {
+                pcout << "No volume tape was replayed." << std::endl;
+                error = 1;
+            }
+            if (clip_pressure && n_mismatches == 0) {
+                pcout << "The clipped pressures were not detected as branch mismatches." << std::endl;
+                error = 1;
+            }
+        }
+    }
+
+    return error;
+}
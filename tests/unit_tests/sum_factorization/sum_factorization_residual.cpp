@@ -0,0 +1,119 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+/// Relative difference allowed between the residuals of the sum-factorized and dense operators.
+const double TOLERANCE = 1e-12;
+/// Highest polynomial degree tested.
+const unsigned int MAX_POLY_DEGREE = 5;
+
+/// Creates a grid with farfield boundaries, either affine or curved.
+/** The affine grid is a subdivided hypercube. The curved grid is a hyper shell, whose cells
+ *  follow the spherical manifold and whose faces are not all in standard orientation in 3D.
+ */
+std::shared_ptr<Triangulation> create_grid (const bool curved)
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        MPI_COMM_WORLD,
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+    if (curved) {
+        const dealii::Point<dim> center;
+        const double inner_radius = 0.5, outer_radius = 1.0;
+        dealii::GridGenerator::hyper_shell(*grid, center, inner_radius, outer_radius);
+    } else {
+        const unsigned int n_subdivisions = 3;
+        dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    }
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Assembles the explicit residual at the manufactured solution on a new grid.
+template<int dim, int nstate>
+VectorType assemble_residual (
+    const unsigned int poly_degree,
+    const bool curved,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr<Triangulation> grid = create_grid(curved);
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg->high_order_grid.mapping_fe_field), dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+
+    dg->assemble_residual();
+    return dg->right_hand_side;
+}
+
+/** Checks that the explicit residual evaluated through sum-factorization matches the one of the dense
+ *  shape functions, up to round-off.
+ *
+ *  The Euler residual is compared for the weak and strong forms, polynomial degrees 1 to 5, on affine
+ *  and curved grids. Both contain interior and boundary faces, and the curved grid also exercises the
+ *  fallback of the faces that are not in standard orientation.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters dense_parameters, sum_factorization_parameters;
+    dense_parameters.parse_parameters (parameter_handler);
+    sum_factorization_parameters.parse_parameters (parameter_handler);
+    dense_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+    sum_factorization_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+    dense_parameters.use_sum_factorization = false;
+    sum_factorization_parameters.use_sum_factorization = true;
+
+    int error = 0;
+    for (const bool curved : {false, true}) {
+        for (const bool use_weak_form : {true, false}) {
+            dense_parameters.use_weak_form = use_weak_form;
+            sum_factorization_parameters.use_weak_form = use_weak_form;
+            for (unsigned int poly_degree = 1; poly_degree <= MAX_POLY_DEGREE; ++poly_degree) {
+                const VectorType dense_residual = assemble_residual<dim,nstate>(poly_degree, curved, dense_parameters);
+                VectorType difference = assemble_residual<dim,nstate>(poly_degree, curved, sum_factorization_parameters);
+                difference -= dense_residual;
+                const double relative_difference = difference.l2_norm() / dense_residual.l2_norm();
+
+                pcout << (curved ? "Curved" : "Affine") << " grid, " << (use_weak_form ? "weak" : "strong")
+                      << " form, poly degree " << poly_degree << ": relative difference of " << relative_difference << std::endl;
+                if (relative_difference > TOLERANCE) {
+                    pcout << "The sum-factorized residual does not match the dense one." << std::endl;
+                    error = 1;
+                }
+            }
+        }
+    }
+
+    return error;
+}
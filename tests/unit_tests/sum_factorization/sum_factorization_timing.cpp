@@ -0,0 +1,133 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/function_parser.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+
+/// Relative difference allowed between the residuals of the sum-factorized and dense operators.
+const double TOLERANCE = 1e-12;
+/// Highest polynomial degree timed.
+const unsigned int MAX_POLY_DEGREE = 5;
+/// Number of residual assemblies timed per configuration.
+const int N_ASSEMBLIES = 5;
+
+/// Grid of the Taylor-Green vortex, as in EulerTaylorGreen::run_test().
+std::shared_ptr<Triangulation> create_taylor_green_grid ()
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+    const double left = 0.0;
+    const double right = 2 * dealii::numbers::PI;
+    const bool colorize = true;
+    dealii::GridGenerator::hyper_cube(*grid, left, right, colorize);
+
+    std::vector<dealii::GridTools::PeriodicFacePair<typename dealii::Triangulation<dim>::cell_iterator> > matched_pairs;
+    dealii::GridTools::collect_periodic_faces(*grid,0,1,0,matched_pairs);
+    dealii::GridTools::collect_periodic_faces(*grid,2,3,1,matched_pairs);
+    dealii::GridTools::collect_periodic_faces(*grid,4,5,2,matched_pairs);
+    grid->add_periodicity(matched_pairs);
+
+    const unsigned int n_refinements = 2;
+    grid->refine_global(n_refinements);
+    return grid;
+}
+
+/// Assembles the residual of the Taylor-Green initial condition, and returns the wall time of one assembly.
+double time_residual (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters,
+    VectorType &residual)
+{
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = create_taylor_green_grid();
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    dealii::FunctionParser<dim> initial_condition(dim+2);
+    const std::string variables = "x,y,z";
+    std::map<std::string,double> constants;
+    constants["pi"] = dealii::numbers::PI;
+    std::vector<std::string> expressions(dim+2);
+    expressions[0] = "1";
+    expressions[1] = "sin(x)*cos(y)*cos(z)";
+    expressions[2] = "-cos(x)*sin(y)*cos(z)";
+    expressions[3] = "0";
+    expressions[4] = "250.0/1.4 + 2.5/16.0 * (cos(2.0*x)*cos(2.0*z) + 2.0*cos(2.0*y) + 2.0*cos(2.0*x) + cos(2.0*y)*cos(2.0*z)) + 0.5 * pow(cos(z),2.0) * (pow(cos(x),2.0) * pow(sin(y),2.0) +pow(sin(x),2.0) * pow(cos(y),2.0))";
+    initial_condition.initialize(variables, expressions, constants);
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, initial_condition, solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+
+    // The first assembly also fills the caches of the DG, and is not timed.
+    dg->assemble_residual();
+    const double start_time = MPI_Wtime();
+    for (int i = 0; i < N_ASSEMBLIES; ++i) {
+        dg->invalidate_residual();
+        dg->assemble_residual();
+    }
+    const double wall_time = dealii::Utilities::MPI::max(MPI_Wtime() - start_time, MPI_COMM_WORLD) / N_ASSEMBLIES;
+
+    residual = dg->right_hand_side;
+    return wall_time;
+}
+
+/** Reports the wall time of the explicit residual of the 3D Taylor-Green vortex with the dense
+ *  and sum-factorized operators, using the split-form strong DG of its control file.
+ *
+ *  Only fails if the two residuals differ, since the timings depend on the machine.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters dense_parameters, sum_factorization_parameters;
+    for (Parameters::AllParameters *all_parameters : {&dense_parameters, &sum_factorization_parameters}) {
+        all_parameters->parse_parameters (parameter_handler);
+        all_parameters->pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+        all_parameters->conv_num_flux_type = Parameters::AllParameters::ConvectiveNumericalFlux::split_form;
+        all_parameters->use_weak_form = false;
+        all_parameters->use_collocated_nodes = true;
+    }
+    dense_parameters.use_sum_factorization = false;
+    sum_factorization_parameters.use_sum_factorization = true;
+
+    int error = 0;
+    pcout << "Processes: " << dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD) << std::endl;
+    for (unsigned int poly_degree = 1; poly_degree <= MAX_POLY_DEGREE; ++poly_degree) {
+        VectorType dense_residual, difference;
+        const double dense_time = time_residual(poly_degree, dense_parameters, dense_residual);
+        const double sum_factorization_time = time_residual(poly_degree, sum_factorization_parameters, difference);
+        difference -= dense_residual;
+        const double relative_difference = difference.l2_norm() / dense_residual.l2_norm();
+
+        pcout << "Poly degree " << poly_degree
+              << " Dense: " << dense_time << " s"
+              << " Sum-factorized: " << sum_factorization_time << " s"
+              << " Speedup: " << dense_time / sum_factorization_time
+              << " Relative difference: " << relative_difference << std::endl;
+        if (relative_difference > TOLERANCE) {
+            pcout << "The sum-factorized residual does not match the dense one." << std::endl;
+            error = 1;
+        }
+    }
+
+    return error;
+}
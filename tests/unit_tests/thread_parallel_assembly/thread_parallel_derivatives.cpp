@@ -0,0 +1,150 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+using MatrixType = dealii::TrilinosWrappers::SparseMatrix;
+
+/// Relative difference allowed between the derivatives assembled with one and multiple threads.
+/** The tapeless Sacado types used by the threads accumulate the derivatives in a different order than
+ *  the CoDiPack tapes used by a single thread.
+ */
+const double TOLERANCE = 1e-10;
+/// Highest polynomial degree tested.
+const unsigned int MAX_POLY_DEGREE = 2;
+/// Number of threads used by the thread-parallel assembly.
+const unsigned int N_THREADS = 4;
+
+/// Returns the Frobenius norm of (matrix - reference) relative to the one of the reference.
+double relative_difference (const MatrixType &matrix, const MatrixType &reference)
+{
+    MatrixType difference;
+    difference.copy_from(matrix);
+    difference.add(-1.0, reference);
+    return difference.frobenius_norm() / reference.frobenius_norm();
+}
+
+/// Assembles the residual and all its derivatives with the current thread limit.
+template<int dim, int nstate>
+void assemble_derivatives (
+    PHiLiP::DGBase<dim,double> &dg,
+    const PHiLiP::Physics::PhysicsBase<dim,nstate,double> &physics)
+{
+    VectorType solution_no_ghost;
+    solution_no_ghost.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg.high_order_grid.mapping_fe_field), dg.dof_handler, *(physics.manufactured_solution_function), solution_no_ghost);
+    dg.solution = solution_no_ghost;
+    dg.solution.update_ghost_values();
+
+    // Set dual to 1.0 so that every 2nd derivative of the residual is accounted for.
+    for (auto it = dg.dual.begin(); it != dg.dual.end(); ++it) {
+        (*it) = 1.0;
+    }
+    dg.dual.update_ghost_values();
+
+    dg.invalidate_residual();
+    dg.invalidate_dRdW();
+    dg.assemble_residual(true, false, false);
+    dg.assemble_residual(false, true, false);
+    dg.assemble_residual(false, false, true);
+}
+
+/** Checks that the residual, dRdW, dRdX, and d2R assembled with multiple threads per process match the
+ *  ones assembled with a single thread, at a non-uniform state of a curved grid with hanging nodes.
+ *
+ *  A single thread records the CoDiPack tapes, while multiple threads differentiate with Sacado and add
+ *  their rows to the Trilinos matrices through the copier of the WorkStream.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+
+    int error = 0;
+    for (unsigned int poly_degree = 1; poly_degree <= MAX_POLY_DEGREE; ++poly_degree) {
+        std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+            MPI_COMM_WORLD,
+            typename dealii::Triangulation<dim>::MeshSmoothing(
+                dealii::Triangulation<dim>::smoothing_on_refinement |
+                dealii::Triangulation<dim>::smoothing_on_coarsening));
+        const unsigned int n_subdivisions = 4;
+        dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+        const double random_factor = 0.2;
+        const bool keep_boundary = false;
+        dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+        for (auto &cell : grid->active_cell_iterators()) {
+            for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+            }
+        }
+
+        std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+
+        // Refine the first cells to obtain hanging nodes.
+        dg->high_order_grid.prepare_for_coarsening_and_refinement();
+        grid->prepare_coarsening_and_refinement();
+        unsigned int icell = 0;
+        for (auto cell = grid->begin_active(); cell!=grid->end(); ++cell) {
+            if (!cell->is_locally_owned()) continue;
+            if (++icell < grid->n_active_cells()/2) cell->set_refine_flag();
+        }
+        grid->execute_coarsening_and_refinement();
+        dg->high_order_grid.execute_coarsening_and_refinement();
+        dg->allocate_system ();
+
+        dealii::MultithreadInfo::set_thread_limit(1);
+        assemble_derivatives<dim,nstate>(*dg, *physics_double);
+        const VectorType serial_residual = dg->right_hand_side;
+        MatrixType serial_dRdW, serial_dRdX, serial_d2RdWdW, serial_d2RdWdX, serial_d2RdXdX;
+        serial_dRdW.copy_from(dg->system_matrix);
+        serial_dRdX.copy_from(dg->dRdXv);
+        serial_d2RdWdW.copy_from(dg->d2RdWdW);
+        serial_d2RdWdX.copy_from(dg->d2RdWdX);
+        serial_d2RdXdX.copy_from(dg->d2RdXdX);
+
+        dealii::MultithreadInfo::set_thread_limit(N_THREADS);
+        assemble_derivatives<dim,nstate>(*dg, *physics_double);
+        VectorType residual_difference = dg->right_hand_side;
+        residual_difference -= serial_residual;
+
+        const std::vector<std::pair<std::string,double>> differences {
+            { "residual", residual_difference.l2_norm() / serial_residual.l2_norm() },
+            { "dRdW",     relative_difference(dg->system_matrix, serial_dRdW) },
+            { "dRdX",     relative_difference(dg->dRdXv, serial_dRdX) },
+            { "d2RdWdW",  relative_difference(dg->d2RdWdW, serial_d2RdWdW) },
+            { "d2RdWdX",  relative_difference(dg->d2RdWdX, serial_d2RdWdX) },
+            { "d2RdXdX",  relative_difference(dg->d2RdXdX, serial_d2RdXdX) } };
+
+        pcout << "Poly degree " << poly_degree << " with " << dealii::MultithreadInfo::n_threads() << " threads:";
+        for (const auto &difference : differences) {
+            pcout << " " << difference.first << " " << difference.second;
+            if (difference.second > TOLERANCE) error = 1;
+        }
+        pcout << std::endl;
+        if (error) pcout << "The thread-parallel assembly does not match the serial one." << std::endl;
+    }
+
+    return error;
+}
@@ -0,0 +1,118 @@
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "mesh/grids/gaussian_bump.h"
+#include "parameters/all_parameters.h"
+#include "physics/euler.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+
+/// Polynomial degree of the solution.
+const unsigned int POLY_DEGREE = 2;
+/// Number of assemblies timed per thread count.
+const int N_ASSEMBLIES = 3;
+
+/// Returns the wall time of one assembly of the residual and dRdW, or of the residual only.
+double time_assembly (PHiLiP::DGBase<PHILIP_DIM,double> &dg, const bool compute_dRdW)
+{
+    const double start_time = MPI_Wtime();
+    for (int i = 0; i < N_ASSEMBLIES; ++i) {
+        dg.invalidate_residual();
+        dg.invalidate_dRdW();
+        dg.assemble_residual(compute_dRdW);
+    }
+    return dealii::Utilities::MPI::max(MPI_Wtime() - start_time, MPI_COMM_WORLD) / N_ASSEMBLIES;
+}
+
+/** Reports the strong scaling of the residual and dRdW assembly of the Gaussian bump with the number
+ *  of threads per process, doubled from 1 up to the number of cores.
+ *
+ *  Only fails if the assemblies with multiple threads do not match the serial one, since the timings
+ *  depend on the machine.
+ */
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    const int nstate = dim+2;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+    all_parameters.conv_num_flux_type = Parameters::AllParameters::ConvectiveNumericalFlux::roe;
+    all_parameters.euler_param.mach_inf = 0.5;
+
+    // Gaussian bump of EulerGaussianBump, with 16 cells across the channel height.
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+    const std::vector<unsigned int> n_subdivisions {{ 64, 16 }};
+    const double channel_length = 3.0;
+    const double channel_height = 0.8;
+    Grids::gaussian_bump(*grid, n_subdivisions, channel_length, channel_height);
+
+    const unsigned int grid_degree = POLY_DEGREE+1;
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, POLY_DEGREE, POLY_DEGREE, grid_degree, grid);
+    dg->allocate_system ();
+
+    const Physics::Euler<dim,nstate,double> euler_physics_double(
+        all_parameters.euler_param.ref_length,
+        all_parameters.euler_param.gamma_gas,
+        all_parameters.euler_param.mach_inf,
+        all_parameters.euler_param.angle_of_attack,
+        all_parameters.euler_param.side_slip_angle);
+    Physics::FreeStreamInitialConditions<dim,nstate> initial_conditions(euler_physics_double);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+
+    pcout << "Processes: " << dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)
+          << " Cells: " << grid->n_global_active_cells()
+          << " Degrees of freedom: " << dg->dof_handler.n_dofs() << std::endl;
+
+    int error = 0;
+    const unsigned int max_threads = dealii::MultithreadInfo::n_cores();
+    double serial_residual_time = 0.0, serial_dRdW_time = 0.0;
+    dealii::TrilinosWrappers::SparseMatrix serial_dRdW;
+    for (unsigned int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        dealii::MultithreadInfo::set_thread_limit(n_threads);
+
+        // The first assembly also fills the caches of the DG, and is not timed.
+        dg->assemble_residual(true);
+        const double residual_time = time_assembly(*dg, false);
+        const double dRdW_time = time_assembly(*dg, true);
+
+        if (n_threads == 1) {
+            serial_residual_time = residual_time;
+            serial_dRdW_time = dRdW_time;
+            serial_dRdW.copy_from(dg->system_matrix);
+        } else {
+            dealii::TrilinosWrappers::SparseMatrix difference;
+            difference.copy_from(dg->system_matrix);
+            difference.add(-1.0, serial_dRdW);
+            if (difference.frobenius_norm() > 1e-10 * serial_dRdW.frobenius_norm()) {
+                pcout << "The dRdW assembled with " << n_threads << " threads does not match the serial one." << std::endl;
+                error = 1;
+            }
+        }
+
+        pcout << "Threads: " << dealii::MultithreadInfo::n_threads()
+              << " Residual: " << residual_time << " s"
+              << " Speedup: " << serial_residual_time / residual_time
+              << " Residual and dRdW: " << dRdW_time << " s"
+              << " Speedup: " << serial_dRdW_time / dRdW_time
+              << " Efficiency: " << serial_dRdW_time / (dRdW_time * n_threads) << std::endl;
+    }
+
+    return error;
+}